@@ -1259,7 +1259,16 @@ typedef enum {
      * @a value1   New width
      * @a value2   New height
      */
-    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+    ENGINE_CALLBACK_EMBED_UI_RESIZED = 48,
+
+    /*!
+     * A function that is not realtime-safe was called from the audio thread.
+     * Only reported when running with the libcarla_interposer-rtsan preload library.
+     * @a pluginId Plugin Id, or MAIN_CARLA_PLUGIN_ID if called by the engine itself
+     * @a value1   Number of calls, including similar ones not reported separately
+     * @a valueStr Name of the function
+     */
+    ENGINE_CALLBACK_RT_SAFETY_VIOLATION = 49
 
 } EngineCallbackOpcode;
 
@@ -1550,7 +1559,113 @@ typedef enum {
     /*!
      * Treat loaded plugins as standalone (that is, there is no host UI to manage them)
      */
-    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
+    ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35,
+
+    /*!
+     * Minimum size in bytes for plugin chunks and custom data values to be saved as binary files,
+     * stored in a "<project>.data" folder next to the project file instead of being embedded in it.
+     * Default is 0, which disables this and keeps all data inside the project file.
+     */
+    ENGINE_OPTION_PROJECT_BINARY_DATA = 36,
+
+    /*!
+     * Number of plugin discovery processes to run concurrently.
+     * Default is 0, which uses one process per CPU core.
+     * @note Only used by plugin discovery, see carla_plugin_discovery_set_option(); engines reject it.
+     */
+    ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS = 37,
+
+    /*!
+     * Identify plugin binaries by their contents, so the discovery cache follows binaries that are moved or renamed.
+     * Binaries are hashed in a background thread and remembered in the discovery index.
+     * Default is 0, which identifies binaries by filename and modification time.
+     * @note Only used by plugin discovery, see carla_plugin_discovery_set_option(); engines reject it.
+     */
+    ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH = 38,
+
+    /*!
+     * CPUs to run audio threads on, as a list of CPUs and CPU ranges like "2,4-5".
+     * Applies to the engine audio thread, bridge audio threads and JACK application threads.
+     * Default is empty, which does not set any CPU affinity.
+     * @note Only supported on Linux.
+     */
+    ENGINE_OPTION_AUDIO_CPU_SET = 39,
+
+    /*!
+     * CPUs to run plugin worker threads on, using the same format as ENGINE_OPTION_AUDIO_CPU_SET.
+     * Default is empty, which does not set any CPU affinity.
+     * @note Only supported on Linux.
+     */
+    ENGINE_OPTION_WORKER_CPU_SET = 40,
+
+    /*!
+     * Realtime priority for audio threads created by Carla, such as bridge audio threads.
+     * Positive values are absolute priorities (1-99),
+     * negative values are relative to the priority of the engine audio thread (e.g. JACK's).
+     * Default is 0, which uses priority 80.
+     */
+    ENGINE_OPTION_RT_PRIORITY = 41,
+
+    /*!
+     * Lock the memory of plugin bridge processes, so that audio threads do not page fault.
+     * Default is 0, which does not lock memory.
+     * @note Not supported on Windows.
+     */
+    ENGINE_OPTION_BRIDGE_LOCK_MEMORY = 42,
+
+    /*!
+     * Time in milliseconds an effect must stay silent, while its input is silent and it receives no events,
+     * before it is put to sleep and skipped during processing.
+     * Plugins that report their tail length use it instead of this value.
+     * Sleeping plugins are woken up as soon as they receive non-silent input or events.
+     * Default is 0, which disables plugin sleep.
+     */
+    ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT = 43,
+
+    /*!
+     * Granularity in frames used to split plugin processing at control event times,
+     * for plugins without PLUGIN_OPTION_FIXED_BUFFERS.
+     * Event times are rounded down to a multiple of this value before splitting, so parameter changes apply
+     * up to granularity-1 frames early, while MIDI events keep their exact time inside the sub-block.
+     * A value of -1 picks a granularity per plugin from its measured per-call overhead.
+     * Default is 0, which splits at every event time.
+     */
+    ENGINE_OPTION_SUB_BLOCK_GRANULARITY = 44,
+
+    /*!
+     * Interval in frames at which CV sources mapped to parameters are read, for sample-accurate plugins.
+     * A parameter change is only sent when the value moved enough since the last one, so idle CV costs no events.
+     * Default is 32, a value of 0 reads CV once per audio cycle.
+     */
+    ENGINE_OPTION_CV_EVENT_RESOLUTION = 45,
+
+    /*!
+     * Number of realtime worker threads shared by all plugins, used for plugins that split their processing
+     * into parallel tasks (CLAP thread-pool extension).
+     * Worker threads use the realtime priority from ENGINE_OPTION_RT_PRIORITY and run on ENGINE_OPTION_WORKER_CPU_SET.
+     * Default is 0, which uses one thread less than the number of CPUs (at most 8), a value of -1 disables them.
+     * Threads are only started once a plugin needs them. Plugin bridges only start them if set to a positive value.
+     */
+    ENGINE_OPTION_WORKER_THREADS = 46,
+
+    /*!
+     * Number of CPU cores each FluidSynth instance renders its voices on.
+     * Extra rendering threads use the realtime priority from ENGINE_OPTION_RT_PRIORITY
+     * and run on ENGINE_OPTION_WORKER_CPU_SET.
+     * Default is 1, which renders on the audio thread only,
+     * a value of 0 uses as many cores as there are engine worker threads, plus the audio thread.
+     * @see ENGINE_OPTION_WORKER_THREADS
+     */
+    ENGINE_OPTION_FLUIDSYNTH_CPU_CORES = 47,
+
+    /*!
+     * Number of plugin bridge processes to keep started ahead of time for each bridge binary in use,
+     * so that adding a bridged plugin does not need to wait for a new process to start.
+     * A bridge binary is used by the pool after loading a plugin with it,
+     * or right away for the native bridge if ENGINE_OPTION_PREFER_PLUGIN_BRIDGES is set.
+     * Default is 0, which disables the pool.
+     */
+    ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE = 48
 
 } EngineOption;
 
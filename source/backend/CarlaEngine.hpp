@@ -14,6 +14,8 @@ class XmlDocument;
 
 CARLA_BACKEND_START_NAMESPACE
 
+class CarlaStateExternalData;
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -229,6 +231,13 @@ struct CARLA_API EngineOptions {
     bool preferUiBridges;
     bool uisAlwaysOnTop;
     bool pluginsAreStandalone;
+    uint projectBinaryDataMinSize;
+    uint pluginSleepTimeout;
+    int subBlockGranularity;
+    uint cvEventResolution;
+    int workerThreads;
+    int fluidSynthCpuCores;
+    uint pluginBridgePoolSize;
     uint bgColor;
     uint fgColor;
     float uiScale;
@@ -240,6 +249,10 @@ struct CARLA_API EngineOptions {
     bool audioTripleBuffer;
     const char* audioDriver;
     const char* audioDevice;
+    const char* audioCpuSet;
+    const char* workerCpuSet;
+    int rtPriority;
+    bool bridgeLockMemory;
 
 #ifndef BUILD_BRIDGE
     bool oscEnabled;
@@ -347,6 +360,18 @@ struct CARLA_API EngineTimeInfo {
 #endif
 };
 
+/*!
+ * Statistics about the duration of the engine process cycles.
+ * All times are in microseconds.
+ */
+struct CARLA_API EngineProcessTimeStats {
+    uint64_t count;
+    float minTime;
+    float avgTime;
+    float maxTime;
+    float p99Time;
+};
+
 // -----------------------------------------------------------------------
 
 /*!
@@ -942,6 +967,37 @@ public:
      */
     virtual void clearXruns() const noexcept;
 
+    /*!
+     * Get statistics about the duration of the process cycles since the engine started or was last reset.
+     * Only available for drivers that calculate the DSP load.
+     */
+    EngineProcessTimeStats getProcessTimeStats() const noexcept;
+
+    /*!
+     * Reset the process cycle duration statistics.
+     * The reset is done by the audio thread in the next cycle.
+     */
+    void resetProcessTimeStats() const noexcept;
+
+    /*!
+     * Start or stop recording a trace of the audio cycles, see CarlaEngineTrace.
+     * The trace is process-wide, shared by all engines in the same process.
+     */
+    void setTraceEnabled(bool enabled) const;
+
+    /*!
+     * Save the trace recorded so far into @a filename, in Chrome trace JSON format.
+     */
+    bool saveTrace(const char* filename) const;
+
+    /*!
+     * Render @a frames of audio from the start of the timeline into @a filename, as fast as plugins allow.
+     * Plugins are put into offline mode during the render, and @a blockSize overrides the buffer size if non-zero.
+     * Blocks until done, audio processing resumes afterwards.
+     * Only supported by the Dummy driver.
+     */
+    virtual bool renderToFile(const char* filename, uint64_t frames, uint32_t blockSize);
+
     /*!
      * Dynamically change buffer size and/or sample rate while engine is running.
      * @see ENGINE_DRIVER_DEVICE_VARIABLE_BUFFER_SIZE
@@ -974,6 +1030,17 @@ public:
                    const char* filename, const char* name, const char* label, int64_t uniqueId,
                    const void* extra);
 
+#ifndef BUILD_BRIDGE
+    /*!
+     * Load a new plugin into the bridge process of plugin @a id, running after the plugins already there.
+     * The group is seen as a single plugin, no new plugin id is used.
+     * Only available in rack mode.
+     * @see ENGINE_CALLBACK_RELOAD_ALL
+     */
+    bool addPluginToBridgeGroup(uint id, PluginType ptype,
+                                const char* filename, const char* label, int64_t uniqueId);
+#endif
+
     /*!
      * Remove plugin with id @a id.
      * @see ENGINE_CALLBACK_PLUGIN_REMOVED
@@ -1058,6 +1125,20 @@ public:
      */
     bool saveProject(const char* filename, bool setAsCurrentProject);
 
+    /*!
+     * Save current project to a file, serializing again only the plugins whose state changed since the last call.
+     * The file is written on a separate thread, into a temporary file that then replaces the target.
+     * Fails if the previous incremental save is still being written.
+     * @note All plugin data is stored inside the project file, regardless of ENGINE_OPTION_PROJECT_BINARY_DATA.
+     */
+    bool saveProjectIncremental(const char* filename);
+
+    /*!
+     * Get how long the last finished incremental save took in milliseconds, serializing and writing the file.
+     * Returns 0 if no incremental save has succeeded yet.
+     */
+    uint32_t getLastIncrementalSaveTime() const noexcept;
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     /*!
      * Get the currently set project folder.
@@ -1105,6 +1186,12 @@ public:
      */
     const EngineOptions& getOptions() const noexcept;
 
+    /*!
+     * Get the realtime priority to use for audio threads created by Carla.
+     * Resolves relative values of ENGINE_OPTION_RT_PRIORITY against the engine audio thread.
+     */
+    int getRealtimePriority() const noexcept;
+
     /*!
      * Get the current Time information (read-only).
      */
@@ -1257,6 +1344,26 @@ public:
      */
     bool wasActionCanceled() const noexcept;
 
+    /*!
+     * Run @a func for @a numTasks task indexes, spread over the engine worker threads and the calling thread.
+     * Only one set of tasks runs at a time, returns false without running anything if the worker threads
+     * are disabled, not started or busy, in which case the caller is expected to run the tasks by itself.
+     * @see ENGINE_OPTION_WORKER_THREADS, startWorkerThreads()
+     * @note RT call
+     */
+    bool runWorkerTasks(void (*func)(void* ptr, uint32_t taskIndex), void* ptr, uint32_t numTasks) noexcept;
+
+    /*!
+     * Get the number of engine worker threads, as configured; 0 if they are disabled.
+     */
+    uint32_t getWorkerThreadCount() const noexcept;
+
+    /*!
+     * Start the engine worker threads, if not running yet.
+     * Worker threads are not started with the engine, plugins that use runWorkerTasks() call this when loaded.
+     */
+    void startWorkerThreads();
+
     // -------------------------------------------------------------------
     // Options
 
@@ -1338,13 +1445,19 @@ protected:
 public:
     /*!
      * Common save project function for main engine and plugin.
+     * Large plugin data is written into @a externalData when non-null, otherwise everything goes inline.
+     * If @a onlyChangedPlugins is set, plugins whose state did not change re-use their previously saved state.
      */
-    void saveProjectInternal(water::MemoryOutputStream& outStrm) const;
+    void saveProjectInternal(water::MemoryOutputStream& outStrm,
+                             CarlaStateExternalData* externalData = nullptr,
+                             bool onlyChangedPlugins = false);
 
     /*!
      * Common load project function for main engine and plugin.
+     * @a externalData is used to resolve plugin data stored outside of the project file.
      */
-    bool loadProjectInternal(water::XmlDocument& xmlDoc, bool alwaysLoadConnections);
+    bool loadProjectInternal(water::XmlDocument& xmlDoc, bool alwaysLoadConnections,
+                             const CarlaStateExternalData* externalData = nullptr);
 
 protected:
     // -------------------------------------------------------------------
@@ -286,6 +286,40 @@ typedef struct _CarlaRuntimeEngineInfo {
 
 } CarlaRuntimeEngineInfo;
 
+/*!
+ * Plugin DSP time statistics.
+ * Times are in microseconds, measured by the engine around each of the plugin's process calls.
+ */
+typedef struct _CarlaPluginDspStats {
+    /*!
+     * Number of process calls accounted for.
+     */
+    uint64_t count;
+
+    /*!
+     * Minimum, average and maximum time of a process call.
+     */
+    float minTime;
+    float avgTime;
+    float maxTime;
+
+    /*!
+     * Estimated 99th percentile of the process call time.
+     */
+    float p99Time;
+
+    /*!
+     * Average time as percentage of the engine's buffer period.
+     */
+    float load;
+
+    /*!
+     * Percentage of cycles skipped while the plugin was asleep, see ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT.
+     */
+    float asleep;
+
+} CarlaPluginDspStats;
+
 /*!
  * Runtime engine driver device information.
  */
@@ -456,6 +490,40 @@ CARLA_API_EXPORT bool carla_show_engine_device_control_panel(CarlaHostHandle han
  */
 CARLA_API_EXPORT void carla_clear_engine_xruns(CarlaHostHandle handle);
 
+/*!
+ * Get the DSP time statistics of the whole engine process cycles, accumulated since the engine started or last reset.
+ * The same structure as plugin stats is used, with count being the number of cycles.
+ * Only drivers that calculate the DSP load fill these in.
+ */
+CARLA_API_EXPORT const CarlaPluginDspStats* carla_get_engine_dsp_stats(CarlaHostHandle handle);
+
+/*!
+ * Reset the DSP time statistics of the engine process cycles.
+ */
+CARLA_API_EXPORT void carla_reset_engine_dsp_stats(CarlaHostHandle handle);
+
+/*!
+ * Start or stop recording a trace of the engine audio cycles.
+ * Recorded spans include each cycle, graph rendering, event conversion, plugin processing and bridge round-trips.
+ * Enabling again discards the previous recording.
+ */
+CARLA_API_EXPORT void carla_engine_set_tracing(CarlaHostHandle handle, bool enabled);
+
+/*!
+ * Save the engine trace recorded so far into @a filename, in Chrome trace JSON format.
+ * The file can be opened with Perfetto or chrome://tracing.
+ */
+CARLA_API_EXPORT bool carla_engine_save_trace(CarlaHostHandle handle, const char* filename);
+
+/*!
+ * Render @a frames of audio from the start of the timeline into @a filename, faster than realtime.
+ * The file is written as FLAC if the filename ends in ".flac", otherwise as 32-bit float WAV.
+ * A non-zero @a blockSize temporarily overrides the engine buffer size.
+ * Blocks until the render is complete, only supported by the Dummy driver.
+ */
+CARLA_API_EXPORT bool carla_engine_render_to_file(CarlaHostHandle handle,
+                                                  const char* filename, uint64_t frames, uint blockSize);
+
 /*!
  * Tell the engine to stop the current cancelable action.
  * @see ENGINE_CALLBACK_CANCELABLE_ACTION
@@ -511,6 +579,19 @@ CARLA_API_EXPORT bool carla_load_project(CarlaHostHandle handle, const char* fil
  */
 CARLA_API_EXPORT bool carla_save_project(CarlaHostHandle handle, const char* filename);
 
+/*!
+ * Save current project to a file, only serializing again plugins whose state changed since the last call.
+ * The file is written in the background, meant for frequent autosaves.
+ * Returns false if the previous incremental save is still being written.
+ */
+CARLA_API_EXPORT bool carla_save_project_incremental(CarlaHostHandle handle, const char* filename);
+
+/*!
+ * Get how long the last finished incremental save took, in milliseconds.
+ * Returns 0 if no incremental save has succeeded yet.
+ */
+CARLA_API_EXPORT uint32_t carla_get_last_incremental_save_time(CarlaHostHandle handle);
+
 #ifndef BUILD_BRIDGE
 /*!
   * Get the currently set project folder.
@@ -658,6 +739,18 @@ CARLA_API_EXPORT bool carla_clone_plugin(CarlaHostHandle handle, uint pluginId);
  */
 CARLA_API_EXPORT bool carla_replace_plugin(CarlaHostHandle handle, uint pluginId);
 
+/*!
+ * Load a new plugin into the bridge process of another, running after the plugins already there.
+ * The group is seen as a single plugin, only available in rack mode.
+ * @param pluginId Bridged plugin to add to
+ * @param ptype    Plugin type
+ * @param filename Filename, if applicable
+ * @param label    Plugin label, if applicable
+ * @param uniqueId Plugin unique Id, if applicable
+ */
+CARLA_API_EXPORT bool carla_add_plugin_to_bridge_group(CarlaHostHandle handle, uint pluginId, PluginType ptype,
+                                                       const char* filename, const char* label, int64_t uniqueId);
+
 /*!
  * Switch two plugins positions.
  * @param pluginIdA Plugin A
@@ -914,6 +1007,18 @@ CARLA_API_EXPORT float carla_get_input_peak_value(CarlaHostHandle handle, uint p
  */
 CARLA_API_EXPORT float carla_get_output_peak_value(CarlaHostHandle handle, uint pluginId, bool isLeft);
 
+/*!
+ * Get a plugin's DSP time statistics, accumulated since the plugin was added or last reset.
+ * @param pluginId Plugin
+ */
+CARLA_API_EXPORT const CarlaPluginDspStats* carla_get_plugin_dsp_stats(CarlaHostHandle handle, uint pluginId);
+
+/*!
+ * Reset a plugin's DSP time statistics.
+ * @param pluginId Plugin
+ */
+CARLA_API_EXPORT void carla_reset_plugin_dsp_stats(CarlaHostHandle handle, uint pluginId);
+
 /*!
  * Render a plugin's inline display.
  * @param pluginId Plugin
@@ -13,6 +13,10 @@
 typedef struct _NativePluginDescriptor NativePluginDescriptor;
 struct LADSPA_RDF_Descriptor;
 
+namespace water {
+class String;
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_START_NAMESPACE
@@ -42,6 +46,22 @@ struct EngineEvent;
 
 // -----------------------------------------------------------------------
 
+/*!
+ * Statistics about the duration of a plugin's process() calls.
+ * All times are in microseconds.
+ * @a sleepCount is the number of cycles skipped while the plugin was asleep.
+ */
+struct CARLA_API PluginProcessTimeStats {
+    uint64_t count;
+    uint64_t sleepCount;
+    float minTime;
+    float avgTime;
+    float maxTime;
+    float p99Time;
+};
+
+// -----------------------------------------------------------------------
+
 /*!
  * Carla Backend base plugin class
  *
@@ -424,6 +444,26 @@ public:
      */
     void loadStateSave(const CarlaStateSave& stateSave);
 
+    /*!
+     * Mark the plugin state as changed, so it gets serialized again on the next incremental project save.
+     * @note RT-safe
+     */
+    void setStateChanged() noexcept;
+
+    /*!
+     * Check if the plugin state changed since the last call to getStateSaveXml().
+     * Plugin types that cannot report all of their state changes always return true.
+     */
+    virtual bool isStateChanged() const noexcept;
+
+    /*!
+     * Get the plugin's save state as project XML.
+     * The previous result is re-used if the state did not change since the last call.
+     *
+     * @see CarlaEngine::saveProjectIncremental()
+     */
+    const water::String& getStateSaveXml();
+
     /*!
      * Save the current plugin state to @a filename.
      *
@@ -683,6 +723,13 @@ public:
      */
     virtual void reloadPrograms(bool doInit);
 
+    /*!
+     * Load another plugin into this plugin's bridge process, to run in series after the plugins already there.
+     * The group keeps being seen as a single plugin, with the new plugin parameters appended to the current ones.
+     * Only plugin bridges support this, on failure the engine last error is set.
+     */
+    virtual bool addPluginToBridgeGroup(PluginType ptype, const char* filename, const char* label, int64_t uniqueId);
+
     // -------------------------------------------------------------------
     // Plugin processing
 
@@ -704,6 +751,48 @@ public:
     virtual void process(const float* const* audioIn, float** audioOut,
                          const float* const* cvIn, float** cvOut, uint32_t frames) = 0;
 
+    /*!
+     * Get a buffer owned by the plugin for audio port @a index, or null if it has none.
+     * A host free to choose its buffers can write inputs into and read outputs from these directly,
+     * passing them to process() so the plugin does not need to copy audio in and out.
+     * The buffers are only valid while the plugin is locked.
+     * @note RT call
+     */
+    virtual float* getAudioPortBuffer(bool isInput, uint32_t index) const noexcept;
+
+    /*!
+     * Account one process() call, using the carla_gettime_ns() values taken by the engine around it.
+     * @note RT call
+     */
+    void addProcessTime(uint64_t startTime, uint64_t endTime) noexcept;
+
+    /*!
+     * Check if the plugin is asleep and its next process() call can be skipped, see ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT.
+     * The plugin is woken up if its input is not silent or if it has events to process.
+     * If this returns true the caller must not call process() and must clear the plugin outputs instead.
+     * @note RT call
+     */
+    bool isAsleep(bool inputIsSilent, bool hasInputEvents) noexcept;
+
+    /*!
+     * Update the plugin sleep state after a process() call, from the peak level of its outputs
+     * and whether it produced any events.
+     * @note RT call
+     */
+    void updateSleepState(float outputPeak, bool hasOutputEvents, uint32_t frames) noexcept;
+
+    /*!
+     * Get statistics about the duration of process() calls since the plugin was added or last reset.
+     * All times are in microseconds.
+     */
+    PluginProcessTimeStats getProcessTimeStats() const noexcept;
+
+    /*!
+     * Reset the process() duration statistics.
+     * The reset is done by the audio thread in the next cycle.
+     */
+    void resetProcessTimeStats() noexcept;
+
     /*!
      * Tell the plugin the current buffer size changed.
      */
@@ -956,9 +1045,15 @@ public:
         const uint options; // see PluginOptions
     };
 
+    // warmBridge, if running, is used instead of starting a new bridge process
     static CarlaPluginPtr newBridge(const Initializer& init,
                                     BinaryType btype, PluginType ptype,
-                                    const char* binaryArchName, const char* bridgeBinary);
+                                    const char* binaryArchName, const char* bridgeBinary,
+                                    CarlaPluginPtr warmBridge = CarlaPluginPtr());
+
+    // start a bridge process without a plugin, for newBridge() to load one into later
+    static CarlaPluginPtr newWarmBridge(CarlaEngine* engine, BinaryType btype,
+                                        const char* binaryArchName, const char* bridgeBinary);
 
    #ifndef CARLA_PLUGIN_ONLY_BRIDGE
     static CarlaPluginPtr newNative(const Initializer& init);
@@ -1014,6 +1109,12 @@ protected:
      */
     virtual void waitForBridgeSaveSignal() noexcept;
 
+    /*!
+     * Check if a plugin bridge is still processing the save request sent by prepareForSave().
+     * Allows the engine to wait for all bridges at once.
+     */
+    virtual bool isWaitingForBridgeSaveSignal() const noexcept;
+
     // -------------------------------------------------------------------
     // Helper classes
 
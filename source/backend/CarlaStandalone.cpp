@@ -272,6 +272,30 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
 
     if (const char* const frontendWinId = std::getenv("ENGINE_OPTION_FRONTEND_WIN_ID"))
         engine->setOption(CB::ENGINE_OPTION_FRONTEND_WIN_ID, 0, frontendWinId);
+
+    if (const char* const audioCpuSet = std::getenv("ENGINE_OPTION_AUDIO_CPU_SET"))
+        engine->setOption(CB::ENGINE_OPTION_AUDIO_CPU_SET, 0, audioCpuSet);
+
+    if (const char* const workerCpuSet = std::getenv("ENGINE_OPTION_WORKER_CPU_SET"))
+        engine->setOption(CB::ENGINE_OPTION_WORKER_CPU_SET, 0, workerCpuSet);
+
+    if (const char* const rtPriority = std::getenv("ENGINE_OPTION_RT_PRIORITY"))
+        engine->setOption(CB::ENGINE_OPTION_RT_PRIORITY, std::atoi(rtPriority), nullptr);
+
+    if (const char* const bridgeLockMemory = std::getenv("ENGINE_OPTION_BRIDGE_LOCK_MEMORY"))
+        engine->setOption(CB::ENGINE_OPTION_BRIDGE_LOCK_MEMORY, (std::strcmp(bridgeLockMemory, "true") == 0) ? 1 : 0, nullptr);
+
+    if (const char* const subBlockGranularity = std::getenv("ENGINE_OPTION_SUB_BLOCK_GRANULARITY"))
+        engine->setOption(CB::ENGINE_OPTION_SUB_BLOCK_GRANULARITY, std::atoi(subBlockGranularity), nullptr);
+
+    if (const char* const cvEventResolution = std::getenv("ENGINE_OPTION_CV_EVENT_RESOLUTION"))
+        engine->setOption(CB::ENGINE_OPTION_CV_EVENT_RESOLUTION, std::atoi(cvEventResolution), nullptr);
+
+    if (const char* const workerThreads = std::getenv("ENGINE_OPTION_WORKER_THREADS"))
+        engine->setOption(CB::ENGINE_OPTION_WORKER_THREADS, std::atoi(workerThreads), nullptr);
+
+    if (const char* const fluidSynthCpuCores = std::getenv("ENGINE_OPTION_FLUIDSYNTH_CPU_CORES"))
+        engine->setOption(CB::ENGINE_OPTION_FLUIDSYNTH_CPU_CORES, std::atoi(fluidSynthCpuCores), nullptr);
 #else
     engine->setOption(CB::ENGINE_OPTION_FORCE_STEREO,          standalone.engineOptions.forceStereo         ? 1 : 0,        nullptr);
     engine->setOption(CB::ENGINE_OPTION_PREFER_PLUGIN_BRIDGES, standalone.engineOptions.preferPluginBridges ? 1 : 0,        nullptr);
@@ -370,6 +394,22 @@ static void carla_engine_init_common(const CarlaHostStandalone& standalone, Carl
     engine->setOption(CB::ENGINE_OPTION_CLIENT_NAME_PREFIX, 0, standalone.engineOptions.clientNamePrefix);
 
     engine->setOption(CB::ENGINE_OPTION_PLUGINS_ARE_STANDALONE, standalone.engineOptions.pluginsAreStandalone, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_PROJECT_BINARY_DATA,
+                      static_cast<int>(standalone.engineOptions.projectBinaryDataMinSize), nullptr);
+
+    engine->setOption(CB::ENGINE_OPTION_AUDIO_CPU_SET, 0, standalone.engineOptions.audioCpuSet);
+    engine->setOption(CB::ENGINE_OPTION_WORKER_CPU_SET, 0, standalone.engineOptions.workerCpuSet);
+    engine->setOption(CB::ENGINE_OPTION_RT_PRIORITY, standalone.engineOptions.rtPriority, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_BRIDGE_LOCK_MEMORY, standalone.engineOptions.bridgeLockMemory ? 1 : 0, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT,
+                      static_cast<int>(standalone.engineOptions.pluginSleepTimeout), nullptr);
+    engine->setOption(CB::ENGINE_OPTION_SUB_BLOCK_GRANULARITY, standalone.engineOptions.subBlockGranularity, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_CV_EVENT_RESOLUTION,
+                      static_cast<int>(standalone.engineOptions.cvEventResolution), nullptr);
+    engine->setOption(CB::ENGINE_OPTION_WORKER_THREADS, standalone.engineOptions.workerThreads, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_FLUIDSYNTH_CPU_CORES, standalone.engineOptions.fluidSynthCpuCores, nullptr);
+    engine->setOption(CB::ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE,
+                      static_cast<int>(standalone.engineOptions.pluginBridgePoolSize), nullptr);
 #endif // BUILD_BRIDGE
 }
 
@@ -627,6 +667,75 @@ void carla_clear_engine_xruns(CarlaHostHandle handle)
         handle->engine->clearXruns();
 }
 
+const CarlaPluginDspStats* carla_get_engine_dsp_stats(CarlaHostHandle handle)
+{
+    static CarlaPluginDspStats retStats;
+
+    // reset
+    retStats.count   = 0;
+    retStats.minTime = 0.0f;
+    retStats.avgTime = 0.0f;
+    retStats.maxTime = 0.0f;
+    retStats.p99Time = 0.0f;
+    retStats.load    = 0.0f;
+    retStats.asleep  = 0.0f;
+
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, &retStats);
+
+    const CB::EngineProcessTimeStats stats(handle->engine->getProcessTimeStats());
+
+    retStats.count   = stats.count;
+    retStats.minTime = stats.minTime;
+    retStats.avgTime = stats.avgTime;
+    retStats.maxTime = stats.maxTime;
+    retStats.p99Time = stats.p99Time;
+
+    const uint32_t bufferSize = handle->engine->getBufferSize();
+    const double sampleRate = handle->engine->getSampleRate();
+
+    if (bufferSize != 0 && sampleRate > 0.0)
+        retStats.load = static_cast<float>(stats.avgTime * sampleRate / bufferSize / 10000.0);
+
+    return &retStats;
+}
+
+void carla_reset_engine_dsp_stats(CarlaHostHandle handle)
+{
+    if (handle->engine != nullptr)
+        handle->engine->resetProcessTimeStats();
+}
+
+void carla_engine_set_tracing(CarlaHostHandle handle, bool enabled)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr,);
+    carla_debug("carla_engine_set_tracing(%p, %s)", handle, bool2str(enabled));
+
+    handle->engine->setTraceEnabled(enabled);
+}
+
+bool carla_engine_save_trace(CarlaHostHandle handle, const char* filename)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    carla_debug("carla_engine_save_trace(%p, \"%s\")", handle, filename);
+
+    if (handle->engine->saveTrace(filename))
+        return true;
+
+    handle->engine->setLastError("Failed to save trace file");
+    return false;
+}
+
+bool carla_engine_render_to_file(CarlaHostHandle handle, const char* filename, uint64_t frames, uint blockSize)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(frames != 0, false);
+    carla_debug("carla_engine_render_to_file(%p, \"%s\", " P_UINT64 ", %u)", handle, filename, frames, blockSize);
+
+    return handle->engine->renderToFile(filename, frames, blockSize);
+}
+
 void carla_cancel_engine_action(CarlaHostHandle handle)
 {
     if (handle->engine != nullptr)
@@ -973,6 +1082,76 @@ void carla_set_engine_option(CarlaHostHandle handle, EngineOption option, int va
             CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
             shandle.engineOptions.pluginsAreStandalone = (value != 0);
             break;
+
+        case CB::ENGINE_OPTION_PROJECT_BINARY_DATA:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.projectBinaryDataMinSize = static_cast<uint>(value);
+            break;
+
+        // discovery runs outside of the engine, these need to go through carla_plugin_discovery_set_option()
+        case CB::ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS:
+        case CB::ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH:
+            shandle.lastError = "Plugin discovery options must be set with carla_plugin_discovery_set_option()";
+            return carla_stderr("carla_set_engine_option(%p, %i:%s, %i, \"%s\") - Not an engine option, ignored",
+                                handle, option, CB::EngineOption2Str(option), value, valueStr);
+
+        case CB::ENGINE_OPTION_AUDIO_CPU_SET:
+            if (shandle.engineOptions.audioCpuSet != nullptr)
+                delete[] shandle.engineOptions.audioCpuSet;
+
+            shandle.engineOptions.audioCpuSet = valueStr != nullptr && valueStr[0] != '\0'
+                                              ? carla_strdup_safe(valueStr)
+                                              : nullptr;
+            break;
+
+        case CB::ENGINE_OPTION_WORKER_CPU_SET:
+            if (shandle.engineOptions.workerCpuSet != nullptr)
+                delete[] shandle.engineOptions.workerCpuSet;
+
+            shandle.engineOptions.workerCpuSet = valueStr != nullptr && valueStr[0] != '\0'
+                                               ? carla_strdup_safe(valueStr)
+                                               : nullptr;
+            break;
+
+        case CB::ENGINE_OPTION_RT_PRIORITY:
+            CARLA_SAFE_ASSERT_RETURN(value > -99 && value < 100,);
+            shandle.engineOptions.rtPriority = value;
+            break;
+
+        case CB::ENGINE_OPTION_BRIDGE_LOCK_MEMORY:
+            CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+            shandle.engineOptions.bridgeLockMemory = (value != 0);
+            break;
+
+        case CB::ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.pluginSleepTimeout = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_SUB_BLOCK_GRANULARITY:
+            CARLA_SAFE_ASSERT_RETURN(value >= -1 && value <= 1024,);
+            shandle.engineOptions.subBlockGranularity = value;
+            break;
+
+        case CB::ENGINE_OPTION_CV_EVENT_RESOLUTION:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+            shandle.engineOptions.cvEventResolution = static_cast<uint>(value);
+            break;
+
+        case CB::ENGINE_OPTION_WORKER_THREADS:
+            CARLA_SAFE_ASSERT_RETURN(value >= -1 && value <= 64,);
+            shandle.engineOptions.workerThreads = value;
+            break;
+
+        case CB::ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 64,);
+            shandle.engineOptions.fluidSynthCpuCores = value;
+            break;
+
+        case CB::ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE:
+            CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 16,);
+            shandle.engineOptions.pluginBridgePoolSize = static_cast<uint>(value);
+            break;
         }
     }
 
@@ -1028,6 +1207,25 @@ bool carla_save_project(CarlaHostHandle handle, const char* filename)
     return handle->engine->saveProject(filename, true);
 }
 
+bool carla_save_project_incremental(CarlaHostHandle handle, const char* filename)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_save_project_incremental(%p, \"%s\")", handle, filename);
+
+    return handle->engine->saveProjectIncremental(filename);
+}
+
+uint32_t carla_get_last_incremental_save_time(CarlaHostHandle handle)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, 0);
+
+    carla_debug("carla_get_last_incremental_save_time(%p)", handle);
+
+    return handle->engine->getLastIncrementalSaveTime();
+}
+
 #ifndef BUILD_BRIDGE
 const char* carla_get_current_project_folder(CarlaHostHandle handle)
 {
@@ -1261,6 +1459,17 @@ bool carla_replace_plugin(CarlaHostHandle handle, uint pluginId)
     return handle->engine->replacePlugin(pluginId);
 }
 
+bool carla_add_plugin_to_bridge_group(CarlaHostHandle handle, uint pluginId, PluginType ptype,
+                                      const char* filename, const char* label, int64_t uniqueId)
+{
+    CARLA_SAFE_ASSERT_WITH_LAST_ERROR_RETURN(handle->engine != nullptr, "Engine is not initialized", false);
+
+    carla_debug("carla_add_plugin_to_bridge_group(%p, %i, %i:%s, \"%s\", \"%s\", " P_INT64 ")",
+                handle, pluginId, ptype, CB::PluginType2Str(ptype), filename, label, uniqueId);
+
+    return handle->engine->addPluginToBridgeGroup(pluginId, ptype, filename, label, uniqueId);
+}
+
 bool carla_switch_plugins(CarlaHostHandle handle, uint pluginIdA, uint pluginIdB)
 {
     CARLA_SAFE_ASSERT_RETURN(pluginIdA != pluginIdB, false);
@@ -1991,6 +2200,54 @@ float carla_get_output_peak_value(CarlaHostHandle handle, uint pluginId, bool is
 
 // --------------------------------------------------------------------------------------------------------------------
 
+const CarlaPluginDspStats* carla_get_plugin_dsp_stats(CarlaHostHandle handle, uint pluginId)
+{
+    static CarlaPluginDspStats retStats;
+
+    // reset
+    retStats.count   = 0;
+    retStats.minTime = 0.0f;
+    retStats.avgTime = 0.0f;
+    retStats.maxTime = 0.0f;
+    retStats.p99Time = 0.0f;
+    retStats.load    = 0.0f;
+    retStats.asleep  = 0.0f;
+
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr, &retStats);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+    {
+        const CB::PluginProcessTimeStats stats(plugin->getProcessTimeStats());
+
+        retStats.count   = stats.count;
+        retStats.minTime = stats.minTime;
+        retStats.avgTime = stats.avgTime;
+        retStats.maxTime = stats.maxTime;
+        retStats.p99Time = stats.p99Time;
+
+        const uint32_t bufferSize = handle->engine->getBufferSize();
+        const double sampleRate = handle->engine->getSampleRate();
+
+        if (bufferSize != 0 && sampleRate > 0.0)
+            retStats.load = static_cast<float>(stats.avgTime * sampleRate / bufferSize / 10000.0);
+
+        if (const uint64_t cycles = stats.count + stats.sleepCount)
+            retStats.asleep = static_cast<float>(static_cast<double>(stats.sleepCount) * 100.0 / cycles);
+    }
+
+    return &retStats;
+}
+
+void carla_reset_plugin_dsp_stats(CarlaHostHandle handle, uint pluginId)
+{
+    CARLA_SAFE_ASSERT_RETURN(handle->engine != nullptr,);
+
+    if (const CarlaPluginPtr plugin = handle->engine->getPlugin(pluginId))
+        plugin->resetProcessTimeStats();
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 CARLA_BACKEND_START_NAMESPACE
 
 #if !(defined(BUILD_BRIDGE_ALTERNATIVE_ARCH) || defined(CARLA_PLUGIN_ONLY_BRIDGE))
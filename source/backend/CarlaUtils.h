@@ -223,6 +223,12 @@ CARLA_PLUGIN_EXPORT void carla_plugin_discovery_skip(CarlaPluginDiscoveryHandle
  */
 CARLA_PLUGIN_EXPORT void carla_plugin_discovery_stop(CarlaPluginDiscoveryHandle handle);
 
+/*!
+ * Get the progress of a plugin discovery.
+ * @p scanned is the number of binaries already scanned and reported, @p total the number of binaries to scan.
+ */
+CARLA_PLUGIN_EXPORT void carla_plugin_discovery_get_progress(CarlaPluginDiscoveryHandle handle, uint* scanned, uint* total);
+
 /*!
  * Set a plugin discovery setting, to be applied globally.
  */
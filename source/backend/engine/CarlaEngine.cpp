@@ -21,6 +21,7 @@
 #include "CarlaProcessUtils.hpp"
 #include "CarlaScopeUtils.hpp"
 #include "CarlaStateUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 #include "CarlaMIDI.h"
 
 #include "jackbridge/JackBridge.hpp"
@@ -414,6 +415,10 @@ void CarlaEngine::idle() noexcept
     pData->osc.idle();
 #endif
 
+    try {
+        pData->bridgePool.idle();
+    } CARLA_SAFE_EXCEPTION("Bridge pool idle");
+
     pData->deletePluginsAsNeeded();
 }
 
@@ -454,6 +459,46 @@ void CarlaEngine::clearXruns() const noexcept
 #endif
 }
 
+EngineProcessTimeStats CarlaEngine::getProcessTimeStats() const noexcept
+{
+    EngineProcessTimeStats ret = { 0, 0.0f, 0.0f, 0.0f, 0.0f };
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    const CarlaProcessTimeHistogram::Stats stats(pData->cycleTime.getStats());
+
+    ret.count   = stats.count;
+    ret.minTime = stats.minTime;
+    ret.avgTime = stats.avgTime;
+    ret.maxTime = stats.maxTime;
+    ret.p99Time = stats.p99Time;
+#endif
+
+    return ret;
+}
+
+void CarlaEngine::resetProcessTimeStats() const noexcept
+{
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    pData->cycleTime.requestReset();
+#endif
+}
+
+void CarlaEngine::setTraceEnabled(const bool enabled) const
+{
+    CarlaEngineTrace::setEnabled(enabled);
+}
+
+bool CarlaEngine::saveTrace(const char* const filename) const
+{
+    return CarlaEngineTrace::saveToFile(this, filename);
+}
+
+bool CarlaEngine::renderToFile(const char* const, const uint64_t, const uint32_t)
+{
+    setLastError("Offline rendering is not supported by the current engine driver");
+    return false;
+}
+
 bool CarlaEngine::showDeviceControlPanel() const noexcept
 {
     return false;
@@ -646,7 +691,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
    #if defined(CARLA_PLUGIN_ONLY_BRIDGE)
     if (bridgeBinary.isNotEmpty())
     {
-        plugin = CarlaPlugin::newBridge(initializer, btype, ptype, needsArchBridge, bridgeBinary);
+        plugin = pData->bridgePool.newBridge(initializer, btype, ptype, needsArchBridge, bridgeBinary);
     }
     else
     {
@@ -658,7 +703,7 @@ bool CarlaEngine::addPlugin(const BinaryType btype,
     {
         if (bridgeBinary.isNotEmpty())
         {
-            plugin = CarlaPlugin::newBridge(initializer, btype, ptype, needsArchBridge, bridgeBinary);
+            plugin = pData->bridgePool.newBridge(initializer, btype, ptype, needsArchBridge, bridgeBinary);
         }
         else
         {
@@ -873,6 +918,47 @@ bool CarlaEngine::addPlugin(const PluginType ptype,
     return addPlugin(BINARY_NATIVE, ptype, filename, name, label, uniqueId, extra, PLUGIN_OPTIONS_NULL);
 }
 
+#ifndef BUILD_BRIDGE
+bool CarlaEngine::addPluginToBridgeGroup(const uint id,
+                                         const PluginType ptype,
+                                         const char* const filename,
+                                         const char* const label,
+                                         const int64_t uniqueId)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->plugins != nullptr, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(pData->nextAction.opcode == kEnginePostActionNull, "Invalid engine internal data");
+    CARLA_SAFE_ASSERT_RETURN_ERR(id < pData->curPluginCount, "Invalid plugin Id");
+    CARLA_SAFE_ASSERT_RETURN_ERR(ptype != PLUGIN_NONE, "Invalid plugin type");
+    CARLA_SAFE_ASSERT_RETURN_ERR((filename != nullptr && filename[0] != '\0') || (label != nullptr && label[0] != '\0'), "Invalid plugin filename and label");
+    carla_debug("CarlaEngine::addPluginToBridgeGroup(%i, %i:%s, \"%s\", \"%s\", " P_INT64 ")",
+                id, ptype, PluginType2Str(ptype), filename, label, uniqueId);
+
+    if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+    {
+        setLastError("Bridge groups are only available in rack mode");
+        return false;
+    }
+
+    const CarlaPluginPtr plugin = pData->plugins[id].plugin;
+
+    CARLA_SAFE_ASSERT_RETURN_ERR(plugin.get() != nullptr, "Could not find plugin to add to");
+    CARLA_SAFE_ASSERT_RETURN_ERR(plugin->getId() == id, "Invalid engine internal data");
+
+    if ((plugin->getHints() & PLUGIN_IS_BRIDGE) == 0)
+    {
+        setLastError("Plugin is not a bridge");
+        return false;
+    }
+
+    if (! plugin->addPluginToBridgeGroup(ptype, filename, label, uniqueId))
+        return false;
+
+    callback(true, true, ENGINE_CALLBACK_RELOAD_ALL, id, 0, 0, 0, 0.0f, nullptr);
+    return true;
+}
+#endif
+
 bool CarlaEngine::removePlugin(const uint id)
 {
     CARLA_SAFE_ASSERT_RETURN_ERR(pData->isIdling == 0, "An operation is still being processed, please wait for it to finish");
@@ -1417,8 +1503,11 @@ bool CarlaEngine::loadProject(const char* const filename, const bool setAsCurren
 #endif
     }
 
+    // binary data files are always resolved, regardless of the save option
+    const CarlaStateExternalData externalData(file, 0);
+
     XmlDocument xml(file);
-    return loadProjectInternal(xml, !setAsCurrentProject);
+    return loadProjectInternal(xml, !setAsCurrentProject, &externalData);
 }
 
 bool CarlaEngine::saveProject(const char* const filename, const bool setAsCurrentProject)
@@ -1449,18 +1538,54 @@ bool CarlaEngine::saveProject(const char* const filename, const bool setAsCurren
 #endif
     }
 
-    MemoryOutputStream out;
-    saveProjectInternal(out);
+    // do not race against a pending incremental save into the same file
+    pData->projectWriter.waitForWrite();
 
-    File file(filename);
+    const File file(filename);
+    CarlaStateExternalData externalData(file, pData->options.projectBinaryDataMinSize);
+
+    MemoryOutputStream out;
+    saveProjectInternal(out, pData->options.projectBinaryDataMinSize != 0 ? &externalData : nullptr);
 
     if (file.replaceWithData(out.getData(), out.getDataSize()))
+    {
+        externalData.removeUnused();
         return true;
+    }
 
+    externalData.removeStored();
     setLastError("Failed to write file");
     return false;
 }
 
+bool CarlaEngine::saveProjectIncremental(const char* const filename)
+{
+    CARLA_SAFE_ASSERT_RETURN_ERR(filename != nullptr && filename[0] != '\0', "Invalid filename");
+    carla_debug("CarlaEngine::saveProjectIncremental(\"%s\")", filename);
+
+    if (pData->projectWriter.isWriting())
+    {
+        setLastError("Previous save is still in progress");
+        return false;
+    }
+
+    const uint32_t startTime = carla_gettime_ms();
+
+    MemoryOutputStream out;
+    saveProjectInternal(out, nullptr, true);
+
+    if (pData->projectWriter.write(filename, out.getData(), out.getDataSize(), carla_gettime_ms() - startTime))
+        return true;
+
+    setLastError("Failed to start writing file");
+    return false;
+}
+
+uint32_t CarlaEngine::getLastIncrementalSaveTime() const noexcept
+{
+    return pData->projectWriter.getLastSaveTime();
+}
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
 const char* CarlaEngine::getCurrentProjectFolder() const noexcept
 {
@@ -1508,6 +1633,24 @@ const EngineOptions& CarlaEngine::getOptions() const noexcept
     return pData->options;
 }
 
+int CarlaEngine::getRealtimePriority() const noexcept
+{
+    // same as CarlaThread
+    static constexpr const int kDefaultRealtimePriority = 80;
+
+    const int priority = pData->options.rtPriority;
+
+    if (priority > 0)
+        return priority;
+    if (priority == 0)
+        return kDefaultRealtimePriority;
+
+    const int audioThreadPriority = pData->audioThreadPriority;
+    const int basePriority = audioThreadPriority > 0 ? audioThreadPriority : kDefaultRealtimePriority;
+
+    return std::max(1, basePriority + priority);
+}
+
 EngineTimeInfo CarlaEngine::getTimeInfo() const noexcept
 {
     return pData->timeInfo;
@@ -1825,6 +1968,21 @@ bool CarlaEngine::wasActionCanceled() const noexcept
     return pData->actionCanceled;
 }
 
+bool CarlaEngine::runWorkerTasks(void (*const func)(void*, uint32_t), void* const ptr, const uint32_t numTasks) noexcept
+{
+    return pData->workerPool.execute(func, ptr, numTasks);
+}
+
+uint32_t CarlaEngine::getWorkerThreadCount() const noexcept
+{
+    return pData->workerPool.getConfiguredWorkerCount();
+}
+
+void CarlaEngine::startWorkerThreads()
+{
+    pData->workerPool.start();
+}
+
 // -----------------------------------------------------------------------
 // Global options
 
@@ -1842,6 +2000,36 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         case ENGINE_OPTION_AUDIO_DEVICE:
             return carla_stderr("CarlaEngine::setOption(%i:%s, %i, \"%s\") - Cannot set this option while engine is running!",
                                 option, EngineOption2Str(option), value, valueStr);
+
+        // options given to plugin bridges on startup
+        case ENGINE_OPTION_FORCE_STEREO:
+        case ENGINE_OPTION_PREFER_PLUGIN_BRIDGES:
+        case ENGINE_OPTION_PREFER_UI_BRIDGES:
+        case ENGINE_OPTION_UIS_ALWAYS_ON_TOP:
+        case ENGINE_OPTION_MAX_PARAMETERS:
+        case ENGINE_OPTION_UI_BRIDGES_TIMEOUT:
+        case ENGINE_OPTION_PLUGIN_PATH:
+        case ENGINE_OPTION_PATH_BINARIES:
+        case ENGINE_OPTION_PATH_RESOURCES:
+        case ENGINE_OPTION_PREVENT_BAD_BEHAVIOUR:
+        case ENGINE_OPTION_FRONTEND_WIN_ID:
+        case ENGINE_OPTION_WINE_EXECUTABLE:
+        case ENGINE_OPTION_WINE_AUTO_PREFIX:
+        case ENGINE_OPTION_WINE_FALLBACK_PREFIX:
+        case ENGINE_OPTION_WINE_RT_PRIO_ENABLED:
+        case ENGINE_OPTION_WINE_BASE_RT_PRIO:
+        case ENGINE_OPTION_WINE_SERVER_RT_PRIO:
+        case ENGINE_OPTION_AUDIO_CPU_SET:
+        case ENGINE_OPTION_WORKER_CPU_SET:
+        case ENGINE_OPTION_RT_PRIORITY:
+        case ENGINE_OPTION_BRIDGE_LOCK_MEMORY:
+        case ENGINE_OPTION_SUB_BLOCK_GRANULARITY:
+        case ENGINE_OPTION_CV_EVENT_RESOLUTION:
+        case ENGINE_OPTION_WORKER_THREADS:
+        case ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+            pData->bridgePool.invalidate();
+            break;
+
         default:
             break;
         }
@@ -2198,6 +2386,76 @@ void CarlaEngine::setOption(const EngineOption option, const int value, const ch
         CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
         pData->options.pluginsAreStandalone = (value != 0);
         break;
+
+    case ENGINE_OPTION_PROJECT_BINARY_DATA:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.projectBinaryDataMinSize = static_cast<uint>(value);
+        break;
+
+    // discovery runs outside of the engine, these need to go through carla_plugin_discovery_set_option()
+    case ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS:
+    case ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH:
+        setLastError("Plugin discovery options must be set with carla_plugin_discovery_set_option()");
+        return carla_stderr("CarlaEngine::setOption(%i:%s, %i, \"%s\") - Not an engine option, ignored",
+                            option, EngineOption2Str(option), value, valueStr);
+
+    case ENGINE_OPTION_AUDIO_CPU_SET:
+        if (pData->options.audioCpuSet != nullptr)
+            delete[] pData->options.audioCpuSet;
+
+        pData->options.audioCpuSet = valueStr != nullptr && valueStr[0] != '\0'
+                                   ? carla_strdup_safe(valueStr)
+                                   : nullptr;
+        break;
+
+    case ENGINE_OPTION_WORKER_CPU_SET:
+        if (pData->options.workerCpuSet != nullptr)
+            delete[] pData->options.workerCpuSet;
+
+        pData->options.workerCpuSet = valueStr != nullptr && valueStr[0] != '\0'
+                                    ? carla_strdup_safe(valueStr)
+                                    : nullptr;
+        break;
+
+    case ENGINE_OPTION_RT_PRIORITY:
+        CARLA_SAFE_ASSERT_RETURN(value > -99 && value < 100,);
+        pData->options.rtPriority = value;
+        break;
+
+    case ENGINE_OPTION_BRIDGE_LOCK_MEMORY:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        pData->options.bridgeLockMemory = (value != 0);
+        break;
+
+    case ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.pluginSleepTimeout = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_SUB_BLOCK_GRANULARITY:
+        CARLA_SAFE_ASSERT_RETURN(value >= -1 && value <= 1024,);
+        pData->options.subBlockGranularity = value;
+        break;
+
+    case ENGINE_OPTION_CV_EVENT_RESOLUTION:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        pData->options.cvEventResolution = static_cast<uint>(value);
+        break;
+
+    case ENGINE_OPTION_WORKER_THREADS:
+        CARLA_SAFE_ASSERT_RETURN(value >= -1 && value <= 64,);
+        pData->options.workerThreads = value;
+        break;
+
+    case ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 64,);
+        pData->options.fluidSynthCpuCores = value;
+        break;
+
+    case ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0 && value <= 16,);
+        pData->options.pluginBridgePoolSize = static_cast<uint>(value);
+        break;
     }
 }
 
@@ -2249,6 +2507,7 @@ void CarlaEngine::bufferSizeChanged(const uint32_t newBufferSize)
 #endif
 
     pData->time.updateAudioValues(newBufferSize, pData->sampleRate);
+    pData->bridgePool.invalidate();
 
     for (uint i=0; i < pData->curPluginCount; ++i)
     {
@@ -2278,6 +2537,7 @@ void CarlaEngine::sampleRateChanged(const double newSampleRate)
 #endif
 
     pData->time.updateAudioValues(pData->bufferSize, newSampleRate);
+    pData->bridgePool.invalidate();
 
     for (uint i=0; i < pData->curPluginCount; ++i)
     {
@@ -2324,7 +2584,9 @@ void CarlaEngine::setPluginPeaksRT(const uint pluginId, float const inPeaks[2],
     pluginData.peaks[3] = outPeaks[1];
 }
 
-void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) const
+void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream,
+                                      CarlaStateExternalData* const externalData,
+                                      const bool onlyChangedPlugins)
 {
     // send initial prepareForSave first, giving time for bridges to act
     for (uint i=0; i < pData->curPluginCount; ++i)
@@ -2333,6 +2595,9 @@ void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) cons
         {
             if (plugin->isEnabled())
             {
+                if (onlyChangedPlugins && ! plugin->isStateChanged())
+                    continue;
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
                 // deactivate bridge client-side ping check, since some plugins block during save
                 if (plugin->getHints() & PLUGIN_IS_BRIDGE)
@@ -2343,6 +2608,41 @@ void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) cons
         }
     }
 
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+    // bridges are now saving concurrently, wait for all of them at once with a single timeout
+    {
+        const uint32_t timeoutEnd = carla_gettime_ms() + 60*1000; // 60 secs, 1 minute
+        const bool needsEngineIdle = getType() != kEngineTypePlugin;
+
+        for (bool pending = true; pending && carla_gettime_ms() < timeoutEnd;)
+        {
+            pending = false;
+
+            for (uint i=0; i < pData->curPluginCount; ++i)
+            {
+                if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+                {
+                    if (plugin->isEnabled() && plugin->isWaitingForBridgeSaveSignal())
+                    {
+                        pending = true;
+                        break;
+                    }
+                }
+            }
+
+            if (! pending)
+                break;
+
+            callback(true, true, ENGINE_CALLBACK_IDLE, 0, 0, 0, 0, 0.0f, nullptr);
+
+            if (needsEngineIdle)
+                idle();
+
+            carla_msleep(20);
+        }
+    }
+#endif
+
     outStream << "<?xml version='1.0' encoding='UTF-8'?>\n";
     outStream << "<!DOCTYPE CARLA-PROJECT>\n";
     outStream << "<CARLA-PROJECT VERSION='" CARLA_VERSION_STRMIN "'";
@@ -2408,7 +2708,9 @@ void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) cons
             if (plugin->isEnabled())
             {
                 MemoryOutputStream outPlugin(4096), streamPlugin;
-                plugin->getStateSave(false).dumpToMemoryStream(streamPlugin);
+
+                if (! onlyChangedPlugins)
+                    plugin->getStateSave(false).dumpToMemoryStream(streamPlugin, externalData);
 
                 outPlugin << "\n";
 
@@ -2416,7 +2718,12 @@ void CarlaEngine::saveProjectInternal(water::MemoryOutputStream& outStream) cons
                     outPlugin << " <!-- " << xmlSafeString(strBuf, true) << " -->\n";
 
                 outPlugin << " <Plugin>\n";
-                outPlugin << streamPlugin;
+
+                if (onlyChangedPlugins)
+                    outPlugin << plugin->getStateSaveXml();
+                else
+                    outPlugin << streamPlugin;
+
                 outPlugin << " </Plugin>\n";
                 outStream << outPlugin;
             }
@@ -2652,7 +2959,8 @@ static String findBinaryInCustomPath(const char* const searchPath, const char* c
     return String();
 }
 
-bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alwaysLoadConnections)
+bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alwaysLoadConnections,
+                                      const CarlaStateExternalData* const externalData)
 {
     carla_debug("CarlaEngine::loadProjectInternal(%p, %s) - START", &xmlDoc, bool2str(alwaysLoadConnections));
 
@@ -2873,7 +3181,7 @@ bool CarlaEngine::loadProjectInternal(water::XmlDocument& xmlDoc, const bool alw
         if (isPreset || tagName == "Plugin")
         {
             CarlaStateSave stateSave;
-            stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem);
+            stateSave.fillFromXmlElement(isPreset ? xmlElement.get() : elem, externalData);
 
             if (pData->aboutToClose)
                 return true;
@@ -18,6 +18,7 @@
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
 #include "CarlaBridgeUtils.hpp"
+#include "CarlaProcessUtils.hpp"
 #include "CarlaTimeUtils.hpp"
 #include "CarlaMIDI.h"
 
@@ -67,8 +68,8 @@ protected:
         if (getLatency() == samples)
             return;
 
-        fLatencyCallback->latencyChanged(samples);
         CarlaEngineClient::setLatency(samples);
+        fLatencyCallback->latencyChanged(samples);
     }
 
 private:
@@ -134,7 +135,11 @@ public:
           fIsOffline(false),
           fFirstIdle(true),
           fBridgeVersion(0),
-          fLastPingTime(UINT32_MAX)
+          fLastPingTime(UINT32_MAX),
+          fGroupMutex(),
+          fGroupBuffer(),
+          fGroupMaxAudioOuts(0),
+          fGroupPluginCount(0)
     {
         carla_debug("CarlaEngineBridge::CarlaEngineBridge(\"%s\", \"%s\", \"%s\", \"%s\")", audioPoolBaseName, rtClientBaseName, nonRtClientBaseName, nonRtServerBaseName);
     }
@@ -275,6 +280,10 @@ public:
             fShmNonRtServerControl.commitWrite();
         }
 
+        if (pData->options.bridgeLockMemory)
+            carla_lockProcessMemory();
+
+        setThreadPolicy(getRealtimePriority(), pData->options.audioCpuSet);
         startThread(true);
         return true;
     }
@@ -322,11 +331,11 @@ public:
 
     void touchPluginParameter(const uint id, const uint32_t parameterId, const bool touch) noexcept override
     {
-        CARLA_SAFE_ASSERT_RETURN(id == 0,);
+        CARLA_SAFE_ASSERT_RETURN(id < pData->curPluginCount,);
 
         const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
         fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterTouch);
-        fShmNonRtServerControl.writeUInt(parameterId);
+        fShmNonRtServerControl.writeUInt(getGroupParameterOffset(id) + parameterId);
         fShmNonRtServerControl.writeBool(touch);
         fShmNonRtServerControl.commitWrite();
     }
@@ -349,6 +358,15 @@ public:
 
         if (plugin.get() == nullptr)
         {
+            // started ahead of time by the host, which loads the plugin later through kPluginBridgeNonRtClientAddGroupPlugin
+            if (fFirstIdle && pData->lastError.isEmpty())
+            {
+                try {
+                    handleNonRtDataWithoutPlugin();
+                } CARLA_SAFE_EXCEPTION("handleNonRtDataWithoutPlugin");
+                return;
+            }
+
             if (const uint32_t length = static_cast<uint32_t>(pData->lastError.length()))
             {
                 const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
@@ -375,7 +393,13 @@ public:
 
             uint32_t bufStrSize;
 
+            // a group is seen as a single plugin, with the inputs of the first one and the outputs of the last
+            const uint pluginCount = pData->curPluginCount;
+            const CarlaPluginPtr lastPlugin = pData->plugins[pluginCount - 1].plugin;
+            CARLA_SAFE_ASSERT_RETURN(lastPlugin.get() != nullptr,);
+
             const CarlaEngineClient* const client(plugin->getEngineClient());
+            const CarlaEngineClient* const lastClient(lastPlugin->getEngineClient());
             const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
 
             // kPluginBridgeNonRtServerPluginInfo1
@@ -427,7 +451,7 @@ public:
             // kPluginBridgeNonRtServerAudioCount
             {
                 const uint32_t aIns  = plugin->getAudioInCount();
-                const uint32_t aOuts = plugin->getAudioOutCount();
+                const uint32_t aOuts = lastPlugin->getAudioOutCount();
 
                 // uint/ins, uint/outs
                 fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerAudioCount);
@@ -454,7 +478,7 @@ public:
                 // kPluginBridgeNonRtServerPortName
                 for (uint32_t i=0; i<aOuts; ++i)
                 {
-                    const char* const portName(client->getAudioPortName(false, i));
+                    const char* const portName(lastClient->getAudioPortName(false, i));
                     CARLA_SAFE_ASSERT_CONTINUE(portName != nullptr && portName[0] != '\0');
 
                     // byte/type, uint/index, uint/size, str[] (name)
@@ -475,7 +499,7 @@ public:
                 // uint/ins, uint/outs
                 fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerMidiCount);
                 fShmNonRtServerControl.writeUInt(plugin->getMidiInCount());
-                fShmNonRtServerControl.writeUInt(plugin->getMidiOutCount());
+                fShmNonRtServerControl.writeUInt(lastPlugin->getMidiOutCount());
                 fShmNonRtServerControl.commitWrite();
             }
 
@@ -486,14 +510,14 @@ public:
                 // uint/ins, uint/outs
                 fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerCvCount);
                 fShmNonRtServerControl.writeUInt(plugin->getCVInCount());
-                fShmNonRtServerControl.writeUInt(plugin->getCVOutCount());
+                fShmNonRtServerControl.writeUInt(lastPlugin->getCVOutCount());
                 fShmNonRtServerControl.commitWrite();
             }
 
             fShmNonRtServerControl.waitIfDataIsReachingLimit();
 
             // kPluginBridgeNonRtServerParameter*
-            if (const uint32_t count = plugin->getParameterCount())
+            if (const uint32_t count = getGroupParameterOffset(pluginCount))
             {
                 // uint/count
                 fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterCount);
@@ -502,7 +526,11 @@ public:
 
                 for (uint32_t i=0; i<count; ++i)
                 {
-                    const ParameterData& paramData(plugin->getParameterData(i));
+                    uint32_t rindex = i;
+                    const CarlaPluginPtr paramPlugin = getGroupPluginForParameter(rindex);
+                    CARLA_SAFE_ASSERT_BREAK(paramPlugin.get() != nullptr);
+
+                    const ParameterData& paramData(paramPlugin->getParameterData(rindex));
 
                     if (paramData.type != PARAMETER_INPUT && paramData.type != PARAMETER_OUTPUT)
                         continue;
@@ -527,19 +555,32 @@ public:
                         fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterData2);
                         fShmNonRtServerControl.writeUInt(i);
 
-                        if (! plugin->getParameterName(i, bufStr))
-                            std::snprintf(bufStr, STR_MAX, "Param %u", i+1);
+                        if (! paramPlugin->getParameterName(rindex, bufStr))
+                            std::snprintf(bufStr, STR_MAX, "Param %u", rindex+1);
+
+                        // prefix names and symbols with the group position, so they stay unique
+                        if (pluginCount > 1)
+                            prefixGroupParameterString(paramPlugin->getId(), ": ", bufStr);
                         bufStrSize = carla_fixedValue(1U, 32U, static_cast<uint32_t>(std::strlen(bufStr)));
                         fShmNonRtServerControl.writeUInt(bufStrSize);
                         fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
 
-                        if (! plugin->getParameterSymbol(i, bufStr))
+                        if (paramPlugin->getId() != 0)
+                        {
+                            // parameters of other plugins always get a symbol, so they can be found on restore
+                            if (! paramPlugin->getParameterSymbol(rindex, bufStr) || bufStr[0] == '\0')
+                                std::snprintf(bufStr, STR_MAX, "%u", rindex);
+                            prefixGroupParameterString(paramPlugin->getId(), ":", bufStr);
+                        }
+                        else if (! paramPlugin->getParameterSymbol(rindex, bufStr))
+                        {
                             bufStr[0] = '\0';
+                        }
                         bufStrSize = carla_fixedValue(1U, 64U, static_cast<uint32_t>(std::strlen(bufStr)));
                         fShmNonRtServerControl.writeUInt(bufStrSize);
                         fShmNonRtServerControl.writeCustomData(bufStr, bufStrSize);
 
-                        if (! plugin->getParameterUnit(i, bufStr))
+                        if (! paramPlugin->getParameterUnit(rindex, bufStr))
                             bufStr[0] = '\0';
                         bufStrSize = carla_fixedValue(1U, 32U, static_cast<uint32_t>(std::strlen(bufStr)));
                         fShmNonRtServerControl.writeUInt(bufStrSize);
@@ -550,7 +591,7 @@ public:
 
                     // kPluginBridgeNonRtServerParameterRanges
                     {
-                        const ParameterRanges& paramRanges(plugin->getParameterRanges(i));
+                        const ParameterRanges& paramRanges(paramPlugin->getParameterRanges(rindex));
 
                         // uint/index, float/def, float/min, float/max, float/step, float/stepSmall, float/stepLarge
                         fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterRanges);
@@ -569,7 +610,7 @@ public:
                         // uint/index float/value (used for init/output parameters only, don't resend values)
                         fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterValue2);
                         fShmNonRtServerControl.writeUInt(i);
-                        fShmNonRtServerControl.writeFloat(plugin->getParameterValue(i));
+                        fShmNonRtServerControl.writeFloat(paramPlugin->getParameterValue(rindex));
                         fShmNonRtServerControl.commitWrite();
                     }
 
@@ -630,7 +671,7 @@ public:
                 }
             }
 
-            if (const uint32_t latency = plugin->getLatencyInFrames())
+            if (const uint32_t latency = pluginCount > 1 ? getGroupLatency() : plugin->getLatencyInFrames())
             {
                 fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetLatency);
                 fShmNonRtServerControl.writeUInt(latency);
@@ -647,23 +688,40 @@ public:
         }
 
         // send parameter outputs
-        if (const uint32_t count = plugin->getParameterCount())
+        for (uint i=0, offset=0; i < pData->curPluginCount; ++i)
         {
+            const CarlaPluginPtr groupPlugin = pData->plugins[i].plugin;
+            CARLA_SAFE_ASSERT_BREAK(groupPlugin.get() != nullptr);
+
+            const uint32_t count = groupPlugin->getParameterCount();
+
+            if (count == 0)
+                continue;
+
             const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+            bool full = false;
 
-            for (uint32_t i=0; i < count; ++i)
+            for (uint32_t j=0; j < count; ++j)
             {
-                if (! plugin->isParameterOutput(i))
+                if (! groupPlugin->isParameterOutput(j))
                     continue;
 
                 fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterValue2);
-                fShmNonRtServerControl.writeUInt(i);
-                fShmNonRtServerControl.writeFloat(plugin->getParameterValue(i));
+                fShmNonRtServerControl.writeUInt(offset + j);
+                fShmNonRtServerControl.writeFloat(groupPlugin->getParameterValue(j));
 
                 // parameter outputs are not that important, we can skip some
                 if (! fShmNonRtServerControl.commitWrite())
+                {
+                    full = true;
                     break;
+                }
             }
+
+            if (full)
+                break;
+
+            offset += count;
         }
 
         CarlaEngine::idle();
@@ -690,6 +748,13 @@ public:
         if (fClosingDown || ! sendHost)
             return;
 
+        // other plugins of a group only report their parameters
+        if (pluginId != 0 &&
+            action != ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED &&
+            action != ENGINE_CALLBACK_PARAMETER_DEFAULT_CHANGED &&
+            action != ENGINE_CALLBACK_RELOAD_PARAMETERS)
+            return;
+
         switch (action)
         {
         // uint/index float/value
@@ -697,7 +762,7 @@ public:
             CARLA_SAFE_ASSERT_BREAK(value1 >= 0);
             const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
             fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterValue);
-            fShmNonRtServerControl.writeUInt(static_cast<uint>(value1));
+            fShmNonRtServerControl.writeUInt(getGroupParameterOffset(pluginId) + static_cast<uint>(value1));
             fShmNonRtServerControl.writeFloat(valuef);
             fShmNonRtServerControl.commitWrite();
         }   break;
@@ -707,7 +772,7 @@ public:
             CARLA_SAFE_ASSERT_BREAK(value1 >= 0);
             const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
             fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerDefaultValue);
-            fShmNonRtServerControl.writeUInt(static_cast<uint>(value1));
+            fShmNonRtServerControl.writeUInt(getGroupParameterOffset(pluginId) + static_cast<uint>(value1));
             fShmNonRtServerControl.writeFloat(valuef);
             fShmNonRtServerControl.commitWrite();
         }   break;
@@ -752,10 +817,14 @@ public:
         }   break;
 
         case ENGINE_CALLBACK_RELOAD_PARAMETERS:
-            if (const CarlaPluginPtr plugin = pData->plugins[0].plugin)
+            if (pluginId >= pData->curPluginCount)
+                break;
+
+            if (const CarlaPluginPtr plugin = pData->plugins[pluginId].plugin)
             {
                 if (const uint32_t count = plugin->getParameterCount())
                 {
+                    const uint32_t offset = getGroupParameterOffset(pluginId);
                     const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
 
                     for (uint32_t i=0; i<count; ++i)
@@ -768,7 +837,7 @@ public:
                             continue;
 
                         fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerParameterValue);
-                        fShmNonRtServerControl.writeUInt(i);
+                        fShmNonRtServerControl.writeUInt(offset + i);
                         fShmNonRtServerControl.writeFloat(plugin->getParameterValue(i));
                         fShmNonRtServerControl.commitWrite();
 
@@ -793,6 +862,211 @@ public:
         fShmNonRtServerControl.clear();
     }
 
+    // -------------------------------------------------------------------
+    // Plugin groups
+    //
+    // Plugins added through kPluginBridgeNonRtClientAddGroupPlugin run in series after the first one.
+    // The host sees the whole group as a single plugin, with the parameters of all plugins concatenated.
+
+    // find the plugin a host-side parameter index belongs to, changing @a index into the plugin-side one
+    CarlaPluginPtr getGroupPluginForParameter(uint32_t& index) const noexcept
+    {
+        for (uint i=0; i < pData->curPluginCount; ++i)
+        {
+            const CarlaPluginPtr plugin = pData->plugins[i].plugin;
+            CARLA_SAFE_ASSERT_BREAK(plugin.get() != nullptr);
+
+            const uint32_t count = plugin->getParameterCount();
+
+            if (index < count)
+                return plugin;
+
+            index -= count;
+        }
+
+        return CarlaPluginPtr();
+    }
+
+    // host-side index of the first parameter of plugin @a id
+    uint32_t getGroupParameterOffset(const uint id) const noexcept
+    {
+        uint32_t offset = 0;
+
+        for (uint i=0; i < id && i < pData->curPluginCount; ++i)
+        {
+            if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+                offset += plugin->getParameterCount();
+        }
+
+        return offset;
+    }
+
+    uint32_t getGroupLatency() const noexcept
+    {
+        uint32_t latency = 0;
+
+        for (uint i=0; i < pData->curPluginCount; ++i)
+        {
+            if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+                if (const CarlaEngineClient* const client = plugin->getEngineClient())
+                    latency += client->getLatency();
+        }
+
+        return latency;
+    }
+
+    static void prefixGroupParameterString(const uint id, const char* const separator, char* const bufStr) noexcept
+    {
+        char tmpBuf[STR_MAX+1];
+        std::snprintf(tmpBuf, STR_MAX, "%u%s%s", id + 1, separator, bufStr);
+        tmpBuf[STR_MAX] = '\0';
+        std::memcpy(bufStr, tmpBuf, std::strlen(tmpBuf) + 1);
+    }
+
+    // find the plugin custom data belongs to, removing the group prefix from @a key
+    CarlaPluginPtr getGroupPluginForCustomData(const char*& key, bool& isChunk) const noexcept
+    {
+        uint index = 0;
+        isChunk = false;
+
+        if (std::strncmp(key, "__CarlaBridgeGroup", 18) == 0)
+        {
+            const char* indexStr = key + 18;
+
+            if (std::strncmp(indexStr, "Chunk", 5) == 0)
+            {
+                isChunk = true;
+                indexStr += 5;
+            }
+
+            char* end = nullptr;
+            const long value = std::strtol(indexStr, &end, 10);
+
+            if (end != indexStr && value > 0 && std::strncmp(end, "__", 2) == 0)
+            {
+                index = static_cast<uint>(value);
+                key = end + 2;
+            }
+            else
+            {
+                isChunk = false;
+            }
+        }
+
+        if (index >= pData->curPluginCount)
+            return CarlaPluginPtr();
+
+        return pData->plugins[index].plugin;
+    }
+
+    static void setGroupPluginCustomData(const CarlaPluginPtr& plugin, const bool isChunk,
+                                         const char* const type, const char* const key, const char* const value)
+    {
+        if (! isChunk)
+        {
+            plugin->setCustomData(type, key, value, true);
+            return;
+        }
+
+        CARLA_SAFE_ASSERT_RETURN(value[0] != '\0',);
+
+        std::vector<uint8_t> chunk(carla_getChunkFromBase64String(value));
+        CARLA_SAFE_ASSERT_RETURN(chunk.size() > 0,);
+
+#ifdef CARLA_PROPER_CPP11_SUPPORT
+        plugin->setChunkData(chunk.data(), chunk.size());
+#else
+        plugin->setChunkData(&chunk.front(), chunk.size());
+#endif
+    }
+
+    // scratch buffers for running a group, audio outputs of the intermediate plugins plus zero and discard buffers
+    // also publishes the current plugin count to processGroup(), together with the buffers
+    void resizeGroupBuffers() noexcept
+    {
+        const uint pluginCount = pData->curPluginCount;
+        uint32_t maxAudioOuts = 0;
+
+        if (pluginCount > 1)
+        {
+            for (uint i=0; i < pluginCount; ++i)
+            {
+                if (const CarlaPluginPtr plugin = pData->plugins[i].plugin)
+                    maxAudioOuts = std::max(maxAudioOuts, std::min(plugin->getAudioOutCount(), 64U));
+            }
+        }
+
+        std::vector<float> buffer;
+
+        try {
+            if (pluginCount > 1)
+                buffer.resize((2 * maxAudioOuts + 2) * pData->bufferSize);
+        } CARLA_SAFE_EXCEPTION_RETURN("resizeGroupBuffers",);
+
+        {
+            const CarlaMutexLocker cml(fGroupMutex);
+
+            fGroupBuffer.swap(buffer);
+            fGroupMaxAudioOuts = maxAudioOuts;
+            fGroupPluginCount = pluginCount;
+        }
+
+        // the previous buffer is freed here, after unlocking
+    }
+
+    void sendCustomData(const char* const type, const char* const key, const char* const value,
+                        const uint32_t maxLocalValueLen)
+    {
+        const uint32_t typeLen  = static_cast<uint32_t>(std::strlen(type));
+        const uint32_t keyLen   = static_cast<uint32_t>(std::strlen(key));
+        const uint32_t valueLen = static_cast<uint32_t>(std::strlen(value));
+
+        const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+
+        if (valueLen > maxLocalValueLen)
+            fShmNonRtServerControl.waitIfDataIsReachingLimit();
+
+        fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetCustomData);
+
+        fShmNonRtServerControl.writeUInt(typeLen);
+        fShmNonRtServerControl.writeCustomData(type, typeLen);
+
+        fShmNonRtServerControl.writeUInt(keyLen);
+        fShmNonRtServerControl.writeCustomData(key, keyLen);
+
+        fShmNonRtServerControl.writeUInt(valueLen);
+
+        if (valueLen > 0)
+        {
+            if (valueLen > maxLocalValueLen)
+            {
+                String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
+
+                filePath += CARLA_OS_SEP_STR ".CarlaCustomData_";
+                filePath += fShmAudioPool.getFilenameSuffix();
+
+                if (File(filePath.toRawUTF8()).replaceWithText(value))
+                {
+                    const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
+
+                    fShmNonRtServerControl.writeUInt(ulength);
+                    fShmNonRtServerControl.writeCustomData(filePath.toRawUTF8(), ulength);
+                }
+                else
+                {
+                    fShmNonRtServerControl.writeUInt(0);
+                }
+            }
+            else
+            {
+                fShmNonRtServerControl.writeCustomData(value, valueLen);
+            }
+        }
+
+        fShmNonRtServerControl.commitWrite();
+        fShmNonRtServerControl.waitIfDataIsReachingLimit();
+    }
+
     void handleNonRtData()
     {
         const CarlaPluginPtr plugin = pData->plugins[0].plugin;
@@ -836,13 +1110,15 @@ public:
                 break;
 
             case kPluginBridgeNonRtClientActivate:
-                if (plugin->isEnabled())
-                    plugin->setActive(true, false, false);
-                break;
-
             case kPluginBridgeNonRtClientDeactivate:
-                if (plugin->isEnabled())
-                    plugin->setActive(false, false, false);
+                for (uint i=0; i < pData->curPluginCount; ++i)
+                {
+                    const CarlaPluginPtr groupPlugin = pData->plugins[i].plugin;
+                    CARLA_SAFE_ASSERT_CONTINUE(groupPlugin.get() != nullptr);
+
+                    if (groupPlugin->isEnabled())
+                        groupPlugin->setActive(opcode == kPluginBridgeNonRtClientActivate, false, false);
+                }
                 break;
 
             case kPluginBridgeNonRtClientInitialSetup:
@@ -852,39 +1128,47 @@ public:
                 break;
 
             case kPluginBridgeNonRtClientSetParameterValue: {
-                const uint32_t index(fShmNonRtClientControl.readUInt());
+                uint32_t index(fShmNonRtClientControl.readUInt());
                 const float    value(fShmNonRtClientControl.readFloat());
 
-                if (plugin->isEnabled())
-                    plugin->setParameterValue(index, value, false, false, false);
+                const CarlaPluginPtr paramPlugin = getGroupPluginForParameter(index);
+
+                if (paramPlugin.get() != nullptr && paramPlugin->isEnabled())
+                    paramPlugin->setParameterValue(index, value, false, false, false);
                 break;
             }
 
             case kPluginBridgeNonRtClientSetParameterMidiChannel: {
-                const uint32_t index(fShmNonRtClientControl.readUInt());
+                uint32_t index(fShmNonRtClientControl.readUInt());
                 const uint8_t  channel(fShmNonRtClientControl.readByte());
 
-                if (plugin->isEnabled())
-                    plugin->setParameterMidiChannel(index, channel, false, false);
+                const CarlaPluginPtr paramPlugin = getGroupPluginForParameter(index);
+
+                if (paramPlugin.get() != nullptr && paramPlugin->isEnabled())
+                    paramPlugin->setParameterMidiChannel(index, channel, false, false);
                 break;
             }
 
             case kPluginBridgeNonRtClientSetParameterMappedControlIndex: {
-                const uint32_t index(fShmNonRtClientControl.readUInt());
+                uint32_t index(fShmNonRtClientControl.readUInt());
                 const int16_t  ctrl(fShmNonRtClientControl.readShort());
 
-                if (plugin->isEnabled())
-                    plugin->setParameterMappedControlIndex(index, ctrl, false, false, true);
+                const CarlaPluginPtr paramPlugin = getGroupPluginForParameter(index);
+
+                if (paramPlugin.get() != nullptr && paramPlugin->isEnabled())
+                    paramPlugin->setParameterMappedControlIndex(index, ctrl, false, false, true);
                 break;
             }
 
             case kPluginBridgeNonRtClientSetParameterMappedRange: {
-                const uint32_t index   = fShmNonRtClientControl.readUInt();
+                uint32_t index         = fShmNonRtClientControl.readUInt();
                 const float    minimum = fShmNonRtClientControl.readFloat();
                 const float    maximum = fShmNonRtClientControl.readFloat();
 
-                if (plugin->isEnabled())
-                    plugin->setParameterMappedRange(index, minimum, maximum, false, false);
+                const CarlaPluginPtr paramPlugin = getGroupPluginForParameter(index);
+
+                if (paramPlugin.get() != nullptr && paramPlugin->isEnabled())
+                    paramPlugin->setParameterMappedRange(index, minimum, maximum, false, false);
                 break;
             }
 
@@ -913,6 +1197,12 @@ public:
                 // key
                 const BridgeTextReader key(fShmNonRtClientControl);
 
+                // data of other plugins of a group has their group position as key prefix
+                const char* dataKey = key.text;
+                bool isChunk = false;
+                const CarlaPluginPtr dataPlugin = getGroupPluginForCustomData(dataKey, isChunk);
+                const bool dataPluginEnabled = dataPlugin.get() != nullptr && dataPlugin->isEnabled();
+
                 // value
                 const uint32_t valueSize = fShmNonRtClientControl.readUInt();
 
@@ -923,7 +1213,7 @@ public:
                         const BridgeTextReader bigValueFilePathTry(fShmNonRtClientControl);
 
                         CARLA_SAFE_ASSERT_BREAK(bigValueFilePathTry.text[0] != '\0');
-                        if (! plugin->isEnabled()) break;
+                        if (! dataPluginEnabled) break;
 
                         String bigValueFilePath(bigValueFilePathTry.text);
 
@@ -936,7 +1226,8 @@ public:
                         File bigValueFile(bigValueFilePath.toRawUTF8());
                         CARLA_SAFE_ASSERT_BREAK(bigValueFile.existsAsFile());
 
-                        plugin->setCustomData(type.text, key.text, bigValueFile.loadFileAsString().toRawUTF8(), true);
+                        setGroupPluginCustomData(dataPlugin, isChunk, type.text, dataKey,
+                                                 bigValueFile.loadFileAsString().toRawUTF8());
 
                         bigValueFile.deleteFile();
                     }
@@ -944,14 +1235,14 @@ public:
                     {
                         const BridgeTextReader value(fShmNonRtClientControl, valueSize);
 
-                        if (plugin->isEnabled())
-                            plugin->setCustomData(type.text, key.text, value.text, true);
+                        if (dataPluginEnabled)
+                            setGroupPluginCustomData(dataPlugin, isChunk, type.text, dataKey, value.text);
                     }
                 }
                 else
                 {
-                    if (plugin->isEnabled())
-                        plugin->setCustomData(type.text, key.text, "", true);
+                    if (dataPluginEnabled)
+                        setGroupPluginCustomData(dataPlugin, isChunk, type.text, dataKey, "");
                 }
 
                 break;
@@ -995,8 +1286,14 @@ public:
                 const int16_t channel(fShmNonRtClientControl.readShort());
                 CARLA_SAFE_ASSERT_BREAK(channel >= -1 && channel < MAX_MIDI_CHANNELS);
 
-                if (plugin->isEnabled())
-                    plugin->setCtrlChannel(static_cast<int8_t>(channel), false, false);
+                for (uint i=0; i < pData->curPluginCount; ++i)
+                {
+                    const CarlaPluginPtr groupPlugin = pData->plugins[i].plugin;
+                    CARLA_SAFE_ASSERT_CONTINUE(groupPlugin.get() != nullptr);
+
+                    if (groupPlugin->isEnabled())
+                        groupPlugin->setCtrlChannel(static_cast<int8_t>(channel), false, false);
+                }
                 break;
             }
 
@@ -1026,11 +1323,14 @@ public:
             case kPluginBridgeNonRtClientGetParameterText: {
                 const int32_t index = fShmNonRtClientControl.readInt();
 
-                if (index >= 0 && plugin->isEnabled())
+                uint32_t rindex = static_cast<uint32_t>(index);
+                const CarlaPluginPtr paramPlugin = index >= 0 ? getGroupPluginForParameter(rindex) : CarlaPluginPtr();
+
+                if (paramPlugin.get() != nullptr && paramPlugin->isEnabled())
                 {
                     char bufStr[STR_MAX+1];
                     carla_zeroChars(bufStr, STR_MAX+1);
-                    if (! plugin->getParameterText(static_cast<uint32_t>(index), bufStr))
+                    if (! paramPlugin->getParameterText(rindex, bufStr))
                         bufStr[0] = '\0';
 
                     const uint32_t bufStrLen = static_cast<uint32_t>(std::strlen(bufStr));
@@ -1079,55 +1379,50 @@ public:
                     if (std::strcmp(cdata.type, CUSTOM_DATA_TYPE_PROPERTY) == 0)
                         continue;
 
-                    const uint32_t typeLen  = static_cast<uint32_t>(std::strlen(cdata.type));
-                    const uint32_t keyLen   = static_cast<uint32_t>(std::strlen(cdata.key));
-                    const uint32_t valueLen = static_cast<uint32_t>(std::strlen(cdata.value));
+                    sendCustomData(cdata.type, cdata.key, cdata.value, maxLocalValueLen);
+                }
 
-                    {
-                        const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+                // data of other plugins of a group, with their group position as key prefix
+                for (uint i=1; i < pData->curPluginCount; ++i)
+                {
+                    const CarlaPluginPtr groupPlugin = pData->plugins[i].plugin;
+                    CARLA_SAFE_ASSERT_CONTINUE(groupPlugin.get() != nullptr);
+
+                    if (! groupPlugin->isEnabled())
+                        continue;
 
-                        if (valueLen > maxLocalValueLen)
-                            fShmNonRtServerControl.waitIfDataIsReachingLimit();
+                    groupPlugin->prepareForSave(false);
 
-                        fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetCustomData);
+                    char keyPrefix[STR_MAX+1];
+                    std::snprintf(keyPrefix, STR_MAX, "__CarlaBridgeGroup%u__", i);
+                    keyPrefix[STR_MAX] = '\0';
 
-                        fShmNonRtServerControl.writeUInt(typeLen);
-                        fShmNonRtServerControl.writeCustomData(cdata.type, typeLen);
+                    for (uint32_t j=0, count=groupPlugin->getCustomDataCount(); j<count; ++j)
+                    {
+                        const CustomData& cdata(groupPlugin->getCustomData(j));
 
-                        fShmNonRtServerControl.writeUInt(keyLen);
-                        fShmNonRtServerControl.writeCustomData(cdata.key, keyLen);
+                        if (std::strcmp(cdata.type, CUSTOM_DATA_TYPE_PROPERTY) == 0)
+                            continue;
 
-                        fShmNonRtServerControl.writeUInt(valueLen);
+                        CarlaString key(keyPrefix);
+                        key += cdata.key;
 
-                        if (valueLen > 0)
+                        sendCustomData(cdata.type, key, cdata.value, maxLocalValueLen);
+                    }
+
+                    if (groupPlugin->getOptionsEnabled() & PLUGIN_OPTION_USE_CHUNKS)
+                    {
+                        void* data = nullptr;
+                        if (const std::size_t dataSize = groupPlugin->getChunkData(&data))
                         {
-                            if (valueLen > maxLocalValueLen)
-                            {
-                                String filePath(File::getSpecialLocation(File::tempDirectory).getFullPathName());
-
-                                filePath += CARLA_OS_SEP_STR ".CarlaCustomData_";
-                                filePath += fShmAudioPool.getFilenameSuffix();
-
-                                if (File(filePath.toRawUTF8()).replaceWithText(cdata.value))
-                                {
-                                    const uint32_t ulength(static_cast<uint32_t>(filePath.length()));
-
-                                    fShmNonRtServerControl.writeUInt(ulength);
-                                    fShmNonRtServerControl.writeCustomData(filePath.toRawUTF8(), ulength);
-                                }
-                                else
-                                {
-                                    fShmNonRtServerControl.writeUInt(0);
-                                }
-                            }
-                            else
-                            {
-                                fShmNonRtServerControl.writeCustomData(cdata.value, valueLen);
-                            }
-                        }
+                            CARLA_SAFE_ASSERT_CONTINUE(data != nullptr);
 
-                        fShmNonRtServerControl.commitWrite();
-                        fShmNonRtServerControl.waitIfDataIsReachingLimit();
+                            std::snprintf(keyPrefix, STR_MAX, "__CarlaBridgeGroupChunk%u__", i);
+                            keyPrefix[STR_MAX] = '\0';
+
+                            const CarlaString dataBase64(CarlaString::asBase64(data, dataSize));
+                            sendCustomData(CUSTOM_DATA_TYPE_CHUNK, keyPrefix, dataBase64, maxLocalValueLen);
+                        }
                     }
                 }
 
@@ -1170,8 +1465,17 @@ public:
             }
 
             case kPluginBridgeNonRtClientRestoreLV2State:
-                if (plugin->isEnabled())
-                    plugin->restoreLV2State(false);
+                for (uint i=0; i < pData->curPluginCount; ++i)
+                {
+                    const CarlaPluginPtr groupPlugin = pData->plugins[i].plugin;
+                    CARLA_SAFE_ASSERT_CONTINUE(groupPlugin.get() != nullptr);
+
+                    if (groupPlugin->getType() != PLUGIN_LV2)
+                        continue;
+
+                    if (groupPlugin->isEnabled())
+                        groupPlugin->restoreLV2State(false);
+                }
                 break;
 
             case kPluginBridgeNonRtClientShowUI:
@@ -1203,11 +1507,13 @@ public:
             }
 
             case kPluginBridgeNonRtClientUiParameterChange: {
-                const uint32_t index = fShmNonRtClientControl.readUInt();
+                uint32_t       index = fShmNonRtClientControl.readUInt();
                 const float    value = fShmNonRtClientControl.readFloat();
 
-                if (plugin->isEnabled())
-                    plugin->uiParameterChange(index, value);
+                const CarlaPluginPtr paramPlugin = getGroupPluginForParameter(index);
+
+                if (paramPlugin.get() != nullptr && paramPlugin->isEnabled())
+                    paramPlugin->uiParameterChange(index, value);
                 break;
             }
 
@@ -1255,10 +1561,107 @@ public:
             case kPluginBridgeNonRtClientReload:
                 fFirstIdle = true;
                 break;
+
+            case kPluginBridgeNonRtClientAddGroupPlugin:
+                handleAddGroupPlugin();
+                break;
             }
         }
     }
 
+    // a bridge started ahead of time only takes a few messages until its plugin is loaded
+    void handleNonRtDataWithoutPlugin()
+    {
+        for (; fShmNonRtClientControl.isDataAvailableForReading();)
+        {
+            const PluginBridgeNonRtClientOpcode opcode = fShmNonRtClientControl.readOpcode();
+
+            switch (opcode)
+            {
+            case kPluginBridgeNonRtClientNull:
+                break;
+
+            case kPluginBridgeNonRtClientPing: {
+                const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+
+                fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerPong);
+                fShmNonRtServerControl.commitWrite();
+            }   break;
+
+            case kPluginBridgeNonRtClientPingOnOff:
+                fLastPingTime = fShmNonRtClientControl.readBool() ? carla_gettime_ms() : UINT32_MAX;
+                break;
+
+            case kPluginBridgeNonRtClientQuit:
+                fClosingDown = true;
+                signalThreadShouldExit();
+                callback(true, true, ENGINE_CALLBACK_QUIT, 0, 0, 0, 0, 0.0f, nullptr);
+                break;
+
+            case kPluginBridgeNonRtClientAddGroupPlugin:
+                handleAddGroupPlugin();
+
+                // everything else is handled with the plugin in place
+                if (pData->curPluginCount != 0)
+                    return;
+                break;
+
+            default:
+                carla_stderr2("CarlaEngineBridge::handleNonRtDataWithoutPlugin() - unexpected opcode %i:%s",
+                              opcode, PluginBridgeNonRtClientOpcode2str(opcode));
+                return;
+            }
+        }
+    }
+
+    void handleAddGroupPlugin()
+    {
+        // uint/type, uint/size, str[] (filename), uint/size, str[] (label), long/uniqueId
+        const uint32_t ptype = fShmNonRtClientControl.readUInt();
+
+        // filename
+        const uint32_t filenameSize = fShmNonRtClientControl.readUInt();
+        const BridgeTextReader filename(fShmNonRtClientControl, filenameSize);
+
+        // label
+        const uint32_t labelSize = fShmNonRtClientControl.readUInt();
+        const BridgeTextReader label(fShmNonRtClientControl, labelSize);
+
+        const int64_t uniqueId = fShmNonRtClientControl.readLong();
+
+        if (addPlugin(BINARY_NATIVE, static_cast<PluginType>(ptype),
+                      filenameSize != 0 ? filename.text : nullptr, nullptr,
+                      labelSize != 0 ? label.text : nullptr,
+                      uniqueId, nullptr, PLUGIN_OPTIONS_NULL))
+        {
+            const CarlaPluginPtr plugin = pData->plugins[0].plugin;
+            const CarlaPluginPtr newPlugin = pData->plugins[pData->curPluginCount - 1].plugin;
+            CARLA_SAFE_ASSERT_RETURN(plugin.get() != nullptr && newPlugin.get() != nullptr,);
+
+            newPlugin->setActive(plugin->getInternalParameterValue(PARAMETER_ACTIVE) >= 0.5f, false, false);
+            resizeGroupBuffers();
+
+            // the host waits for the updated plugin info
+            fFirstIdle = true;
+            return;
+        }
+
+        if (pData->lastError.isEmpty())
+            setLastError("Failed to add plugin to the bridge");
+
+        // without a plugin, idle() reports the error and closes the bridge
+        if (pData->curPluginCount == 0)
+            return;
+
+        const uint32_t errorSize = static_cast<uint32_t>(pData->lastError.length());
+
+        const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
+        fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerError);
+        fShmNonRtServerControl.writeUInt(errorSize);
+        fShmNonRtServerControl.writeCustomData(pData->lastError.buffer(), errorSize);
+        fShmNonRtServerControl.commitWrite();
+    }
+
     // -------------------------------------------------------------------
 
 protected:
@@ -1269,6 +1672,9 @@ protected:
         _mm_setcsr(_mm_getcsr() | 0x8040);
 #endif
 
+        if (pData->options.bridgeLockMemory)
+            carla_prefaultThreadStack();
+
         bool quitReceived = false;
 
         for (; ! shouldThreadExit();)
@@ -1310,6 +1716,7 @@ protected:
                     const uint32_t bufferSize(fShmRtClientControl.readUInt());
                     pData->bufferSize = bufferSize;
                     bufferSizeChanged(bufferSize);
+                    resizeGroupBuffers();
                     break;
                 }
 
@@ -1473,10 +1880,18 @@ protected:
 
                     CARLA_SAFE_ASSERT_BREAK(fShmAudioPool.data != nullptr);
 
-                    if (plugin.get() != nullptr && plugin->isEnabled() && plugin->tryLock(fIsOffline))
-                    {
-                        const BridgeTimeInfo& bridgeTimeInfo(fShmRtClientControl.data->timeInfo);
+                    const CarlaMutexTryLocker cmtl(fGroupMutex, fIsOffline);
 
+                    // nothing is processed while the group changes, same as when the plugin cannot be locked
+                    if (cmtl.wasNotLocked())
+                        pass();
+                    else if (fGroupPluginCount > 1)
+                    {
+                        updateTimeInfo();
+                        processGroup(frames);
+                    }
+                    else if (plugin.get() != nullptr && plugin->isEnabled() && plugin->tryLock(fIsOffline))
+                    {
                         const uint32_t audioInCount = plugin->getAudioInCount();
                         const uint32_t audioOutCount = plugin->getAudioOutCount();
                         const uint32_t cvInCount = plugin->getCVInCount();
@@ -1499,29 +1914,16 @@ protected:
                         for (uint32_t i=0; i < cvOutCount; ++i, fdata += pData->bufferSize)
                             cvOut[i] = fdata;
 
-                        EngineTimeInfo& timeInfo(pData->timeInfo);
-
-                        timeInfo.playing   = bridgeTimeInfo.playing;
-                        timeInfo.frame     = bridgeTimeInfo.frame;
-                        timeInfo.usecs     = bridgeTimeInfo.usecs;
-                        timeInfo.bbt.valid = (bridgeTimeInfo.validFlags & kPluginBridgeTimeInfoValidBBT) != 0;
+                        updateTimeInfo();
 
-                        if (timeInfo.bbt.valid)
-                        {
-                            timeInfo.bbt.bar  = bridgeTimeInfo.bar;
-                            timeInfo.bbt.beat = bridgeTimeInfo.beat;
-                            timeInfo.bbt.tick = bridgeTimeInfo.tick;
-
-                            timeInfo.bbt.beatsPerBar = bridgeTimeInfo.beatsPerBar;
-                            timeInfo.bbt.beatType    = bridgeTimeInfo.beatType;
-
-                            timeInfo.bbt.ticksPerBeat   = bridgeTimeInfo.ticksPerBeat;
-                            timeInfo.bbt.beatsPerMinute = bridgeTimeInfo.beatsPerMinute;
-                            timeInfo.bbt.barStartTick   = bridgeTimeInfo.barStartTick;
-                        }
+                        const ScopedRtSanitizerContext srsc1(fIsOffline ? kCarlaRtSanitizerNoContext
+                                                                        : kCarlaRtSanitizerEngineContext);
+                        const ScopedRtSanitizerContext srsc2(0);
 
                         plugin->initBuffers();
+                        const uint64_t processStartTime = carla_gettime_ns();
                         plugin->process(audioIn, audioOut, cvIn, cvOut, frames);
+                        plugin->addProcessTime(processStartTime, carla_gettime_ns());
                         plugin->unlock();
                     }
 
@@ -1634,6 +2036,175 @@ protected:
         }
     }
 
+    // called from process thread above
+    void updateTimeInfo() noexcept
+    {
+        const BridgeTimeInfo& bridgeTimeInfo(fShmRtClientControl.data->timeInfo);
+
+        EngineTimeInfo& timeInfo(pData->timeInfo);
+
+        timeInfo.playing   = bridgeTimeInfo.playing;
+        timeInfo.frame     = bridgeTimeInfo.frame;
+        timeInfo.usecs     = bridgeTimeInfo.usecs;
+        timeInfo.bbt.valid = (bridgeTimeInfo.validFlags & kPluginBridgeTimeInfoValidBBT) != 0;
+
+        if (timeInfo.bbt.valid)
+        {
+            timeInfo.bbt.bar  = bridgeTimeInfo.bar;
+            timeInfo.bbt.beat = bridgeTimeInfo.beat;
+            timeInfo.bbt.tick = bridgeTimeInfo.tick;
+
+            timeInfo.bbt.beatsPerBar = bridgeTimeInfo.beatsPerBar;
+            timeInfo.bbt.beatType    = bridgeTimeInfo.beatType;
+
+            timeInfo.bbt.ticksPerBeat   = bridgeTimeInfo.ticksPerBeat;
+            timeInfo.bbt.beatsPerMinute = bridgeTimeInfo.beatsPerMinute;
+            timeInfo.bbt.barStartTick   = bridgeTimeInfo.barStartTick;
+        }
+    }
+
+    // called from process thread above with fGroupMutex locked, runs all plugins of a group in series
+    void processGroup(const uint32_t frames) noexcept
+    {
+        const uint pluginCount = fGroupPluginCount;
+        const uint32_t bufferSize = pData->bufferSize;
+        const uint32_t maxAudioOuts = fGroupMaxAudioOuts;
+
+        if (fGroupBuffer.size() < (2 * maxAudioOuts + 2) * bufferSize)
+            return;
+
+        const CarlaPluginPtr firstPlugin = pData->plugins[0].plugin;
+        const CarlaPluginPtr lastPlugin = pData->plugins[pluginCount - 1].plugin;
+        CARLA_SAFE_ASSERT_RETURN(firstPlugin.get() != nullptr && lastPlugin.get() != nullptr,);
+
+        // pool layout, as sent to the host on first idle
+        const uint32_t poolAudioInCount  = std::min(firstPlugin->getAudioInCount(), 64U);
+        const uint32_t poolAudioOutCount = std::min(lastPlugin->getAudioOutCount(), 64U);
+        const uint32_t poolCvInCount     = std::min(firstPlugin->getCVInCount(), 32U);
+        const uint32_t poolCvOutCount    = std::min(lastPlugin->getCVOutCount(), 32U);
+
+        float* const poolAudioIn  = fShmAudioPool.data;
+        float* const poolAudioOut = poolAudioIn + poolAudioInCount * bufferSize;
+        float* const poolCvIn     = poolAudioOut + poolAudioOutCount * bufferSize;
+        float* const poolCvOut    = poolCvIn + poolCvInCount * bufferSize;
+
+        float* const scratch    = fGroupBuffer.data();
+        float* const zeroBuf    = scratch + 2 * maxAudioOuts * bufferSize;
+        float* const discardBuf = zeroBuf + bufferSize;
+
+        // plugins may not treat their inputs as read-only
+        carla_zeroFloats(zeroBuf, frames);
+
+        // audio from the previous plugin, starting with the host input
+        const float* prevOut[64];
+        uint32_t prevOutCount = poolAudioInCount;
+        uint32_t prevMidiOutCount = 0;
+        uint scratchSide = 0;
+        bool processed = false;
+        bool lastProcessed = false;
+
+        for (uint32_t j=0; j < poolAudioInCount; ++j)
+            prevOut[j] = poolAudioIn + j * bufferSize;
+
+        const ScopedRtSanitizerContext srsc1(fIsOffline ? kCarlaRtSanitizerNoContext
+                                                        : kCarlaRtSanitizerEngineContext);
+
+        for (uint i=0; i < pluginCount; ++i)
+        {
+            const CarlaPluginPtr plugin = pData->plugins[i].plugin;
+
+            // skipped plugins let the audio through
+            if (plugin.get() == nullptr || ! plugin->isEnabled() || ! plugin->tryLock(fIsOffline))
+                continue;
+
+            const bool isLast = i + 1 == pluginCount;
+
+            const uint32_t audioInCount  = plugin->getAudioInCount();
+            const uint32_t audioOutCount = plugin->getAudioOutCount();
+            const uint32_t cvInCount     = plugin->getCVInCount();
+            const uint32_t cvOutCount    = plugin->getCVOutCount();
+
+            if (audioInCount > 64 || cvInCount > 32 || cvOutCount > 32 ||
+                audioOutCount > (isLast ? poolAudioOutCount : maxAudioOuts) ||
+                (i == 0 && (audioInCount > poolAudioInCount || cvInCount > poolCvInCount)) ||
+                (isLast && cvOutCount > poolCvOutCount))
+            {
+                plugin->unlock();
+                continue;
+            }
+
+            const float* audioIn[64];
+            /* */ float* audioOut[64];
+            const float* cvIn[32];
+            /* */ float* cvOut[32];
+
+            for (uint32_t j=0; j < audioInCount; ++j)
+                audioIn[j] = j < prevOutCount ? prevOut[j] : zeroBuf;
+
+            for (uint32_t j=0; j < audioOutCount; ++j)
+                audioOut[j] = isLast ? poolAudioOut + j * bufferSize
+                                     : scratch + (scratchSide * maxAudioOuts + j) * bufferSize;
+
+            for (uint32_t j=0; j < cvInCount; ++j)
+                cvIn[j] = i == 0 ? poolCvIn + j * bufferSize : zeroBuf;
+
+            for (uint32_t j=0; j < cvOutCount; ++j)
+                cvOut[j] = isLast ? poolCvOut + j * bufferSize : discardBuf;
+
+            if (processed)
+            {
+                // if plugin has no midi out, add previous events
+                if (prevMidiOutCount == 0 && pData->events.in[0].type != kEngineEventTypeNull)
+                {
+                    if (pData->events.out[0].type != kEngineEventTypeNull)
+                    {
+                        // TODO: carefully add to input, sorted events
+                    }
+                    // else nothing needed
+                }
+                else
+                {
+                    // initialize event inputs from previous outputs
+                    carla_copyStructs(pData->events.in, pData->events.out, kMaxEngineEventInternalCount);
+
+                    // initialize event outputs (zero)
+                    carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+                }
+            }
+
+            {
+                const ScopedRtSanitizerContext srsc2(static_cast<int32_t>(i));
+
+                plugin->initBuffers();
+                const uint64_t processStartTime = carla_gettime_ns();
+                plugin->process(audioIn, audioOut, cvIn, cvOut, frames);
+                plugin->addProcessTime(processStartTime, carla_gettime_ns());
+                plugin->unlock();
+            }
+
+            for (uint32_t j=0; j < audioOutCount; ++j)
+                prevOut[j] = audioOut[j];
+
+            prevOutCount = audioOutCount;
+            prevMidiOutCount = plugin->getMidiOutCount();
+            scratchSide = 1 - scratchSide;
+            processed = true;
+            lastProcessed = isLast;
+        }
+
+        // last plugin was skipped, pass the audio of the previous one to the host
+        if (processed && ! lastProcessed)
+        {
+            for (uint32_t j=0; j < poolAudioOutCount; ++j)
+            {
+                if (j < prevOutCount)
+                    carla_copyFloats(poolAudioOut + j * bufferSize, prevOut[j], frames);
+                else
+                    carla_zeroFloats(poolAudioOut + j * bufferSize, frames);
+            }
+        }
+    }
+
     // called from process thread above
     EngineEvent* getNextFreeInputEvent() const noexcept
     {
@@ -1652,7 +2223,7 @@ protected:
         const CarlaMutexLocker _cml(fShmNonRtServerControl.mutex);
 
         fShmNonRtServerControl.writeOpcode(kPluginBridgeNonRtServerSetLatency);
-        fShmNonRtServerControl.writeUInt(samples);
+        fShmNonRtServerControl.writeUInt(pData->curPluginCount > 1 ? getGroupLatency() : samples);
         fShmNonRtServerControl.commitWrite();
     }
 
@@ -1675,6 +2246,12 @@ private:
     uint32_t fBridgeVersion;
     uint32_t fLastPingTime;
 
+    // group as seen by processGroup(), only changed with fGroupMutex, which the RT thread only tries to lock
+    CarlaMutex fGroupMutex;
+    std::vector<float> fGroupBuffer;
+    uint32_t fGroupMaxAudioOuts;
+    uint fGroupPluginCount;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineBridge)
 };
 
@@ -0,0 +1,275 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaEngineBridgePool.hpp"
+#include "CarlaEngine.hpp"
+#include "CarlaScopeUtils.hpp"
+#include "CarlaString.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include "water/files/File.h"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineBridgePool::Binary
+
+struct CarlaEngineBridgePool::Binary {
+    const BinaryType btype;
+    const CarlaString archName;
+    const CarlaString path;
+
+    // started bridges, oldest first
+    std::vector<CarlaPluginPtr> bridges;
+
+    // set when a bridge of this binary could not be started, to not keep trying
+    bool failed;
+
+    // load times without the pool
+    uint32_t coldLoadCount;
+    uint32_t coldLoadTime;
+
+    Binary(const BinaryType bt, const char* const arch, const char* const p)
+        : btype(bt),
+          archName(arch != nullptr ? arch : ""),
+          path(p),
+          bridges(),
+          failed(false),
+          coldLoadCount(0),
+          coldLoadTime(0) {}
+
+    bool matches(const BinaryType bt, const char* const arch, const char* const p) const noexcept
+    {
+        return btype == bt && archName == (arch != nullptr ? arch : "") && path == p;
+    }
+
+    uint32_t getAverageColdLoadTime() const noexcept
+    {
+        return coldLoadCount != 0 ? coldLoadTime / coldLoadCount : 0;
+    }
+
+    // start bridges until there are @a count of them
+    void fill(CarlaEngine* const engine, const std::size_t count)
+    {
+        while (! failed && bridges.size() < count)
+        {
+            const CarlaPluginPtr bridge = CarlaPlugin::newWarmBridge(engine, btype,
+                                                                     archName.isNotEmpty() ? archName.buffer() : nullptr,
+                                                                     path);
+
+            if (bridge.get() == nullptr)
+            {
+                carla_stderr2("CarlaEngineBridgePool: failed to start bridge '%s', not using it anymore", path.buffer());
+                failed = true;
+                break;
+            }
+
+            bridges.push_back(bridge);
+        }
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(Binary)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineBridgePool
+
+CarlaEngineBridgePool::CarlaEngineBridgePool(CarlaEngine* const engine) noexcept
+    : kEngine(engine),
+      fBinaries(),
+      fInvalidated(false),
+      fLoading(false),
+      fWarmLoadCount(0),
+      fSavedTime(0)
+{
+    CARLA_SAFE_ASSERT(engine != nullptr);
+}
+
+CarlaEngineBridgePool::~CarlaEngineBridgePool() noexcept
+{
+    stop();
+}
+
+void CarlaEngineBridgePool::start()
+{
+    CARLA_SAFE_ASSERT_RETURN(fBinaries.empty(),);
+
+    fInvalidated = false;
+    fWarmLoadCount = 0;
+    fSavedTime = 0;
+
+#if !defined(BUILD_BRIDGE) && !defined(CARLA_OS_WIN)
+    const EngineOptions& options(kEngine->getOptions());
+
+    // plugins use the native bridge by default in this case, no need to wait for the first one
+    if (options.preferPluginBridges && options.binaryDir != nullptr && options.binaryDir[0] != '\0')
+    {
+        const CarlaString bridgeBinary(CarlaString(options.binaryDir) + CARLA_OS_SEP_STR "carla-bridge-native");
+
+        if (water::File(bridgeBinary.buffer()).existsAsFile())
+            getBinary(BINARY_NATIVE, nullptr, bridgeBinary);
+    }
+#endif
+}
+
+void CarlaEngineBridgePool::stop() noexcept
+{
+    if (fBinaries.empty())
+        return;
+
+    carla_debug("CarlaEngineBridgePool::stop()");
+
+    if (fWarmLoadCount != 0)
+        carla_stdout("CarlaEngineBridgePool: %u plugins loaded into started bridges, saving about %u ms in total",
+                     fWarmLoadCount, fSavedTime);
+
+    clear();
+}
+
+void CarlaEngineBridgePool::invalidate() noexcept
+{
+    fInvalidated = true;
+}
+
+void CarlaEngineBridgePool::idle()
+{
+    if (fBinaries.empty() || fLoading)
+        return;
+
+    if (fInvalidated.exchange(false))
+    {
+        carla_debug("CarlaEngineBridgePool::idle() - restarting bridges");
+
+        for (std::vector<Binary*>::iterator it = fBinaries.begin(); it != fBinaries.end(); ++it)
+        {
+            (*it)->bridges.clear();
+            (*it)->failed = false;
+        }
+    }
+
+    if (! kEngine->isRunning() || kEngine->isAboutToClose())
+        return;
+
+    const std::size_t poolSize = kEngine->getOptions().pluginBridgePoolSize;
+
+    for (std::vector<Binary*>::iterator it = fBinaries.begin(); it != fBinaries.end(); ++it)
+    {
+        Binary* const binary(*it);
+
+        if (binary->bridges.size() > poolSize)
+            binary->bridges.resize(poolSize);
+        else
+            binary->fill(kEngine, poolSize);
+    }
+}
+
+CarlaPluginPtr CarlaEngineBridgePool::newBridge(const CarlaPlugin::Initializer& init,
+                                                const BinaryType btype,
+                                                const PluginType ptype,
+                                                const char* const binaryArchName,
+                                                const char* const bridgeBinary)
+{
+    bool usePool = kEngine->getOptions().pluginBridgePoolSize != 0
+                && ! fLoading
+                && bridgeBinary != nullptr && bridgeBinary[0] != '\0';
+
+    // 16-output SoundFonts are requested through the bridge arguments
+    if (ptype == PLUGIN_SF2)
+        usePool = false;
+
+#ifndef CARLA_OS_WIN
+    // the automatic wine prefix depends on the plugin filename, unknown when starting the bridge
+    if (kEngine->getOptions().wine.autoPrefix && CarlaString(bridgeBinary).contains(".exe", true))
+        usePool = false;
+#endif
+
+    if (! usePool)
+        return CarlaPlugin::newBridge(init, btype, ptype, binaryArchName, bridgeBinary);
+
+    Binary* const binary = getBinary(btype, binaryArchName, bridgeBinary);
+
+    CarlaPluginPtr warmBridge;
+
+    if (! binary->bridges.empty())
+    {
+        warmBridge = binary->bridges.front();
+        binary->bridges.erase(binary->bridges.begin());
+    }
+
+    // the engine keeps idling while waiting for the bridge
+    const CarlaScopedValueSetter<bool> svs(fLoading, true);
+
+    // start the replacement now, so that it gets ready while this plugin loads
+    binary->fill(kEngine, kEngine->getOptions().pluginBridgePoolSize);
+
+    const uint32_t startTime = carla_gettime_ms();
+    const CarlaPluginPtr plugin = CarlaPlugin::newBridge(init, btype, ptype, binaryArchName, bridgeBinary, warmBridge);
+    const uint32_t loadTime = carla_gettime_ms() - startTime;
+
+    if (plugin.get() == nullptr)
+        return plugin;
+
+    if (warmBridge.get() != nullptr && plugin.get() == warmBridge.get())
+    {
+        ++fWarmLoadCount;
+
+        if (const uint32_t coldLoadTime = binary->getAverageColdLoadTime())
+        {
+            if (coldLoadTime > loadTime)
+                fSavedTime += coldLoadTime - loadTime;
+
+            carla_stdout("CarlaEngineBridgePool: loaded plugin into a started bridge in %u ms, %u ms on average without",
+                         loadTime, coldLoadTime);
+        }
+        else
+        {
+            carla_stdout("CarlaEngineBridgePool: loaded plugin into a started bridge in %u ms", loadTime);
+        }
+    }
+    else
+    {
+        ++binary->coldLoadCount;
+        binary->coldLoadTime += loadTime;
+
+        // the started bridge was gone, and the plugin loaded fine in a new one.
+        // only that bridge is dropped, its replacement was already started above.
+        if (warmBridge.get() != nullptr)
+            carla_stderr2("CarlaEngineBridgePool: started bridge '%s' did not run, dropped it",
+                          binary->path.buffer());
+    }
+
+    return plugin;
+}
+
+CarlaEngineBridgePool::Binary* CarlaEngineBridgePool::getBinary(const BinaryType btype,
+                                                                const char* const binaryArchName,
+                                                                const char* const bridgeBinary)
+{
+    for (std::vector<Binary*>::iterator it = fBinaries.begin(); it != fBinaries.end(); ++it)
+    {
+        if ((*it)->matches(btype, binaryArchName, bridgeBinary))
+            return *it;
+    }
+
+    carla_debug("CarlaEngineBridgePool::getBinary() - now using '%s'", bridgeBinary);
+
+    Binary* const binary = new Binary(btype, binaryArchName, bridgeBinary);
+    fBinaries.push_back(binary);
+    return binary;
+}
+
+void CarlaEngineBridgePool::clear() noexcept
+{
+    for (std::vector<Binary*>::iterator it = fBinaries.begin(); it != fBinaries.end(); ++it)
+    {
+        try {
+            delete *it;
+        } CARLA_SAFE_EXCEPTION("CarlaEngineBridgePool::clear");
+    }
+
+    fBinaries.clear();
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
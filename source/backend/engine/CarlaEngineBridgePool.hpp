@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_ENGINE_BRIDGE_POOL_HPP_INCLUDED
+#define CARLA_ENGINE_BRIDGE_POOL_HPP_INCLUDED
+
+#include "CarlaPlugin.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include <atomic>
+#include <vector>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineBridgePool
+
+/*
+   Plugin bridge processes started ahead of time, so that adding a bridged plugin does not need to wait for one.
+
+   The engine keeps ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE bridges running for each bridge binary in use,
+   newBridge() loads the plugin into one of them and starts its replacement.
+   All calls happen on the main thread, except for invalidate().
+  */
+
+class CarlaEngineBridgePool
+{
+public:
+    CarlaEngineBridgePool(CarlaEngine* engine) noexcept;
+    ~CarlaEngineBridgePool() noexcept;
+
+    /*
+     * Prepare the pool, as configured by the engine options.
+     * Bridges are only started later during idle(), once the engine is running.
+     */
+    void start();
+
+    /*
+     * Close all bridges of the pool.
+     */
+    void stop() noexcept;
+
+    /*
+     * Restart all bridges of the pool on the next idle, used when they no longer match the engine settings.
+     * @note RT-safe
+     */
+    void invalidate() noexcept;
+
+    /*
+     * Start or close bridges as needed.
+     */
+    void idle();
+
+    /*
+     * Create a bridged plugin, using a bridge of the pool when possible.
+     * Same as CarlaPlugin::newBridge() otherwise.
+     */
+    CarlaPluginPtr newBridge(const CarlaPlugin::Initializer& init,
+                             BinaryType btype, PluginType ptype,
+                             const char* binaryArchName, const char* bridgeBinary);
+
+private:
+    struct Binary;
+
+    CarlaEngine* const kEngine;
+
+    std::vector<Binary*> fBinaries;
+    std::atomic<bool> fInvalidated;
+    bool fLoading;
+
+    // load time statistics
+    uint32_t fWarmLoadCount;
+    uint32_t fSavedTime;
+
+    Binary* getBinary(BinaryType btype, const char* binaryArchName, const char* bridgeBinary);
+    void clear() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineBridgePool)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_BRIDGE_POOL_HPP_INCLUDED
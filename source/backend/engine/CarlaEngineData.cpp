@@ -210,6 +210,13 @@ EngineOptions::EngineOptions() noexcept
 #endif
       uisAlwaysOnTop(true),
       pluginsAreStandalone(false),
+      projectBinaryDataMinSize(0),
+      pluginSleepTimeout(0),
+      subBlockGranularity(0),
+      cvEventResolution(32),
+      workerThreads(0),
+      fluidSynthCpuCores(1),
+      pluginBridgePoolSize(0),
       bgColor(0x000000ff),
       fgColor(0xffffffff),
       uiScale(1.0f),
@@ -220,6 +227,10 @@ EngineOptions::EngineOptions() noexcept
       audioTripleBuffer(false),
       audioDriver(nullptr),
       audioDevice(nullptr),
+      audioCpuSet(nullptr),
+      workerCpuSet(nullptr),
+      rtPriority(0),
+      bridgeLockMemory(false),
 #ifndef BUILD_BRIDGE
 # ifdef CARLA_OS_WIN
       oscEnabled(false),
@@ -263,6 +274,16 @@ EngineOptions::~EngineOptions() noexcept
         delete[] audioDevice;
         audioDevice = nullptr;
     }
+    if (audioCpuSet != nullptr)
+    {
+        delete[] audioCpuSet;
+        audioCpuSet = nullptr;
+    }
+    if (workerCpuSet != nullptr)
+    {
+        delete[] workerCpuSet;
+        workerCpuSet = nullptr;
+    }
     if (pathAudio != nullptr)
     {
         delete[] pathAudio;
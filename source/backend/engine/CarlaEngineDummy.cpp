@@ -20,10 +20,20 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaTimeUtils.hpp"
 
+#ifndef BUILD_BRIDGE
+# include "CarlaEngineRender.hpp"
+#endif
+
+#include "CarlaMIDI.h"
+
 CARLA_BACKEND_START_NAMESPACE
 
 // -------------------------------------------------------------------------------------------------------------------
 // Dummy Engine
+//
+// Besides CARLA_BRIDGE_DUMMY, a few environment variables are used for benchmarking:
+//  - CARLA_DUMMY_FREEWHEEL: run cycles as fast as possible, the engine reports itself as offline
+//  - CARLA_DUMMY_MIDI_EVENTS: number of synthetic MIDI note events fed into the engine input on each cycle
 
 class CarlaEngineDummy : public CarlaEngine,
                          public CarlaThread
@@ -32,7 +42,10 @@ public:
     CarlaEngineDummy()
         : CarlaEngine(),
           CarlaThread("CarlaEngineDummy"),
-          fRunning(false)
+          fRunning(false),
+          fFreewheel(false),
+          fRendering(false),
+          fMidiEventsPerCycle(0)
     {
         carla_debug("CarlaEngineDummy::CarlaEngineDummy()");
 
@@ -52,12 +65,19 @@ public:
         CARLA_SAFE_ASSERT_RETURN(clientName != nullptr && clientName[0] != '\0', false);
         carla_debug("CarlaEngineDummy::init(\"%s\")", clientName);
 
-        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+        if (pData->options.processMode != ENGINE_PROCESS_MODE_CONTINUOUS_RACK &&
+            pData->options.processMode != ENGINE_PROCESS_MODE_PATCHBAY)
         {
             setLastError("Invalid process mode");
             return false;
         }
 
+        if (const char* const freewheelstr = std::getenv("CARLA_DUMMY_FREEWHEEL"))
+            fFreewheel = std::atoi(freewheelstr) != 0;
+
+        if (const char* const eventsstr = std::getenv("CARLA_DUMMY_MIDI_EVENTS"))
+            fMidiEventsPerCycle = static_cast<uint32_t>(std::max(0, std::atoi(eventsstr)));
+
         fRunning = true;
 
         if (! pData->init(clientName))
@@ -73,6 +93,9 @@ public:
 
         pData->graph.create(2, 2, 0, 0);
 
+        if (fFreewheel)
+            offlineModeChanged(true);
+
         if (! startThread())
         {
             close();
@@ -82,6 +105,9 @@ public:
 
         patchbayRefresh(true, false, false);
 
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_PATCHBAY)
+            refreshExternalGraphPorts<PatchbayGraph>(pData->graph.getPatchbayGraph(), false, false);
+
         callback(true, true,
                  ENGINE_CALLBACK_ENGINE_STARTED,
                  0,
@@ -98,6 +124,7 @@ public:
         carla_debug("CarlaEngineDummy::close()");
 
         fRunning = false;
+        fFreewheel = false;
         stopThread(-1);
         CarlaEngine::close();
 
@@ -117,7 +144,7 @@ public:
 
     bool isOffline() const noexcept override
     {
-        return false;
+        return fFreewheel || fRendering;
     }
 
     EngineType getType() const noexcept override
@@ -133,11 +160,9 @@ public:
     // -------------------------------------------------------------------
     // Patchbay
 
-    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool) override
+    template<class Graph>
+    bool refreshExternalGraphPorts(Graph* const graph, const bool sendHost, const bool sendOSC)
     {
-        CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
-
-        RackGraph* const graph = pData->graph.getRackGraph();
         CARLA_SAFE_ASSERT_RETURN(graph != nullptr, false);
 
         ExternalGraph& extGraph(graph->extGraph);
@@ -182,11 +207,151 @@ public:
         // now refresh
 
         if (sendHost || sendOSC)
-            graph->refresh(sendHost, sendOSC, false, "Dummy");
+            graph->refresh(sendHost, sendOSC, true, "Dummy");
 
         return true;
     }
 
+    bool patchbayRefresh(const bool sendHost, const bool sendOSC, const bool external) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->graph.isReady(), false);
+
+        if (pData->options.processMode == ENGINE_PROCESS_MODE_CONTINUOUS_RACK)
+            return refreshExternalGraphPorts<RackGraph>(pData->graph.getRackGraph(), sendHost, sendOSC);
+
+        if (sendHost)
+            pData->graph.setUsingExternalHost(external);
+        if (sendOSC)
+            pData->graph.setUsingExternalOSC(external);
+
+        if (external)
+            return refreshExternalGraphPorts<PatchbayGraph>(pData->graph.getPatchbayGraph(), sendHost, sendOSC);
+
+        return CarlaEngine::patchbayRefresh(sendHost, sendOSC, false);
+    }
+
+    // -------------------------------------------------------------------
+    // Offline render
+
+#ifndef BUILD_BRIDGE
+    bool renderToFile(const char* const filename, const uint64_t frames, const uint32_t blockSize) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+        CARLA_SAFE_ASSERT_RETURN(frames != 0, false);
+        carla_debug("CarlaEngineDummy::renderToFile(\"%s\", " P_UINT64 ", %u)", filename, frames, blockSize);
+
+        if (! fRunning)
+        {
+            setLastError("Engine is not running");
+            return false;
+        }
+
+        CarlaEngineRenderWriter writer;
+
+        if (! writer.open(filename, kNumAudioOuts, pData->sampleRate))
+        {
+            setLastError(writer.getLastError());
+            return false;
+        }
+
+        // take over processing from the audio thread
+        stopThread(-1);
+
+        const uint32_t oldBufferSize = pData->bufferSize;
+        const uint32_t renderBufferSize = blockSize != 0 ? blockSize : oldBufferSize;
+        const bool wasOffline = isOffline();
+        const bool wasPlaying = pData->timeInfo.playing;
+        const uint64_t oldFrame = pData->timeInfo.frame;
+
+        fRendering = true;
+
+        if (! wasOffline)
+            offlineModeChanged(true);
+
+        if (renderBufferSize != oldBufferSize)
+        {
+            pData->bufferSize = renderBufferSize;
+            bufferSizeChanged(renderBufferSize);
+        }
+
+       #ifdef HAVE_HYLIA
+        // Ableton Link would make the transport follow the wall clock
+        const bool linkEnabled = pData->options.transportExtra != nullptr
+                              && std::strstr(pData->options.transportExtra, ":link:") != nullptr;
+
+        if (linkEnabled)
+            pData->time.enableLink(false);
+       #endif
+
+        // always render from the start of the timeline
+        transportRelocate(0);
+        transportPlay();
+
+        std::vector<float> buffers(renderBufferSize * kNumAudioOuts * 2, 0.0f);
+        float* audioIns[kNumAudioOuts];
+        float* audioOuts[kNumAudioOuts];
+
+        for (uint32_t i=0; i < kNumAudioOuts; ++i)
+        {
+            audioIns[i]  = buffers.data() + renderBufferSize * i;
+            audioOuts[i] = buffers.data() + renderBufferSize * (kNumAudioOuts + i);
+        }
+
+        carla_zeroStructs(pData->events.in, kMaxEngineEventInternalCount);
+
+        bool ok = true;
+        const uint64_t startTime = carla_gettime_ms();
+
+        for (uint64_t renderedFrames = 0; ok && renderedFrames < frames; renderedFrames += renderBufferSize)
+        {
+            processCycle(audioIns, audioOuts, renderBufferSize);
+
+            ok = writer.write(audioOuts, static_cast<uint32_t>(std::min<uint64_t>(renderBufferSize,
+                                                                                   frames - renderedFrames)));
+        }
+
+        if (! writer.close())
+            ok = false;
+
+        if (ok)
+            carla_stdout("CarlaEngineDummy rendered " P_UINT64 " frames into \"%s\" in " P_UINT64 "ms",
+                         frames, filename, carla_gettime_ms() - startTime);
+        else
+            setLastError(writer.getLastError());
+
+        // restore previous state
+        transportPause();
+        transportRelocate(oldFrame);
+
+        if (wasPlaying)
+            transportPlay();
+
+       #ifdef HAVE_HYLIA
+        if (linkEnabled)
+            pData->time.enableLink(true);
+       #endif
+
+        if (renderBufferSize != oldBufferSize)
+        {
+            pData->bufferSize = oldBufferSize;
+            bufferSizeChanged(oldBufferSize);
+        }
+
+        fRendering = false;
+
+        if (! wasOffline)
+            offlineModeChanged(false);
+
+        if (! startThread())
+        {
+            setLastError("Failed to restart dummy audio thread");
+            return false;
+        }
+
+        return ok;
+    }
+#endif
+
     // -------------------------------------------------------------------
 
 protected:
@@ -201,8 +366,8 @@ protected:
             if ((delay = atoi(delaystr)) == 1)
                 delay = 0;
 
-        carla_stdout("CarlaEngineDummy audio thread started, cycle time: " P_INT64 "ms, delay %ds",
-                     cycleTime / 1000, delay);
+        carla_stdout("CarlaEngineDummy audio thread started, cycle time: " P_INT64 "ms, delay %ds%s",
+                     cycleTime / 1000, delay, fFreewheel ? ", freewheel" : "");
 
         float* audioIns[2] = {
             (float*)std::malloc(sizeof(float)*bufferSize),
@@ -231,13 +396,10 @@ protected:
 
             oldTime = carla_gettime_us();
 
-            const PendingRtEventsRunner prt(this, bufferSize, true);
-
-            carla_zeroFloats(audioOuts[0], bufferSize);
-            carla_zeroFloats(audioOuts[1], bufferSize);
-            carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+            processCycle(audioIns, audioOuts, bufferSize);
 
-            pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+            if (fFreewheel)
+                continue;
 
             newTime = carla_gettime_us();
             CARLA_SAFE_ASSERT_CONTINUE(newTime >= oldTime);
@@ -247,6 +409,7 @@ protected:
             if (remainingTime <= 0)
             {
                 ++pData->xruns;
+                CarlaEngineTrace::addInstantEvent("xrun");
                 carla_stdout("XRUN! remaining time: " P_INT64 ", old: " P_INT64 ", new: " P_INT64 ")",
                              remainingTime, oldTime, newTime);
             }
@@ -268,7 +431,53 @@ protected:
     // -------------------------------------------------------------------
 
 private:
+    static constexpr const uint32_t kNumAudioOuts = 2;
+
     bool fRunning;
+    bool fFreewheel;
+    bool fRendering;
+    uint32_t fMidiEventsPerCycle;
+
+    void processCycle(float** const audioIns, float** const audioOuts, const uint32_t bufferSize)
+    {
+        const PendingRtEventsRunner prt(this, bufferSize, true);
+
+        for (uint32_t i=0; i < kNumAudioOuts; ++i)
+            carla_zeroFloats(audioOuts[i], bufferSize);
+
+        carla_zeroStructs(pData->events.out, kMaxEngineEventInternalCount);
+
+        if (fMidiEventsPerCycle != 0)
+            fillSyntheticMidiEvents(bufferSize);
+
+        pData->graph.process(pData, audioIns, audioOuts, bufferSize);
+    }
+
+    // alternating note-on/off pairs, evenly spread over the cycle
+    void fillSyntheticMidiEvents(const uint32_t bufferSize) noexcept
+    {
+        const uint32_t count = std::min<uint32_t>(fMidiEventsPerCycle, kMaxEngineEventInternalCount);
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            EngineEvent& event(pData->events.in[i]);
+
+            event.type    = kEngineEventTypeMidi;
+            event.time    = static_cast<uint32_t>(static_cast<uint64_t>(i) * bufferSize / count);
+            event.channel = 0;
+
+            event.midi.port    = 0;
+            event.midi.size    = 3;
+            event.midi.data[0] = (i % 2) == 0 ? MIDI_STATUS_NOTE_ON : MIDI_STATUS_NOTE_OFF;
+            event.midi.data[1] = static_cast<uint8_t>(36 + (i / 2) % 48);
+            event.midi.data[2] = (i % 2) == 0 ? 100 : 0;
+            event.midi.data[3] = 0;
+            event.midi.dataExt = nullptr;
+        }
+
+        if (count < kMaxEngineEventInternalCount)
+            pData->events.in[count].type = kEngineEventTypeNull;
+    }
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineDummy)
 };
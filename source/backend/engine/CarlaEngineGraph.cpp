@@ -21,6 +21,7 @@
 
 #include "CarlaMathUtils.hpp"
 #include "CarlaScopeUtils.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "CarlaMIDI.h"
 
@@ -997,6 +998,10 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
     float* outBuf[MAX_GRAPH_AUDIO_IO];
     float* cvBuf[MAX_GRAPH_CV_IO];
 
+    // where the audio of the previous plugin is, its plugin stays locked while that is one of its own buffers
+    const float* prevOutBuf[2] = { inBuf0, inBuf1 };
+    CarlaPluginPtr prevOutPlugin;
+
     uint32_t oldAudioInCount  = 0;
     uint32_t oldAudioOutCount = 0;
     uint32_t oldMidiOutCount  = 0;
@@ -1012,14 +1017,6 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
 
         if (processed)
         {
-            // initialize audio inputs (from previous outputs)
-            carla_copyFloats(inBuf0, outBufReal[0], frames);
-            carla_copyFloats(inBuf1, outBufReal[1], frames);
-
-            // initialize audio outputs (zero)
-            carla_zeroFloats(outBufReal[0], frames);
-            carla_zeroFloats(outBufReal[1], frames);
-
             // if plugin has no midi out, add previous events
             if (oldMidiOutCount == 0 && data->events.in[0].type != kEngineEventTypeNull)
             {
@@ -1048,15 +1045,51 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
         const uint32_t numOutBufs = std::max(oldAudioOutCount, 2U);
         const uint32_t numCvBufs  = std::max(plugin->getCVInCount(), plugin->getCVOutCount());
 
+        // use the plugin own buffers for the main pair when it has them, so it does not need to copy audio
+        float* const rackInBuf[2] = { inBuf0, inBuf1 };
+        bool usesOwnOutBuf = false;
+
+        for (uint32_t j=0; j<2; ++j)
+        {
+            float* const ownInBuf  = j < oldAudioInCount  ? plugin->getAudioPortBuffer(true, j)  : nullptr;
+            float* const ownOutBuf = j < oldAudioOutCount ? plugin->getAudioPortBuffer(false, j) : nullptr;
+
+            float* const pluginInBuf = ownInBuf != nullptr ? ownInBuf : rackInBuf[j];
+
+            // initialize audio inputs (from previous outputs)
+            if (pluginInBuf != prevOutBuf[j])
+                carla_copyFloats(pluginInBuf, prevOutBuf[j], frames);
+
+            inBuf[j] = pluginInBuf;
+
+            if (ownOutBuf != nullptr)
+            {
+                outBuf[j] = ownOutBuf;
+                usesOwnOutBuf = true;
+            }
+            else
+            {
+                outBuf[j] = outBufReal[j];
+            }
+        }
+
+        // previous outputs were consumed
+        if (prevOutPlugin.get() != nullptr)
+        {
+            prevOutPlugin->unlock();
+            prevOutPlugin.reset();
+        }
+
         CARLA_SAFE_ASSERT_RETURN(numInBufs <= MAX_GRAPH_AUDIO_IO, plugin->unlock());
         CARLA_SAFE_ASSERT_RETURN(numOutBufs <= MAX_GRAPH_AUDIO_IO, plugin->unlock());
         CARLA_SAFE_ASSERT_RETURN(numCvBufs <= MAX_GRAPH_CV_IO, plugin->unlock());
 
-        inBuf[0] = inBuf0;
-        inBuf[1] = inBuf1;
-
-        outBuf[0] = outBufReal[0];
-        outBuf[1] = outBufReal[1];
+        // initialize audio outputs (zero), the rack outputs start that way
+        for (uint32_t j=0; j<2; ++j)
+        {
+            if (processed || outBuf[j] != outBufReal[j])
+                carla_zeroFloats(outBuf[j], frames);
+        }
 
         for (uint32_t j=0; j<numCvBufs; ++j)
             cvBuf[j] = dummyBuf;
@@ -1072,53 +1105,85 @@ void RackGraph::process(CarlaEngine::ProtectedData* const data, const float* inB
                 outBuf[j] = dummyBuf;
         }
 
-        // process
-        plugin->initBuffers();
-        plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
-        plugin->unlock();
+        EnginePluginData& pluginData(data->plugins[i]);
+
+        // input peaks, also used to know if the input is silent
+        if (oldAudioInCount > 0)
+        {
+            pluginData.peaks[0] = carla_findMaxNormalizedFloat(inBuf[0], frames);
+            pluginData.peaks[1] = carla_findMaxNormalizedFloat(inBuf[1], frames);
+        }
+        else
+        {
+            pluginData.peaks[0] = 0.0f;
+            pluginData.peaks[1] = 0.0f;
+        }
+
+        // process, unless asleep (outputs are already zero)
+        const bool asleep = plugin->isAsleep(carla_isZero(pluginData.peaks[0]) && carla_isZero(pluginData.peaks[1]),
+                                             data->events.in[0].type != kEngineEventTypeNull);
+
+        if (! asleep)
+        {
+            plugin->initBuffers();
+            const ScopedRtSanitizerContext srsc(static_cast<int32_t>(plugin->getId()));
+            const uint64_t processStartTime = carla_gettime_ns();
+            plugin->process(inBuf, outBuf, cvBuf, cvBuf, frames);
+            plugin->addProcessTime(processStartTime, carla_gettime_ns());
+        }
+
+        // keep the plugin locked until its own output buffers are consumed
+        if (usesOwnOutBuf)
+            prevOutPlugin = plugin;
+        else
+            plugin->unlock();
 
         // if plugin has no audio inputs, add input buffer
         if (oldAudioInCount == 0)
         {
-            carla_addFloats(outBufReal[0], inBuf0, frames);
-            carla_addFloats(outBufReal[1], inBuf1, frames);
+            carla_addFloats(outBuf[0], inBuf0, frames);
+            carla_addFloats(outBuf[1], inBuf1, frames);
         }
 
         // if plugin only has 1 output, copy it to the 2nd
         if (oldAudioOutCount == 1)
         {
-            carla_copyFloats(outBufReal[1], outBufReal[0], frames);
+            carla_copyFloats(outBuf[1], outBuf[0], frames);
         }
 
-        // set peaks
+        // set output peaks
+        if (oldAudioOutCount > 0)
         {
-            EnginePluginData& pluginData(data->plugins[i]);
-
-            if (oldAudioInCount > 0)
-            {
-                pluginData.peaks[0] = carla_findMaxNormalizedFloat(inBuf0, frames);
-                pluginData.peaks[1] = carla_findMaxNormalizedFloat(inBuf1, frames);
-            }
-            else
-            {
-                pluginData.peaks[0] = 0.0f;
-                pluginData.peaks[1] = 0.0f;
-            }
-
-            if (oldAudioOutCount > 0)
-            {
-                pluginData.peaks[2] = carla_findMaxNormalizedFloat(outBufReal[0], frames);
-                pluginData.peaks[3] = carla_findMaxNormalizedFloat(outBufReal[1], frames);
-            }
-            else
-            {
-                pluginData.peaks[2] = 0.0f;
-                pluginData.peaks[3] = 0.0f;
-            }
+            pluginData.peaks[2] = carla_findMaxNormalizedFloat(outBuf[0], frames);
+            pluginData.peaks[3] = carla_findMaxNormalizedFloat(outBuf[1], frames);
         }
+        else
+        {
+            pluginData.peaks[2] = 0.0f;
+            pluginData.peaks[3] = 0.0f;
+        }
+
+        if (! asleep)
+            plugin->updateSleepState(std::max(pluginData.peaks[2], pluginData.peaks[3]),
+                                     data->events.out[0].type != kEngineEventTypeNull, frames);
 
+        prevOutBuf[0] = outBuf[0];
+        prevOutBuf[1] = outBuf[1];
         processed = true;
     }
+
+    // move the output of the last plugin into place
+    if (processed)
+    {
+        for (uint32_t j=0; j<2; ++j)
+        {
+            if (prevOutBuf[j] != outBufReal[j])
+                carla_copyFloats(outBufReal[j], prevOutBuf[j], frames);
+        }
+    }
+
+    if (prevOutPlugin.get() != nullptr)
+        prevOutPlugin->unlock();
 }
 
 void RackGraph::processHelper(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
@@ -1567,10 +1632,12 @@ public:
             EngineEvent* const engineEvents(port->fBuffer);
             CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
 
+            const ScopedEngineTraceSpan sets("event conversion", static_cast<int32_t>(plugin->getId()));
             carla_zeroStructs(engineEvents, kMaxEngineEventInternalCount);
             fillEngineEventsFromWaterMidiBuffer(engineEvents, midi);
         }
 
+        const bool hasInputEvents = ! midi.isEmpty();
         midi.clear();
 
         plugin->initBuffers();
@@ -1583,7 +1650,10 @@ public:
         if (numAudioChan+numCVInChan+numCVOutChan == 0)
         {
             // nothing to process
+            const ScopedRtSanitizerContext srsc(static_cast<int32_t>(plugin->getId()));
+            const uint64_t processStartTime = carla_gettime_ns();
             plugin->process(nullptr, nullptr, nullptr, nullptr, numSamples);
+            plugin->addProcessTime(processStartTime, carla_gettime_ns());
         }
         else if (numAudioChan != 0)
         {
@@ -1610,17 +1680,54 @@ public:
             float inPeaks[2] = { 0.0f };
             float outPeaks[2] = { 0.0f };
 
-            for (uint32_t i=0, count=jmin(plugin->getAudioInCount(), numChan2); i<count; ++i)
-                inPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+            bool inputIsSilent = true;
 
-            plugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
-                            cvInBuffers, cvOutBuffers,
-                            numSamples);
+            for (uint32_t i=0, count=jmin(plugin->getAudioInCount(), numAudioChan); i<count; ++i)
+            {
+                const float peak = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
+
+                if (i < 2)
+                    inPeaks[i] = peak;
+                if (! carla_isZero(peak))
+                    inputIsSilent = false;
+            }
+
+            const bool asleep = plugin->isAsleep(inputIsSilent, hasInputEvents);
+
+            if (asleep)
+            {
+                // input is silent, clear any extra output channels
+                audio.clear();
+                cvOut.clear();
+            }
+            else
+            {
+                const ScopedRtSanitizerContext srsc(static_cast<int32_t>(plugin->getId()));
+                const uint64_t processStartTime = carla_gettime_ns();
+                plugin->process(const_cast<const float**>(audioBuffers), audioBuffers,
+                                cvInBuffers, cvOutBuffers,
+                                numSamples);
+                plugin->addProcessTime(processStartTime, carla_gettime_ns());
+            }
 
             for (uint32_t i=0, count=jmin(plugin->getAudioOutCount(), numChan2); i<count; ++i)
                 outPeaks[i] = carla_findMaxNormalizedFloat(audioBuffers[i], numSamples);
 
             kEngine->setPluginPeaksRT(plugin->getId(), inPeaks, outPeaks);
+
+            if (! asleep)
+            {
+                float outputPeak = std::max(outPeaks[0], outPeaks[1]);
+
+                for (uint32_t i=2, count=jmin(plugin->getAudioOutCount(), numAudioChan); i<count; ++i)
+                    outputPeak = std::max(outputPeak, carla_findMaxNormalizedFloat(audioBuffers[i], numSamples));
+
+                const CarlaEngineEventPort* const port = plugin->getDefaultEventOutPort();
+                const bool hasOutputEvents = port != nullptr && port->fBuffer != nullptr
+                                          && port->fBuffer[0].type != kEngineEventTypeNull;
+
+                plugin->updateSleepState(outputPeak, hasOutputEvents, numSamples);
+            }
         }
         else
         {
@@ -1633,9 +1740,12 @@ public:
             for (uint32_t i=0; i<numCVInChan; ++i)
                 cvInBuffers[i] = cvIn.getReadPointer(i);
 
+            const ScopedRtSanitizerContext srsc(static_cast<int32_t>(plugin->getId()));
+            const uint64_t processStartTime = carla_gettime_ns();
             plugin->process(nullptr, nullptr,
                             cvInBuffers, cvOutBuffers,
                             numSamples);
+            plugin->addProcessTime(processStartTime, carla_gettime_ns());
         }
 
         midi.clear();
@@ -1645,6 +1755,7 @@ public:
             /*const*/ EngineEvent* const engineEvents(port->fBuffer);
             CARLA_SAFE_ASSERT_RETURN(engineEvents != nullptr,);
 
+            const ScopedEngineTraceSpan sets("event conversion", static_cast<int32_t>(plugin->getId()));
             fillWaterMidiBufferFromEngineEvents(midi, engineEvents);
             carla_zeroStructs(engineEvents, kMaxEngineEventInternalCount);
         }
@@ -2598,6 +2709,7 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
 
     // put events in water buffer
     {
+        const ScopedEngineTraceSpan sets("event conversion");
         midiBuffer.clear();
         fillWaterMidiBufferFromEngineEvents(midiBuffer, data->events.in);
     }
@@ -2633,7 +2745,10 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
     }
 
     // ready to go!
-    graph.processBlockWithCV(audioBuffer, cvInBuffer, cvOutBuffer, midiBuffer);
+    {
+        const ScopedEngineTraceSpan sets("graph render");
+        graph.processBlockWithCV(audioBuffer, cvInBuffer, cvOutBuffer, midiBuffer);
+    }
 
     // put water audio and cv in carla buffer
     {
@@ -2648,6 +2763,7 @@ void PatchbayGraph::process(CarlaEngine::ProtectedData* const data,
 
     // put water events in carla buffer
     {
+        const ScopedEngineTraceSpan sets("event conversion");
         carla_zeroStructs(data->events.out, kMaxEngineEventInternalCount);
         fillEngineEventsFromWaterMidiBuffer(data->events.out, midiBuffer);
         midiBuffer.clear();
@@ -2788,6 +2904,8 @@ PatchbayGraph* EngineInternalGraph::getPatchbayGraphOrNull() const noexcept
 
 void EngineInternalGraph::process(CarlaEngine::ProtectedData* const data, const float* const* const inBuf, float* const* const outBuf, const uint32_t frames)
 {
+    const ScopedEngineTraceSpan sets("graph");
+
     if (fIsRack)
     {
         CARLA_SAFE_ASSERT_RETURN(fRack != nullptr,);
@@ -2805,6 +2923,7 @@ void EngineInternalGraph::processRack(CarlaEngine::ProtectedData* const data, co
     CARLA_SAFE_ASSERT_RETURN(fIsRack,);
     CARLA_SAFE_ASSERT_RETURN(fRack != nullptr,);
 
+    const ScopedEngineTraceSpan sets("graph");
     fRack->process(data, inBuf, outBuf, frames);
 }
 
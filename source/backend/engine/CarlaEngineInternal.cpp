@@ -18,6 +18,9 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaPlugin.hpp"
 #include "CarlaSemUtils.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include "water/files/File.h"
 
 #include "jackbridge/JackBridge.hpp"
 
@@ -371,6 +374,77 @@ void EngineNextAction::clearAndReset() noexcept
     mutex.unlock();
 }
 
+// -----------------------------------------------------------------------
+// ProjectWriter
+
+EngineProjectWriter::EngineProjectWriter() noexcept
+    : CarlaThread("CarlaEngineProjectWriter"),
+      fFilename(),
+      fData(),
+      fSerializeTimeMs(0),
+      fLastSaveTimeMs(0) {}
+
+EngineProjectWriter::~EngineProjectWriter() noexcept
+{
+    // let a pending write finish, the file would be left untouched otherwise
+    waitForWrite();
+}
+
+bool EngineProjectWriter::write(const char* const filename,
+                                const void* const data, const std::size_t size, const uint32_t serializeTimeMs)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr && size != 0, false);
+
+    if (isThreadRunning())
+        return false;
+
+    fFilename = filename;
+    fData.assign(static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    fSerializeTimeMs = serializeTimeMs;
+
+    return startThread();
+}
+
+bool EngineProjectWriter::isWriting() const noexcept
+{
+    return isThreadRunning();
+}
+
+void EngineProjectWriter::waitForWrite() noexcept
+{
+    // run() does not check for exit requests, this simply waits for it to finish
+    stopThread(-1);
+}
+
+uint32_t EngineProjectWriter::getLastSaveTime() const noexcept
+{
+    return fLastSaveTimeMs;
+}
+
+void EngineProjectWriter::run()
+{
+    const uint32_t startTime = carla_gettime_ms();
+
+    // replaceWithData writes into a temporary file first, then renames it over the target
+    const bool ok = water::File(fFilename.buffer()).replaceWithData(&fData.front(), fData.size());
+
+    const uint32_t writeTimeMs = carla_gettime_ms() - startTime;
+
+    if (ok)
+    {
+        fLastSaveTimeMs = fSerializeTimeMs + writeTimeMs;
+        carla_stdout("Saved project '%s' in %u ms (%u ms serializing, %u ms writing)",
+                     fFilename.buffer(), fSerializeTimeMs + writeTimeMs, fSerializeTimeMs, writeTimeMs);
+    }
+    else
+    {
+        carla_stderr2("Failed to write project file '%s'", fFilename.buffer());
+    }
+
+    fData.clear();
+}
+
 // -----------------------------------------------------------------------
 // Helper functions
 
@@ -384,6 +458,8 @@ EngineEvent* CarlaEngine::getInternalEventBuffer(const bool isInput) const noexc
 
 CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
     : runner(engine),
+      workerPool(engine),
+      bridgePool(engine),
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
       osc(engine),
 #endif
@@ -414,6 +490,7 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
       plugins(nullptr),
       xruns(0),
       dspLoad(0.0f),
+      cycleTime(),
 #endif
       pluginsToDeleteMutex(),
       pluginsToDelete(),
@@ -422,11 +499,16 @@ CarlaEngine::ProtectedData::ProtectedData(CarlaEngine* const engine)
       graph(engine),
 #endif
       time(timeInfo, options.transportMode),
-      nextAction()
+      nextAction(),
+      projectWriter(),
+      audioThreadPriority(0)
 {
 #ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    plugins[0].plugin = nullptr;
-    carla_zeroStructs(plugins[0].peaks, 1);
+    for (uint i=0; i < kMaxBridgeGroupPlugins; ++i)
+    {
+        plugins[i].plugin = nullptr;
+        carla_zeroFloats(plugins[i].peaks, 4);
+    }
 #endif
 }
 
@@ -480,7 +562,7 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
         maxPluginNumber = MAX_PATCHBAY_PLUGINS;
         break;
     case ENGINE_PROCESS_MODE_BRIDGE:
-        maxPluginNumber = 1;
+        maxPluginNumber = kMaxBridgeGroupPlugins;
         break;
     default:
         maxPluginNumber = MAX_DEFAULT_PLUGINS;
@@ -517,10 +599,12 @@ bool CarlaEngine::ProtectedData::init(const char* const clientName)
     plugins = new EnginePluginData[maxPluginNumber];
     xruns = 0;
     dspLoad = 0.0f;
+    cycleTime.requestReset();
 #endif
 
     nextAction.clearAndReset();
     runner.start();
+    bridgePool.start();
 
     return true;
 }
@@ -536,6 +620,8 @@ void CarlaEngine::ProtectedData::close()
     aboutToClose = true;
 
     runner.stop();
+    workerPool.stop();
+    bridgePool.stop();
     nextAction.clearAndReset();
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
@@ -697,6 +783,28 @@ void CarlaEngine::ProtectedData::doNextPluginAction() noexcept
     }
 }
 
+// the engine whose audio thread policy was applied to the current thread
+static thread_local const void* tAudioThreadPolicyOwner = nullptr;
+
+void CarlaEngine::ProtectedData::applyAudioThreadPolicy() noexcept
+{
+    if (tAudioThreadPolicyOwner == this)
+        return;
+
+    tAudioThreadPolicyOwner = this;
+
+#ifndef CARLA_OS_WIN
+    int policy;
+    struct sched_param param;
+
+    if (pthread_getschedparam(pthread_self(), &policy, &param) == 0)
+        audioThreadPriority = (policy == SCHED_FIFO || policy == SCHED_RR) ? param.sched_priority : 0;
+#endif
+
+    if (options.audioCpuSet != nullptr)
+        CarlaThread::setCurrentThreadAffinity(options.audioCpuSet);
+}
+
 // -----------------------------------------------------------------------
 // PendingRtEventsRunner
 
@@ -725,14 +833,43 @@ PendingRtEventsRunner::PendingRtEventsRunner(CarlaEngine* const engine,
                                              const uint32_t frames,
                                              const bool calcDSPLoad) noexcept
     : pData(engine->pData),
-      prevTime(calcDSPLoad ? getTimeInMicroseconds() : 0)
+      rtContext(engine->isOffline() ? kCarlaRtSanitizerNoContext : kCarlaRtSanitizerEngineContext),
+      prevTime(calcDSPLoad ? getTimeInMicroseconds() : 0),
+      traceEnabled(CarlaEngineTrace::isEnabled()),
+      startTime(calcDSPLoad || traceEnabled ? carla_gettime_ns() : 0)
 {
+    // offline processing may run on any thread
+    if (! engine->isOffline())
+        pData->applyAudioThreadPolicy();
+
     pData->time.preProcess(frames);
 }
 
 PendingRtEventsRunner::~PendingRtEventsRunner() noexcept
 {
-    pData->doNextPluginAction();
+    if (traceEnabled)
+    {
+        const uint64_t actionStartTime = carla_gettime_ns();
+        pData->doNextPluginAction();
+        const uint64_t endTime = carla_gettime_ns();
+
+        CarlaEngineTrace::addEvent("post-rt actions", actionStartTime, endTime);
+        CarlaEngineTrace::addEvent("cycle", startTime, endTime);
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        if (prevTime > 0)
+            pData->cycleTime.add(endTime - startTime);
+#endif
+    }
+    else
+    {
+        pData->doNextPluginAction();
+
+#ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+        if (prevTime > 0)
+            pData->cycleTime.add(carla_gettime_ns() - startTime);
+#endif
+    }
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (prevTime > 0)
@@ -18,9 +18,15 @@
 #ifndef CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 #define CARLA_ENGINE_INTERNAL_HPP_INCLUDED
 
+#include "CarlaEngineBridgePool.hpp"
 #include "CarlaEngineRunner.hpp"
+#include "CarlaEngineTrace.hpp"
 #include "CarlaEngineUtils.hpp"
+#include "CarlaEngineWorkerPool.hpp"
 #include "CarlaPlugin.hpp"
+#include "CarlaProcessTimeHistogram.hpp"
+#include "CarlaRtSanitizer.hpp"
+#include "CarlaThread.hpp"
 #include "LinkedList.hpp"
 
 #ifndef BUILD_BRIDGE
@@ -34,6 +40,7 @@
 # include "water/memory/Atomic.h"
 #endif
 
+#include <atomic>
 #include <vector>
 
 // FIXME only use CARLA_PREVENT_HEAP_ALLOCATION for structs
@@ -244,9 +251,41 @@ struct EngineNextAction {
     CARLA_DECLARE_NON_COPYABLE(EngineNextAction)
 };
 
+// -----------------------------------------------------------------------
+// EngineProjectWriter
+
+class EngineProjectWriter : private CarlaThread
+{
+public:
+    EngineProjectWriter() noexcept;
+    ~EngineProjectWriter() noexcept override;
+
+    // copy data and write it into filename on a separate thread, fails if a previous write is still pending
+    bool write(const char* filename, const void* data, std::size_t size, uint32_t serializeTimeMs);
+    bool isWriting() const noexcept;
+    void waitForWrite() noexcept;
+
+    // total time of the last finished write in ms, serializing included, 0 if none succeeded yet
+    uint32_t getLastSaveTime() const noexcept;
+
+protected:
+    void run() override;
+
+private:
+    CarlaString fFilename;
+    std::vector<uint8_t> fData;
+    uint32_t fSerializeTimeMs;
+    std::atomic<uint32_t> fLastSaveTimeMs;
+
+    CARLA_DECLARE_NON_COPYABLE(EngineProjectWriter)
+};
+
 // -----------------------------------------------------------------------
 // EnginePluginData
 
+// maximum number of plugins a bridge process can run as a group
+static constexpr const uint kMaxBridgeGroupPlugins = 16;
+
 struct EnginePluginData {
     CarlaPluginPtr plugin;
     float peaks[4];
@@ -268,6 +307,8 @@ struct EnginePluginData {
 
 struct CarlaEngine::ProtectedData {
     CarlaEngineRunner runner;
+    CarlaEngineWorkerPool workerPool;
+    CarlaEngineBridgePool bridgePool;
 
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
     CarlaEngineOsc osc;
@@ -304,11 +345,12 @@ struct CarlaEngine::ProtectedData {
     EngineTimeInfo timeInfo;
 
 #ifdef BUILD_BRIDGE_ALTERNATIVE_ARCH
-    EnginePluginData plugins[1];
+    EnginePluginData plugins[kMaxBridgeGroupPlugins];
 #else
     EnginePluginData* plugins;
     uint32_t xruns;
     float dspLoad;
+    CarlaProcessTimeHistogram cycleTime;
 #endif
     float peaks[4];
 
@@ -321,6 +363,10 @@ struct CarlaEngine::ProtectedData {
 #endif
     EngineInternalTime   time;
     EngineNextAction     nextAction;
+    EngineProjectWriter  projectWriter;
+
+    // realtime priority of the engine audio thread, 0 if unknown or not realtime
+    std::atomic<int> audioThreadPriority;
 
     // -------------------------------------------------------------------
 
@@ -346,6 +392,11 @@ struct CarlaEngine::ProtectedData {
 
     // -------------------------------------------------------------------
 
+    // apply the audio CPU set to the calling audio thread and note its priority, once per thread
+    void applyAudioThreadPolicy() noexcept;
+
+    // -------------------------------------------------------------------
+
 #ifdef CARLA_PROPER_CPP11_SUPPORT
     ProtectedData() = delete;
     CARLA_DECLARE_NON_COPYABLE(ProtectedData)
@@ -364,7 +415,10 @@ public:
 
 private:
     CarlaEngine::ProtectedData* const pData;
+    const ScopedRtSanitizerContext rtContext;
     int64_t prevTime;
+    const bool traceEnabled;
+    const uint64_t startTime;
 
     CARLA_PREVENT_HEAP_ALLOCATION
     CARLA_DECLARE_NON_COPYABLE(PendingRtEventsRunner)
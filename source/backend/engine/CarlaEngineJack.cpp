@@ -12,6 +12,7 @@
 #include "CarlaMIDI.h"
 #include "CarlaPatchbayUtils.hpp"
 #include "CarlaStringList.hpp"
+#include "CarlaTimeUtils.hpp"
 
 #include "jackey.h"
 
@@ -2987,6 +2988,7 @@ protected:
 
             if (eventIn != nullptr)
             {
+                const ScopedEngineTraceSpan sets("event conversion");
                 ushort engineEventIndex = 0;
 
                 jack_midi_event_t jackEvent;
@@ -3022,6 +3024,7 @@ protected:
             // output control
             if (eventOut != nullptr)
             {
+                const ScopedEngineTraceSpan sets("event conversion");
                 jackbridge_midi_clear_buffer(eventOut);
 
                 uint8_t  size     = 0;
@@ -4035,6 +4038,9 @@ private:
 
     void processPlugin(CarlaPluginPtr& plugin, const uint32_t nframes)
     {
+        // plugin clients have their own process threads
+        const ScopedRtSanitizerContext srsc1(fFreewheel ? kCarlaRtSanitizerNoContext : kCarlaRtSanitizerEngineContext);
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         CarlaEngineJackClient* const client = (CarlaEngineJackClient*)plugin->getEngineClient();
         CarlaEngineJackCVSourcePorts& cvSourcePorts(client->getCVSourcePorts());
@@ -4126,7 +4132,10 @@ private:
             }
         }
 
+        const ScopedRtSanitizerContext srsc(static_cast<int32_t>(plugin->getId()));
+        const uint64_t processStartTime = carla_gettime_ns();
         plugin->process(audioIn, audioOut, cvIn, cvOut, nframes);
+        plugin->addProcessTime(processStartTime, carla_gettime_ns());
 
         for (uint32_t i=0; i < audioOutCount && i < 2; ++i)
         {
@@ -4385,6 +4394,7 @@ private:
     static int JACKBRIDGE_API carla_jack_xrun_callback(void* arg)
     {
         ++(handlePtr->pData->xruns);
+        CarlaEngineTrace::addInstantEvent("xrun");
         return 0;
     }
 #endif
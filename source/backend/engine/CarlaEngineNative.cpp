@@ -1470,6 +1470,19 @@ protected:
                           static_cast<double>(plugData.peaks[3]));
             CARLA_SAFE_ASSERT_RETURN(fUiServer.writeMessage(tmpBuf),);
 
+            const PluginProcessTimeStats dspStats(plugin->getProcessTimeStats());
+
+            std::snprintf(tmpBuf, STR_MAX, "DSPSTATS_%i\n", i);
+            CARLA_SAFE_ASSERT_RETURN(fUiServer.writeMessage(tmpBuf),);
+            std::snprintf(tmpBuf, STR_MAX, P_UINT64 ":%.12g:%.12g:%.12g:%.12g:" P_UINT64 "\n",
+                          dspStats.count,
+                          static_cast<double>(dspStats.minTime),
+                          static_cast<double>(dspStats.avgTime),
+                          static_cast<double>(dspStats.maxTime),
+                          static_cast<double>(dspStats.p99Time),
+                          dspStats.sleepCount);
+            CARLA_SAFE_ASSERT_RETURN(fUiServer.writeMessage(tmpBuf),);
+
             fUiServer.syncMessages();
 
             for (uint32_t j=0, count=plugin->getParameterCount(); j < count; ++j)
@@ -1491,7 +1504,7 @@ protected:
     // -------------------------------------------------------------------
     // Plugin state calls
 
-    char* getState() const
+    char* getState()
     {
         MemoryOutputStream out;
         saveProjectInternal(out);
@@ -1807,6 +1820,22 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
     {
         fEngine->setActionCanceled(true);
     }
+    else if (std::strcmp(msg, "engine_set_tracing") == 0)
+    {
+        bool enabled;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsBool(enabled), true);
+
+        fEngine->setTraceEnabled(enabled);
+    }
+    else if (std::strcmp(msg, "engine_save_trace") == 0)
+    {
+        const char* filename;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(filename, false), true);
+
+        ok = fEngine->saveTrace(filename);
+    }
     else if (std::strcmp(msg, "load_file") == 0)
     {
         const char* filename;
@@ -2278,6 +2307,15 @@ bool CarlaEngineNativeUI::msgReceived(const char* const msg) noexcept
             _updateParamValues(plugin, pluginId, false, true);
         }
     }
+    else if (std::strcmp(msg, "reset_plugin_dsp_stats") == 0)
+    {
+        uint32_t pluginId;
+
+        CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(pluginId), true);
+
+        if (const CarlaPluginPtr plugin = fEngine->getPlugin(pluginId))
+            plugin->resetProcessTimeStats();
+    }
     else if (std::strcmp(msg, "randomize_parameters") == 0)
     {
         uint32_t pluginId;
@@ -117,6 +117,7 @@ public:
     void sendRuntimeInfo() const noexcept;
     void sendParameterValue(uint pluginId, uint32_t index, float value) const noexcept;
     void sendPeaks(uint pluginId, const float peaks[4]) const noexcept;
+    void sendPluginDspStats(const CarlaPluginPtr& plugin) const noexcept;
 
     // -------------------------------------------------------------------
 
@@ -158,6 +159,7 @@ private:
     int handleMsgSetMidiProgram(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgNoteOn(CARLA_ENGINE_OSC_HANDLE_ARGS);
     int handleMsgNoteOff(CARLA_ENGINE_OSC_HANDLE_ARGS);
+    int handleMsgResetDspStats(CARLA_ENGINE_OSC_HANDLE_ARGS);
 
     // -----------------------------------------------------------------------
 
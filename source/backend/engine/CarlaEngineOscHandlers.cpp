@@ -201,6 +201,8 @@ int CarlaEngineOsc::handleMessage(const bool isTCP, const char* const path,
         return handleMsgNoteOn(plugin, argc, argv, types);
     if (std::strcmp(method, "note_off") == 0)
         return handleMsgNoteOff(plugin, argc, argv, types);
+    if (std::strcmp(method, "reset_dsp_stats") == 0)
+        return handleMsgResetDspStats(plugin, argc, argv, types);
 
     // Send all other methods to plugins, TODO
     plugin->handleOscMessage(method, argc, argv, types, msg);
@@ -351,6 +353,27 @@ int CarlaEngineOsc::handleMsgControl(const char* const method,
         ok = true;
         fEngine->setActionCanceled(true);
     }
+    else if (std::strcmp(method, "engine_set_tracing") == 0)
+    {
+        CARLA_SAFE_ASSERT_RETURN_OSC_ERR(argc == 2);
+        CARLA_SAFE_ASSERT_RETURN_OSC_ERR(types[1] == 'i');
+
+        ok = true;
+        fEngine->setTraceEnabled(argv[1]->i != 0);
+    }
+    else if (std::strcmp(method, "engine_save_trace") == 0)
+    {
+        CARLA_SAFE_ASSERT_RETURN_OSC_ERR(argc == 2);
+        CARLA_SAFE_ASSERT_RETURN_OSC_ERR(types[1] == 's');
+
+        const char* const filename = &argv[1]->s;
+        CARLA_SAFE_ASSERT_RETURN_OSC_ERR(filename != nullptr && filename[0] != '\0');
+
+        ok = fEngine->saveTrace(filename);
+
+        if (! ok)
+            fEngine->setLastError("Failed to save trace file");
+    }
     else if (std::strcmp(method, "patchbay_connect") == 0)
     {
         CARLA_SAFE_ASSERT_RETURN_OSC_ERR(argc == 6);
@@ -795,6 +818,18 @@ int CarlaEngineOsc::handleMsgNoteOff(CARLA_ENGINE_OSC_HANDLE_ARGS)
     return 0;
 }
 
+int CarlaEngineOsc::handleMsgResetDspStats(CARLA_ENGINE_OSC_HANDLE_ARGS)
+{
+    carla_debug("CarlaEngineOsc::handleMsgResetDspStats()");
+    CARLA_ENGINE_OSC_CHECK_OSC_TYPES(0, "");
+
+    // no arguments
+    (void)argv;
+
+    plugin->resetProcessTimeStats();
+    return 0;
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
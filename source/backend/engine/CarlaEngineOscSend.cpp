@@ -399,6 +399,25 @@ void CarlaEngineOsc::sendPeaks(const uint pluginId, const float peaks[4]) const
                 static_cast<double>(peaks[3]));
 }
 
+void CarlaEngineOsc::sendPluginDspStats(const CarlaPluginPtr& plugin) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.path != nullptr && fControlDataUDP.path[0] != '\0',);
+    CARLA_SAFE_ASSERT_RETURN(fControlDataUDP.target != nullptr,);
+
+    const PluginProcessTimeStats stats(plugin->getProcessTimeStats());
+
+    char targetPath[std::strlen(fControlDataUDP.path)+5];
+    std::strcpy(targetPath, fControlDataUDP.path);
+    std::strcat(targetPath, "/dsp");
+    try_lo_send(fControlDataUDP.target, targetPath, "ihffffh", static_cast<int32_t>(plugin->getId()),
+                static_cast<int64_t>(stats.count),
+                static_cast<double>(stats.minTime),
+                static_cast<double>(stats.avgTime),
+                static_cast<double>(stats.maxTime),
+                static_cast<double>(stats.p99Time),
+                static_cast<int64_t>(stats.sleepCount));
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
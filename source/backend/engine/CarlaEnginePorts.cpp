@@ -344,6 +344,9 @@ bool CarlaEngineEventPort::writeMidiEvent(const uint32_t time, const uint8_t cha
 // -----------------------------------------------------------------------
 // Carla Engine Meta CV port
 
+// smallest change, relative to the port range, sent as a parameter event while CV keeps moving
+static constexpr const float kCVEventThreshold = 1.0f / 2048.0f;
+
 CarlaEngineCVSourcePorts::CarlaEngineCVSourcePorts()
     : pData(new ProtectedData())
 {
@@ -367,7 +370,10 @@ bool CarlaEngineCVSourcePorts::addCVSource(CarlaEngineCVPort* const port,
     {
         const CarlaRecursiveMutexLocker crml(pData->rmutex);
 
-        const CarlaEngineEventCV ecv = { port, portIndexOffset, 0.0f };
+        if (pData->cvEvents == nullptr)
+            pData->cvEvents = new EngineEvent[kMaxEngineEventInternalCount];
+
+        const CarlaEngineEventCV ecv = { port, portIndexOffset, 0.0f, 0.0f };
         if (! pData->cvs.add(ecv))
             return false;
 
@@ -441,9 +447,11 @@ void CarlaEngineCVSourcePorts::initPortBuffers(const float* const* const buffers
     if (eventCount == kMaxEngineEventInternalCount)
         return;
 
-    // TODO be sample accurate
+    const uint resolution = sampleAccurate
+                          ? eventPort->getEngineClient().getEngine().getOptions().cvEventResolution
+                          : 0;
 
-    if (true || ! sampleAccurate)
+    if (resolution == 0)
     {
         const uint32_t eventFrame = eventCount == 0 ? 0 : std::min(buffer[eventCount-1].time, frames-1U);
 
@@ -475,7 +483,63 @@ void CarlaEngineCVSourcePorts::initPortBuffers(const float* const* const buffers
             }
 
             ecv.previousValue = previousValue;
+            ecv.lastReadValue = v;
         }
+
+        return;
+    }
+
+    // read CV every "resolution" frames, then merge the new events by time with the existing ones
+    EngineEvent* const cvEvents = pData->cvEvents;
+    CARLA_SAFE_ASSERT_RETURN(cvEvents != nullptr,);
+
+    const uint32_t maxCvEvents = kMaxEngineEventInternalCount - eventCount;
+    uint32_t numCvEvents = 0;
+
+    for (uint32_t frame = 0; frame < frames && numCvEvents < maxCvEvents; frame += resolution)
+    {
+        for (int i = 0; i < numCVs && numCvEvents < maxCvEvents; ++i)
+        {
+            CarlaEngineEventCV& ecv(pData->cvs.getReference(i));
+            CARLA_SAFE_ASSERT_CONTINUE(ecv.cvPort != nullptr);
+            CARLA_SAFE_ASSERT_CONTINUE(buffers[i] != nullptr);
+
+            v = buffers[i][frame];
+
+            // small steps are skipped while CV is moving, the exact value is sent once it settles
+            const bool settled = carla_isEqual(v, ecv.lastReadValue);
+            ecv.lastReadValue = v;
+
+            if (carla_isEqual(v, ecv.previousValue))
+                continue;
+
+            ecv.cvPort->getRange(min, max);
+
+            if (! settled && std::abs(v - ecv.previousValue) < kCVEventThreshold * std::abs(max - min))
+                continue;
+
+            ecv.previousValue = v;
+
+            EngineEvent& event(cvEvents[numCvEvents++]);
+
+            event.type    = kEngineEventTypeControl;
+            event.time    = frame;
+            event.channel = kEngineEventNonMidiChannel;
+
+            event.ctrl.type            = kEngineControlEventTypeParameter;
+            event.ctrl.param           = static_cast<uint16_t>(ecv.indexOffset);
+            event.ctrl.midiValue       = -1;
+            event.ctrl.normalizedValue = carla_fixedValue(0.0f, 1.0f, (v - min) / (max - min));
+        }
+    }
+
+    // CV events go after existing events with the same time
+    for (uint32_t prev = eventCount, cv = numCvEvents, w = eventCount + numCvEvents; cv != 0;)
+    {
+        if (prev != 0 && buffer[prev-1].time > cvEvents[cv-1].time)
+            buffer[--w] = buffer[--prev];
+        else
+            buffer[--w] = cvEvents[--cv];
     }
 }
 
@@ -29,7 +29,8 @@ CARLA_BACKEND_START_NAMESPACE
 struct CarlaEngineEventCV {
     CarlaEngineCVPort* cvPort;
     uint32_t indexOffset;
-    float previousValue;
+    float previousValue; // last value sent as event
+    float lastReadValue; // last value read from the CV buffer
 };
 
 struct CarlaEngineCVSourcePorts::ProtectedData {
@@ -39,6 +40,8 @@ struct CarlaEngineCVSourcePorts::ProtectedData {
     CarlaPluginPtr plugin;
 #endif
     water::Array<CarlaEngineEventCV> cvs;
+    // sample-accurate CV events before being merged into the event port, allocated with the first CV source
+    EngineEvent* cvEvents;
 
     ProtectedData() noexcept
         : rmutex(),
@@ -46,11 +49,13 @@ struct CarlaEngineCVSourcePorts::ProtectedData {
           graph(nullptr),
           plugin(nullptr),
 #endif
-          cvs() {}
+          cvs(),
+          cvEvents(nullptr) {}
 
     ~ProtectedData()
     {
         CARLA_SAFE_ASSERT(cvs.size() == 0);
+        delete[] cvEvents;
     }
 
     void cleanup()
@@ -0,0 +1,366 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaEngineRender.hpp"
+#include "CarlaMathUtils.hpp"
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+// maximum amount of frames moved through the ring buffer at once
+static constexpr const uint32_t kRenderChunkFrames = 4096;
+
+// WAV header: RIFF + fmt (extensible) + fact + data
+static constexpr const uint32_t kWavHeaderSize = 12 + 8 + 40 + 12 + 8;
+
+static void writeLE16(uint8_t* const buf, const uint16_t value) noexcept
+{
+    buf[0] = static_cast<uint8_t>(value & 0xff);
+    buf[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static void writeLE32(uint8_t* const buf, const uint32_t value) noexcept
+{
+    buf[0] = static_cast<uint8_t>(value & 0xff);
+    buf[1] = static_cast<uint8_t>((value >> 8) & 0xff);
+    buf[2] = static_cast<uint8_t>((value >> 16) & 0xff);
+    buf[3] = static_cast<uint8_t>(value >> 24);
+}
+
+// -----------------------------------------------------------------------
+
+CarlaEngineRenderWriter::CarlaEngineRenderWriter()
+    : CarlaThread("CarlaEngineRenderWriter"),
+      fChannels(0),
+      fSampleRate(0),
+      fFramesWritten(0),
+#ifdef HAVE_SNDFILE
+      fSndFile(nullptr),
+#endif
+      fWavFile(nullptr),
+      fRingMutex(),
+      fRing(),
+      fDataAvailable(),
+      fSpaceAvailable(),
+      fInterleaved(),
+      fFinishing(false),
+      fFailed(false),
+      fLastError() {}
+
+CarlaEngineRenderWriter::~CarlaEngineRenderWriter()
+{
+    close();
+}
+
+bool CarlaEngineRenderWriter::open(const char* const filename, const uint32_t channels, const double sampleRate)
+{
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    CARLA_SAFE_ASSERT_RETURN(channels != 0, false);
+    CARLA_SAFE_ASSERT_RETURN(sampleRate > 0.0, false);
+    CARLA_SAFE_ASSERT_RETURN(! isThreadRunning(), false);
+    carla_debug("CarlaEngineRenderWriter::open(\"%s\", %u, %g)", filename, channels, sampleRate);
+
+    fChannels = channels;
+    fSampleRate = static_cast<uint32_t>(sampleRate + 0.5);
+    fFramesWritten = 0;
+    fFinishing = false;
+    fFailed = false;
+    fLastError.clear();
+
+    CarlaString lowerFilename(filename);
+    lowerFilename.toLower();
+    const bool isFlac = lowerFilename.endsWith(".flac");
+
+#ifdef HAVE_SNDFILE
+    SF_INFO info;
+    carla_zeroStruct(info);
+    info.samplerate = static_cast<int>(fSampleRate);
+    info.channels   = static_cast<int>(channels);
+    info.format     = isFlac ? (SF_FORMAT_FLAC | SF_FORMAT_PCM_24) : (SF_FORMAT_RF64 | SF_FORMAT_FLOAT);
+
+    fSndFile = sf_open(filename, SFM_WRITE, &info);
+
+    if (fSndFile == nullptr)
+    {
+        fLastError = sf_strerror(nullptr);
+        return false;
+    }
+
+    if (isFlac)
+        sf_command(fSndFile, SFC_SET_CLIPPING, nullptr, SF_TRUE);
+    else
+        sf_command(fSndFile, SFC_RF64_AUTO_DOWNGRADE, nullptr, SF_TRUE);
+#else
+    if (isFlac)
+    {
+        fLastError = "FLAC output requires Carla to be built with libsndfile";
+        return false;
+    }
+
+    fWavFile = std::fopen(filename, "wb");
+
+    if (fWavFile == nullptr)
+    {
+        fLastError = "Failed to create output file";
+        return false;
+    }
+
+    if (! writeWavHeader())
+    {
+        std::fclose(fWavFile);
+        fWavFile = nullptr;
+        fLastError = "Failed to write output file header";
+        return false;
+    }
+#endif
+
+    // about 2 seconds of audio
+    const uint32_t frameSize = static_cast<uint32_t>(sizeof(float)) * channels;
+    fRing.createBuffer(std::max(fSampleRate * 2, kRenderChunkFrames * 4) * frameSize, false);
+    fInterleaved.resize(kRenderChunkFrames * channels);
+
+    return startThread();
+}
+
+bool CarlaEngineRenderWriter::write(const float* const* const buffers, const uint32_t frames)
+{
+    CARLA_SAFE_ASSERT_RETURN(buffers != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(isThreadRunning(), false);
+
+    const uint32_t frameSize = static_cast<uint32_t>(sizeof(float)) * fChannels;
+
+    for (uint32_t offset = 0; offset < frames;)
+    {
+        const uint32_t chunkFrames = std::min(frames - offset, kRenderChunkFrames);
+
+        for (uint32_t i=0; i < chunkFrames; ++i)
+            for (uint32_t c=0; c < fChannels; ++c)
+                fInterleaved[i * fChannels + c] = buffers[c][offset + i];
+
+        for (bool written = false; ! written;)
+        {
+            if (fFailed)
+                return false;
+
+            {
+                const CarlaMutexLocker cml(fRingMutex);
+
+                if (fRing.getWritableDataSize() >= chunkFrames * frameSize)
+                {
+                    fRing.writeCustomData(fInterleaved.data(), chunkFrames * frameSize);
+                    fRing.commitWrite();
+                    written = true;
+                }
+            }
+
+            if (written)
+                fDataAvailable.signal();
+            else
+                fSpaceAvailable.wait();
+        }
+
+        offset += chunkFrames;
+    }
+
+    return true;
+}
+
+bool CarlaEngineRenderWriter::close()
+{
+    if (isThreadRunning())
+    {
+        fFinishing = true;
+        fDataAvailable.signal();
+        stopThread(-1);
+    }
+
+    bool ok = ! fFailed;
+
+#ifdef HAVE_SNDFILE
+    if (fSndFile != nullptr)
+    {
+        sf_write_sync(fSndFile);
+
+        if (sf_close(fSndFile) != 0)
+        {
+            fLastError = "Failed to close output file";
+            ok = false;
+        }
+
+        fSndFile = nullptr;
+    }
+#endif
+
+    if (fWavFile != nullptr)
+    {
+        if (! finalizeWavHeader())
+        {
+            if (fLastError.isEmpty())
+                fLastError = "Failed to finalize output file";
+            ok = false;
+        }
+
+        std::fclose(fWavFile);
+        fWavFile = nullptr;
+    }
+
+    fRing.deleteBuffer();
+    return ok;
+}
+
+const char* CarlaEngineRenderWriter::getLastError() const noexcept
+{
+    return fLastError.buffer();
+}
+
+// -----------------------------------------------------------------------
+
+void CarlaEngineRenderWriter::run()
+{
+    const uint32_t frameSize = static_cast<uint32_t>(sizeof(float)) * fChannels;
+    std::vector<float> chunk(kRenderChunkFrames * fChannels);
+
+    for (;;)
+    {
+        // must be checked before reading, so that data queued right before finishing is not lost
+        const bool finishing = fFinishing;
+        uint32_t size;
+
+        {
+            const CarlaMutexLocker cml(fRingMutex);
+
+            size = std::min(fRing.getReadableDataSize(), kRenderChunkFrames * frameSize);
+            size -= size % frameSize;
+
+            if (size != 0)
+                fRing.readCustomData(chunk.data(), size);
+        }
+
+        if (size == 0)
+        {
+            if (finishing)
+                break;
+
+            fDataAvailable.wait();
+            continue;
+        }
+
+        fSpaceAvailable.signal();
+
+        if (! writeToFile(chunk.data(), size / frameSize))
+        {
+            fFailed = true;
+            fSpaceAvailable.signal();
+            break;
+        }
+    }
+}
+
+bool CarlaEngineRenderWriter::writeToFile(const float* const interleaved, const uint32_t frames)
+{
+#ifdef HAVE_SNDFILE
+    if (fSndFile != nullptr)
+    {
+        if (sf_writef_float(fSndFile, interleaved, frames) != static_cast<sf_count_t>(frames))
+        {
+            fLastError = sf_strerror(fSndFile);
+            return false;
+        }
+
+        fFramesWritten += frames;
+        return true;
+    }
+#endif
+
+    CARLA_SAFE_ASSERT_RETURN(fWavFile != nullptr, false);
+
+    // plain WAV sizes are 32-bit
+    if ((fFramesWritten + frames) * fChannels * sizeof(float) > UINT32_MAX - kWavHeaderSize)
+    {
+        fLastError = "Output file reached the WAV size limit";
+        return false;
+    }
+
+    if (std::fwrite(interleaved, sizeof(float) * fChannels, frames, fWavFile) != frames)
+    {
+        fLastError = "Failed to write into output file";
+        return false;
+    }
+
+    fFramesWritten += frames;
+    return true;
+}
+
+// -----------------------------------------------------------------------
+
+bool CarlaEngineRenderWriter::writeWavHeader()
+{
+    uint8_t header[kWavHeaderSize];
+    carla_zeroBytes(header, kWavHeaderSize);
+
+    const uint16_t blockAlign = static_cast<uint16_t>(sizeof(float) * fChannels);
+
+    // RIFF, sizes are filled in later
+    std::memcpy(header, "RIFF", 4);
+    std::memcpy(header + 8, "WAVE", 4);
+
+    // fmt, WAVE_FORMAT_EXTENSIBLE with IEEE float subformat
+    uint8_t* const fmt = header + 12;
+    std::memcpy(fmt, "fmt ", 4);
+    writeLE32(fmt + 4, 40);
+    writeLE16(fmt + 8, 0xfffe);
+    writeLE16(fmt + 10, static_cast<uint16_t>(fChannels));
+    writeLE32(fmt + 12, fSampleRate);
+    writeLE32(fmt + 16, fSampleRate * blockAlign);
+    writeLE16(fmt + 20, blockAlign);
+    writeLE16(fmt + 22, 32);
+    writeLE16(fmt + 24, 22);
+    writeLE16(fmt + 26, 32);
+    writeLE32(fmt + 28, 0); // speaker positions unspecified
+
+    static const uint8_t kSubFormatFloat[16] = {
+        0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+    };
+    std::memcpy(fmt + 32, kSubFormatFloat, 16);
+
+    // fact, frame count is filled in later
+    uint8_t* const fact = fmt + 48;
+    std::memcpy(fact, "fact", 4);
+    writeLE32(fact + 4, 4);
+
+    // data
+    std::memcpy(fact + 12, "data", 4);
+
+    return std::fwrite(header, 1, kWavHeaderSize, fWavFile) == kWavHeaderSize;
+}
+
+bool CarlaEngineRenderWriter::finalizeWavHeader()
+{
+    const uint32_t dataSize = static_cast<uint32_t>(fFramesWritten * fChannels * sizeof(float));
+    uint8_t value[4];
+
+    if (std::fflush(fWavFile) != 0)
+        return false;
+
+    // RIFF size
+    writeLE32(value, kWavHeaderSize - 8 + dataSize);
+    if (std::fseek(fWavFile, 4, SEEK_SET) != 0 || std::fwrite(value, 1, 4, fWavFile) != 4)
+        return false;
+
+    // fact frame count
+    writeLE32(value, static_cast<uint32_t>(fFramesWritten));
+    if (std::fseek(fWavFile, 12 + 48 + 8, SEEK_SET) != 0 || std::fwrite(value, 1, 4, fWavFile) != 4)
+        return false;
+
+    // data size
+    writeLE32(value, dataSize);
+    if (std::fseek(fWavFile, kWavHeaderSize - 4, SEEK_SET) != 0 || std::fwrite(value, 1, 4, fWavFile) != 4)
+        return false;
+
+    return std::fflush(fWavFile) == 0;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_ENGINE_RENDER_HPP_INCLUDED
+#define CARLA_ENGINE_RENDER_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaMutex.hpp"
+#include "CarlaRingBuffer.hpp"
+#include "CarlaString.hpp"
+#include "CarlaThread.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+#ifdef HAVE_SNDFILE
+# include <sndfile.h>
+#endif
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineRenderWriter
+
+/*
+   Writes rendered audio into a file from a background thread.
+
+   The render side queues non-interleaved buffers with write(), which only blocks when the writer thread falls behind.
+   FLAC is used if the filename ends in ".flac" (requires libsndfile), otherwise the output is a 32-bit float WAV.
+  */
+
+class CarlaEngineRenderWriter : private CarlaThread
+{
+public:
+    CarlaEngineRenderWriter();
+    ~CarlaEngineRenderWriter() override;
+
+    /*
+     * Create the output file and start the writer thread.
+     */
+    bool open(const char* filename, uint32_t channels, double sampleRate);
+
+    /*
+     * Queue @a frames of audio, one buffer per channel.
+     * Returns false if the writer thread failed.
+     */
+    bool write(const float* const* buffers, uint32_t frames);
+
+    /*
+     * Wait for all queued audio to be written, then finalize and close the file.
+     */
+    bool close();
+
+    const char* getLastError() const noexcept;
+
+protected:
+    void run() override;
+
+private:
+    uint32_t fChannels;
+    uint32_t fSampleRate;
+    uint64_t fFramesWritten;
+
+#ifdef HAVE_SNDFILE
+    SNDFILE* fSndFile;
+#endif
+    std::FILE* fWavFile;
+
+    CarlaMutex fRingMutex;
+    CarlaHeapRingBuffer fRing;
+    CarlaSignal fDataAvailable;
+    CarlaSignal fSpaceAvailable;
+    std::vector<float> fInterleaved;
+
+    std::atomic<bool> fFinishing;
+    std::atomic<bool> fFailed;
+    CarlaString fLastError;
+
+    bool writeWavHeader();
+    bool finalizeWavHeader();
+    bool writeToFile(const float* interleaved, uint32_t frames);
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaEngineRenderWriter)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_RENDER_HPP_INCLUDED
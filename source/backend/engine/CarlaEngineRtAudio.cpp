@@ -621,6 +621,8 @@ protected:
             ++pData->xruns;
         if (status & RTAUDIO_OUTPUT_UNDERFLOW)
             ++pData->xruns;
+        if (status & (RTAUDIO_INPUT_OVERFLOW|RTAUDIO_OUTPUT_UNDERFLOW))
+            CarlaEngineTrace::addInstantEvent("xrun");
 
         // get buffers from RtAudio
         const float* const insPtr  = (const float*)inputBuffer;
@@ -671,6 +673,7 @@ protected:
 
         if (fMidiInEvents.mutex.tryLock())
         {
+            const ScopedEngineTraceSpan sets("event conversion");
             uint32_t engineEventIndex = 0;
             fMidiInEvents.splice();
 
@@ -19,6 +19,13 @@
 #include "CarlaEngineInternal.hpp"
 #include "CarlaPlugin.hpp"
 
+#include "CarlaRtSanitizer.hpp"
+
+#ifdef CARLA_RT_SANITIZER_SUPPORTED
+# include <execinfo.h>
+# include <unistd.h>
+#endif
+
 #include "water/misc/Time.h"
 
 CARLA_BACKEND_START_NAMESPACE
@@ -143,13 +150,28 @@ bool CarlaEngineRunner::run() noexcept
 
 #if defined(HAVE_LIBLO) && ! defined(BUILD_BRIDGE)
         // -----------------------------------------------------------
-        // Update OSC control client peaks
+        // Update OSC control client peaks and DSP time
 
         if (oscRegistedForUDP)
+        {
             engineOsc.sendPeaks(i, kEngine->getPeaks(i));
+            engineOsc.sendPluginDspStats(plugin);
+        }
 #endif
     }
 
+    // -----------------------------------------------------------
+    // Move recorded trace events out of the RT rings
+
+    if (CarlaEngineTrace::isEnabled())
+        CarlaEngineTrace::collect();
+
+    // -----------------------------------------------------------
+    // Report calls that are not realtime-safe
+
+    if (CarlaRtSanitizer::isActive())
+        reportRtSafetyViolations();
+
 #if defined(HAVE_LIBLO) && !defined(BUILD_BRIDGE)
     if (oscRegistedForUDP)
         engineOsc.sendRuntimeInfo();
@@ -171,6 +193,35 @@ bool CarlaEngineRunner::run() noexcept
     return true;
 }
 
+void CarlaEngineRunner::reportRtSafetyViolations() noexcept
+{
+    CarlaRtSanitizerViolation violation;
+
+    while (CarlaRtSanitizer::fetchViolation(violation))
+    {
+        const uint pluginId = violation.context >= 0 ? static_cast<uint>(violation.context) : MAIN_CARLA_PLUGIN_ID;
+        const CarlaPluginPtr plugin = violation.context >= 0 ? kEngine->getPlugin(pluginId) : CarlaPluginPtr();
+
+        if (plugin.get() != nullptr)
+            carla_stderr2("RT-safety violation: plugin '%s' called '%s' from the audio thread, "
+                          "%u more calls since last report", plugin->getName(), violation.funcName, violation.suppressed);
+        else
+            carla_stderr2("RT-safety violation: engine called '%s' from the audio thread, "
+                          "%u more calls since last report", violation.funcName, violation.suppressed);
+
+#ifdef CARLA_RT_SANITIZER_SUPPORTED
+        backtrace_symbols_fd(violation.frames, static_cast<int>(violation.numFrames), STDERR_FILENO);
+#endif
+
+        kEngine->callback(true, true,
+                          ENGINE_CALLBACK_RT_SAFETY_VIOLATION,
+                          pluginId,
+                          static_cast<int>(violation.suppressed + 1),
+                          0, 0, 0.0f,
+                          violation.funcName);
+    }
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
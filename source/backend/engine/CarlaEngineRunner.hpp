@@ -47,6 +47,8 @@ private:
     bool fIsAlwaysRunning;
     bool fIsPlugin;
 
+    void reportRtSafetyViolations() noexcept;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineRunner)
 };
 
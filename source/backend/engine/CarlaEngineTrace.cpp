@@ -0,0 +1,328 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaEngineTrace.hpp"
+#include "CarlaEngine.hpp"
+#include "CarlaPlugin.hpp"
+
+#include "CarlaMutex.hpp"
+#include "CarlaSpscRingBuffer.hpp"
+#include "CarlaString.hpp"
+
+#include "water/files/File.h"
+#include "water/streams/MemoryOutputStream.h"
+
+#include <deque>
+#include <vector>
+
+#include <pthread.h>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+static constexpr const uint32_t kTraceMaxThreads = 16;
+static constexpr const uint32_t kTraceRingSize   = 8192;
+static constexpr const std::size_t kTraceMaxHistory = 1000000;
+
+typedef CarlaSpscRingBuffer<EngineTraceEvent, kTraceRingSize> EngineTraceRing;
+
+struct EngineTraceState {
+    // allocated on first enable, never freed while the process runs
+    std::atomic<EngineTraceRing*> rings;
+    // set while a thread records into the ring of the same index
+    std::atomic<bool> claimed[kTraceMaxThreads];
+    // highest index of a claimed ring plus one
+    std::atomic<uint32_t> usedRings;
+    std::atomic<uint32_t> droppedEvents;
+
+    // releases the ring of a thread when it exits, created together with the rings
+    pthread_key_t threadKey;
+
+    // consumer side, protected by mutex
+    CarlaMutex mutex;
+    std::deque<EngineTraceEvent> history;
+    uint64_t lostEvents;
+
+    EngineTraceState() noexcept
+        : rings(nullptr),
+          usedRings(0),
+          droppedEvents(0),
+          threadKey(),
+          mutex(),
+          history(),
+          lostEvents(0)
+    {
+        for (uint32_t i=0; i < kTraceMaxThreads; ++i)
+            claimed[i].store(false, std::memory_order_relaxed);
+    }
+
+    // returns kTraceMaxThreads if all rings are in use
+    uint32_t claimRing() noexcept
+    {
+        for (uint32_t i=0; i < kTraceMaxThreads; ++i)
+        {
+            bool expected = false;
+
+            if (claimed[i].load(std::memory_order_relaxed)
+                || ! claimed[i].compare_exchange_strong(expected, true, std::memory_order_acq_rel))
+                continue;
+
+            for (uint32_t used = usedRings.load(std::memory_order_relaxed);
+                 used < i + 1 && ! usedRings.compare_exchange_weak(used, i + 1, std::memory_order_acq_rel);) {}
+
+            // pending events of the previous owner stay in the ring, and are collected as usual
+            pthread_setspecific(threadKey, &claimed[i]);
+            return i;
+        }
+
+        return kTraceMaxThreads;
+    }
+
+    void collectWhileLocked() noexcept
+    {
+        EngineTraceRing* const allRings = rings.load(std::memory_order_acquire);
+        CARLA_SAFE_ASSERT_RETURN(allRings != nullptr,);
+
+        const uint32_t numThreads = usedRings.load(std::memory_order_acquire);
+        EngineTraceEvent event;
+
+        for (uint32_t i=0; i < numThreads; ++i)
+        {
+            EngineTraceRing& ring(allRings[i]);
+
+            lostEvents += ring.takeOverflowCount();
+
+            try {
+                while (ring.tryPop(event))
+                {
+                    if (history.size() >= kTraceMaxHistory)
+                        history.pop_front();
+
+                    history.push_back(event);
+                }
+            } CARLA_SAFE_EXCEPTION_CONTINUE("CarlaEngineTrace::collect");
+        }
+
+        lostEvents += droppedEvents.exchange(0, std::memory_order_relaxed);
+    }
+};
+
+static EngineTraceState sTraceState;
+
+// index of the ring used by the current thread, UINT32_MAX if it has none yet
+static thread_local uint32_t tTraceThreadIndex = UINT32_MAX;
+
+static void releaseTraceRing(void* const ptr)
+{
+    static_cast<std::atomic<bool>*>(ptr)->store(false, std::memory_order_release);
+}
+
+std::atomic<bool> CarlaEngineTrace::sEnabled(false);
+
+// -----------------------------------------------------------------------
+
+void CarlaEngineTrace::addEvent(const char* const name,
+                                const uint64_t startTime,
+                                const uint64_t endTime,
+                                const int32_t pluginId) noexcept
+{
+    EngineTraceRing* const rings = sTraceState.rings.load(std::memory_order_acquire);
+
+    if (rings == nullptr)
+        return;
+
+    uint32_t threadIndex = tTraceThreadIndex;
+
+    if (threadIndex == UINT32_MAX)
+    {
+        threadIndex = sTraceState.claimRing();
+
+        // tried again on the next event, a ring might have been released by then
+        if (threadIndex == kTraceMaxThreads)
+        {
+            sTraceState.droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        tTraceThreadIndex = threadIndex;
+    }
+
+    const EngineTraceEvent event = { name, startTime, endTime, pluginId, threadIndex };
+    rings[threadIndex].tryPush(event);
+}
+
+void CarlaEngineTrace::setEnabled(const bool enabled)
+{
+    if (! enabled)
+    {
+        sEnabled.store(false, std::memory_order_relaxed);
+        collect();
+        return;
+    }
+
+    if (sTraceState.rings.load(std::memory_order_acquire) == nullptr)
+    {
+        CARLA_SAFE_ASSERT_RETURN(pthread_key_create(&sTraceState.threadKey, releaseTraceRing) == 0,);
+        sTraceState.rings.store(new EngineTraceRing[kTraceMaxThreads], std::memory_order_release);
+    }
+
+    {
+        const CarlaMutexLocker cml(sTraceState.mutex);
+
+        // drain through the consumer side, threads might still be recording into the rings
+        sTraceState.collectWhileLocked();
+
+        sTraceState.history.clear();
+        sTraceState.lostEvents = 0;
+        sTraceState.droppedEvents.store(0, std::memory_order_relaxed);
+    }
+
+    sEnabled.store(true, std::memory_order_relaxed);
+}
+
+void CarlaEngineTrace::collect() noexcept
+{
+    if (sTraceState.rings.load(std::memory_order_acquire) == nullptr)
+        return;
+
+    const CarlaMutexLocker cml(sTraceState.mutex);
+    sTraceState.collectWhileLocked();
+}
+
+// -----------------------------------------------------------------------
+
+static void writeTraceTime(water::MemoryOutputStream& out, const char* const key, const uint64_t nanoseconds)
+{
+    // microseconds with fixed decimals, independent of the current locale
+    char tmpBuf[64];
+    std::snprintf(tmpBuf, sizeof(tmpBuf), ",\"%s\":" P_UINT64 ".%03u",
+                  key, nanoseconds / 1000, static_cast<uint>(nanoseconds % 1000));
+    out << tmpBuf;
+}
+
+static void writeTraceString(water::MemoryOutputStream& out, const char* str)
+{
+    out << "\"";
+
+    for (; *str != '\0'; ++str)
+    {
+        const char c = *str;
+
+        if (c == '"' || c == '\\')
+        {
+            const char escaped[3] = { '\\', c, '\0' };
+            out << escaped;
+        }
+        else if (static_cast<uint8_t>(c) < 0x20)
+        {
+            char tmpBuf[8];
+            std::snprintf(tmpBuf, sizeof(tmpBuf), "\\u%04x", static_cast<uint>(c));
+            out << tmpBuf;
+        }
+        else
+        {
+            out.writeByte(c);
+        }
+    }
+
+    out << "\"";
+}
+
+bool CarlaEngineTrace::saveToFile(const CarlaEngine* const engine, const char* const filename)
+{
+    CARLA_SAFE_ASSERT_RETURN(engine != nullptr, false);
+    CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+    carla_debug("CarlaEngineTrace::saveToFile(%p, \"%s\")", engine, filename);
+
+    std::vector<CarlaString> pluginNames;
+
+    for (uint i=0, count=engine->getCurrentPluginCount(); i < count; ++i)
+    {
+        const CarlaPluginPtr plugin = engine->getPluginUnchecked(i);
+        pluginNames.push_back(CarlaString(plugin.get() != nullptr ? plugin->getName() : ""));
+    }
+
+    water::MemoryOutputStream out;
+    char tmpBuf[0xff];
+
+    const CarlaMutexLocker cml(sTraceState.mutex);
+
+    if (sTraceState.rings.load(std::memory_order_acquire) != nullptr)
+        sTraceState.collectWhileLocked();
+
+    // events are grouped per thread, so the earliest one is not necessarily the first
+    uint64_t baseTime = UINT64_MAX;
+
+    for (std::deque<EngineTraceEvent>::const_iterator it = sTraceState.history.begin(),
+         end = sTraceState.history.end(); it != end; ++it)
+        baseTime = std::min(baseTime, it->startTime);
+    const uint32_t numThreads = sTraceState.usedRings.load(std::memory_order_acquire);
+
+    out << "{\"traceEvents\":[\n";
+    std::snprintf(tmpBuf, sizeof(tmpBuf),
+                  "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Carla %s\"}}",
+                  engine->getCurrentDriverName());
+    out << tmpBuf;
+
+    for (uint32_t i=0; i < numThreads; ++i)
+    {
+        std::snprintf(tmpBuf, sizeof(tmpBuf),
+                      ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                      "\"args\":{\"name\":\"Thread %u\"}}", i, i);
+        out << tmpBuf;
+    }
+
+    for (std::deque<EngineTraceEvent>::const_iterator it = sTraceState.history.begin(),
+         end = sTraceState.history.end(); it != end; ++it)
+    {
+        const EngineTraceEvent& event(*it);
+        const bool isInstant = event.startTime == event.endTime;
+
+        out << ",\n{\"name\":";
+
+        if (event.pluginId >= 0 && static_cast<std::size_t>(event.pluginId) < pluginNames.size())
+        {
+            const CarlaString name(CarlaString(event.name) + ": " + pluginNames[event.pluginId]);
+            writeTraceString(out, name);
+        }
+        else
+        {
+            writeTraceString(out, event.name);
+        }
+
+        std::snprintf(tmpBuf, sizeof(tmpBuf), ",\"cat\":\"carla\",\"ph\":\"%s\",\"pid\":1,\"tid\":%u",
+                      isInstant ? "i\",\"s\":\"g" : "X", event.threadIndex);
+        out << tmpBuf;
+
+        writeTraceTime(out, "ts", event.startTime >= baseTime ? event.startTime - baseTime : 0);
+
+        if (! isInstant)
+            writeTraceTime(out, "dur", event.endTime >= event.startTime ? event.endTime - event.startTime : 0);
+
+        if (event.pluginId >= 0)
+        {
+            std::snprintf(tmpBuf, sizeof(tmpBuf), ",\"args\":{\"pluginId\":%i}", event.pluginId);
+            out << tmpBuf;
+        }
+
+        out << "}";
+    }
+
+    std::snprintf(tmpBuf, sizeof(tmpBuf),
+                  "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"lostEvents\":\"" P_UINT64 "\"}}\n",
+                  sTraceState.lostEvents);
+    out << tmpBuf;
+
+    const water::File file(filename);
+
+    if (file.replaceWithData(out.getData(), out.getDataSize()))
+        return true;
+
+    carla_stderr2("CarlaEngineTrace::saveToFile - failed to write \"%s\"", filename);
+    return false;
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
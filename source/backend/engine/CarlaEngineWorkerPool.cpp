@@ -0,0 +1,267 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaEngineWorkerPool.hpp"
+#include "CarlaEngine.hpp"
+#include "CarlaThread.hpp"
+
+#include <thread>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+
+// worker count used when the amount of threads is picked automatically
+static constexpr const uint32_t kMaxAutoWorkerCount = 8;
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool::Worker
+
+class CarlaEngineWorkerPool::Worker : public CarlaThread
+{
+public:
+    Worker(CarlaEngineWorkerPool& pool) noexcept
+        : CarlaThread("CarlaEngineWorker"),
+          kPool(pool),
+          fSem(),
+          fSemValid(carla_sem_create2(fSem, false)) {}
+
+    ~Worker() noexcept override
+    {
+        if (fSemValid)
+            carla_sem_destroy2(fSem);
+    }
+
+    bool isValid() const noexcept
+    {
+        return fSemValid;
+    }
+
+    void wake() noexcept
+    {
+        carla_sem_post(fSem);
+    }
+
+protected:
+    void run() override
+    {
+#ifndef CARLA_OS_WASM
+        while (! shouldThreadExit())
+        {
+            // timeout only used for checking if the thread should exit
+            if (! carla_sem_timedwait(fSem, 500))
+                continue;
+
+            if (shouldThreadExit())
+                break;
+
+            kPool.runTasks();
+            kPool.workerFinished();
+        }
+#endif
+    }
+
+private:
+    CarlaEngineWorkerPool& kPool;
+    carla_sem_t fSem;
+    const bool fSemValid;
+
+    CARLA_DECLARE_NON_COPYABLE(Worker)
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool
+
+CarlaEngineWorkerPool::CarlaEngineWorkerPool(CarlaEngine* const engine) noexcept
+    : kEngine(engine),
+      fWorkers(nullptr),
+      fWorkerCount(0),
+      fBusy(false),
+      fTaskFunc(nullptr),
+      fTaskPtr(nullptr),
+      fTaskCount(0),
+      fNextTask(0),
+      fPendingWorkers(0),
+      fDoneSem()
+{
+    CARLA_SAFE_ASSERT(engine != nullptr);
+}
+
+CarlaEngineWorkerPool::~CarlaEngineWorkerPool() noexcept
+{
+    stop();
+}
+
+uint32_t CarlaEngineWorkerPool::getConfiguredWorkerCount() const noexcept
+{
+#ifdef CARLA_OS_WASM
+    return 0;
+#else
+    const EngineOptions& options(kEngine->getOptions());
+
+    if (options.workerThreads < 0)
+        return 0;
+
+    if (options.workerThreads > 0)
+        return static_cast<uint32_t>(options.workerThreads);
+
+#ifdef BUILD_BRIDGE
+    // the host process already runs its own workers on the same CPUs
+    return 0;
+#else
+    // leave one CPU for the audio thread, which also runs tasks
+    const uint cores = std::thread::hardware_concurrency();
+    return std::min(kMaxAutoWorkerCount, cores > 1 ? cores - 1 : 0U);
+#endif
+#endif
+}
+
+void CarlaEngineWorkerPool::start()
+{
+    if (fWorkers != nullptr)
+        return;
+
+#ifndef CARLA_OS_WASM
+    const uint32_t count = getConfiguredWorkerCount();
+
+    if (count == 0)
+        return;
+
+    carla_debug("CarlaEngineWorkerPool::start() - %u threads", count);
+
+    if (! carla_sem_create2(fDoneSem, false))
+    {
+        carla_stderr2("CarlaEngineWorkerPool: failed to create semaphore, worker threads are disabled");
+        return;
+    }
+
+    const int priority = kEngine->getRealtimePriority();
+    const char* const cpuSet = kEngine->getOptions().workerCpuSet;
+
+    Worker** const workers = new Worker*[count];
+    uint32_t started = 0;
+
+    for (; started < count; ++started)
+    {
+        Worker* const worker = new Worker(*this);
+
+        if (worker->isValid())
+        {
+            worker->setThreadPolicy(priority, cpuSet);
+
+            if (worker->startThread(true))
+            {
+                workers[started] = worker;
+                continue;
+            }
+        }
+
+        carla_stderr2("CarlaEngineWorkerPool: failed to start worker thread, using %u threads", started);
+        delete worker;
+        break;
+    }
+
+    if (started == 0)
+    {
+        delete[] workers;
+        carla_sem_destroy2(fDoneSem);
+        return;
+    }
+
+    // the audio thread might be running already, it only sees the workers after this
+    fWorkers = workers;
+    fWorkerCount.store(started, std::memory_order_release);
+#endif
+}
+
+void CarlaEngineWorkerPool::stop() noexcept
+{
+    if (fWorkers == nullptr)
+        return;
+
+    CARLA_SAFE_ASSERT(! fBusy);
+    carla_debug("CarlaEngineWorkerPool::stop()");
+
+    const uint32_t workerCount = fWorkerCount.exchange(0);
+
+    for (uint32_t i=0; i<workerCount; ++i)
+    {
+        fWorkers[i]->signalThreadShouldExit();
+        fWorkers[i]->wake();
+    }
+
+    for (uint32_t i=0; i<workerCount; ++i)
+    {
+        fWorkers[i]->stopThread(-1);
+        delete fWorkers[i];
+    }
+
+    delete[] fWorkers;
+    fWorkers = nullptr;
+
+    carla_sem_destroy2(fDoneSem);
+}
+
+bool CarlaEngineWorkerPool::execute(const TaskFunc func, void* const ptr, const uint32_t numTasks) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(func != nullptr, false);
+
+#ifdef CARLA_OS_WASM
+    // unused
+    (void)ptr;
+    (void)numTasks;
+    return false;
+#else
+    const uint32_t workerCount = fWorkerCount.load(std::memory_order_acquire);
+
+    if (workerCount == 0)
+        return false;
+    if (numTasks == 0)
+        return true;
+
+    bool expected = false;
+    if (! fBusy.compare_exchange_strong(expected, true))
+        return false;
+
+    fTaskFunc = func;
+    fTaskPtr = ptr;
+    fTaskCount = numTasks;
+    fNextTask = 0;
+
+    // the calling thread runs tasks too, so one worker less is needed
+    const uint32_t wakeCount = std::min(numTasks - 1, workerCount);
+    fPendingWorkers = wakeCount;
+
+    for (uint32_t i=0; i<wakeCount; ++i)
+        fWorkers[i]->wake();
+
+    runTasks();
+
+    // workers must be done with the job before it can be released, even if they came too late to get a task
+    if (wakeCount != 0)
+    {
+        while (! carla_sem_timedwait(fDoneSem, 1000)) {}
+    }
+
+    fTaskFunc = nullptr;
+    fTaskPtr = nullptr;
+    fBusy = false;
+    return true;
+#endif
+}
+
+void CarlaEngineWorkerPool::runTasks() noexcept
+{
+    for (uint32_t index; (index = fNextTask++) < fTaskCount;)
+        fTaskFunc(fTaskPtr, index);
+}
+
+void CarlaEngineWorkerPool::workerFinished() noexcept
+{
+    if (--fPendingWorkers == 0)
+        carla_sem_post(fDoneSem);
+}
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
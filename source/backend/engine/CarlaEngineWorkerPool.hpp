@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_ENGINE_WORKER_POOL_HPP_INCLUDED
+#define CARLA_ENGINE_WORKER_POOL_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaSemUtils.hpp"
+
+#include "CarlaJuceUtils.hpp"
+
+#include <atomic>
+
+CARLA_BACKEND_START_NAMESPACE
+
+// -----------------------------------------------------------------------
+// CarlaEngineWorkerPool
+
+/*
+   Realtime worker threads shared by all plugins of an engine.
+
+   A plugin calls execute() from its process function to spread a number of tasks over the workers,
+   the calling thread takes part in running them and only returns once all tasks are done.
+   One job runs at a time, execute() returns false instead of waiting when the pool is in use.
+
+   Threads are only started once a plugin needs them, most engines never use the pool.
+  */
+
+class CarlaEngineWorkerPool
+{
+public:
+    typedef void (*TaskFunc)(void* ptr, uint32_t taskIndex);
+
+    CarlaEngineWorkerPool(CarlaEngine* engine) noexcept;
+    ~CarlaEngineWorkerPool() noexcept;
+
+    /*
+     * Start the worker threads as configured by the engine options, does nothing if already running.
+     * Called when loading a plugin that uses the pool, while the engine might be processing.
+     */
+    void start();
+
+    /*
+     * Stop the worker threads, must not be called while processing.
+     */
+    void stop() noexcept;
+
+    /*
+     * Run @a func for every task index in [0, numTasks).
+     * Returns false without running anything if the pool is not running or already in use.
+     * @note RT call
+     */
+    bool execute(TaskFunc func, void* ptr, uint32_t numTasks) noexcept;
+
+    /*
+     * Number of worker threads start() would use, as configured by the engine options.
+     * Automatic in regular engines, disabled unless set explicitly in plugin bridges.
+     */
+    uint32_t getConfiguredWorkerCount() const noexcept;
+
+private:
+    class Worker;
+
+    CarlaEngine* const kEngine;
+
+    Worker** fWorkers;
+    // set after fWorkers, once all threads are started
+    std::atomic<uint32_t> fWorkerCount;
+
+    // current job
+    std::atomic<bool> fBusy;
+    TaskFunc fTaskFunc;
+    void* fTaskPtr;
+    uint32_t fTaskCount;
+    std::atomic<uint32_t> fNextTask;
+    std::atomic<uint32_t> fPendingWorkers;
+    carla_sem_t fDoneSem;
+
+    void runTasks() noexcept;
+    void workerFinished() noexcept;
+
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaEngineWorkerPool)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_WORKER_POOL_HPP_INCLUDED
@@ -6,6 +6,7 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
+#include "CarlaEngineTrace.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
 #include "CarlaPluginUI.hpp"
@@ -15,12 +16,14 @@
 #include <ctime>
 
 #include "water/files/File.h"
+#include "water/memory/MemoryBlock.h"
 #include "water/streams/MemoryOutputStream.h"
 #include "water/xml/XmlDocument.h"
 #include "water/xml/XmlElement.h"
 
 using water::CharPointer_UTF8;
 using water::File;
+using water::MemoryBlock;
 using water::MemoryOutputStream;
 using water::Result;
 using water::String;
@@ -40,6 +43,9 @@ static const CustomData        kCustomDataFallback        = { nullptr, nullptr,
 static /* */ CustomData        kCustomDataFallbackNC      = { nullptr, nullptr, nullptr };
 static const PluginPostRtEvent kPluginPostRtEventFallback = { kPluginPostRtEventNull, false, {} };
 
+// output level below which a plugin is considered quiet, -120dB
+static constexpr const float kSleepQuietLevel = 0.000001f;
+
 // -------------------------------------------------------------------------------------------------------------------
 // ParamSymbol struct, needed for CarlaPlugin::loadStateSave()
 
@@ -65,6 +71,35 @@ struct ParamSymbol {
 #endif
 };
 
+// -------------------------------------------------------------------------------------------------------------------
+// Custom data value from a saved state, needed for CarlaPlugin::loadStateSave()
+// Values stored in external files are only read here, when the plugin is restored.
+
+static const char* getStateCustomDataValue(const CarlaStateSave::CustomData* const stateCustomData, String& storage)
+{
+    if (stateCustomData->value != nullptr)
+        return stateCustomData->value;
+
+    const File file(stateCustomData->valueFile);
+
+    // chunks are stored decoded, custom data values keep them as base64
+    if (std::strcmp(stateCustomData->type, CUSTOM_DATA_TYPE_CHUNK) == 0)
+    {
+        MemoryBlock chunk;
+
+        if (file.loadFileAsData(chunk) && chunk.getSize() != 0)
+            storage = CarlaString::asBase64(chunk.getData(), chunk.getSize()).buffer();
+        else
+            storage.clear();
+    }
+    else
+    {
+        storage = file.loadFileAsString();
+    }
+
+    return storage.toRawUTF8();
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 // Constructor and destructor
 
@@ -91,7 +126,8 @@ CarlaPlugin::CarlaPlugin(CarlaEngine* const engine, const uint id)
         break;
 
     case ENGINE_PROCESS_MODE_BRIDGE:
-        CARLA_SAFE_ASSERT(id == 0);
+        // more than 1 plugin only when grouped, see kPluginBridgeNonRtClientAddGroupPlugin
+        CARLA_SAFE_ASSERT(id < engine->getMaxPluginNumber());
         break;
     }
 }
@@ -557,7 +593,14 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
 
         if (data != nullptr && dataSize > 0)
         {
-            pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
+            const uint binaryDataMinSize = pData->engine->getOptions().projectBinaryDataMinSize;
+
+            // keep raw data if it might be saved as a binary file, encoding is done later if needed
+            if (binaryDataMinSize != 0 && dataSize >= binaryDataMinSize)
+                pData->stateSave.chunkData.assign(static_cast<const uint8_t*>(data),
+                                                  static_cast<const uint8_t*>(data) + dataSize);
+            else
+                pData->stateSave.chunk = CarlaString::asBase64(data, dataSize).dup();
 
             if (pluginType != PLUGIN_INTERNAL && pluginType != PLUGIN_JSFX)
                 usingChunk = true;
@@ -670,6 +713,7 @@ const CarlaStateSave& CarlaPlugin::getStateSave(const bool callPrepareForSave)
 void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
 {
     const bool usesMultiProgs = pData->hints & PLUGIN_USES_MULTI_PROGS;
+    const bool isBridge = pData->hints & PLUGIN_IS_BRIDGE;
     const PluginType pluginType = getType();
 
     char strBuf[STR_MAX+1];
@@ -692,10 +736,13 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
             pass();
         else if (usesMultiProgs && std::strcmp(key, "midiPrograms") == 0)
             pass();
+        else if (isBridge && std::strcmp(key, "__CarlaBridgeGroup__") == 0)
+            pass();
         else
             continue;
 
-        setCustomData(stateCustomData->type, key, stateCustomData->value, true);
+        String valueStorage;
+        setCustomData(stateCustomData->type, key, getStateCustomDataValue(stateCustomData, valueStorage), true);
     }
 
     // ---------------------------------------------------------------
@@ -897,14 +944,17 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
             continue;
         if (usesMultiProgs && std::strcmp(key, "midiPrograms") == 0)
             continue;
+        if (isBridge && std::strcmp(key, "__CarlaBridgeGroup__") == 0)
+            continue;
 
-        setCustomData(stateCustomData->type, key, stateCustomData->value, true);
+        String valueStorage;
+        setCustomData(stateCustomData->type, key, getStateCustomDataValue(stateCustomData, valueStorage), true);
     }
 
     // ---------------------------------------------------------------
-    // Part 5x - set lv2 state
+    // Part 5x - set lv2 state (bridges might contain more lv2 plugins in their group)
 
-    if (pluginType == PLUGIN_LV2)
+    if (pluginType == PLUGIN_LV2 || isBridge)
     {
         for (LinkedList<CustomData>::Itenerator it = pData->custom.begin2(); it.valid(); it.next())
         {
@@ -922,14 +972,33 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
     // ---------------------------------------------------------------
     // Part 6 - set chunk
 
-    if (stateSave.chunk != nullptr && (pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
+    if ((pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0)
     {
-        std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateSave.chunk));
-       #ifdef CARLA_PROPER_CPP11_SUPPORT
-        setChunkData(chunk.data(), chunk.size());
-       #else
-        setChunkData(&chunk.front(), chunk.size());
-       #endif
+        if (! stateSave.chunkData.empty())
+        {
+            setChunkData(&stateSave.chunkData.front(), stateSave.chunkData.size());
+        }
+        else if (stateSave.chunkFile != nullptr)
+        {
+            MemoryBlock chunk;
+
+            if (File(stateSave.chunkFile).loadFileAsData(chunk) && chunk.getSize() != 0)
+                setChunkData(chunk.getData(), chunk.getSize());
+            else
+                carla_stderr2("Failed to read chunk file '%s' for '%s'", stateSave.chunkFile, pData->name);
+        }
+        else if (stateSave.chunk != nullptr)
+        {
+            std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateSave.chunk));
+           #ifdef CARLA_PROPER_CPP11_SUPPORT
+            setChunkData(chunk.data(), chunk.size());
+           #else
+            setChunkData(&chunk.front(), chunk.size());
+           #endif
+        }
+
+        // plugin-specific setChunkData does not mark the state as changed
+        pData->stateChanged = true;
     }
 
    #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -959,6 +1028,34 @@ void CarlaPlugin::loadStateSave(const CarlaStateSave& stateSave)
    #endif
 }
 
+void CarlaPlugin::setStateChanged() noexcept
+{
+    pData->stateChanged = true;
+}
+
+bool CarlaPlugin::isStateChanged() const noexcept
+{
+    // bridged plugins do not report all of their changes back to us
+    if (pData->hints & PLUGIN_IS_BRIDGE)
+        return true;
+
+    return pData->stateChanged;
+}
+
+const String& CarlaPlugin::getStateSaveXml()
+{
+    if (isStateChanged() || pData->stateSaveXml.isEmpty())
+    {
+        pData->stateChanged = false;
+
+        MemoryOutputStream stream;
+        getStateSave(false).dumpToMemoryStream(stream);
+        pData->stateSaveXml = stream.toString();
+    }
+
+    return pData->stateSaveXml;
+}
+
 bool CarlaPlugin::saveStateToFile(const char* const filename)
 {
     CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
@@ -1346,6 +1443,7 @@ void CarlaPlugin::setName(const char* const newName)
         delete[] pData->name;
 
     pData->name = carla_strdup(newName);
+    pData->stateChanged = true;
 }
 
 void CarlaPlugin::setOption(const uint option, const bool yesNo, const bool sendCallback)
@@ -1357,6 +1455,8 @@ void CarlaPlugin::setOption(const uint option, const bool yesNo, const bool send
     else
         pData->options &= ~option;
 
+    pData->stateChanged = true;
+
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (sendCallback)
         pData->engine->callback(true, true,
@@ -1408,6 +1508,7 @@ void CarlaPlugin::setActive(const bool active, const bool sendOsc, const bool se
     }
 
     pData->active = active;
+    pData->stateChanged = true;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     const float value = active ? 1.0f : 0.0f;
@@ -1438,6 +1539,7 @@ void CarlaPlugin::setDryWet(const float value, const bool sendOsc, const bool se
         return;
 
     pData->postProc.dryWet = fixedValue;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1463,6 +1565,7 @@ void CarlaPlugin::setVolume(const float value, const bool sendOsc, const bool se
         return;
 
     pData->postProc.volume = fixedValue;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1488,6 +1591,7 @@ void CarlaPlugin::setBalanceLeft(const float value, const bool sendOsc, const bo
         return;
 
     pData->postProc.balanceLeft = fixedValue;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1513,6 +1617,7 @@ void CarlaPlugin::setBalanceRight(const float value, const bool sendOsc, const b
         return;
 
     pData->postProc.balanceRight = fixedValue;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1538,6 +1643,7 @@ void CarlaPlugin::setPanning(const float value, const bool sendOsc, const bool s
         return;
 
     pData->postProc.panning = fixedValue;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PARAMETER_VALUE_CHANGED,
@@ -1558,6 +1664,7 @@ void CarlaPlugin::setDryWetRT(const float value, const bool sendCallbackLater) n
         return;
 
     pData->postProc.dryWet = fixedValue;
+    pData->stateChanged = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, PARAMETER_DRYWET, fixedValue);
 }
 
@@ -1571,6 +1678,7 @@ void CarlaPlugin::setVolumeRT(const float value, const bool sendCallbackLater) n
         return;
 
     pData->postProc.volume = fixedValue;
+    pData->stateChanged = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, PARAMETER_VOLUME, fixedValue);
 }
 
@@ -1584,6 +1692,7 @@ void CarlaPlugin::setBalanceLeftRT(const float value, const bool sendCallbackLat
         return;
 
     pData->postProc.balanceLeft = fixedValue;
+    pData->stateChanged = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, PARAMETER_BALANCE_LEFT, fixedValue);
 }
 
@@ -1597,6 +1706,7 @@ void CarlaPlugin::setBalanceRightRT(const float value, const bool sendCallbackLa
         return;
 
     pData->postProc.balanceRight = fixedValue;
+    pData->stateChanged = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, PARAMETER_BALANCE_RIGHT, fixedValue);
 }
 
@@ -1610,6 +1720,7 @@ void CarlaPlugin::setPanningRT(const float value, const bool sendCallbackLater)
         return;
 
     pData->postProc.panning = fixedValue;
+    pData->stateChanged = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, PARAMETER_PANNING, fixedValue);
 }
 #endif // ! BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -1627,6 +1738,7 @@ void CarlaPlugin::setCtrlChannel(const int8_t channel, const bool sendOsc, const
         return;
 
     pData->ctrlChannel = channel;
+    pData->stateChanged = true;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     const float channelf = static_cast<float>(channel);
@@ -1655,6 +1767,8 @@ void CarlaPlugin::setParameterValue(const uint32_t parameterId, const float valu
     }
     CARLA_SAFE_ASSERT_RETURN(parameterId < pData->param.count,);
 
+    pData->stateChanged = true;
+
     if (sendGui && (pData->hints & PLUGIN_HAS_CUSTOM_UI) != 0)
         uiParameterChange(parameterId, value);
 
@@ -1669,6 +1783,7 @@ void CarlaPlugin::setParameterValue(const uint32_t parameterId, const float valu
 
 void CarlaPlugin::setParameterValueRT(const uint32_t parameterId, const float value, uint32_t, const bool sendCallbackLater) noexcept
 {
+    pData->stateChanged = true;
     pData->postponeParameterChangeRtEvent(sendCallbackLater, static_cast<int32_t>(parameterId), value);
 }
 
@@ -1722,6 +1837,7 @@ void CarlaPlugin::setParameterMidiChannel(const uint32_t parameterId, const uint
         return;
 
     pData->param.data[parameterId].midiChannel = channel;
+    pData->stateChanged = true;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     pData->engine->callback(sendCallback, sendOsc,
@@ -1815,6 +1931,7 @@ void CarlaPlugin::setParameterMappedControlIndex(const uint32_t parameterId, con
 #endif
 
     paramData.mappedControlIndex = index;
+    pData->stateChanged = true;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (index == CONTROL_INDEX_MIDI_LEARN)
@@ -1862,6 +1979,7 @@ void CarlaPlugin::setParameterMappedRange(const uint32_t parameterId, const floa
     paramData.hints |= PARAMETER_MAPPED_RANGES_SET;
     paramData.mappedMinimum = minimum;
     paramData.mappedMaximum = maximum;
+    pData->stateChanged = true;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
     if (pData->event.cvSourcePorts != nullptr && paramData.mappedControlIndex == CONTROL_INDEX_CV)
@@ -1897,6 +2015,8 @@ void CarlaPlugin::setCustomData(const char* const type, const char* const key, c
             return;
     }
 
+    pData->stateChanged = true;
+
     // Check if we already have this key
     for (LinkedList<CustomData>::Itenerator it = pData->custom.begin2(); it.valid(); it.next())
     {
@@ -1934,6 +2054,7 @@ void CarlaPlugin::setProgram(const int32_t index,
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->prog.count),);
 
     pData->prog.current = index;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_PROGRAM_CHANGED,
@@ -1966,6 +2087,7 @@ void CarlaPlugin::setMidiProgram(const int32_t index,
     CARLA_SAFE_ASSERT_RETURN(index >= -1 && index < static_cast<int32_t>(pData->midiprog.count),);
 
     pData->midiprog.current = index;
+    pData->stateChanged = true;
 
     pData->engine->callback(sendCallback, sendOsc,
                             ENGINE_CALLBACK_MIDI_PROGRAM_CHANGED,
@@ -2007,6 +2129,7 @@ void CarlaPlugin::setProgramRT(const uint32_t uindex, const bool sendCallbackLat
 
     const int32_t index = static_cast<int32_t>(uindex);
     pData->prog.current = index;
+    pData->stateChanged = true;
 
     // Change default parameter values
     switch (getType())
@@ -2029,6 +2152,7 @@ void CarlaPlugin::setMidiProgramRT(const uint32_t uindex, const bool sendCallbac
 
     const int32_t index = static_cast<int32_t>(uindex);
     pData->midiprog.current = index;
+    pData->stateChanged = true;
 
     // Change default parameter values
     switch (getType())
@@ -2052,6 +2176,12 @@ void CarlaPlugin::reloadPrograms(const bool)
 {
 }
 
+bool CarlaPlugin::addPluginToBridgeGroup(const PluginType, const char* const, const char* const, const int64_t)
+{
+    pData->engine->setLastError("Plugin is not a bridge");
+    return false;
+}
+
 // -------------------------------------------------------------------
 // Plugin processing
 
@@ -2065,6 +2195,116 @@ void CarlaPlugin::deactivate() noexcept
     CARLA_SAFE_ASSERT(pData->active);
 }
 
+float* CarlaPlugin::getAudioPortBuffer(bool, uint32_t) const noexcept
+{
+    return nullptr;
+}
+
+void CarlaPlugin::addProcessTime(const uint64_t startTime, const uint64_t endTime) noexcept
+{
+    pData->processTime.add(endTime - startTime);
+    pData->subBlock.addProcessTime(endTime - startTime);
+
+    if (CarlaEngineTrace::isEnabled())
+        CarlaEngineTrace::addEvent("process", startTime, endTime, static_cast<int32_t>(pData->id));
+}
+
+bool CarlaPlugin::isAsleep(const bool inputIsSilent, const bool hasInputEvents) noexcept
+{
+    ProtectedData::Sleep& sleep(pData->sleep);
+
+    sleep.status = ProtectedData::Sleep::kStatusDefault;
+    sleep.inputSilent = inputIsSilent;
+
+    // only effects can sleep, anything else might produce sound on its own
+    if (! inputIsSilent || hasInputEvents
+        || pData->audioIn.count == 0 || pData->cvIn.count != 0
+        || pData->extNotes.data.getReadableCount() != 0
+        || pData->engine->getOptions().pluginSleepTimeout == 0)
+    {
+        sleep.wakeUp();
+        sleep.idle = false;
+        return false;
+    }
+
+    sleep.idle = true;
+
+    if (! sleep.asleep)
+        return false;
+
+    pData->processTime.addSkipped();
+    return true;
+}
+
+void CarlaPlugin::updateSleepState(const float outputPeak, const bool hasOutputEvents, const uint32_t frames) noexcept
+{
+    ProtectedData::Sleep& sleep(pData->sleep);
+
+    if (! sleep.idle)
+        return;
+
+    switch (sleep.status)
+    {
+    case ProtectedData::Sleep::kStatusDefault:
+        if (outputPeak >= kSleepQuietLevel || hasOutputEvents)
+        {
+            sleep.quietFrames = 0;
+            return;
+        }
+        break;
+    case ProtectedData::Sleep::kStatusQuiet:
+        if (hasOutputEvents)
+        {
+            sleep.quietFrames = 0;
+            return;
+        }
+        break;
+    case ProtectedData::Sleep::kStatusSleep:
+        sleep.asleep = true;
+        return;
+    case ProtectedData::Sleep::kStatusContinue:
+        sleep.quietFrames = 0;
+        return;
+    }
+
+    if (sleep.tailFrames == ProtectedData::Sleep::kTailInfinite)
+        return;
+
+    // keep processing until the tail and any latency went through
+    uint64_t holdFrames = pData->latency.frames;
+
+    if (sleep.tailFrames != ProtectedData::Sleep::kTailUnknown)
+        holdFrames += sleep.tailFrames;
+    else
+        holdFrames += static_cast<uint64_t>(pData->engine->getOptions().pluginSleepTimeout
+                                            * pData->engine->getSampleRate() / 1000.0);
+
+    if (sleep.quietFrames < UINT32_MAX - frames)
+        sleep.quietFrames += frames;
+
+    if (sleep.quietFrames >= holdFrames)
+        sleep.asleep = true;
+}
+
+PluginProcessTimeStats CarlaPlugin::getProcessTimeStats() const noexcept
+{
+    const CarlaProcessTimeHistogram::Stats stats(pData->processTime.getStats());
+
+    PluginProcessTimeStats ret;
+    ret.count      = stats.count;
+    ret.sleepCount = stats.skipped;
+    ret.minTime    = stats.minTime;
+    ret.avgTime    = stats.avgTime;
+    ret.maxTime    = stats.maxTime;
+    ret.p99Time    = stats.p99Time;
+    return ret;
+}
+
+void CarlaPlugin::resetProcessTimeStats() noexcept
+{
+    pData->processTime.requestReset();
+}
+
 void CarlaPlugin::bufferSizeChanged(const uint32_t newBufferSize)
 {
    #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -2112,12 +2352,14 @@ void CarlaPlugin::idle()
 
     ProtectedData::PostRtEvents::Access rtEvents(pData->postRtEvents);
 
+    if (const uint32_t overflows = rtEvents.takeOverflowCount())
+        carla_stderr2("Plugin '%s' dropped %u post-RT events, queue was full", pData->name, overflows);
+
     if (rtEvents.isEmpty())
         return;
 
-    for (RtLinkedList<PluginPostRtEvent>::Itenerator it = rtEvents.getDataIterator(); it.valid(); it.next())
+    for (PluginPostRtEvent event; rtEvents.readNext(event);)
     {
-        const PluginPostRtEvent& event(it.getValue(kPluginPostRtEventFallback));
         CARLA_SAFE_ASSERT_CONTINUE(event.type != kPluginPostRtEventNull);
 
         switch (event.type)
@@ -2660,6 +2902,11 @@ void CarlaPlugin::waitForBridgeSaveSignal() noexcept
 {
 }
 
+bool CarlaPlugin::isWaitingForBridgeSaveSignal() const noexcept
+{
+    return false;
+}
+
 // -------------------------------------------------------------------
 // Scoped Disabler
 
@@ -20,6 +20,7 @@
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
 #include "CarlaBridgeUtils.hpp"
+#include "CarlaEngineTrace.hpp"
 #include "CarlaEngineUtils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaPipeUtils.hpp"
@@ -45,11 +46,6 @@ using water::StringArray;
 
 CARLA_BACKEND_START_NAMESPACE
 
-// --------------------------------------------------------------------------------------------------------------------
-// Fallback data
-
-static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
-
 // --------------------------------------------------------------------------------------------------------------------
 
 #ifndef CARLA_OS_WIN
@@ -155,9 +151,14 @@ public:
         fBridgeBinary = bridgeBinary;
         fShmIds = shmIds;
 
-        if (label != nullptr)
+        setLabel(label);
+    }
+
+    void setLabel(const char* const label) noexcept
+    {
+        if (label != nullptr && label[0] != '\0')
             fLabel = label;
-        if (fLabel.isEmpty())
+        else
             fLabel = "(none)";
     }
 
@@ -318,6 +319,34 @@ protected:
             std::snprintf(strBuf, STR_MAX, P_UINTPTR, options.frontendWinId);
             carla_setenv("ENGINE_OPTION_FRONTEND_WIN_ID", strBuf);
 
+            if (options.audioCpuSet != nullptr)
+                carla_setenv("ENGINE_OPTION_AUDIO_CPU_SET", options.audioCpuSet);
+            else
+                carla_setenv("ENGINE_OPTION_AUDIO_CPU_SET", "");
+
+            if (options.workerCpuSet != nullptr)
+                carla_setenv("ENGINE_OPTION_WORKER_CPU_SET", options.workerCpuSet);
+            else
+                carla_setenv("ENGINE_OPTION_WORKER_CPU_SET", "");
+
+            // relative priorities can only be resolved on this side
+            std::snprintf(strBuf, STR_MAX, "%i", kEngine->getRealtimePriority());
+            carla_setenv("ENGINE_OPTION_RT_PRIORITY", strBuf);
+
+            carla_setenv("ENGINE_OPTION_BRIDGE_LOCK_MEMORY", bool2str(options.bridgeLockMemory));
+
+            std::snprintf(strBuf, STR_MAX, "%i", options.subBlockGranularity);
+            carla_setenv("ENGINE_OPTION_SUB_BLOCK_GRANULARITY", strBuf);
+
+            std::snprintf(strBuf, STR_MAX, "%u", options.cvEventResolution);
+            carla_setenv("ENGINE_OPTION_CV_EVENT_RESOLUTION", strBuf);
+
+            std::snprintf(strBuf, STR_MAX, "%i", options.workerThreads);
+            carla_setenv("ENGINE_OPTION_WORKER_THREADS", strBuf);
+
+            std::snprintf(strBuf, STR_MAX, "%i", options.fluidSynthCpuCores);
+            carla_setenv("ENGINE_OPTION_FLUIDSYNTH_CPU_CORES", strBuf);
+
             carla_setenv("ENGINE_BRIDGE_SHM_IDS", fShmIds.toRawUTF8());
 
            #ifndef CARLA_OS_WIN
@@ -410,6 +439,13 @@ protected:
             {
                 carla_stderr("CarlaPluginBridgeThread::run() - bridge crashed");
 
+                // a bridge started ahead of time has no plugin yet, nothing to report
+                if (kPlugin->getType() == PLUGIN_NONE)
+                {
+                    fProcess = nullptr;
+                    return;
+                }
+
                 CarlaString errorString("Plugin '" + CarlaString(kPlugin->getName()) + "' has crashed!\n"
                                         "Saving now will lose its current settings.\n"
                                         "Please remove this plugin, and not rely on it from this point.");
@@ -469,7 +505,8 @@ public:
           fInfo(),
           fUniqueId(0),
           fLatency(0),
-          fParams(nullptr)
+          fParams(nullptr),
+          fGroupState()
     {
         carla_debug("CarlaPluginBridge::CarlaPluginBridge(%p, %i, %s, %s)", engine, id, BinaryType2Str(btype), PluginType2Str(ptype));
 
@@ -965,6 +1002,12 @@ public:
             return;
         }
 
+        if (std::strcmp(type, CUSTOM_DATA_TYPE_STRING) == 0 && std::strcmp(key, "__CarlaBridgeGroup__") == 0)
+        {
+            restoreBridgeGroup(value, false);
+            return;
+        }
+
         const uint32_t maxLocalValueLen = fBridgeVersion >= 10 ? 4096 : 16384;
 
         const uint32_t typeLen  = static_cast<uint32_t>(std::strlen(type));
@@ -1389,6 +1432,54 @@ public:
         carla_debug("CarlaPluginBridge::reload() - end");
     }
 
+    bool addPluginToBridgeGroup(const PluginType ptype, const char* const filename, const char* const label,
+                                const int64_t uniqueId) override
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->engine != nullptr, false);
+        carla_debug("CarlaPluginBridge::addPluginToBridgeGroup(%i:%s, \"%s\", \"%s\", " P_INT64 ")",
+                    ptype, PluginType2Str(ptype), filename, label, uniqueId);
+
+        if (fBridgeVersion < 11)
+        {
+            pData->engine->setLastError("Plugin bridge is too old to load more plugins");
+            return false;
+        }
+
+        if (fTimedError || ! fBridgeThread.isThreadRunning())
+        {
+            pData->engine->setLastError("Plugin bridge is not running");
+            return false;
+        }
+
+        bool added;
+
+        {
+            // the bridge only processes when asked to, so it will not run while its ports change
+            const ScopedDisabler sd(this);
+            added = loadGroupPlugin(ptype, filename, label, uniqueId);
+        }
+
+        if (added)
+        {
+            reload();
+
+            char strBuf[STR_MAX+1];
+            std::snprintf(strBuf, STR_MAX, "%u\t" P_INT64 "\t", static_cast<uint>(ptype), uniqueId);
+            strBuf[STR_MAX] = '\0';
+
+            fGroupState += strBuf;
+            fGroupState += label != nullptr ? label : "";
+            fGroupState += "\t";
+            fGroupState += filename != nullptr ? filename : "";
+            fGroupState += "\n";
+
+            // saved with the plugin state, and restored through setCustomData()
+            CarlaPlugin::setCustomData(CUSTOM_DATA_TYPE_STRING, "__CarlaBridgeGroup__", fGroupState, false);
+        }
+
+        return added;
+    }
+
     // -------------------------------------------------------------------
     // Plugin processing
 
@@ -1468,11 +1559,10 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
-                for (RtLinkedList<ExternalMidiNote>::Itenerator it = pData->extNotes.data.begin2(); it.valid(); it.next())
+                for (ExternalMidiNote note; pData->extNotes.data.tryPop(note);)
                 {
-                    const ExternalMidiNote& note(it.getValue(kExternalMidiNoteFallback));
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     uint8_t data1, data2, data3;
@@ -1490,9 +1580,6 @@ public:
                     fShmRtClientControl.commitWrite();
                 }
 
-                pData->extNotes.data.clear();
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -1743,8 +1830,6 @@ public:
                 }
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input
 
         if (! processSingle(audioIn, audioOut, cvIn, cvOut, frames))
@@ -1858,8 +1943,14 @@ public:
         // --------------------------------------------------------------------------------------------------------
         // Reset audio buffers
 
+        // buffers handed out by getAudioPortBuffer() are already in place
         for (uint32_t i=0; i < pData->audioIn.count; ++i)
-            carla_copyFloats(fShmAudioPool.data + (i * fBufferSize), audioIn[i], frames);
+        {
+            float* const poolBuf = fShmAudioPool.data + (i * fBufferSize);
+
+            if (audioIn[i] != poolBuf)
+                carla_copyFloats(poolBuf, audioIn[i], frames);
+        }
         for (uint32_t i=0; i < pData->cvIn.count; ++i)
             carla_copyFloats(fShmAudioPool.data + ((pData->audioIn.count + pData->audioOut.count + i) * fBufferSize), cvIn[i], frames);
 
@@ -1897,7 +1988,10 @@ public:
             fShmRtClientControl.commitWrite();
         }
 
-        waitForClient("process", fProcWaitTime);
+        {
+            const ScopedEngineTraceSpan sets("bridge wait", static_cast<int32_t>(pData->id));
+            waitForClient("process", fProcWaitTime);
+        }
 
         if (fTimedOut)
         {
@@ -1906,7 +2000,12 @@ public:
         }
 
         for (uint32_t i=0; i < pData->audioOut.count; ++i)
-            carla_copyFloats(audioOut[i], fShmAudioPool.data + ((pData->audioIn.count + i) * fBufferSize), frames);
+        {
+            const float* const poolBuf = fShmAudioPool.data + ((pData->audioIn.count + i) * fBufferSize);
+
+            if (audioOut[i] != poolBuf)
+                carla_copyFloats(audioOut[i], poolBuf, frames);
+        }
         for (uint32_t i=0; i < pData->cvOut.count; ++i)
             carla_copyFloats(cvOut[i], fShmAudioPool.data + ((pData->audioIn.count + pData->audioOut.count + pData->cvIn.count + i) * fBufferSize), frames);
 
@@ -2083,6 +2182,22 @@ public:
         CarlaPlugin::clearBuffers();
     }
 
+    // audio ports live in the shared memory pool, hosts writing there directly save the copies in processSingle
+    float* getAudioPortBuffer(const bool isInput, const uint32_t index) const noexcept override
+    {
+        if (fShmAudioPool.data == nullptr || fTimedError)
+            return nullptr;
+
+        if (isInput)
+        {
+            CARLA_SAFE_ASSERT_RETURN(index < pData->audioIn.count, nullptr);
+            return fShmAudioPool.data + (index * fBufferSize);
+        }
+
+        CARLA_SAFE_ASSERT_RETURN(index < pData->audioOut.count, nullptr);
+        return fShmAudioPool.data + ((pData->audioIn.count + index) * fBufferSize);
+    }
+
     // -------------------------------------------------------------------
     // Post-poned UI Stuff
 
@@ -2166,6 +2281,11 @@ public:
             waitForSaved();
     }
 
+    bool isWaitingForBridgeSaveSignal() const noexcept override
+    {
+        return !fSaved && fBridgeThread.isThreadRunning();
+    }
+
     // -------------------------------------------------------------------
 
     void handleNonRtData()
@@ -2721,10 +2841,81 @@ public:
         fUniqueId     = uniqueId;
         fBridgeBinary = bridgeBinary;
 
-        std::srand(static_cast<uint>(std::time(nullptr)));
+        if (! initSharedMemory())
+            return false;
+
+        initWinePrefix();
+        initBridgeThread(binaryArchName, label);
+
+        if (! restartBridgeThread())
+            return false;
+
+        return initClient(plugin, label, options);
+    }
+
+    bool isBridgeProcessRunning() const noexcept
+    {
+        return fBridgeThread.isThreadRunning();
+    }
+
+    bool initWarm(const char* const binaryArchName, const char* const bridgeBinary)
+    {
+        CARLA_SAFE_ASSERT_RETURN(pData->engine != nullptr, false);
+        CARLA_SAFE_ASSERT_RETURN(bridgeBinary != nullptr && bridgeBinary[0] != '\0', false);
+
+        pData->filename = carla_strdup("");
+        fBridgeBinary   = bridgeBinary;
+
+        if (! initSharedMemory())
+            return false;
+
+        initWinePrefix();
+        initBridgeThread(binaryArchName, nullptr);
+
+        // the bridge reports back once it has a plugin, see initFromWarm()
+        startBridgeProcess();
+        return true;
+    }
+
+    bool initFromWarm(CarlaPluginPtr plugin, const Initializer& init, const PluginType ptype)
+    {
+        CARLA_SAFE_ASSERT_RETURN(fPluginType == PLUGIN_NONE, false);
+        CARLA_SAFE_ASSERT_RETURN(pData->client == nullptr, false);
 
         // ---------------------------------------------------------------
-        // init sem/shm
+        // set info
+
+        setId(init.id);
+        fPluginType = ptype;
+
+        if (init.name != nullptr && init.name[0] != '\0')
+            pData->name = pData->engine->getUniquePluginName(init.name);
+
+        if (init.filename != nullptr && init.filename[0] != '\0')
+        {
+            delete[] pData->filename;
+            pData->filename = carla_strdup(init.filename);
+        }
+
+        fUniqueId = init.uniqueId;
+
+        // used if the bridge needs to be restarted later on
+        fBridgeThread.setLabel(init.label);
+
+        // ---------------------------------------------------------------
+        // load plugin
+
+        // on failure the bridge waits for the quit messages sent on destruction
+        if (! loadGroupPlugin(ptype, init.filename, init.label, init.uniqueId))
+            return false;
+
+        return initClient(plugin, init.label, init.options);
+    }
+
+private:
+    bool initSharedMemory()
+    {
+        std::srand(static_cast<uint>(std::time(nullptr)));
 
         if (! fShmAudioPool.initializeServer())
         {
@@ -2756,10 +2947,12 @@ public:
             return false;
         }
 
-       #ifndef CARLA_OS_WIN
-        // ---------------------------------------------------------------
-        // set wine prefix
+        return true;
+    }
 
+    void initWinePrefix()
+    {
+       #ifndef CARLA_OS_WIN
         if (fBridgeBinary.contains(".exe", true))
         {
             const EngineOptions& engineOptions(pData->engine->getOptions());
@@ -2784,29 +2977,27 @@ public:
             fWinePrefix = winePrefix.toRawUTF8();
         }
        #endif
+    }
 
-        // ---------------------------------------------------------------
-        // init bridge thread
-
-        {
-            char shmIdsStr[6*4+1];
-            carla_zeroChars(shmIdsStr, 6*4+1);
-
-            std::strncpy(shmIdsStr+6*0, &fShmAudioPool.filename[fShmAudioPool.filename.length()-6], 6);
-            std::strncpy(shmIdsStr+6*1, &fShmRtClientControl.filename[fShmRtClientControl.filename.length()-6], 6);
-            std::strncpy(shmIdsStr+6*2, &fShmNonRtClientControl.filename[fShmNonRtClientControl.filename.length()-6], 6);
-            std::strncpy(shmIdsStr+6*3, &fShmNonRtServerControl.filename[fShmNonRtServerControl.filename.length()-6], 6);
+    void initBridgeThread(const char* const binaryArchName, const char* const label)
+    {
+        char shmIdsStr[6*4+1];
+        carla_zeroChars(shmIdsStr, 6*4+1);
 
-            fBridgeThread.setData(
-                                 #ifndef CARLA_OS_WIN
-                                  fWinePrefix,
-                                 #endif
-                                  binaryArchName, bridgeBinary, label, shmIdsStr);
-        }
+        std::strncpy(shmIdsStr+6*0, &fShmAudioPool.filename[fShmAudioPool.filename.length()-6], 6);
+        std::strncpy(shmIdsStr+6*1, &fShmRtClientControl.filename[fShmRtClientControl.filename.length()-6], 6);
+        std::strncpy(shmIdsStr+6*2, &fShmNonRtClientControl.filename[fShmNonRtClientControl.filename.length()-6], 6);
+        std::strncpy(shmIdsStr+6*3, &fShmNonRtServerControl.filename[fShmNonRtServerControl.filename.length()-6], 6);
 
-        if (! restartBridgeThread())
-            return false;
+        fBridgeThread.setData(
+                             #ifndef CARLA_OS_WIN
+                              fWinePrefix,
+                             #endif
+                              binaryArchName, fBridgeBinary, label, shmIdsStr);
+    }
 
+    bool initClient(CarlaPluginPtr plugin, const char* const label, const uint options)
+    {
         // ---------------------------------------------------------------
         // register client
 
@@ -2900,7 +3091,7 @@ public:
 
 private:
     const BinaryType fBinaryType;
-    const PluginType fPluginType;
+    PluginType fPluginType;
     uint fBridgeVersion;
 
     bool fInitiated;
@@ -3080,6 +3271,9 @@ private:
 
     BridgeParamInfo* fParams;
 
+    // plugins loaded into the bridge group after the first one, one "type\tuniqueId\tlabel\tfilename" line each
+    CarlaString fGroupState;
+
     void handleProcessStopped() noexcept
     {
         const bool wasActive = pData->active;
@@ -3131,49 +3325,9 @@ private:
         carla_stderr2("waitForClient(%s) timed out", action);
     }
 
-    bool restartBridgeThread()
+    // process bridge messages until it reports being ready, an error, or the user cancels
+    void waitForBridgeReady(const char* const actionName)
     {
-        fInitiated  = false;
-        fInitError  = false;
-        fTimedError = false;
-
-        // reset memory
-        fShmRtClientControl.data->procFlags = 0;
-        carla_zeroStruct(fShmRtClientControl.data->timeInfo);
-        carla_zeroBytes(fShmRtClientControl.data->midiOut, kBridgeRtClientDataMidiOutSize);
-
-        fShmRtClientControl.clearData();
-        fShmNonRtClientControl.clearData();
-        fShmNonRtServerControl.clearData();
-
-        fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientVersion);
-        fShmNonRtClientControl.writeUInt(CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT);
-
-        fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(sizeof(BridgeRtClientData)));
-        fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(sizeof(BridgeNonRtClientData)));
-        fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(sizeof(BridgeNonRtServerData)));
-
-        fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientInitialSetup);
-        fShmNonRtClientControl.writeUInt(pData->engine->getBufferSize());
-        fShmNonRtClientControl.writeDouble(pData->engine->getSampleRate());
-
-        fShmNonRtClientControl.commitWrite();
-
-        if (fShmAudioPool.dataSize != 0)
-        {
-            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientSetAudioPool);
-            fShmRtClientControl.writeULong(static_cast<uint64_t>(fShmAudioPool.dataSize));
-            fShmRtClientControl.commitWrite();
-        }
-        else
-        {
-            // testing dummy message
-            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientNull);
-            fShmRtClientControl.commitWrite();
-        }
-
-        fBridgeThread.startThread();
-
         const bool needsEngineIdle = pData->engine->getType() != kEngineTypePlugin;
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         const bool needsCancelableAction = ! pData->engine->isLoadingProject();
@@ -3186,7 +3340,7 @@ private:
                                     pData->id,
                                     1,
                                     0, 0, 0.0f,
-                                    "Loading plugin bridge");
+                                    actionName);
         }
 #endif
 
@@ -3215,9 +3369,137 @@ private:
                                     pData->id,
                                     0,
                                     0, 0, 0.0f,
-                                    "Loading plugin bridge");
+                                    actionName);
         }
 #endif
+    }
+
+    // load a plugin into the running bridge, waiting for the updated plugin info
+    bool loadGroupPlugin(const PluginType ptype, const char* const filename, const char* const label,
+                         const int64_t uniqueId)
+    {
+        fInitiated = false;
+        fInitError = false;
+
+        {
+            const uint32_t filenameLen = filename != nullptr ? static_cast<uint32_t>(std::strlen(filename)) : 0;
+            const uint32_t labelLen    = label != nullptr ? static_cast<uint32_t>(std::strlen(label)) : 0;
+
+            const CarlaMutexLocker _cml(fShmNonRtClientControl.mutex);
+
+            fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientAddGroupPlugin);
+            fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(ptype));
+
+            fShmNonRtClientControl.writeUInt(filenameLen);
+            if (filenameLen != 0)
+                fShmNonRtClientControl.writeCustomData(filename, filenameLen);
+
+            fShmNonRtClientControl.writeUInt(labelLen);
+            if (labelLen != 0)
+                fShmNonRtClientControl.writeCustomData(label, labelLen);
+
+            fShmNonRtClientControl.writeLong(uniqueId);
+            fShmNonRtClientControl.commitWrite();
+        }
+
+        waitForBridgeReady("Loading plugin into bridge");
+
+        const bool added = fInitiated && ! fInitError;
+
+        if (! fInitiated)
+            pData->engine->setLastError("Timeout while waiting for a response from plugin-bridge\n"
+                                        "(or the plugin crashed on initialization?)");
+
+        // back to regular operation, a crashed bridge is then handled by idle()
+        fInitiated = true;
+        fInitError = false;
+
+        return added;
+    }
+
+    // load the plugins of a saved group which are not loaded yet, or all of them after the bridge restarted
+    void restoreBridgeGroup(const char* const groupState, const bool afterRestart)
+    {
+        const StringArray lines(StringArray::fromLines(groupState));
+        const StringArray loadedLines(StringArray::fromLines(fGroupState.buffer()));
+
+        for (int i=0; i < lines.size(); ++i)
+        {
+            if (lines[i].isEmpty())
+                continue;
+            if (! afterRestart && i < loadedLines.size() && lines[i] == loadedLines[i])
+                continue;
+
+            const StringArray tokens(StringArray::fromTokens(lines[i], "\t", ""));
+            CARLA_SAFE_ASSERT_CONTINUE(tokens.size() == 4);
+
+            const PluginType ptype = static_cast<PluginType>(tokens[0].getIntValue());
+            const int64_t uniqueId = tokens[1].getLargeIntValue();
+            const String& label(tokens[2]);
+            const String& filename(tokens[3]);
+
+            const char* const filenameStr = filename.isNotEmpty() ? filename.toRawUTF8() : nullptr;
+            const char* const labelStr    = label.isNotEmpty() ? label.toRawUTF8() : nullptr;
+
+            // ports did not change when restarting, so there is no need for a full reload
+            if (! (afterRestart ? loadGroupPlugin(ptype, filenameStr, labelStr, uniqueId)
+                                : addPluginToBridgeGroup(ptype, filenameStr, labelStr, uniqueId)))
+            {
+                carla_stderr2("Failed to restore bridge group plugin '%s': %s",
+                              label.isNotEmpty() ? label.toRawUTF8() : filename.toRawUTF8(),
+                              pData->engine->getLastError());
+            }
+        }
+    }
+
+    void startBridgeProcess()
+    {
+        fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientVersion);
+        fShmNonRtClientControl.writeUInt(CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT);
+
+        fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(sizeof(BridgeRtClientData)));
+        fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(sizeof(BridgeNonRtClientData)));
+        fShmNonRtClientControl.writeUInt(static_cast<uint32_t>(sizeof(BridgeNonRtServerData)));
+
+        fShmNonRtClientControl.writeOpcode(kPluginBridgeNonRtClientInitialSetup);
+        fShmNonRtClientControl.writeUInt(pData->engine->getBufferSize());
+        fShmNonRtClientControl.writeDouble(pData->engine->getSampleRate());
+
+        fShmNonRtClientControl.commitWrite();
+
+        if (fShmAudioPool.dataSize != 0)
+        {
+            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientSetAudioPool);
+            fShmRtClientControl.writeULong(static_cast<uint64_t>(fShmAudioPool.dataSize));
+            fShmRtClientControl.commitWrite();
+        }
+        else
+        {
+            // testing dummy message
+            fShmRtClientControl.writeOpcode(kPluginBridgeRtClientNull);
+            fShmRtClientControl.commitWrite();
+        }
+
+        fBridgeThread.startThread();
+    }
+
+    bool restartBridgeThread()
+    {
+        fInitiated  = false;
+        fInitError  = false;
+        fTimedError = false;
+
+        // reset memory
+        fShmRtClientControl.data->procFlags = 0;
+        carla_zeroStruct(fShmRtClientControl.data->timeInfo);
+        carla_zeroBytes(fShmRtClientControl.data->midiOut, kBridgeRtClientDataMidiOutSize);
+
+        fShmRtClientControl.clearData();
+        fShmNonRtClientControl.clearData();
+        fShmNonRtServerControl.clearData();
+
+        startBridgeProcess();
+        waitForBridgeReady("Loading plugin bridge");
 
         if (fInitError || ! fInitiated)
         {
@@ -3230,6 +3512,14 @@ private:
             return false;
         }
 
+        // plugins of the group went away together with the previous bridge process
+        if (fGroupState.isNotEmpty())
+        {
+            // not processed until the whole group is back, like when adding a plugin to it
+            const ScopedDisabler sd(this);
+            restoreBridgeGroup(fGroupState, true);
+        }
+
         if (const size_t dataSize = fInfo.chunk.size())
         {
 #ifdef CARLA_PROPER_CPP11_SUPPORT
@@ -3289,11 +3579,29 @@ CarlaPluginPtr CarlaPlugin::newBridge(const Initializer& init,
                                       const BinaryType btype,
                                       const PluginType ptype,
                                       const char* const binaryArchName,
-                                      const char* bridgeBinary)
+                                      const char* bridgeBinary,
+                                      const CarlaPluginPtr warmBridge)
 {
-    carla_debug("CarlaPlugin::newBridge({%p, \"%s\", \"%s\", \"%s\"}, %s, %s, \"%s\", \"%s\")",
+    carla_debug("CarlaPlugin::newBridge({%p, \"%s\", \"%s\", \"%s\"}, %s, %s, \"%s\", \"%s\", %p)",
                 init.engine, init.filename, init.name, init.label,
-                BinaryType2Str(btype), PluginType2Str(ptype), binaryArchName, bridgeBinary);
+                BinaryType2Str(btype), PluginType2Str(ptype), binaryArchName, bridgeBinary, warmBridge.get());
+
+    if (warmBridge.get() != nullptr)
+    {
+        CARLA_SAFE_ASSERT_RETURN(warmBridge->getHints() & PLUGIN_IS_BRIDGE, nullptr);
+
+        const std::shared_ptr<CarlaPluginBridge> plugin(std::static_pointer_cast<CarlaPluginBridge>(warmBridge));
+
+        if (plugin->getType() == PLUGIN_NONE && plugin->getBinaryType() == btype && plugin->isBridgeProcessRunning())
+        {
+            if (! plugin->initFromWarm(plugin, init, ptype))
+                return nullptr;
+
+            return plugin;
+        }
+
+        carla_stderr2("CarlaPlugin::newBridge() - warm bridge is not usable, starting a new one");
+    }
 
     if (bridgeBinary == nullptr || bridgeBinary[0] == '\0')
     {
@@ -3315,6 +3623,31 @@ CarlaPluginPtr CarlaPlugin::newBridge(const Initializer& init,
     return plugin;
 }
 
+CarlaPluginPtr CarlaPlugin::newWarmBridge(CarlaEngine* const engine,
+                                          const BinaryType btype,
+                                          const char* const binaryArchName,
+                                          const char* bridgeBinary)
+{
+    carla_debug("CarlaPlugin::newWarmBridge(%p, %s, \"%s\", \"%s\")",
+                engine, BinaryType2Str(btype), binaryArchName, bridgeBinary);
+
+    CARLA_SAFE_ASSERT_RETURN(engine != nullptr, nullptr);
+    CARLA_SAFE_ASSERT_RETURN(bridgeBinary != nullptr && bridgeBinary[0] != '\0', nullptr);
+
+#ifndef CARLA_OS_WIN
+    if (std::strncmp(bridgeBinary, "//", 2) == 0)
+        ++bridgeBinary;
+#endif
+
+    // the id is only set once a plugin is loaded
+    std::shared_ptr<CarlaPluginBridge> plugin(new CarlaPluginBridge(engine, 0, btype, PLUGIN_NONE));
+
+    if (! plugin->initWarm(binaryArchName, bridgeBinary))
+        return nullptr;
+
+    return plugin;
+}
+
 CARLA_BACKEND_END_NAMESPACE
 
 // ---------------------------------------------------------------------------------------------------------------------
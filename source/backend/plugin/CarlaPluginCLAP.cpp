@@ -158,6 +158,7 @@ struct carla_clap_host : clap_host_t {
         virtual void clapRequestCallback() = 0;
         virtual void clapMarkDirty() = 0;
         virtual void clapLatencyChanged() = 0;
+        virtual bool clapRequestExec(uint32_t numTasks) = 0;
       #ifdef CLAP_WINDOW_API_NATIVE
         // gui
         virtual void clapGuiResizeHintsChanged() = 0;
@@ -181,6 +182,7 @@ struct carla_clap_host : clap_host_t {
 
     clap_host_latency_t latency;
     clap_host_state_t state;
+    clap_host_thread_pool_t threadPool;
   #ifdef CLAP_WINDOW_API_NATIVE
     clap_host_gui_t gui;
    #ifdef _POSIX_VERSION
@@ -208,6 +210,8 @@ struct carla_clap_host : clap_host_t {
 
         state.mark_dirty = carla_mark_dirty;
 
+        threadPool.request_exec = carla_request_exec;
+
       #ifdef CLAP_WINDOW_API_NATIVE
         gui.resize_hints_changed = carla_resize_hints_changed;
         gui.request_resize = carla_request_resize;
@@ -234,6 +238,8 @@ struct carla_clap_host : clap_host_t {
             return &self->latency;
         if (std::strcmp(extension_id, CLAP_EXT_STATE) == 0)
             return &self->state;
+        if (std::strcmp(extension_id, CLAP_EXT_THREAD_POOL) == 0)
+            return &self->threadPool;
       #ifdef CLAP_WINDOW_API_NATIVE
         if (std::strcmp(extension_id, CLAP_EXT_GUI) == 0)
             return &self->gui;
@@ -274,6 +280,11 @@ struct carla_clap_host : clap_host_t {
         static_cast<const carla_clap_host*>(host->host_data)->hostCallbacks->clapMarkDirty();
     }
 
+    static bool CLAP_ABI carla_request_exec(const clap_host_t* const host, const uint32_t num_tasks)
+    {
+        return static_cast<const carla_clap_host*>(host->host_data)->hostCallbacks->clapRequestExec(num_tasks);
+    }
+
   #ifdef CLAP_WINDOW_API_NATIVE
     static void CLAP_ABI carla_resize_hints_changed(const clap_host_t* const host)
     {
@@ -728,7 +739,8 @@ public:
           fNeedsParamFlush(false),
           fNeedsRestart(false),
           fNeedsProcess(false),
-          fNeedsIdleCallback(false)
+          fNeedsIdleCallback(false),
+          fIsProcessing(false)
     {
         carla_debug("CarlaPluginCLAP::CarlaPluginCLAP(%p, %i)", engine, id);
     }
@@ -1392,6 +1404,12 @@ public:
         const clap_plugin_state_t* stateExt = static_cast<const clap_plugin_state_t*>(
             fPlugin->get_extension(fPlugin, CLAP_EXT_STATE));
 
+        const clap_plugin_tail_t* tailExt = static_cast<const clap_plugin_tail_t*>(
+            fPlugin->get_extension(fPlugin, CLAP_EXT_TAIL));
+
+        const clap_plugin_thread_pool_t* threadPoolExt = static_cast<const clap_plugin_thread_pool_t*>(
+            fPlugin->get_extension(fPlugin, CLAP_EXT_THREAD_POOL));
+
         const clap_plugin_timer_support_t* timerExt = static_cast<const clap_plugin_timer_support_t*>(
             fPlugin->get_extension(fPlugin, CLAP_EXT_TIMER_SUPPORT));
 
@@ -1410,12 +1428,23 @@ public:
         if (stateExt != nullptr && (stateExt->save == nullptr || stateExt->load == nullptr))
             stateExt = nullptr;
 
+        if (tailExt != nullptr && tailExt->get == nullptr)
+            tailExt = nullptr;
+
+        if (threadPoolExt != nullptr && threadPoolExt->exec == nullptr)
+            threadPoolExt = nullptr;
+
+        if (threadPoolExt != nullptr)
+            pData->engine->startWorkerThreads();
+
         if (timerExt != nullptr && timerExt->on_timer == nullptr)
             timerExt = nullptr;
 
         fExtensions.latency = latencyExt;
         fExtensions.params = paramsExt;
         fExtensions.state = stateExt;
+        fExtensions.tail = tailExt;
+        fExtensions.threadPool = threadPoolExt;
         fExtensions.timer = timerExt;
 
        #ifdef CLAP_WINDOW_API_NATIVE
@@ -2097,22 +2126,20 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
                 if (fInputEvents.portCount == 0)
                 {
                     // does not handle MIDI
-                    pData->extNotes.data.clear();
+                    pData->extNotes.data.flush();
                 }
                 else
                 {
                     ExternalMidiNote note = { -1, 0, 0 };
                     const uint16_t p = fInputEvents.portData[0].clapPortIndex;
 
-                    for (; fInputEvents.numEventsUsed < fInputEvents.numEventsAllocated && ! pData->extNotes.data.isEmpty();)
+                    for (; fInputEvents.numEventsUsed < fInputEvents.numEventsAllocated && pData->extNotes.data.tryPop(note);)
                     {
-                        note = pData->extNotes.data.getFirst(note, true);
-
                         CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                         if (fInputEvents.portData[0].supportedDialects & CLAP_NOTE_DIALECT_MIDI)
@@ -2131,8 +2158,6 @@ public:
                     }
                 }
 
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -2425,8 +2450,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input (main port)
 
         // --------------------------------------------------------------------------------------------------------
@@ -2464,7 +2487,32 @@ public:
             fOutputEvents.cast()
         };
 
-        fPlugin->process(fPlugin, &process);
+        fIsProcessing = true;
+        const clap_process_status status = fPlugin->process(fPlugin, &process);
+        fIsProcessing = false;
+
+        // let the engine know when this plugin can sleep
+        pData->sleep.tailFrames = ProtectedData::Sleep::kTailUnknown;
+
+        switch (status)
+        {
+        case CLAP_PROCESS_CONTINUE:
+            pData->sleep.status = ProtectedData::Sleep::kStatusContinue;
+            break;
+        case CLAP_PROCESS_CONTINUE_IF_NOT_QUIET:
+            pData->sleep.tailFrames = 0;
+            break;
+        case CLAP_PROCESS_TAIL:
+            if (fExtensions.tail != nullptr)
+            {
+                const uint32_t tail = fExtensions.tail->get(fPlugin);
+                pData->sleep.tailFrames = tail < INT32_MAX ? tail : ProtectedData::Sleep::kTailInfinite;
+            }
+            break;
+        case CLAP_PROCESS_SLEEP:
+            pData->sleep.status = ProtectedData::Sleep::kStatusSleep;
+            break;
+        }
 
        #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
@@ -2784,9 +2832,29 @@ protected:
 
     // -------------------------------------------------------------------
 
+    bool clapRequestExec(const uint32_t numTasks) override
+    {
+        // only valid from within process, the plugin runs the tasks by itself otherwise
+        if (! fIsProcessing || fExtensions.threadPool == nullptr)
+            return false;
+
+        return pData->engine->runWorkerTasks(carla_thread_pool_exec, this, numTasks);
+    }
+
+    static void carla_thread_pool_exec(void* const ptr, const uint32_t taskIndex)
+    {
+        CarlaPluginCLAP* const self = static_cast<CarlaPluginCLAP*>(ptr);
+
+        self->fExtensions.threadPool->exec(self->fPlugin, taskIndex);
+    }
+
+    // -------------------------------------------------------------------
+
     void clapMarkDirty() override
     {
-        carla_stdout("CarlaPluginCLAP::clapMarkDirty()");
+        carla_debug("CarlaPluginCLAP::clapMarkDirty()");
+
+        setStateChanged();
     }
 
     // -------------------------------------------------------------------
@@ -3245,6 +3313,8 @@ private:
         const clap_plugin_latency_t* latency;
         const clap_plugin_params_t* params;
         const clap_plugin_state_t* state;
+        const clap_plugin_tail_t* tail;
+        const clap_plugin_thread_pool_t* threadPool;
         const clap_plugin_timer_support_t* timer;
       #ifdef CLAP_WINDOW_API_NATIVE
         const clap_plugin_gui_t* gui;
@@ -3257,6 +3327,8 @@ private:
             : latency(nullptr),
               params(nullptr),
               state(nullptr),
+              tail(nullptr),
+              threadPool(nullptr),
               timer(nullptr)
           #ifdef CLAP_WINDOW_API_NATIVE
             , gui(nullptr)
@@ -3324,6 +3396,7 @@ private:
     bool fNeedsRestart;
     bool fNeedsProcess;
     bool fNeedsIdleCallback;
+    bool fIsProcessing;
 
    #ifdef CARLA_OS_MAC
     BundleLoader fBundleLoader;
@@ -22,11 +22,16 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaMathUtils.hpp"
+#include "CarlaMutex.hpp"
+#include "CarlaThread.hpp"
 
 #include "water/text/StringArray.h"
 
 #include <fluidsynth.h>
 
+#include <map>
+#include <string>
+
 #define FLUID_DEFAULT_POLYPHONY 64
 
 using water::String;
@@ -34,10 +39,299 @@ using water::StringArray;
 
 CARLA_BACKEND_START_NAMESPACE
 
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
 // -------------------------------------------------------------------------------------------------------------------
-// Fallback data
+// SoundFonts shared by all FluidSynth instances
+
+/*
+   FluidSynth keeps a full copy of a SoundFont for every synth it is loaded into.
+   Each plugin synth gets a loader from this class, which keeps a single copy of every file inside a private synth
+   and hands out light SoundFont objects forwarding to it.
+   Every light SoundFont has its own presets wrapping the shared ones, so the channel reference counting done by
+   each synth (from its own audio thread) never touches the shared SoundFont, and so does program iteration.
+   Sample reference counts are still shared, these are only used for dynamic sample loading which is disabled here.
+   A file is unloaded once the last synth using it is deleted.
+  */
+class CarlaFluidSoundFontCache
+{
+public:
+    /*
+     * Create a SoundFont loader for a plugin synth, owned by the synth after fluid_synth_add_sfloader().
+     */
+    static fluid_sfloader_t* createLoader() noexcept
+    {
+        return new_fluid_sfloader(carla_fluid_sfloader_load, delete_fluid_sfloader);
+    }
+
+private:
+    struct SharedSoundFont {
+        std::string filename;
+        fluid_sfont_t* sfont;
+        int sfontId;
+        uint refCount;
+    };
+
+    typedef std::map<std::string, SharedSoundFont*> SoundFontMap;
+    typedef std::map<int, fluid_preset_t*> PresetMap;
+
+    struct SoundFontInstance {
+        SharedSoundFont* shared;
+        PresetMap presets;
+        PresetMap::const_iterator iteration;
+        uint noteId;
+    };
+
+    CarlaMutex fMutex;
+    fluid_settings_t* fSettings;
+    fluid_synth_t* fSynth;
+    SoundFontMap fSoundFonts;
+
+    CarlaFluidSoundFontCache() noexcept
+        : fMutex(),
+          fSettings(nullptr),
+          fSynth(nullptr),
+          fSoundFonts() {}
+
+    static CarlaFluidSoundFontCache& getInstance() noexcept
+    {
+        static CarlaFluidSoundFontCache cache;
+        return cache;
+    }
+
+    SharedSoundFont* acquire(const char* const filename)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        const SoundFontMap::iterator it = fSoundFonts.find(filename);
+
+        if (it != fSoundFonts.end())
+        {
+            SharedSoundFont* const shared = it->second;
+            ++shared->refCount;
+            return shared;
+        }
+
+        if (fSynth == nullptr)
+        {
+            fSettings = new_fluid_settings();
+            CARLA_SAFE_ASSERT_RETURN(fSettings != nullptr, nullptr);
+
+            // only used as SoundFont storage, samples must stay loaded as they are shared
+            fluid_settings_setint(fSettings, "synth.polyphony", 1);
+            fluid_settings_setint(fSettings, "synth.ladspa.active", 0);
+            fluid_settings_setint(fSettings, "synth.lock-memory", 1);
+            fluid_settings_setint(fSettings, "synth.dynamic-sample-loading", 0);
+            fluid_settings_setint(fSettings, "synth.threadsafe-api", 0);
+
+            fSynth = new_fluid_synth(fSettings);
+
+            if (fSynth == nullptr)
+            {
+                carla_safe_assert("fSynth != nullptr", __FILE__, __LINE__);
+                delete_fluid_settings(fSettings);
+                fSettings = nullptr;
+                return nullptr;
+            }
+        }
+
+        const int sfontId = fluid_synth_sfload(fSynth, filename, 0);
 
-static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
+        if (sfontId < 0)
+        {
+            cleanupIfUnused();
+            return nullptr;
+        }
+
+        fluid_sfont_t* const sfont = fluid_synth_get_sfont_by_id(fSynth, sfontId);
+        CARLA_SAFE_ASSERT_RETURN(sfont != nullptr, nullptr);
+
+        SharedSoundFont* const shared = new SharedSoundFont;
+        shared->filename = filename;
+        shared->sfont = sfont;
+        shared->sfontId = sfontId;
+        shared->refCount = 1;
+
+        fSoundFonts[shared->filename] = shared;
+        return shared;
+    }
+
+    void release(SharedSoundFont* const shared)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        CARLA_SAFE_ASSERT_RETURN(shared->refCount != 0,);
+
+        if (--shared->refCount != 0)
+            return;
+
+        carla_debug("CarlaFluidSoundFontCache::release() - unloading \"%s\"", shared->filename.c_str());
+
+        fSoundFonts.erase(shared->filename);
+        fluid_synth_sfunload(fSynth, shared->sfontId, 0);
+        delete shared;
+
+        cleanupIfUnused();
+    }
+
+    // create presets for a light SoundFont, each forwarding to a shared one
+    void createPresets(fluid_sfont_t* const sfont, SoundFontInstance* const instance)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        fluid_sfont_t* const sharedSfont = instance->shared->sfont;
+        fluid_sfont_iteration_start(sharedSfont);
+
+        while (fluid_preset_t* const sharedPreset = fluid_sfont_iteration_next(sharedSfont))
+        {
+            fluid_preset_t* const preset = new_fluid_preset(sfont,
+                                                            carla_fluid_preset_get_name,
+                                                            carla_fluid_preset_get_banknum,
+                                                            carla_fluid_preset_get_num,
+                                                            carla_fluid_preset_noteon,
+                                                            carla_fluid_preset_free);
+            CARLA_SAFE_ASSERT_CONTINUE(preset != nullptr);
+
+            fluid_preset_set_data(preset, sharedPreset);
+
+            const int key = fluid_preset_get_banknum(sharedPreset) * 128 + fluid_preset_get_num(sharedPreset);
+            instance->presets[key] = preset;
+        }
+    }
+
+    void cleanupIfUnused()
+    {
+        if (! fSoundFonts.empty())
+            return;
+
+        if (fSynth != nullptr)
+        {
+            delete_fluid_synth(fSynth);
+            fSynth = nullptr;
+        }
+
+        if (fSettings != nullptr)
+        {
+            delete_fluid_settings(fSettings);
+            fSettings = nullptr;
+        }
+    }
+
+    // ---------------------------------------------------------------------------------------------------------------
+    // loader and SoundFont callbacks, these are called by plugin synths
+
+    static fluid_sfont_t* carla_fluid_sfloader_load(fluid_sfloader_t*, const char* const filename)
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', nullptr);
+
+        SharedSoundFont* const shared = getInstance().acquire(filename);
+
+        // let the default loaders report the error
+        if (shared == nullptr)
+            return nullptr;
+
+        fluid_sfont_t* const sfont = new_fluid_sfont(carla_fluid_sfont_get_name,
+                                                     carla_fluid_sfont_get_preset,
+                                                     carla_fluid_sfont_iteration_start,
+                                                     carla_fluid_sfont_iteration_next,
+                                                     carla_fluid_sfont_free);
+
+        if (sfont == nullptr)
+        {
+            carla_safe_assert("sfont != nullptr", __FILE__, __LINE__);
+            getInstance().release(shared);
+            return nullptr;
+        }
+
+        SoundFontInstance* const instance = new SoundFontInstance;
+        instance->shared = shared;
+        // kept apart from the note ids FluidSynth uses itself
+        instance->noteId = 0x80000000U;
+
+        fluid_sfont_set_data(sfont, instance);
+
+        getInstance().createPresets(sfont, instance);
+        instance->iteration = instance->presets.end();
+
+        return sfont;
+    }
+
+    static const char* carla_fluid_sfont_get_name(fluid_sfont_t* const sfont)
+    {
+        return fluid_sfont_get_name(((SoundFontInstance*)fluid_sfont_get_data(sfont))->shared->sfont);
+    }
+
+    // called from the audio thread on program changes, must not allocate
+    static fluid_preset_t* carla_fluid_sfont_get_preset(fluid_sfont_t* const sfont, const int bank, const int prenum)
+    {
+        const PresetMap& presets(((SoundFontInstance*)fluid_sfont_get_data(sfont))->presets);
+        const PresetMap::const_iterator it = presets.find(bank * 128 + prenum);
+
+        return it != presets.end() ? it->second : nullptr;
+    }
+
+    static void carla_fluid_sfont_iteration_start(fluid_sfont_t* const sfont)
+    {
+        SoundFontInstance* const instance = (SoundFontInstance*)fluid_sfont_get_data(sfont);
+        instance->iteration = instance->presets.begin();
+    }
+
+    static fluid_preset_t* carla_fluid_sfont_iteration_next(fluid_sfont_t* const sfont)
+    {
+        SoundFontInstance* const instance = (SoundFontInstance*)fluid_sfont_get_data(sfont);
+
+        if (instance->iteration == instance->presets.end())
+            return nullptr;
+
+        return (instance->iteration++)->second;
+    }
+
+    static int carla_fluid_sfont_free(fluid_sfont_t* const sfont)
+    {
+        SoundFontInstance* const instance = (SoundFontInstance*)fluid_sfont_get_data(sfont);
+
+        for (PresetMap::iterator it = instance->presets.begin(), end = instance->presets.end(); it != end; ++it)
+            delete_fluid_preset(it->second);
+
+        getInstance().release(instance->shared);
+        delete instance;
+
+        delete_fluid_sfont(sfont);
+        return 0;
+    }
+
+    static const char* carla_fluid_preset_get_name(fluid_preset_t* const preset)
+    {
+        return fluid_preset_get_name((fluid_preset_t*)fluid_preset_get_data(preset));
+    }
+
+    static int carla_fluid_preset_get_banknum(fluid_preset_t* const preset)
+    {
+        return fluid_preset_get_banknum((fluid_preset_t*)fluid_preset_get_data(preset));
+    }
+
+    static int carla_fluid_preset_get_num(fluid_preset_t* const preset)
+    {
+        return fluid_preset_get_num((fluid_preset_t*)fluid_preset_get_data(preset));
+    }
+
+    // voices are started from the shared preset, reading only its (constant) zones and samples
+    static int carla_fluid_preset_noteon(fluid_preset_t* const preset, fluid_synth_t* const synth,
+                                         const int chan, const int key, const int vel)
+    {
+        SoundFontInstance* const instance = (SoundFontInstance*)fluid_sfont_get_data(fluid_preset_get_sfont(preset));
+
+        return fluid_synth_start(synth, instance->noteId++, (fluid_preset_t*)fluid_preset_get_data(preset),
+                                 0, chan, key, vel);
+    }
+
+    // presets are owned and deleted by their SoundFont
+    static void carla_fluid_preset_free(fluid_preset_t*)
+    {
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaFluidSoundFontCache)
+};
+#endif
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -66,7 +360,6 @@ public:
         fluid_settings_setint(fSettings, "synth.audio-channels", use16Outs ? 16 : 1);
         fluid_settings_setint(fSettings, "synth.audio-groups", use16Outs ? 16 : 1);
         fluid_settings_setnum(fSettings, "synth.sample-rate", pData->engine->getSampleRate());
-        //fluid_settings_setnum(fSettings, "synth.cpu-cores", 2);
         fluid_settings_setint(fSettings, "synth.ladspa.active", 0);
         fluid_settings_setint(fSettings, "synth.lock-memory", 1);
 #if FLUIDSYNTH_VERSION_MAJOR < 2
@@ -77,10 +370,44 @@ public:
         fluid_settings_setint(fSettings, "synth.verbose", 1);
 #endif
 
-        // create synth
+        const EngineOptions& options(pData->engine->getOptions());
+
+        int cpuCores = options.fluidSynthCpuCores;
+        if (cpuCores == 0)
+            cpuCores = static_cast<int>(pData->engine->getWorkerThreadCount()) + 1;
+
+        if (cpuCores > 1)
+        {
+            fluid_settings_setint(fSettings, "synth.cpu-cores", cpuCores);
+            fluid_settings_setint(fSettings, "audio.realtime-prio", pData->engine->getRealtimePriority());
+        }
+
+        // create synth.
+        // FluidSynth starts its rendering threads in here, restrict this thread to the worker CPUs meanwhile
+        // so that the new threads inherit them.
+#ifdef CARLA_OS_LINUX
+        cpu_set_t oldCpus;
+        const bool restoreCpus = cpuCores > 1
+                              && options.workerCpuSet != nullptr
+                              && pthread_getaffinity_np(pthread_self(), sizeof(oldCpus), &oldCpus) == 0
+                              && CarlaThread::setCurrentThreadAffinity(options.workerCpuSet);
+#endif
+
         fSynth = new_fluid_synth(fSettings);
+
+#ifdef CARLA_OS_LINUX
+        if (restoreCpus)
+            pthread_setaffinity_np(pthread_self(), sizeof(oldCpus), &oldCpus);
+#endif
+
         CARLA_SAFE_ASSERT_RETURN(fSynth != nullptr,);
 
+#if FLUIDSYNTH_VERSION_MAJOR >= 2
+        // tried before the default loaders, so SoundFont data is shared with other instances
+        if (fluid_sfloader_t* const loader = CarlaFluidSoundFontCache::createLoader())
+            fluid_synth_add_sfloader(fSynth, loader);
+#endif
+
         initializeFluidDefaultsIfNeeded();
 
 #if FLUIDSYNTH_VERSION_MAJOR < 2
@@ -1170,11 +1497,10 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
-                for (RtLinkedList<ExternalMidiNote>::Itenerator it = pData->extNotes.data.begin2(); it.valid(); it.next())
+                for (ExternalMidiNote note; pData->extNotes.data.tryPop(note);)
                 {
-                    const ExternalMidiNote& note(it.getValue(kExternalMidiNoteFallback));
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     if (note.velo > 0)
@@ -1183,9 +1509,6 @@ public:
                         fluid_synth_noteoff(fSynth,note.channel, note.note);
                 }
 
-                pData->extNotes.data.clear();
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -1455,8 +1778,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioOut, frames - timeOffset, timeOffset);
 
@@ -509,26 +509,121 @@ const MidiProgramData& PluginMidiProgramData::getCurrent() const noexcept
 
 CarlaPlugin::ProtectedData::ExternalNotes::ExternalNotes() noexcept
     : mutex(),
-      dataPool("CarlaPlugin::ProtectedData::ExternalNotes", 32, 152),
-      data(dataPool) {}
+      data() {}
+
+CarlaPlugin::ProtectedData::ExternalNotes::~ExternalNotes() noexcept {}
 
-CarlaPlugin::ProtectedData::ExternalNotes::~ExternalNotes() noexcept
+void CarlaPlugin::ProtectedData::ExternalNotes::appendNonRT(const ExternalMidiNote& note) noexcept
 {
-    clear();
+    const CarlaMutexLocker cml(mutex);
+
+    if (! data.tryPush(note))
+        carla_stderr2("CarlaPlugin: external note queue is full, note %u dropped", note.note);
 }
 
-void CarlaPlugin::ProtectedData::ExternalNotes::appendNonRT(const ExternalMidiNote& note) noexcept
+// -----------------------------------------------------------------------
+// ProtectedData::Sleep
+
+CarlaPlugin::ProtectedData::Sleep::Sleep() noexcept
+    : status(kStatusDefault),
+      tailFrames(kTailUnknown),
+      inputSilent(false),
+      idle(false),
+      asleep(false),
+      quietFrames(0) {}
+
+void CarlaPlugin::ProtectedData::Sleep::wakeUp() noexcept
 {
-    mutex.lock();
-    data.append_sleepy(note);
-    mutex.unlock();
+    asleep = false;
+    quietFrames = 0;
+}
+
+// -----------------------------------------------------------------------
+// ProtectedData::SubBlock
+
+// weight of past process() calls in the adaptive fit, roughly the last few hundred calls count
+static constexpr const double kSubBlockHistoryWeight = 0.99;
+
+// adaptive mode keeps the per-call overhead below this ratio of the time spent processing a sub-block
+static constexpr const double kSubBlockMaxOverhead = 0.25;
+
+static constexpr const uint32_t kSubBlockMaxAdaptiveGranularity = 64;
+
+CarlaPlugin::ProtectedData::SubBlock::SubBlock() noexcept
+    : granularity(1),
+      measuring(false),
+      frames(0),
+      splits(0),
+      adaptiveGranularity(1),
+      sumCallsCalls(0.0),
+      sumCallsFrames(0.0),
+      sumFramesFrames(0.0),
+      sumCallsTime(0.0),
+      sumFramesTime(0.0) {}
+
+void CarlaPlugin::ProtectedData::SubBlock::begin(const int option, const uint32_t newFrames) noexcept
+{
+    measuring = option < 0;
+    frames = newFrames;
+    splits = 0;
+
+    if (option > 0)
+        granularity = static_cast<uint32_t>(option);
+    else if (option < 0)
+        granularity = adaptiveGranularity;
+    else
+        granularity = 1;
 }
 
-void CarlaPlugin::ProtectedData::ExternalNotes::clear() noexcept
+uint32_t CarlaPlugin::ProtectedData::SubBlock::getSplitTime(const uint32_t eventTime, const uint32_t timeOffset) noexcept
 {
-    mutex.lock();
-    data.clear();
-    mutex.unlock();
+    // events sharing a grid cell never split between them,
+    // so events placed in the current sub-block always come before the next split
+    const uint32_t splitTime = eventTime - eventTime % granularity;
+
+    if (splitTime <= timeOffset)
+        return timeOffset;
+
+    ++splits;
+    return splitTime;
+}
+
+void CarlaPlugin::ProtectedData::SubBlock::addProcessTime(const uint64_t time) noexcept
+{
+    if (! measuring)
+        return;
+
+    measuring = false;
+
+    const double calls = static_cast<double>(splits + 1);
+    const double dframes = static_cast<double>(frames);
+    const double dtime = static_cast<double>(time);
+
+    sumCallsCalls   = sumCallsCalls   * kSubBlockHistoryWeight + calls * calls;
+    sumCallsFrames  = sumCallsFrames  * kSubBlockHistoryWeight + calls * dframes;
+    sumFramesFrames = sumFramesFrames * kSubBlockHistoryWeight + dframes * dframes;
+    sumCallsTime    = sumCallsTime    * kSubBlockHistoryWeight + calls * dtime;
+    sumFramesTime   = sumFramesTime   * kSubBlockHistoryWeight + dframes * dtime;
+
+    // time = callCost * calls + frameCost * frames, only solvable once the number of calls varies
+    const double det = sumCallsCalls * sumFramesFrames - sumCallsFrames * sumCallsFrames;
+
+    if (det <= 0.001 * sumCallsCalls * sumFramesFrames)
+        return;
+
+    const double callCost  = (sumFramesFrames * sumCallsTime - sumCallsFrames * sumFramesTime) / det;
+    const double frameCost = (sumCallsCalls * sumFramesTime - sumCallsFrames * sumCallsTime) / det;
+
+    if (frameCost <= 0.0)
+        return;
+
+    uint32_t newGranularity = 1;
+
+    while (newGranularity < kSubBlockMaxAdaptiveGranularity
+           && callCost > kSubBlockMaxOverhead * frameCost * newGranularity)
+        newGranularity *= 2;
+
+    adaptiveGranularity = newGranularity;
 }
 
 // -----------------------------------------------------------------------
@@ -633,45 +728,24 @@ void CarlaPlugin::ProtectedData::Latency::recreateBuffers(const uint32_t newChan
 // ProtectedData::PostRtEvents
 
 CarlaPlugin::ProtectedData::PostRtEvents::PostRtEvents() noexcept
-    : dataPool("CarlaPlugin::ProtectedData::PostRtEvents", 512, 512),
-      data(dataPool),
-      dataPendingRT(dataPool),
-      dataMutex(),
-      dataPendingMutex(),
-      poolMutex() {}
-
-CarlaPlugin::ProtectedData::PostRtEvents::~PostRtEvents() noexcept
-{
-    const CarlaMutexLocker cml1(dataMutex);
-    const CarlaMutexLocker cml2(dataPendingMutex);
-    const CarlaMutexLocker cml3(poolMutex);
+    : dataRT(),
+      dataNonRT(),
+      writeMutex(),
+      readMutex() {}
 
-    data.clear();
-    dataPendingRT.clear();
-}
+CarlaPlugin::ProtectedData::PostRtEvents::~PostRtEvents() noexcept {}
 
 void CarlaPlugin::ProtectedData::PostRtEvents::appendRT(const PluginPostRtEvent& e) noexcept
 {
-    CARLA_SAFE_ASSERT_INT_RETURN(dataPendingMutex.tryLock(), e.type,);
-    {
-        const CarlaMutexLocker cml(poolMutex);
-        dataPendingRT.append(e);
-    }
-    dataPendingMutex.unlock();
+    // on overflow the event is dropped and counted, reported later by postRtEventsRun()
+    dataRT.tryPush(e);
 }
 
-void CarlaPlugin::ProtectedData::PostRtEvents::trySplice() noexcept
+void CarlaPlugin::ProtectedData::PostRtEvents::appendNonRT(const PluginPostRtEvent& e) noexcept
 {
-    const CarlaMutexTryLocker cmtl(dataPendingMutex);
+    const CarlaMutexLocker cml(writeMutex);
 
-    if (cmtl.wasLocked() && dataPendingRT.isNotEmpty() && dataMutex.tryLock())
-    {
-        {
-            const CarlaMutexLocker cml(poolMutex);
-            dataPendingRT.moveTo(data, true);
-        }
-        dataMutex.unlock();
-    }
+    dataNonRT.tryPush(e);
 }
 
 // -----------------------------------------------------------------------
@@ -751,9 +825,13 @@ CarlaPlugin::ProtectedData::ProtectedData(CarlaEngine* const eng, const uint idx
       masterMutex(),
       singleMutex(),
       stateSave(),
+      stateChanged(true),
+      stateSaveXml(),
       uiTitle(),
       extNotes(),
       latency(),
+      sleep(),
+      subBlock(),
       postRtEvents(),
       postUiEvents()
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -950,6 +1028,17 @@ void CarlaPlugin::ProtectedData::postponeMidiLearnRtEvent(const bool sendCallbac
     postRtEvents.appendRT(rtEvent);
 }
 
+void CarlaPlugin::ProtectedData::postponeParameterChangeNonRtEvent(const bool sendCallbackLater,
+                                                                   const int32_t index,
+                                                                   const float value) noexcept
+{
+    PluginPostRtEvent rtEvent = { kPluginPostRtEventParameterChange, sendCallbackLater, {} };
+    rtEvent.parameter.index = index;
+    rtEvent.parameter.value = value;
+
+    postRtEvents.appendNonRT(rtEvent);
+}
+
 // -----------------------------------------------------------------------
 // Library functions
 
@@ -26,8 +26,12 @@
 
 #include "CarlaMIDI.h"
 #include "CarlaMutex.hpp"
+#include "CarlaProcessTimeHistogram.hpp"
+#include "CarlaSpscRingBuffer.hpp"
 #include "CarlaString.hpp"
-#include "RtLinkedList.hpp"
+#include "LinkedList.hpp"
+
+#include <atomic>
 
 CARLA_BACKEND_START_NAMESPACE
 
@@ -286,17 +290,20 @@ struct CarlaPlugin::ProtectedData {
 
     CarlaStateSave stateSave;
 
+    // incremental project saves, see CarlaPlugin::getStateSaveXml()
+    std::atomic<bool> stateChanged;
+    water::String stateSaveXml;
+
     CarlaString uiTitle;
 
     struct ExternalNotes {
+        // serializes non-RT writers, never taken by the RT reader
         CarlaMutex mutex;
-        RtLinkedList<ExternalMidiNote>::Pool dataPool;
-        RtLinkedList<ExternalMidiNote> data;
+        CarlaSpscRingBuffer<ExternalMidiNote, 512> data;
 
         ExternalNotes() noexcept;
         ~ExternalNotes() noexcept;
         void appendNonRT(const ExternalMidiNote& note) noexcept;
-        void clear() noexcept;
 
         CARLA_DECLARE_NON_COPYABLE(ExternalNotes)
 
@@ -320,53 +327,131 @@ struct CarlaPlugin::ProtectedData {
 
     } latency;
 
+    // time taken by each process() call, measured by the engine
+    CarlaProcessTimeHistogram processTime;
+
+    // sleep state for idle effects, only used by the audio thread
+    struct Sleep {
+        // tailFrames values when the plugin does not report its tail length or has an infinite one
+        static constexpr const uint32_t kTailUnknown  = UINT32_MAX;
+        static constexpr const uint32_t kTailInfinite = UINT32_MAX - 1;
+
+        enum Status {
+            kStatusDefault = 0, // decide from output level and tail
+            kStatusQuiet,       // plugin reports its output as silent
+            kStatusSleep,       // plugin asks to sleep until input or events arrive
+            kStatusContinue     // plugin asks to keep processing
+        };
+
+        // set by the plugin implementation during process()
+        Status status;
+        uint32_t tailFrames;
+
+        // set by the engine
+        bool inputSilent;
+        bool idle;        // input is silent and there are no events, so the plugin may sleep
+        bool asleep;
+        uint32_t quietFrames;
+
+        Sleep() noexcept;
+        void wakeUp() noexcept;
+
+        CARLA_DECLARE_NON_COPYABLE(Sleep)
+
+    } sleep;
+
+    // splitting of process() at control event times, only used by the audio thread
+    struct SubBlock {
+        // granularity for the current process() call, 1 splits at every event time
+        uint32_t granularity;
+
+        // current process() call, measured in adaptive mode
+        bool measuring;
+        uint32_t frames;
+        uint32_t splits;
+
+        // adaptive mode, least squares fit of process() time against the number of calls and frames
+        uint32_t adaptiveGranularity;
+        double sumCallsCalls;
+        double sumCallsFrames;
+        double sumFramesFrames;
+        double sumCallsTime;
+        double sumFramesTime;
+
+        SubBlock() noexcept;
+
+        // start a new process() call, option is the value of ENGINE_OPTION_SUB_BLOCK_GRANULARITY
+        void begin(int option, uint32_t newFrames) noexcept;
+
+        // time to split at for an event at eventTime, returns timeOffset if there is no need to split
+        uint32_t getSplitTime(uint32_t eventTime, uint32_t timeOffset) noexcept;
+
+        // time taken by the last process() call, used to update the adaptive granularity
+        void addProcessTime(uint64_t time) noexcept;
+
+        CARLA_DECLARE_NON_COPYABLE(SubBlock)
+
+    } subBlock;
+
     class PostRtEvents {
     public:
         PostRtEvents() noexcept;
         ~PostRtEvents() noexcept;
         void appendRT(const PluginPostRtEvent& event) noexcept;
-        void trySplice() noexcept;
+        void appendNonRT(const PluginPostRtEvent& event) noexcept;
 
         struct Access {
-            Access(PostRtEvents& e)
-              : data2(e.dataPool),
-                poolMutex(e.poolMutex)
+            Access(PostRtEvents& e) noexcept
+              : events(e),
+                cml(e.readMutex),
+                remainingRT(e.dataRT.getReadableCount()),
+                remainingNonRT(e.dataNonRT.getReadableCount()) {}
+
+            // only returns events that were available when this access was created
+            inline bool readNext(PluginPostRtEvent& event) noexcept
             {
-                const CarlaMutexLocker cml1(e.dataMutex);
-                const CarlaMutexLocker cml2(e.poolMutex);
-
-                if (e.data.isNotEmpty())
-                    e.data.moveTo(data2, true);
+                if (remainingRT != 0)
+                {
+                    --remainingRT;
+                    return events.dataRT.tryPop(event);
+                }
+
+                if (remainingNonRT != 0)
+                {
+                    --remainingNonRT;
+                    return events.dataNonRT.tryPop(event);
+                }
+
+                return false;
             }
 
-            ~Access()
+            inline bool isEmpty() const noexcept
             {
-                const CarlaMutexLocker cml(poolMutex);
-
-                data2.clear();
+                return remainingRT == 0 && remainingNonRT == 0;
             }
 
-            inline RtLinkedList<PluginPostRtEvent>::Itenerator getDataIterator() const noexcept
+            inline uint32_t takeOverflowCount() noexcept
             {
-                return data2.begin2();
-            }
-
-            inline std::size_t isEmpty() const noexcept
-            {
-                return data2.isEmpty();
+                return events.dataRT.takeOverflowCount() + events.dataNonRT.takeOverflowCount();
             }
 
         private:
-            RtLinkedList<PluginPostRtEvent> data2;
-            CarlaMutex& poolMutex;
+            PostRtEvents& events;
+            const CarlaMutexLocker cml;
+            uint32_t remainingRT;
+            uint32_t remainingNonRT;
+
+            CARLA_DECLARE_NON_COPYABLE(Access)
         };
 
     private:
-        RtLinkedList<PluginPostRtEvent>::Pool dataPool;
-        RtLinkedList<PluginPostRtEvent> data, dataPendingRT;
-        CarlaMutex dataMutex;
-        CarlaMutex dataPendingMutex;
-        CarlaMutex poolMutex;
+        // written by the audio thread only
+        CarlaSpscRingBuffer<PluginPostRtEvent, 1024> dataRT;
+        // written by any other thread, serialized by writeMutex
+        CarlaSpscRingBuffer<PluginPostRtEvent, 256> dataNonRT;
+        CarlaMutex writeMutex;
+        // serializes non-RT readers, never taken by the RT writer
+        CarlaMutex readMutex;
 
         CARLA_DECLARE_NON_COPYABLE(PostRtEvents)
 
@@ -420,6 +505,9 @@ struct CarlaPlugin::ProtectedData {
     void postponeNoteOffRtEvent(bool sendCallbackLater, uint8_t channel, uint8_t note) noexcept;
     void postponeMidiLearnRtEvent(bool sendCallbackLater, uint32_t parameter, uint8_t cc, uint8_t channel) noexcept;
 
+    // same as postponeParameterChangeRtEvent(), for threads other than the audio one
+    void postponeParameterChangeNonRtEvent(bool sendCallbackLater, int32_t index, float value) noexcept;
+
     // -------------------------------------------------------------------
     // Library functions
 
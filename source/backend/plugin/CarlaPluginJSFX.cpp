@@ -24,6 +24,7 @@
 
 #include "CarlaJsfxUtils.hpp"
 #include "CarlaBackendUtils.hpp"
+#include "CarlaMutex.hpp"
 #include "CarlaUtils.hpp"
 
 #include "water/files/File.h"
@@ -32,6 +33,8 @@
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
+#include <map>
+#include <string>
 
 using water::CharPointer_UTF8;
 using water::File;
@@ -41,9 +44,128 @@ using water::StringArray;
 CARLA_BACKEND_START_NAMESPACE
 
 // -------------------------------------------------------------------------------------------------------------------
-// Fallback data
+// Sources shared by all JSFX instances
 
-static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
+/*
+   Reading and parsing an effect and its imports happens once per file.
+   Following instances take the parsed sections from an effect kept here, which is only checked against the size and
+   modification time of its source files.
+   Compiled code is not shared, EEL2 binds it to the variables of the VM it was compiled for.
+  */
+class CarlaJsfxSourceCache
+{
+public:
+    static CarlaJsfxSourceCache& getInstance()
+    {
+        static CarlaJsfxSourceCache cache;
+        return cache;
+    }
+
+    /*
+     * Load the source of @a unit into @a effect, parsing files only if needed.
+     * Each successful call must be paired with release().
+     */
+    bool load(ysfx_t* const effect, const CarlaJsfxUnit& unit)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        const std::string key(getKey(unit));
+        SourceMap::iterator it = fSources.find(key);
+
+        if (it != fSources.end() && ! it->second.files.isUpToDate())
+        {
+            carla_stdout("JSFX source '%s' changed, loading it again", unit.getFilePath().buffer());
+            ysfx_free(it->second.effect);
+            it->second.effect = nullptr;
+        }
+
+        if (it == fSources.end() || it->second.effect == nullptr)
+        {
+            ysfx_t* const source = loadSource(unit);
+
+            if (source == nullptr)
+                return false;
+
+            if (it == fSources.end())
+            {
+                Source newSource;
+                newSource.effect = source;
+                newSource.users = 0;
+                it = fSources.insert(SourceMap::value_type(key, newSource)).first;
+            }
+            else
+            {
+                it->second.effect = source;
+            }
+
+            it->second.files.setFromEffect(source, unit.getFilePath());
+        }
+
+        if (! ysfx_load_source_from(effect, it->second.effect))
+            return false;
+
+        ++it->second.users;
+        return true;
+    }
+
+    void release(const CarlaJsfxUnit& unit)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        const SourceMap::iterator it = fSources.find(getKey(unit));
+        CARLA_SAFE_ASSERT_RETURN(it != fSources.end(),);
+        CARLA_SAFE_ASSERT_RETURN(it->second.users != 0,);
+
+        if (--it->second.users != 0)
+            return;
+
+        ysfx_free(it->second.effect);
+        fSources.erase(it);
+    }
+
+private:
+    struct Source {
+        ysfx_t* effect;
+        CarlaJsfxSourceFiles files;
+        uint users;
+    };
+
+    typedef std::map<std::string, Source> SourceMap;
+
+    CarlaMutex fMutex;
+    SourceMap fSources;
+
+    CarlaJsfxSourceCache()
+        : fMutex(),
+          fSources() {}
+
+    // imports are resolved relative to the root path, so the same file can have different sources
+    static std::string getKey(const CarlaJsfxUnit& unit)
+    {
+        return std::string(unit.getRootPath().buffer()) + '\n' + unit.getFilePath().buffer();
+    }
+
+    static ysfx_t* loadSource(const CarlaJsfxUnit& unit)
+    {
+        ysfx_config_u config(ysfx_config_new());
+        CARLA_SAFE_ASSERT_RETURN(config != nullptr, nullptr);
+
+        ysfx_register_builtin_audio_formats(config.get());
+        ysfx_set_import_root(config.get(), unit.getRootPath());
+        ysfx_guess_file_roots(config.get(), unit.getFilePath());
+        ysfx_set_log_reporter(config.get(), &CarlaJsfxLogging::logAll);
+
+        ysfx_u source(ysfx_new(config.get()));
+        CARLA_SAFE_ASSERT_RETURN(source != nullptr, nullptr);
+
+        if (! ysfx_load_file(source.get(), unit.getFilePath(), 0))
+            return nullptr;
+
+        return source.release();
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaJsfxSourceCache)
+};
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -55,6 +177,7 @@ public:
           fEffect(nullptr),
           fEffectState(nullptr),
           fUnit(),
+          fSourceLoaded(false),
           fChunkText(),
           fTransportValues(),
           fMapOfSliderToParameter(ysfx_max_sliders, -1)
@@ -84,6 +207,9 @@ public:
 
         ysfx_state_free(fEffectState);
         ysfx_free(fEffect);
+
+        if (fSourceLoaded)
+            CarlaJsfxSourceCache::getInstance().release(fUnit);
     }
 
     // -------------------------------------------------------------------
@@ -153,6 +279,15 @@ public:
         return fEffectState->data_size;
     }
 
+    bool isStateChanged() const noexcept override
+    {
+        // the serialized state can change at any time while processing, without us knowing
+        if ((pData->options & PLUGIN_OPTION_USE_CHUNKS) != 0 && ysfx_has_section(fEffect, ysfx_section_serialize))
+            return true;
+
+        return CarlaPlugin::isStateChanged();
+    }
+
     // -------------------------------------------------------------------
     // Information (per-plugin data)
 
@@ -548,11 +683,10 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
-                for (RtLinkedList<ExternalMidiNote>::Itenerator it = pData->extNotes.data.begin2(); it.valid(); it.next())
+                for (ExternalMidiNote note; pData->extNotes.data.tryPop(note);)
                 {
-                    const ExternalMidiNote& note(it.getValue(kExternalMidiNoteFallback));
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     uint8_t midiData[3];
@@ -568,9 +702,6 @@ public:
                     ysfx_send_midi(fEffect, &event);
                 }
 
-                pData->extNotes.data.clear();
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -836,8 +967,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input and Processing
 
         // --------------------------------------------------------------------------------------------------------
@@ -993,12 +1122,14 @@ public:
         // get info
 
         {
-            if (! ysfx_load_file(fEffect, filePath, 0))
+            if (! CarlaJsfxSourceCache::getInstance().load(fEffect, fUnit))
             {
                 pData->engine->setLastError("Failed to load JSFX");
                 return false;
             }
 
+            fSourceLoaded = true;
+
             // TODO(jsfx) adapt when implementing these features
             const int compileFlags = 0
                 //| ysfx_compile_no_serialize
@@ -1064,6 +1195,7 @@ private:
     ysfx_t* fEffect;
     ysfx_state_t* fEffectState;
     CarlaJsfxUnit fUnit;
+    bool fSourceLoaded;
     water::String fChunkText;
     ysfx_time_info_t fTransportValues;
     std::vector<int32_t> fMapOfSliderToParameter;
@@ -49,11 +49,6 @@ static size_t safe_rand(const size_t limit)
     return static_cast<uint>(r) % limit;
 }
 
-// -------------------------------------------------------------------------------------------------------------------
-// Fallback data
-
-static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
-
 // -------------------------------------------------------------------------------------------------------------------
 
 struct Announcer {
@@ -381,6 +376,14 @@ protected:
             carla_setenv("CARLA_LIBJACK_SETUP", fSetupLabel.buffer());
             carla_setenv("CARLA_SHM_IDS", fShmIds.buffer());
 
+            carla_setenv("ENGINE_OPTION_AUDIO_CPU_SET", options.audioCpuSet != nullptr ? options.audioCpuSet : "");
+            carla_setenv("ENGINE_OPTION_BRIDGE_LOCK_MEMORY", bool2str(options.bridgeLockMemory));
+
+            char rtPrioStr[STR_MAX+1];
+            std::snprintf(rtPrioStr, STR_MAX, "%i", kEngine->getRealtimePriority());
+            rtPrioStr[STR_MAX] = '\0';
+            carla_setenv("ENGINE_OPTION_RT_PRIORITY", rtPrioStr);
+
             if (! fProcess->start(arguments))
             {
                 carla_stdout("failed!");
@@ -1031,11 +1034,10 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
-                for (RtLinkedList<ExternalMidiNote>::Itenerator it = pData->extNotes.data.begin2(); it.valid(); it.next())
+                for (ExternalMidiNote note; pData->extNotes.data.tryPop(note);)
                 {
-                    const ExternalMidiNote& note(it.getValue(kExternalMidiNoteFallback));
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     uint8_t data1, data2, data3;
@@ -1053,9 +1055,6 @@ public:
                     fShmRtClientControl.commitWrite();
                 }
 
-                pData->extNotes.data.clear();
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -1241,8 +1240,6 @@ public:
                 }
             }
 
-            pData->postRtEvents.trySplice();
-
         } // End of Event Input
 
         if (! processSingle(audioIn, audioOut, frames))
@@ -1559,13 +1559,12 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
                 ExternalMidiNote note = { 0, 0, 0 };
 
-                for (; midiEventCount < kPluginMaxMidiEvents && ! pData->extNotes.data.isEmpty();)
+                for (; midiEventCount < kPluginMaxMidiEvents && pData->extNotes.data.tryPop(note);)
                 {
-                    note = pData->extNotes.data.getFirst(note, true);
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
@@ -1577,8 +1576,6 @@ public:
                     seqEvent.data.note.velocity = note.velo;
                 }
 
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -1603,6 +1600,8 @@ public:
                 pData->event.cvSourcePorts->initPortBuffers(cvIn, frames, isSampleAccurate, pData->event.portIn);
 #endif
 
+            pData->subBlock.begin(pData->engine->getOptions().subBlockGranularity, frames);
+
             for (uint32_t i=0, numEvents=pData->event.portIn->getEventCount(); i < numEvents; ++i)
             {
                 EngineEvent& event(pData->event.portIn->getEvent(i));
@@ -1617,12 +1616,15 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                const uint32_t splitTime = isSampleAccurate ? pData->subBlock.getSplitTime(eventTime, timeOffset)
+                                                            : timeOffset;
+
+                if (splitTime > timeOffset)
                 {
-                    if (processSingle(audioIn, audioOut, eventTime - timeOffset, timeOffset, midiEventCount))
+                    if (processSingle(audioIn, audioOut, splitTime - timeOffset, timeOffset, midiEventCount))
                     {
                         startTime  = 0;
-                        timeOffset = eventTime;
+                        timeOffset = splitTime;
                         midiEventCount = 0;
 
                         if (pData->midiprog.current >= 0 && pData->midiprog.count > 0)
@@ -1730,7 +1732,7 @@ public:
                             snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
                             carla_zeroStruct(seqEvent);
 
-                            seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
+                            seqEvent.time.tick = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
 
                             seqEvent.type = SND_SEQ_EVENT_CONTROLLER;
                             seqEvent.data.control.channel = event.channel;
@@ -1775,7 +1777,7 @@ public:
                             snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
                             carla_zeroStruct(seqEvent);
 
-                            seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
+                            seqEvent.time.tick = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
 
                             seqEvent.type = SND_SEQ_EVENT_CONTROLLER;
                             seqEvent.data.control.channel = event.channel;
@@ -1800,7 +1802,7 @@ public:
                             snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
                             carla_zeroStruct(seqEvent);
 
-                            seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
+                            seqEvent.time.tick = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
 
                             seqEvent.type = SND_SEQ_EVENT_CONTROLLER;
                             seqEvent.data.control.channel = event.channel;
@@ -1829,7 +1831,7 @@ public:
                     snd_seq_event_t& seqEvent(fMidiEvents[midiEventCount++]);
                     carla_zeroStruct(seqEvent);
 
-                    seqEvent.time.tick = isSampleAccurate ? startTime : eventTime;
+                    seqEvent.time.tick = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
 
                     switch (status)
                     {
@@ -1918,8 +1920,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, frames - timeOffset, timeOffset, midiEventCount);
 
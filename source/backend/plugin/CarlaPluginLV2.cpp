@@ -8,7 +8,7 @@
 #include "CarlaPluginInternal.hpp"
 #include "CarlaEngine.hpp"
 
-#include "CarlaLv2Utils.hpp"
+#include "CarlaLv2CacheUtils.hpp"
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBase64Utils.hpp"
@@ -40,6 +40,7 @@ extern "C" {
 #endif
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using water::File;
@@ -55,7 +56,6 @@ CARLA_BACKEND_START_NAMESPACE
 
 static const CustomData       kCustomDataFallback       = { nullptr, nullptr, nullptr };
 static /* */ CustomData       kCustomDataFallbackNC     = { nullptr, nullptr, nullptr };
-static const ExternalMidiNote kExternalMidiNoteFallback = { -1, 0, 0 };
 static const char* const      kUnmapFallback            = "urn:null";
 
 // -------------------------------------------------------------------------------------------------------------------
@@ -148,6 +148,81 @@ enum CarlaLv2URIDs {
     kUridCount
 };
 
+// URIs of the fixed URIDs above, in the same order
+static const char* const kUridStrings[kUridCount] = {
+    kUnmapFallback,
+    LV2_ATOM__Blank,
+    LV2_ATOM__Bool,
+    LV2_ATOM__Chunk,
+    LV2_ATOM__Double,
+    LV2_ATOM__Event,
+    LV2_ATOM__Float,
+    LV2_ATOM__Int,
+    LV2_ATOM__Literal,
+    LV2_ATOM__Long,
+    LV2_ATOM__Number,
+    LV2_ATOM__Object,
+    LV2_ATOM__Path,
+    LV2_ATOM__Property,
+    LV2_ATOM__Resource,
+    LV2_ATOM__Sequence,
+    LV2_ATOM__Sound,
+    LV2_ATOM__String,
+    LV2_ATOM__Tuple,
+    LV2_ATOM__URI,
+    LV2_ATOM__URID,
+    LV2_ATOM__Vector,
+    LV2_ATOM__atomTransfer,
+    LV2_ATOM__eventTransfer,
+    LV2_BUF_SIZE__maxBlockLength,
+    LV2_BUF_SIZE__minBlockLength,
+    LV2_BUF_SIZE__nominalBlockLength,
+    LV2_BUF_SIZE__sequenceSize,
+    LV2_LOG__Error,
+    LV2_LOG__Note,
+    LV2_LOG__Trace,
+    LV2_LOG__Warning,
+    LV2_PATCH__Set,
+    LV2_PATCH__property,
+    LV2_PATCH__subject,
+    LV2_PATCH__value,
+    LV2_TIME__Position,
+    LV2_TIME__bar,
+    LV2_TIME__barBeat,
+    LV2_TIME__beat,
+    LV2_TIME__beatUnit,
+    LV2_TIME__beatsPerBar,
+    LV2_TIME__beatsPerMinute,
+    LV2_TIME__frame,
+    LV2_TIME__framesPerSecond,
+    LV2_TIME__speed,
+    LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat,
+    LV2_MIDI__MidiEvent,
+    LV2_PARAMETERS__sampleRate,
+    LV2_UI__backgroundColor,
+    LV2_UI__foregroundColor,
+#ifndef CARLA_OS_MAC
+    LV2_UI__scaleFactor,
+#endif
+    LV2_UI__windowTitle,
+    URI_CARLA_ATOM_WORKER_IN,
+    URI_CARLA_ATOM_WORKER_RESP,
+    URI_CARLA_PARAMETER_CHANGE,
+    LV2_KXSTUDIO_PROPERTIES__TransientWindowId,
+};
+
+// get the fixed URID of @a uri, or kUridNull if it is not one of them. does not lock or allocate
+static LV2_URID findFixedURID(const char* const uri) noexcept
+{
+    for (uint32_t i=kUridNull+1; i < kUridCount; ++i)
+    {
+        if (std::strcmp(kUridStrings[i], uri) == 0)
+            return static_cast<LV2_URID>(i);
+    }
+
+    return kUridNull;
+}
+
 // LV2 Feature Ids
 enum CarlaLv2Features {
     // DSP features
@@ -204,6 +279,85 @@ enum CarlaLv2StateFeatures {
     kStateFeatureCountAll
 };
 
+// -------------------------------------------------------------------------------------------------------------------
+// Process-wide table of URIs mapped by LV2 plugins.
+//
+// Each URI is stored once and gets a process-wide index, the fixed URIDs above use their own value as index.
+// Plugin instances keep their own URID numbering, which must stay dense for UI bridges,
+// translating between both through small index arrays.
+
+class CarlaLv2URIDTable
+{
+public:
+    static constexpr const uint32_t kInvalidIndex = UINT32_MAX;
+
+    static CarlaLv2URIDTable& getInstance()
+    {
+        static CarlaLv2URIDTable table;
+        return table;
+    }
+
+    /*
+     * Get the index of @a uri, adding it to the table if needed.
+     * @a storedURI is set to the table copy of the URI, valid for the lifetime of the process.
+     */
+    uint32_t add(const char* const uri, const char*& storedURI)
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        const std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> ret(
+            fIndexes.insert(std::make_pair(std::string(uri), static_cast<uint32_t>(fURIs.size()))));
+
+        // map keys do not move, even on rehash
+        if (ret.second)
+            fURIs.push_back(ret.first->first.c_str());
+
+        storedURI = fURIs[ret.first->second];
+        return ret.first->second;
+    }
+
+    /*
+     * Get the index of @a uri, or kInvalidIndex if not in the table.
+     */
+    uint32_t find(const char* const uri) const noexcept
+    {
+        const CarlaMutexLocker cml(fMutex);
+
+        try {
+            const std::unordered_map<std::string, uint32_t>::const_iterator it(fIndexes.find(uri));
+            return it != fIndexes.end() ? it->second : kInvalidIndex;
+        } CARLA_SAFE_EXCEPTION_RETURN("CarlaLv2URIDTable::find", kInvalidIndex);
+    }
+
+private:
+    mutable CarlaMutex fMutex;
+    std::unordered_map<std::string, uint32_t> fIndexes;
+    std::vector<const char*> fURIs;
+
+    CarlaLv2URIDTable()
+        : fMutex(),
+          fIndexes(),
+          fURIs()
+    {
+        fIndexes.reserve(kUridCount * 4);
+        fURIs.reserve(kUridCount * 4);
+
+        // null URID is never mapped, keep a dummy entry for it
+        fURIs.push_back(kUnmapFallback);
+
+        for (uint32_t i=1; i<kUridCount; ++i)
+        {
+            const std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> ret(
+                fIndexes.insert(std::make_pair(std::string(kUridStrings[i]), i)));
+            CARLA_SAFE_ASSERT(ret.second);
+
+            fURIs.push_back(ret.first->first.c_str());
+        }
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaLv2URIDTable)
+};
+
 // -------------------------------------------------------------------------------------------------------------------
 
 struct Lv2EventData {
@@ -520,7 +674,10 @@ public:
           fFilename(),
           fPluginURI(),
           fUiURI(),
-          fUiState(UiNone) {}
+          fUiState(UiNone)
+    {
+        setBinaryFramingAllowed(true);
+    }
 
     ~CarlaPipeServerLV2() noexcept override
     {
@@ -577,6 +734,7 @@ public:
 protected:
     // returns true if msg was handled
     bool msgReceived(const char* const msg) noexcept override;
+    bool recordReceived(uint32_t type, const void* data, uint32_t size) noexcept override;
 
 private:
     CarlaEngine*    const kEngine;
@@ -669,7 +827,12 @@ public:
 #ifndef LV2_UIS_ONLY_INPROCESS
           fPipeServer(engine, this),
 #endif
-          fCustomURIDs(kUridCount, std::string("urn:null")),
+          fCustomURIDs(kUridStrings, kUridStrings + kUridCount),
+          fCustomURIDsByIndex(),
+          fCustomURIDsMutex(),
+          fUridStateChanged(kUridNull),
+          fParameterIndexForURID(),
+          fParameterURIDs(),
           fFirstActive(true),
           fLastStateChunk(nullptr),
           fLastTimeInfo(),
@@ -1538,7 +1701,7 @@ public:
             lv2_atom_forge_bool(&atomForge, true);
 
             lv2_atom_forge_key(&atomForge, kUridPatchProperty);
-            lv2_atom_forge_urid(&atomForge, getCustomURID(fRdfDescriptor->Parameters[rparamId].URI));
+            lv2_atom_forge_urid(&atomForge, fParameterURIDs[rparamId]);
 
             lv2_atom_forge_key(&atomForge, kUridPatchValue);
 
@@ -1699,8 +1862,7 @@ public:
         {
             const LV2_URID_Map* const uridMap = (const LV2_URID_Map*)fFeatures[kFeatureIdUridMap]->data;
 
-            LilvState* const state = Lv2WorldClass::getInstance().getStateFromURI(fRdfDescriptor->Presets[index].URI,
-                                                                                  uridMap);
+            LilvState* const state = getLv2World().getStateFromURI(fRdfDescriptor->Presets[index].URI, uridMap);
             CARLA_SAFE_ASSERT_RETURN(state != nullptr,);
 
             // invalidate midi-program selection
@@ -1846,26 +2008,27 @@ public:
                     const CarlaScopedLocale csl;
 
                     // write URI mappings
-                    uint32_t u = 0;
-                    for (std::vector<std::string>::iterator it=fCustomURIDs.begin(), end=fCustomURIDs.end(); it != end; ++it, ++u)
                     {
-                        if (u < kUridCount)
-                            continue;
-                        const std::string& uri(*it);
+                        const CarlaMutexLocker cml2(fCustomURIDsMutex);
 
-                        if (! fPipeServer.writeMessage("urid\n", 5))
-                            return;
+                        for (uint32_t u=kUridCount, count=static_cast<uint32_t>(fCustomURIDs.size()); u < count; ++u)
+                        {
+                            const char* const uri = fCustomURIDs[u];
 
-                        std::snprintf(tmpBuf, 0xfe, "%u\n", u);
-                        if (! fPipeServer.writeMessage(tmpBuf))
-                            return;
+                            if (! fPipeServer.writeMessage("urid\n", 5))
+                                return;
 
-                        std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(uri.length()));
-                        if (! fPipeServer.writeMessage(tmpBuf))
-                            return;
+                            std::snprintf(tmpBuf, 0xfe, "%u\n", u);
+                            if (! fPipeServer.writeMessage(tmpBuf))
+                                return;
+
+                            std::snprintf(tmpBuf, 0xfe, "%lu\n", static_cast<long unsigned>(std::strlen(uri)));
+                            if (! fPipeServer.writeMessage(tmpBuf))
+                                return;
 
-                        if (! fPipeServer.writeAndFixMessage(uri.c_str()))
-                            return;
+                            if (! fPipeServer.writeAndFixMessage(uri))
+                                return;
+                        }
                     }
 
                     // write UI options
@@ -2319,6 +2482,12 @@ public:
         }
 
         CarlaPlugin::uiIdle();
+
+#ifndef LV2_UIS_ONLY_INPROCESS
+        // send parameter changes queued during this idle in a single batch
+        if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
+            fPipeServer.flushControlMessages();
+#endif
     }
 
     // -------------------------------------------------------------------
@@ -3086,6 +3255,10 @@ public:
             }
         }
 
+        // map parameter URIs now, so that patch messages resolve them without string lookups
+        fParameterIndexForURID.clear();
+        fParameterURIDs.assign(fRdfDescriptor->ParameterCount, kUridNull);
+
         for (uint32_t i=0; i < fRdfDescriptor->ParameterCount; ++i)
         {
             const LV2_RDF_Parameter& rdfParam(fRdfDescriptor->Parameters[i]);
@@ -3108,6 +3281,17 @@ public:
             pData->param.data[j].index  = static_cast<int32_t>(j);
             pData->param.data[j].rindex = static_cast<int32_t>(fRdfDescriptor->PortCount + i);
 
+            const LV2_URID urid = getCustomURID(rdfParam.URI);
+            fParameterURIDs[i] = urid;
+
+            if (urid != kUridNull)
+            {
+                if (urid >= fParameterIndexForURID.size())
+                    fParameterIndexForURID.resize(urid + 1, UINT32_MAX);
+
+                fParameterIndexForURID[urid] = j;
+            }
+
             float min, max, def, step, stepSmall, stepLarge;
 
             // min value
@@ -3512,8 +3696,8 @@ public:
             else if (fHasLoadDefaultState)
             {
                 // load default state
-                if (LilvState* const state = Lv2WorldClass::getInstance().getStateFromURI(fDescriptor->URI,
-                                                                                          (const LV2_URID_Map*)fFeatures[kFeatureIdUridMap]->data))
+                if (LilvState* const state = getLv2World().getStateFromURI(fDescriptor->URI,
+                                                                           (const LV2_URID_Map*)fFeatures[kFeatureIdUridMap]->data))
                 {
                     lilv_state_restore(state, fExt.state, fHandle, carla_lilv_set_port_value, this, 0, fFeatures);
 
@@ -3897,8 +4081,6 @@ public:
                 //lv2_atom_buffer_write(&fEventsIn.iters[i].atom, 0, 0, atom->type, atom->size, LV2_ATOM_BODY_CONST(atom));
             }
 
-            pData->postRtEvents.trySplice();
-
             fLastTimeInfo = timeInfo;
         }
 
@@ -3938,20 +4120,19 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
                 if ((fEventsIn.ctrl->type & CARLA_EVENT_TYPE_MIDI) == 0)
                 {
                     // does not handle MIDI
-                    pData->extNotes.data.clear();
+                    pData->extNotes.data.flush();
                 }
                 else
                 {
                     const uint32_t j = fEventsIn.ctrlIndex;
 
-                    for (RtLinkedList<ExternalMidiNote>::Itenerator it = pData->extNotes.data.begin2(); it.valid(); it.next())
+                    for (ExternalMidiNote note; pData->extNotes.data.tryPop(note);)
                     {
-                        const ExternalMidiNote& note(it.getValue(kExternalMidiNoteFallback));
                         CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                         uint8_t midiEvent[3];
@@ -3968,12 +4149,8 @@ public:
                         else if (fEventsIn.ctrl->type & CARLA_EVENT_DATA_MIDI_LL)
                             lv2midi_put_event(&fEventsIn.iters[j].midiState, 0.0, 3, midiEvent);
                     }
-
-                    pData->extNotes.data.clear();
                 }
 
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -3998,6 +4175,8 @@ public:
                 pData->event.cvSourcePorts->initPortBuffers(cvIn + pData->cvIn.count, frames, isSampleAccurate, pData->event.portIn);
 #endif
 
+            pData->subBlock.begin(pData->engine->getOptions().subBlockGranularity, frames);
+
             const uint32_t numEvents = (fEventsIn.ctrl->port != nullptr) ? fEventsIn.ctrl->port->getEventCount() : 0;
 
             for (uint32_t i=0; i < numEvents; ++i)
@@ -4014,12 +4193,15 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                const uint32_t splitTime = isSampleAccurate ? pData->subBlock.getSplitTime(eventTime, timeOffset)
+                                                            : timeOffset;
+
+                if (splitTime > timeOffset)
                 {
-                    if (processSingle(audioIn, audioOut, cvIn, cvOut, eventTime - timeOffset, timeOffset))
+                    if (processSingle(audioIn, audioOut, cvIn, cvOut, splitTime - timeOffset, timeOffset))
                     {
                         startTime  = 0;
-                        timeOffset = eventTime;
+                        timeOffset = splitTime;
 
                         if (pData->midiprog.current >= 0 && pData->midiprog.count > 0)
                             nextBankId = pData->midiprog.data[pData->midiprog.current].bank;
@@ -4042,7 +4224,7 @@ public:
                             {
                                 fEventsIn.data[j].midi.event_count = 0;
                                 fEventsIn.data[j].midi.size        = 0;
-                                fEventsIn.iters[j].midiState.position = eventTime;
+                                fEventsIn.iters[j].midiState.position = splitTime;
                             }
                         }
 
@@ -4169,7 +4351,7 @@ public:
                             midiData[1] = uint8_t(ctrlEvent.param);
                             midiData[2] = uint8_t(ctrlEvent.normalizedValue*127.0f + 0.5f);
 
-                            const uint32_t mtime(isSampleAccurate ? startTime : eventTime);
+                            const uint32_t mtime(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
 
                             if (fEventsIn.ctrl->type & CARLA_EVENT_DATA_ATOM)
                                 lv2_atom_buffer_write(&fEventsIn.iters[fEventsIn.ctrlIndex].atom, mtime, 0, kUridMidiEvent, 3, midiData);
@@ -4201,7 +4383,7 @@ public:
                             midiData[1] = MIDI_CONTROL_BANK_SELECT;
                             midiData[2] = uint8_t(ctrlEvent.param);
 
-                            const uint32_t mtime(isSampleAccurate ? startTime : eventTime);
+                            const uint32_t mtime(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
 
                             if (fEventsIn.ctrl->type & CARLA_EVENT_DATA_ATOM)
                                 lv2_atom_buffer_write(&fEventsIn.iters[fEventsIn.ctrlIndex].atom, mtime, 0, kUridMidiEvent, 3, midiData);
@@ -4237,7 +4419,7 @@ public:
                             midiData[0] = uint8_t(MIDI_STATUS_PROGRAM_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             midiData[1] = uint8_t(ctrlEvent.param);
 
-                            const uint32_t mtime(isSampleAccurate ? startTime : eventTime);
+                            const uint32_t mtime(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
 
                             if (fEventsIn.ctrl->type & CARLA_EVENT_DATA_ATOM)
                                 lv2_atom_buffer_write(&fEventsIn.iters[fEventsIn.ctrlIndex].atom, mtime, 0, kUridMidiEvent, 2, midiData);
@@ -4253,7 +4435,7 @@ public:
                     case kEngineControlEventTypeAllSoundOff:
                         if (pData->options & PLUGIN_OPTION_SEND_ALL_SOUND_OFF)
                         {
-                            const uint32_t mtime(isSampleAccurate ? startTime : eventTime);
+                            const uint32_t mtime(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
 
                             uint8_t midiData[3];
                             midiData[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
@@ -4282,7 +4464,7 @@ public:
                             }
 #endif
 
-                            const uint32_t mtime(isSampleAccurate ? startTime : eventTime);
+                            const uint32_t mtime(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
 
                             uint8_t midiData[3];
                             midiData[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
@@ -4326,7 +4508,7 @@ public:
                         status = MIDI_STATUS_NOTE_OFF;
 
                     const uint32_t j     = fEventsIn.ctrlIndex;
-                    const uint32_t mtime = isSampleAccurate ? startTime : eventTime;
+                    const uint32_t mtime = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
 
                     // put back channel in data
                     uint8_t midiData2[4]; // FIXME
@@ -4358,8 +4540,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
 
@@ -4474,9 +4654,13 @@ public:
                             evData.port->writeMidiEvent(currentFrame, static_cast<uint8_t>(ev->body.size), data);
                         }
                     }
-                    else if (fAtomBufferUiOutTmpData != nullptr)
+                    else
                     {
-                        fAtomBufferUiOut.put(&ev->body, evData.rindex);
+                        if (isStateChangeAtom(&ev->body))
+                            setStateChanged();
+
+                        if (fAtomBufferUiOutTmpData != nullptr)
+                            fAtomBufferUiOut.put(&ev->body, evData.rindex);
                     }
 
                     lv2_atom_buffer_increment(&iter);
@@ -4640,8 +4824,6 @@ public:
             }
         }
 
-        pData->postRtEvents.trySplice();
-
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
         // --------------------------------------------------------------------------------------------------------
         // Post-processing (dry/wet, volume and balance)
@@ -4905,7 +5087,7 @@ public:
                 continue;
 
             fParamBuffers[k] = sampleRatef;
-            pData->postponeParameterChangeRtEvent(true, static_cast<int32_t>(k), fParamBuffers[k]);
+            pData->postponeParameterChangeNonRtEvent(true, static_cast<int32_t>(k), fParamBuffers[k]);
             break;
         }
 
@@ -4919,7 +5101,7 @@ public:
             if (pData->param.data[k].type == PARAMETER_INPUT && pData->param.special[k] == PARAMETER_SPECIAL_FREEWHEEL)
             {
                 fParamBuffers[k] = isOffline ? pData->param.ranges[k].max : pData->param.ranges[k].min;
-                pData->postponeParameterChangeRtEvent(true, static_cast<int32_t>(k), fParamBuffers[k]);
+                pData->postponeParameterChangeNonRtEvent(true, static_cast<int32_t>(k), fParamBuffers[k]);
                 break;
             }
         }
@@ -5073,7 +5255,7 @@ public:
                 lv2_atom_forge_bool(&atomForge, true);
 
                 lv2_atom_forge_key(&atomForge, kUridPatchProperty);
-                lv2_atom_forge_urid(&atomForge, getCustomURID(uri));
+                lv2_atom_forge_urid(&atomForge, fParameterURIDs[static_cast<uint32_t>(rindex)]);
 
                 lv2_atom_forge_key(&atomForge, kUridPatchValue);
 
@@ -5574,6 +5756,20 @@ public:
         }
     }
 
+    // patch:Set and state:StateChanged messages change the plugin state without going through us
+    bool isStateChangeAtom(const LV2_Atom* const atom) const noexcept
+    {
+        if (atom->type != kUridAtomBlank && atom->type != kUridAtomObject)
+            return false;
+        if (atom->size < sizeof(LV2_Atom_Object_Body))
+            return false;
+
+        const LV2_Atom_Object_Body* const objbody = (const LV2_Atom_Object_Body*)(atom + 1);
+
+        return objbody->otype == kUridPatchSet
+            || (objbody->otype == fUridStateChanged && fUridStateChanged != kUridNull);
+    }
+
     void inspectAtomForParameterChange(const LV2_Atom* const atom)
     {
         if (atom->type != kUridAtomBlank && atom->type != kUridAtomObject)
@@ -5653,83 +5849,28 @@ public:
     {
         parameterId = UINT32_MAX;
 
-        for (uint32_t i=0; i < fRdfDescriptor->ParameterCount; ++i)
-        {
-            const LV2_RDF_Parameter& rdfParam(fRdfDescriptor->Parameters[i]);
+        const LV2_URID urid = findCustomURID(uri);
 
-            switch (rdfParam.Type)
-            {
-            case LV2_PARAMETER_TYPE_BOOL:
-            case LV2_PARAMETER_TYPE_INT:
-            // case LV2_PARAMETER_TYPE_LONG:
-            case LV2_PARAMETER_TYPE_FLOAT:
-            case LV2_PARAMETER_TYPE_DOUBLE:
-                break;
-            default:
-                continue;
-            }
-
-            if (std::strcmp(rdfParam.URI, uri) == 0)
-            {
-                const int32_t rindex = static_cast<int32_t>(fRdfDescriptor->PortCount + i);
-
-                for (uint32_t j=0; j < pData->param.count; ++j)
-                {
-                    if (pData->param.data[j].rindex == rindex)
-                    {
-                        parameterId = j;
-                        break;
-                    }
-                }
-                break;
-            }
-        }
+        if (urid == kUridNull)
+            return false;
 
-        return (parameterId != UINT32_MAX);
+        return getParameterIndexForURID(urid, parameterId);
     }
 
     bool getParameterIndexForURID(const LV2_URID urid, uint32_t& parameterId) noexcept
     {
         parameterId = UINT32_MAX;
 
-        if (urid >= fCustomURIDs.size())
+        if (urid >= fParameterIndexForURID.size())
             return false;
 
-        for (uint32_t i=0; i < fRdfDescriptor->ParameterCount; ++i)
-        {
-            const LV2_RDF_Parameter& rdfParam(fRdfDescriptor->Parameters[i]);
+        const uint32_t index = fParameterIndexForURID[urid];
 
-            switch (rdfParam.Type)
-            {
-            case LV2_PARAMETER_TYPE_BOOL:
-            case LV2_PARAMETER_TYPE_INT:
-            // case LV2_PARAMETER_TYPE_LONG:
-            case LV2_PARAMETER_TYPE_FLOAT:
-            case LV2_PARAMETER_TYPE_DOUBLE:
-                break;
-            default:
-                continue;
-            }
-
-            const std::string& uri(fCustomURIDs[urid]);
-
-            if (uri != rdfParam.URI)
-                continue;
-
-            const int32_t rindex = static_cast<int32_t>(fRdfDescriptor->PortCount + i);
-
-              for (uint32_t j=0; j < pData->param.count; ++j)
-              {
-                  if (pData->param.data[j].rindex == rindex)
-                  {
-                      parameterId = j;
-                      break;
-                  }
-              }
-              break;
-        }
+        if (index >= pData->param.count)
+            return false;
 
-        return (parameterId != UINT32_MAX);
+        parameterId = index;
+        return true;
     }
 
     // -------------------------------------------------------------------
@@ -5739,21 +5880,30 @@ public:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("CarlaPluginLV2::getCustomURID(\"%s\")", uri);
 
-        const std::string    s_uri(uri);
-        const std::ptrdiff_t s_pos(std::find(fCustomURIDs.begin(), fCustomURIDs.end(), s_uri) - fCustomURIDs.begin());
+        // fixed URIDs, the same for all instances
+        if (const LV2_URID urid = findFixedURID(uri))
+            return urid;
 
-        if (s_pos <= 0 || s_pos >= INT32_MAX)
-            return kUridNull;
+        const char* storedURI;
+        const uint32_t index = CarlaLv2URIDTable::getInstance().add(uri, storedURI);
+        CARLA_SAFE_ASSERT_RETURN(index >= kUridCount, static_cast<LV2_URID>(index));
 
-        const LV2_URID urid     = static_cast<LV2_URID>(s_pos);
-        const LV2_URID uriCount = static_cast<LV2_URID>(fCustomURIDs.size());
+        LV2_URID urid;
 
-        if (urid < uriCount)
-            return urid;
+        {
+            const CarlaMutexLocker cml(fCustomURIDsMutex);
+
+            if (index < fCustomURIDsByIndex.size() && fCustomURIDsByIndex[index] != kUridNull)
+                return fCustomURIDsByIndex[index];
 
-        CARLA_SAFE_ASSERT(urid == uriCount);
+            urid = static_cast<LV2_URID>(fCustomURIDs.size());
+            fCustomURIDs.push_back(storedURI);
 
-        fCustomURIDs.push_back(uri);
+            if (index >= fCustomURIDsByIndex.size())
+                fCustomURIDsByIndex.resize(index + 1, kUridNull);
+
+            fCustomURIDsByIndex[index] = urid;
+        }
 
 #ifndef LV2_UIS_ONLY_INPROCESS
         if (fUI.type == UI::TYPE_BRIDGE && fPipeServer.isPipeRunning())
@@ -5763,13 +5913,37 @@ public:
         return urid;
     }
 
+    // same as getCustomURID, but without mapping new URIs
+    LV2_URID findCustomURID(const char* const uri) const noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
+
+        if (const LV2_URID urid = findFixedURID(uri))
+            return urid;
+
+        const uint32_t index = CarlaLv2URIDTable::getInstance().find(uri);
+
+        if (index == CarlaLv2URIDTable::kInvalidIndex)
+            return kUridNull;
+
+        const CarlaMutexLocker cml(fCustomURIDsMutex);
+
+        return index < fCustomURIDsByIndex.size() ? fCustomURIDsByIndex[index] : static_cast<LV2_URID>(kUridNull);
+    }
+
     const char* getCustomURIDString(const LV2_URID urid) const noexcept
     {
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, kUnmapFallback);
-        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.size(), kUnmapFallback);
         carla_debug("CarlaPluginLV2::getCustomURIString(%i)", urid);
 
-        return fCustomURIDs[urid].c_str();
+        // fixed URIDs, the same for all instances
+        if (urid < kUridCount)
+            return kUridStrings[urid];
+
+        const CarlaMutexLocker cml(fCustomURIDsMutex);
+        CARLA_SAFE_ASSERT_RETURN(urid < fCustomURIDs.size(), kUnmapFallback);
+
+        return fCustomURIDs[urid];
     }
 
     // -------------------------------------------------------------------
@@ -6370,6 +6544,9 @@ public:
                 index = fEventsIn.ctrlIndex;
             }
 
+            if (isStateChangeAtom(atom))
+                setStateChanged();
+
             fAtomBufferEvIn.put(atom, index);
         } break;
 
@@ -6500,21 +6677,9 @@ public:
         const EngineOptions& opts(pData->engine->getOptions());
 
         // ---------------------------------------------------------------
-        // Init LV2 World if needed, sets LV2_PATH for lilv
+        // get plugin from lv2_rdf (cache, or lilv if the cache is stale)
 
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-
-        if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
-            lv2World.initIfNeeded(opts.pathLV2);
-        else if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
-            lv2World.initIfNeeded(LV2_PATH);
-        else
-            lv2World.initIfNeeded(LILV_DEFAULT_LV2_PATH);
-
-        // ---------------------------------------------------------------
-        // get plugin from lv2_rdf (lilv)
-
-        fRdfDescriptor = lv2_rdf_new(uri, true);
+        fRdfDescriptor = lv2_rdf_new_cached(getLv2Path(), uri, true);
 
         if (fRdfDescriptor == nullptr)
         {
@@ -6917,6 +7082,8 @@ public:
         // ---------------------------------------------------------------
         // initialize plugin
 
+        fUridStateChanged = getCustomURID(LV2_STATE__StateChanged);
+
         try {
             fHandle = fDescriptor->instantiate(fDescriptor, pData->engine->getSampleRate(), fRdfDescriptor->Bundle, fFeatures);
         } catch(...) {}
@@ -7467,6 +7634,9 @@ public:
         CARLA_SAFE_ASSERT_RETURN(atom != nullptr,);
         carla_debug("CarlaPluginLV2::handleTransferAtom(%i, %p)", portIndex, atom);
 
+        if (isStateChangeAtom(atom))
+            setStateChanged();
+
         fAtomBufferEvIn.put(atom, portIndex);
     }
 
@@ -7474,14 +7644,17 @@ public:
     {
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull,);
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0',);
-        carla_debug("CarlaPluginLV2::handleUridMap(%i v " P_SIZE ", \"%s\")", urid, fCustomURIDs.size()-1, uri);
+        carla_debug("CarlaPluginLV2::handleUridMap(%i, \"%s\")", urid, uri);
+
+        const char* storedURI;
+        const uint32_t index = CarlaLv2URIDTable::getInstance().add(uri, storedURI);
 
+        const CarlaMutexLocker cml(fCustomURIDsMutex);
         const std::size_t uriCount(fCustomURIDs.size());
 
         if (urid < uriCount)
         {
-            const char* const ourURI(carla_lv2_urid_unmap(this, urid));
-            CARLA_SAFE_ASSERT_RETURN(ourURI != nullptr && ourURI != kUnmapFallback,);
+            const char* const ourURI(fCustomURIDs[urid]);
 
             if (std::strcmp(ourURI, uri) != 0)
             {
@@ -7491,7 +7664,13 @@ public:
         else
         {
             CARLA_SAFE_ASSERT_RETURN(urid == uriCount,);
-            fCustomURIDs.push_back(uri);
+            fCustomURIDs.push_back(storedURI);
+
+            if (index >= fCustomURIDsByIndex.size())
+                fCustomURIDsByIndex.resize(index + 1, kUridNull);
+
+            if (fCustomURIDsByIndex[index] == kUridNull)
+                fCustomURIDsByIndex[index] = urid;
         }
     }
 
@@ -7565,7 +7744,18 @@ private:
     CarlaPipeServerLV2      fPipeServer;
 #endif
 
-    std::vector<std::string> fCustomURIDs;
+    // URIs mapped by this instance, indexed by URID, stored in CarlaLv2URIDTable
+    std::vector<const char*> fCustomURIDs;
+    // CarlaLv2URIDTable index to URID of this instance, null if not mapped yet
+    std::vector<LV2_URID> fCustomURIDsByIndex;
+    mutable CarlaMutex fCustomURIDsMutex;
+
+    // mapped on init, see isStateChangeAtom()
+    LV2_URID fUridStateChanged;
+
+    // parameter index of each URID, or UINT32_MAX; URID of each LV2 parameter (not port). set on reload
+    std::vector<uint32_t> fParameterIndexForURID;
+    std::vector<LV2_URID> fParameterURIDs;
 
     bool fFirstActive; // first process() call after activate()
     void* fLastStateChunk;
@@ -7881,135 +8071,7 @@ private:
         CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', kUridNull);
         carla_debug("carla_lv2_urid_map(%p, \"%s\")", handle, uri);
 
-        // Atom types
-        if (std::strcmp(uri, LV2_ATOM__Blank) == 0)
-            return kUridAtomBlank;
-        if (std::strcmp(uri, LV2_ATOM__Bool) == 0)
-            return kUridAtomBool;
-        if (std::strcmp(uri, LV2_ATOM__Chunk) == 0)
-            return kUridAtomChunk;
-        if (std::strcmp(uri, LV2_ATOM__Double) == 0)
-            return kUridAtomDouble;
-        if (std::strcmp(uri, LV2_ATOM__Event) == 0)
-            return kUridAtomEvent;
-        if (std::strcmp(uri, LV2_ATOM__Float) == 0)
-            return kUridAtomFloat;
-        if (std::strcmp(uri, LV2_ATOM__Int) == 0)
-            return kUridAtomInt;
-        if (std::strcmp(uri, LV2_ATOM__Literal) == 0)
-            return kUridAtomLiteral;
-        if (std::strcmp(uri, LV2_ATOM__Long) == 0)
-            return kUridAtomLong;
-        if (std::strcmp(uri, LV2_ATOM__Number) == 0)
-            return kUridAtomNumber;
-        if (std::strcmp(uri, LV2_ATOM__Object) == 0)
-            return kUridAtomObject;
-        if (std::strcmp(uri, LV2_ATOM__Path) == 0)
-            return kUridAtomPath;
-        if (std::strcmp(uri, LV2_ATOM__Property) == 0)
-            return kUridAtomProperty;
-        if (std::strcmp(uri, LV2_ATOM__Resource) == 0)
-            return kUridAtomResource;
-        if (std::strcmp(uri, LV2_ATOM__Sequence) == 0)
-            return kUridAtomSequence;
-        if (std::strcmp(uri, LV2_ATOM__Sound) == 0)
-            return kUridAtomSound;
-        if (std::strcmp(uri, LV2_ATOM__String) == 0)
-            return kUridAtomString;
-        if (std::strcmp(uri, LV2_ATOM__Tuple) == 0)
-            return kUridAtomTuple;
-        if (std::strcmp(uri, LV2_ATOM__URI) == 0)
-            return kUridAtomURI;
-        if (std::strcmp(uri, LV2_ATOM__URID) == 0)
-            return kUridAtomURID;
-        if (std::strcmp(uri, LV2_ATOM__Vector) == 0)
-            return kUridAtomVector;
-        if (std::strcmp(uri, LV2_ATOM__atomTransfer) == 0)
-            return kUridAtomTransferAtom;
-        if (std::strcmp(uri, LV2_ATOM__eventTransfer) == 0)
-            return kUridAtomTransferEvent;
-
-        // BufSize types
-        if (std::strcmp(uri, LV2_BUF_SIZE__maxBlockLength) == 0)
-            return kUridBufMaxLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__minBlockLength) == 0)
-            return kUridBufMinLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__nominalBlockLength) == 0)
-            return kUridBufNominalLength;
-        if (std::strcmp(uri, LV2_BUF_SIZE__sequenceSize) == 0)
-            return kUridBufSequenceSize;
-
-        // Log types
-        if (std::strcmp(uri, LV2_LOG__Error) == 0)
-            return kUridLogError;
-        if (std::strcmp(uri, LV2_LOG__Note) == 0)
-            return kUridLogNote;
-        if (std::strcmp(uri, LV2_LOG__Trace) == 0)
-            return kUridLogTrace;
-        if (std::strcmp(uri, LV2_LOG__Warning) == 0)
-            return kUridLogWarning;
-
-        // Patch types
-        if (std::strcmp(uri, LV2_PATCH__Set) == 0)
-            return kUridPatchSet;
-        if (std::strcmp(uri, LV2_PATCH__property) == 0)
-            return kUridPatchProperty;
-        if (std::strcmp(uri, LV2_PATCH__subject) == 0)
-            return kUridPatchSubject;
-        if (std::strcmp(uri, LV2_PATCH__value) == 0)
-            return kUridPatchValue;
-
-        // Time types
-        if (std::strcmp(uri, LV2_TIME__Position) == 0)
-            return kUridTimePosition;
-        if (std::strcmp(uri, LV2_TIME__bar) == 0)
-            return kUridTimeBar;
-        if (std::strcmp(uri, LV2_TIME__barBeat) == 0)
-            return kUridTimeBarBeat;
-        if (std::strcmp(uri, LV2_TIME__beat) == 0)
-            return kUridTimeBeat;
-        if (std::strcmp(uri, LV2_TIME__beatUnit) == 0)
-            return kUridTimeBeatUnit;
-        if (std::strcmp(uri, LV2_TIME__beatsPerBar) == 0)
-            return kUridTimeBeatsPerBar;
-        if (std::strcmp(uri, LV2_TIME__beatsPerMinute) == 0)
-            return kUridTimeBeatsPerMinute;
-        if (std::strcmp(uri, LV2_TIME__frame) == 0)
-            return kUridTimeFrame;
-        if (std::strcmp(uri, LV2_TIME__framesPerSecond) == 0)
-            return kUridTimeFramesPerSecond;
-        if (std::strcmp(uri, LV2_TIME__speed) == 0)
-            return kUridTimeSpeed;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat) == 0)
-            return kUridTimeTicksPerBeat;
-
-        // Others
-        if (std::strcmp(uri, LV2_MIDI__MidiEvent) == 0)
-            return kUridMidiEvent;
-        if (std::strcmp(uri, LV2_PARAMETERS__sampleRate) == 0)
-            return kUridParamSampleRate;
-        if (std::strcmp(uri, LV2_UI__backgroundColor) == 0)
-            return kUridBackgroundColor;
-        if (std::strcmp(uri, LV2_UI__foregroundColor) == 0)
-            return kUridForegroundColor;
-#ifndef CARLA_OS_MAC
-        if (std::strcmp(uri, LV2_UI__scaleFactor) == 0)
-            return kUridScaleFactor;
-#endif
-        if (std::strcmp(uri, LV2_UI__windowTitle) == 0)
-            return kUridWindowTitle;
-
-        // Custom Carla types
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_IN) == 0)
-            return kUridCarlaAtomWorkerIn;
-        if (std::strcmp(uri, URI_CARLA_ATOM_WORKER_RESP) == 0)
-            return kUridCarlaAtomWorkerResp;
-        if (std::strcmp(uri, URI_CARLA_PARAMETER_CHANGE) == 0)
-            return kUridCarlaParameterChange;
-        if (std::strcmp(uri, LV2_KXSTUDIO_PROPERTIES__TransientWindowId) == 0)
-            return kUridCarlaTransientWindowId;
-
-        // Custom plugin types
+        // fixed URIDs are resolved without locking, custom ones go through the process-wide table
         return ((CarlaPluginLV2*)handle)->getCustomURID(uri);
     }
 
@@ -8019,136 +8081,9 @@ private:
         CARLA_SAFE_ASSERT_RETURN(urid != kUridNull, nullptr);
         carla_debug("carla_lv2_urid_unmap(%p, %i)", handle, urid);
 
-        switch (urid)
-        {
-        // Atom types
-        case kUridAtomBlank:
-            return LV2_ATOM__Blank;
-        case kUridAtomBool:
-            return LV2_ATOM__Bool;
-        case kUridAtomChunk:
-            return LV2_ATOM__Chunk;
-        case kUridAtomDouble:
-            return LV2_ATOM__Double;
-        case kUridAtomEvent:
-            return LV2_ATOM__Event;
-        case kUridAtomFloat:
-            return LV2_ATOM__Float;
-        case kUridAtomInt:
-            return LV2_ATOM__Int;
-        case kUridAtomLiteral:
-            return LV2_ATOM__Literal;
-        case kUridAtomLong:
-            return LV2_ATOM__Long;
-        case kUridAtomNumber:
-            return LV2_ATOM__Number;
-        case kUridAtomObject:
-            return LV2_ATOM__Object;
-        case kUridAtomPath:
-            return LV2_ATOM__Path;
-        case kUridAtomProperty:
-            return LV2_ATOM__Property;
-        case kUridAtomResource:
-            return LV2_ATOM__Resource;
-        case kUridAtomSequence:
-            return LV2_ATOM__Sequence;
-        case kUridAtomSound:
-            return LV2_ATOM__Sound;
-        case kUridAtomString:
-            return LV2_ATOM__String;
-        case kUridAtomTuple:
-            return LV2_ATOM__Tuple;
-        case kUridAtomURI:
-            return LV2_ATOM__URI;
-        case kUridAtomURID:
-            return LV2_ATOM__URID;
-        case kUridAtomVector:
-            return LV2_ATOM__Vector;
-        case kUridAtomTransferAtom:
-            return LV2_ATOM__atomTransfer;
-        case kUridAtomTransferEvent:
-            return LV2_ATOM__eventTransfer;
-
-        // BufSize types
-        case kUridBufMaxLength:
-            return LV2_BUF_SIZE__maxBlockLength;
-        case kUridBufMinLength:
-            return LV2_BUF_SIZE__minBlockLength;
-        case kUridBufNominalLength:
-            return LV2_BUF_SIZE__nominalBlockLength;
-        case kUridBufSequenceSize:
-            return LV2_BUF_SIZE__sequenceSize;
-
-        // Log types
-        case kUridLogError:
-            return LV2_LOG__Error;
-        case kUridLogNote:
-            return LV2_LOG__Note;
-        case kUridLogTrace:
-            return LV2_LOG__Trace;
-        case kUridLogWarning:
-            return LV2_LOG__Warning;
-
-        // Patch types
-        case kUridPatchSet:
-            return LV2_PATCH__Set;
-        case kUridPatchProperty:
-            return LV2_PATCH__property;
-        case kUridPatchSubject:
-            return LV2_PATCH__subject;
-        case kUridPatchValue:
-            return LV2_PATCH__value;
-
-        // Time types
-        case kUridTimePosition:
-            return LV2_TIME__Position;
-        case kUridTimeBar:
-            return LV2_TIME__bar;
-        case kUridTimeBarBeat:
-            return LV2_TIME__barBeat;
-        case kUridTimeBeat:
-            return LV2_TIME__beat;
-        case kUridTimeBeatUnit:
-            return LV2_TIME__beatUnit;
-        case kUridTimeBeatsPerBar:
-            return LV2_TIME__beatsPerBar;
-        case kUridTimeBeatsPerMinute:
-            return LV2_TIME__beatsPerMinute;
-        case kUridTimeFrame:
-            return LV2_TIME__frame;
-        case kUridTimeFramesPerSecond:
-            return LV2_TIME__framesPerSecond;
-        case kUridTimeSpeed:
-            return LV2_TIME__speed;
-        case kUridTimeTicksPerBeat:
-            return LV2_KXSTUDIO_PROPERTIES__TimePositionTicksPerBeat;
-
-        // Others
-        case kUridMidiEvent:
-            return LV2_MIDI__MidiEvent;
-        case kUridParamSampleRate:
-            return LV2_PARAMETERS__sampleRate;
-        case kUridBackgroundColor:
-            return LV2_UI__backgroundColor;
-        case kUridForegroundColor:
-            return LV2_UI__foregroundColor;
-#ifndef CARLA_OS_MAC
-        case kUridScaleFactor:
-            return LV2_UI__scaleFactor;
-#endif
-        case kUridWindowTitle:
-            return LV2_UI__windowTitle;
-
-        // Custom Carla types
-        case kUridCarlaAtomWorkerIn:
-            return URI_CARLA_ATOM_WORKER_IN;
-        case kUridCarlaAtomWorkerResp:
-            return URI_CARLA_ATOM_WORKER_RESP;
-        case kUridCarlaParameterChange:
-            return URI_CARLA_PARAMETER_CHANGE;
-        case kUridCarlaTransientWindowId:
-            return LV2_KXSTUDIO_PROPERTIES__TransientWindowId;
-        }
+        // Fixed types
+        if (urid < kUridCount)
+            return kUridStrings[urid];
 
         // Custom plugin types
         return ((CarlaPluginLV2*)handle)->getCustomURIDString(urid);
@@ -8279,6 +8214,27 @@ private:
     // -------------------------------------------------------------------
     // Lilv State
 
+    const char* getLv2Path() const noexcept
+    {
+        const EngineOptions& opts(pData->engine->getOptions());
+
+        if (opts.pathLV2 != nullptr && opts.pathLV2[0] != '\0')
+            return opts.pathLV2;
+
+        if (const char* const LV2_PATH = std::getenv("LV2_PATH"))
+            return LV2_PATH;
+
+        return LILV_DEFAULT_LV2_PATH;
+    }
+
+    // plugin data usually comes from the LV2 cache, the lilv world is only loaded when states need it
+    Lv2WorldClass& getLv2World() const
+    {
+        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+        lv2World.initIfNeeded(getLv2Path());
+        return lv2World;
+    }
+
     static void carla_lilv_set_port_value(const char* port_symbol, void* user_data, const void* value, uint32_t size, uint32_t type)
     {
         CARLA_SAFE_ASSERT_RETURN(user_data != nullptr,);
@@ -8425,6 +8381,44 @@ bool CarlaPipeServerLV2::msgReceived(const char* const msg) noexcept
 
     return false;
 }
+
+bool CarlaPipeServerLV2::recordReceived(const uint32_t type, const void* const data, const uint32_t size) noexcept
+{
+    switch (type)
+    {
+    case kCarlaPipeRecordControls: {
+        const CarlaPipeControlValue* const values = static_cast<const CarlaPipeControlValue*>(data);
+        const uint32_t count = size / sizeof(CarlaPipeControlValue);
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            float value = values[i].value;
+
+            try {
+                kPlugin->handleUIWrite(values[i].index, sizeof(float), kUridNull, &value);
+            } CARLA_SAFE_EXCEPTION("recordReceived controls");
+        }
+
+        return true;
+    }
+
+    case kCarlaPipeRecordAtom: {
+        CARLA_SAFE_ASSERT_UINT2_RETURN(size >= sizeof(uint32_t)*2 + sizeof(LV2_Atom), size, sizeof(LV2_Atom), true);
+
+        const uint32_t index = *static_cast<const uint32_t*>(data);
+        const LV2_Atom* const atom = reinterpret_cast<const LV2_Atom*>(static_cast<const uint8_t*>(data) + sizeof(uint32_t)*2);
+        CARLA_SAFE_ASSERT_RETURN(lv2_atom_total_size(atom) == size - sizeof(uint32_t)*2, true);
+
+        try {
+            kPlugin->handleUIWrite(index, lv2_atom_total_size(atom), kUridAtomTransferEvent, atom);
+        } CARLA_SAFE_EXCEPTION("recordReceived atom");
+
+        return true;
+    }
+    }
+
+    return false;
+}
 #endif
 
 // -------------------------------------------------------------------------------------------------------------------
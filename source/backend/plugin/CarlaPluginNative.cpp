@@ -182,9 +182,13 @@ struct NativePluginMidiInData : NativePluginMidiOutData {
 
     MultiPortData* multiportData;
 
+    // used for the control port of plugins without MIDI inputs
+    mutable MultiPortData controlPortData;
+
     NativePluginMidiInData() noexcept
         : NativePluginMidiOutData(),
-          multiportData(nullptr) {}
+          multiportData(nullptr),
+          controlPortData() {}
 
     ~NativePluginMidiInData() noexcept
     {
@@ -213,14 +217,20 @@ struct NativePluginMidiInData : NativePluginMidiOutData {
         NativePluginMidiOutData::clear();
     }
 
+    MultiPortData& getSinglePortData() const noexcept
+    {
+        return count == 1 ? multiportData[0] : controlPortData;
+    }
+
     void initBuffers(CarlaEngineEventPort* const port) const noexcept
     {
-        if (count == 1)
+        if (count <= 1)
         {
-            CARLA_SAFE_ASSERT_RETURN(port != nullptr,);
+            MultiPortData& data(getSinglePortData());
+            carla_zeroStruct(data);
 
-            carla_zeroStruct(multiportData[0]);
-            multiportData[0].cachedEventCount = port->getEventCount();
+            if (port != nullptr)
+                data.cachedEventCount = port->getEventCount();
             return;
         }
 
@@ -236,6 +246,24 @@ struct NativePluginMidiInData : NativePluginMidiOutData {
         }
     }
 
+    // called after CV source events are merged into the control port
+    void updateEventCount(CarlaEngineEventPort* const port) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(port != nullptr,);
+
+        if (count <= 1)
+        {
+            getSinglePortData().cachedEventCount = port->getEventCount();
+            return;
+        }
+
+        for (uint32_t i=0; i < count; ++i)
+        {
+            if (ports[i] == port)
+                multiportData[i].cachedEventCount = port->getEventCount();
+        }
+    }
+
     CARLA_DECLARE_NON_COPYABLE(NativePluginMidiInData)
 };
 
@@ -401,7 +429,14 @@ public:
     // -------------------------------------------------------------------
     // Information (current data)
 
-    // nothing
+    bool isStateChanged() const noexcept override
+    {
+        // internal state is not reported to the host when it changes
+        if (fDescriptor != nullptr && (fDescriptor->hints & NATIVE_PLUGIN_USES_STATE) != 0)
+            return true;
+
+        return CarlaPlugin::isStateChanged();
+    }
 
     // -------------------------------------------------------------------
     // Information (per-plugin data)
@@ -1700,9 +1735,12 @@ public:
 
     EngineEvent& findNextEvent()
     {
-        if (fMidiIn.count == 1)
+        if (fMidiIn.count <= 1)
         {
-            NativePluginMidiInData::MultiPortData& multiportData(fMidiIn.multiportData[0]);
+            if (pData->event.portIn == nullptr)
+                return kNullEngineEvent;
+
+            NativePluginMidiInData::MultiPortData& multiportData(fMidiIn.getSinglePortData());
 
             if (multiportData.usedIndex == multiportData.cachedEventCount)
             {
@@ -1877,14 +1915,12 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
                 ExternalMidiNote note = { 0, 0, 0 };
 
-                for (; fMidiEventInCount < kPluginMaxMidiEvents && ! pData->extNotes.data.isEmpty();)
+                for (; fMidiEventInCount < kPluginMaxMidiEvents && pData->extNotes.data.tryPop(note);)
                 {
-                    note = pData->extNotes.data.getFirst(note, true);
-
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
@@ -1895,8 +1931,6 @@ public:
                     nativeEvent.size    = 3;
                 }
 
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -1918,7 +1952,10 @@ public:
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
             if (cvIn != nullptr && pData->event.cvSourcePorts != nullptr)
+            {
                 pData->event.cvSourcePorts->initPortBuffers(cvIn + pData->cvIn.count, frames, isSampleAccurate, pData->event.portIn);
+                fMidiIn.updateEventCount(pData->event.portIn);
+            }
 #endif
 
             for (;;)
@@ -1938,12 +1975,15 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                const uint32_t splitTime = isSampleAccurate ? pData->subBlock.getSplitTime(eventTime, timeOffset)
+                                                            : timeOffset;
+
+                if (splitTime > timeOffset)
                 {
-                    if (processSingle(audioIn, audioOut, cvIn, cvOut, eventTime - timeOffset, timeOffset))
+                    if (processSingle(audioIn, audioOut, cvIn, cvOut, splitTime - timeOffset, timeOffset))
                     {
                         startTime  = 0;
-                        timeOffset = eventTime;
+                        timeOffset = splitTime;
 
                         if (pData->midiprog.current >= 0 && pData->midiprog.count > 0)
                             nextBankId = pData->midiprog.data[pData->midiprog.current].bank;
@@ -2063,7 +2103,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = uint8_t(ctrlEvent.param);
                             nativeEvent.data[2] = uint8_t(ctrlEvent.normalizedValue*127.0f + 0.5f);
@@ -2091,7 +2131,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = MIDI_CONTROL_BANK_SELECT;
                             nativeEvent.data[2] = uint8_t(ctrlEvent.param);
@@ -2135,7 +2175,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_PROGRAM_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = uint8_t(ctrlEvent.param);
                             nativeEvent.size    = 2;
@@ -2151,7 +2191,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = MIDI_CONTROL_ALL_SOUND_OFF;
                             nativeEvent.data[2] = 0;
@@ -2176,7 +2216,7 @@ public:
                             NativeMidiEvent& nativeEvent(fMidiInEvents[fMidiEventInCount++]);
                             carla_zeroStruct(nativeEvent);
 
-                            nativeEvent.time    = isSampleAccurate ? startTime : eventTime;
+                            nativeEvent.time    = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
                             nativeEvent.data[0] = uint8_t(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             nativeEvent.data[1] = MIDI_CONTROL_ALL_NOTES_OFF;
                             nativeEvent.data[2] = 0;
@@ -2220,7 +2260,7 @@ public:
                     carla_zeroStruct(nativeEvent);
 
                     nativeEvent.port = midiEvent.port;
-                    nativeEvent.time = isSampleAccurate ? startTime : eventTime;
+                    nativeEvent.time = isSampleAccurate ? startTime + eventTime - timeOffset : eventTime;
                     nativeEvent.size = midiEvent.size;
 
                     nativeEvent.data[0] = uint8_t(status | (event.channel & MIDI_CHANNEL_BIT));
@@ -2240,8 +2280,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
 
@@ -2315,6 +2353,8 @@ public:
         }
         else if (! pData->singleMutex.tryLock())
         {
+            pData->subBlock.begin(pData->engine->getOptions().subBlockGranularity, frames);
+
             for (uint32_t i=0; i < pData->audioOut.count; ++i)
             {
                 for (uint32_t k=0; k < frames; ++k)
@@ -1305,14 +1305,12 @@ public:
             // ----------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
                 ExternalMidiNote note = { -1, 0, 0 };
 
-                for (; fMidiEventCount < kPluginMaxMidiEvents*2 && ! pData->extNotes.data.isEmpty();)
+                for (; fMidiEventCount < kPluginMaxMidiEvents*2 && pData->extNotes.data.tryPop(note);)
                 {
-                    note = pData->extNotes.data.getFirst(note, true);
-
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     VstMidiEvent& vstMidiEvent(fMidiEvents[fMidiEventCount++]);
@@ -1324,8 +1322,6 @@ public:
                     vstMidiEvent.midiData[2] = char(note.velo);
                 }
 
-                pData->extNotes.mutex.unlock();
-
             } // End of MIDI Input (External)
 
             // ----------------------------------------------------------------------------------------------------
@@ -1344,6 +1340,8 @@ public:
                 pData->event.cvSourcePorts->initPortBuffers(cvIn, frames, isSampleAccurate, pData->event.portIn);
 #endif
 
+            pData->subBlock.begin(pData->engine->getOptions().subBlockGranularity, frames);
+
             for (uint32_t i=0, numEvents = pData->event.portIn->getEventCount(); i < numEvents; ++i)
             {
                 EngineEvent& event(pData->event.portIn->getEvent(i));
@@ -1358,12 +1356,15 @@ public:
                     eventTime = timeOffset;
                 }
 
-                if (isSampleAccurate && eventTime > timeOffset)
+                const uint32_t splitTime = isSampleAccurate ? pData->subBlock.getSplitTime(eventTime, timeOffset)
+                                                            : timeOffset;
+
+                if (splitTime > timeOffset)
                 {
-                    if (processSingle(audioIn, audioOut, eventTime - timeOffset, timeOffset))
+                    if (processSingle(audioIn, audioOut, splitTime - timeOffset, timeOffset))
                     {
                         startTime  = 0;
-                        timeOffset = eventTime;
+                        timeOffset = splitTime;
 
                         if (fMidiEventCount > 0)
                         {
@@ -1474,7 +1475,7 @@ public:
 
                             vstMidiEvent.type        = kVstMidiType;
                             vstMidiEvent.byteSize    = kVstMidiEventSize;
-                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : eventTime);
+                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                             vstMidiEvent.midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             vstMidiEvent.midiData[1] = char(ctrlEvent.param);
                             vstMidiEvent.midiData[2] = char(ctrlEvent.normalizedValue*127.0f + 0.5f);
@@ -1497,7 +1498,7 @@ public:
                             carla_zeroStruct(vstMidiEvent_MSB);
                             vstMidiEvent_MSB.type = kVstMidiType;
                             vstMidiEvent_MSB.byteSize = kVstMidiEventSize;
-                            vstMidiEvent_MSB.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : event.time);
+                            vstMidiEvent_MSB.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                             vstMidiEvent_MSB.midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             vstMidiEvent_MSB.midiData[1] = MIDI_CONTROL_BANK_SELECT;
                             vstMidiEvent_MSB.midiData[2] = 0;
@@ -1506,7 +1507,7 @@ public:
                             carla_zeroStruct(vstMidiEvent_LSB);
                             vstMidiEvent_LSB.type        = kVstMidiType;
                             vstMidiEvent_LSB.byteSize    = kVstMidiEventSize;
-                            vstMidiEvent_LSB.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : eventTime);
+                            vstMidiEvent_LSB.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                             vstMidiEvent_LSB.midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             vstMidiEvent_LSB.midiData[1] = MIDI_CONTROL_BANK_SELECT__LSB;
                             vstMidiEvent_LSB.midiData[2] = char(ctrlEvent.param);
@@ -1532,7 +1533,7 @@ public:
 
                             vstMidiEvent.type        = kVstMidiType;
                             vstMidiEvent.byteSize    = kVstMidiEventSize;
-                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : eventTime);
+                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                             vstMidiEvent.midiData[0] = char(MIDI_STATUS_PROGRAM_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             vstMidiEvent.midiData[1] = char(ctrlEvent.param);
                         }
@@ -1549,7 +1550,7 @@ public:
 
                             vstMidiEvent.type        = kVstMidiType;
                             vstMidiEvent.byteSize    = kVstMidiEventSize;
-                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : eventTime);
+                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                             vstMidiEvent.midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             vstMidiEvent.midiData[1] = MIDI_CONTROL_ALL_SOUND_OFF;
                         }
@@ -1574,7 +1575,7 @@ public:
 
                             vstMidiEvent.type        = kVstMidiType;
                             vstMidiEvent.byteSize    = kVstMidiEventSize;
-                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : eventTime);
+                            vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                             vstMidiEvent.midiData[0] = char(MIDI_STATUS_CONTROL_CHANGE | (event.channel & MIDI_CHANNEL_BIT));
                             vstMidiEvent.midiData[1] = MIDI_CONTROL_ALL_NOTES_OFF;
                         }
@@ -1617,7 +1618,7 @@ public:
 
                     vstMidiEvent.type        = kVstMidiType;
                     vstMidiEvent.byteSize    = kVstMidiEventSize;
-                    vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime : eventTime);
+                    vstMidiEvent.deltaFrames = static_cast<int32_t>(isSampleAccurate ? startTime + eventTime - timeOffset : eventTime);
                     vstMidiEvent.midiData[0] = char(status | (event.channel & MIDI_CHANNEL_BIT));
                     vstMidiEvent.midiData[1] = char(midiEvent.size >= 2 ? midiEvent.data[1] : 0);
                     vstMidiEvent.midiData[2] = char(midiEvent.size >= 3 ? midiEvent.data[2] : 0);
@@ -1634,8 +1635,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, frames - timeOffset, timeOffset);
 
@@ -2014,13 +2013,13 @@ protected:
             else if (pthread_equal(thisThread, fChangingValuesThread))
             {
                 carla_debug("audioMasterAutomate called while setting state");
-                pData->postponeParameterChangeRtEvent(true, index, fixedValue);
+                pData->postponeParameterChangeNonRtEvent(true, index, fixedValue);
             }
             // Called from effIdle
             else if (pthread_equal(thisThread, fIdleThread))
             {
                 carla_debug("audioMasterAutomate called from idle thread");
-                pData->postponeParameterChangeRtEvent(true, index, fixedValue);
+                pData->postponeParameterChangeNonRtEvent(true, index, fixedValue);
             }
             // Called from main thread, why?
             else if (pthread_equal(thisThread, fMainThread))
@@ -2299,6 +2298,9 @@ protected:
         case audioMasterUpdateDisplay: {
             bool programNamesUpdated = false;
 
+            // plugins use this to tell the host something changed, which might include internal state
+            setStateChanged();
+
             // Update current program
             if (pData->prog.count > 1)
             {
@@ -76,6 +76,15 @@ void strncpy_utf8(char* const dst, const int16_t* const src, const size_t length
 
 // --------------------------------------------------------------------------------------------------------------------
 
+// silence bitset with all channels of a bus set
+static inline
+uint64_t getSilenceMask(const int32_t numChannels) noexcept
+{
+    return numChannels >= 64 ? UINT64_MAX : (static_cast<uint64_t>(1) << numChannels) - 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 struct v3HostCallback {
     virtual ~v3HostCallback() {}
     // v3_component_handler
@@ -2399,6 +2408,11 @@ public:
             v3_cpp_obj(fV3.processor)->set_processing(fV3.processor, true);
         } CARLA_SAFE_EXCEPTION("set_processing on");
 
+        try {
+            const uint32_t tail = v3_cpp_obj(fV3.processor)->get_tail_samples(fV3.processor);
+            pData->sleep.tailFrames = tail != UINT32_MAX ? tail : ProtectedData::Sleep::kTailInfinite;
+        } CARLA_SAFE_EXCEPTION("get_tail_samples");
+
         fFirstActive = true;
         runIdleCallbacksAsNeeded(false);
     }
@@ -2557,15 +2571,13 @@ public:
             // --------------------------------------------------------------------------------------------------------
             // MIDI Input (External)
 
-            if (pData->extNotes.mutex.tryLock())
+            if (! pData->extNotes.data.isEmpty())
             {
                 ExternalMidiNote note = { 0, 0, 0 };
                 uint16_t numEvents = fEvents.eventInputs->numEvents;
 
-                for (; numEvents < kPluginMaxMidiEvents && ! pData->extNotes.data.isEmpty();)
+                for (; numEvents < kPluginMaxMidiEvents && pData->extNotes.data.tryPop(note);)
                 {
-                    note = pData->extNotes.data.getFirst(note, true);
-
                     CARLA_SAFE_ASSERT_CONTINUE(note.channel >= 0 && note.channel < MAX_MIDI_CHANNELS);
 
                     v3_event& event(fEvents.eventInputs->events[numEvents++]);
@@ -2586,8 +2598,6 @@ public:
                     }
                 }
 
-                pData->extNotes.mutex.unlock();
-
                 fEvents.eventInputs->numEvents = numEvents;
 
             } // End of MIDI Input (External)
@@ -2604,8 +2614,9 @@ public:
             uint32_t timeOffset = 0;
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
+            // parameter changes carry their frame offset, so CV can always be read sample-accurately
             if (cvIn != nullptr && pData->event.cvSourcePorts != nullptr)
-                pData->event.cvSourcePorts->initPortBuffers(cvIn, frames, isSampleAccurate, pData->event.portIn);
+                pData->event.cvSourcePorts->initPortBuffers(cvIn, frames, true, pData->event.portIn);
 #endif
 
             for (uint32_t i=0, numEvents = pData->event.portIn->getEventCount(); i < numEvents; ++i)
@@ -3000,8 +3011,6 @@ public:
                 } // switch (event.type)
             }
 
-            pData->postRtEvents.trySplice();
-
             if (frames > timeOffset)
                 processSingle(audioIn, audioOut, cvIn, cvOut, frames - timeOffset, timeOffset);
 
@@ -3100,15 +3109,20 @@ public:
 
         fEvents.prepare();
 
+        // the engine knows when all audio inputs are silent, CV inputs are never flagged
+        const bool inputSilent = pData->sleep.inputSilent && pData->cvIn.count == 0;
+
         for (int32_t b = 0, j = 0; b < fBuses.numInputs; ++b)
         {
             fBuses.inputs[b].channel_buffers_32 = const_cast<float**>(bufferAudioIn + j);
+            fBuses.inputs[b].channel_silence_bitset = inputSilent ? getSilenceMask(fBuses.inputs[b].num_channels) : 0;
             j += fBuses.inputs[b].num_channels;
         }
 
         for (int32_t b = 0, j = 0; b < fBuses.numOutputs; ++b)
         {
             fBuses.outputs[b].channel_buffers_32 = bufferAudioOut + j;
+            fBuses.outputs[b].channel_silence_bitset = 0;
             j += fBuses.outputs[b].num_channels;
         }
 
@@ -3131,6 +3145,21 @@ public:
             v3_cpp_obj(fV3.processor)->process(fV3.processor, &processData);
         } CARLA_SAFE_EXCEPTION("process");
 
+        // outputs flagged as silent by the plugin count as quiet for sleep purposes
+        if (fBuses.numOutputs != 0)
+        {
+            bool outputSilent = true;
+
+            for (int32_t b = 0; b < fBuses.numOutputs && outputSilent; ++b)
+            {
+                const uint64_t mask = getSilenceMask(fBuses.outputs[b].num_channels);
+                outputSilent = (fBuses.outputs[b].channel_silence_bitset & mask) == mask;
+            }
+
+            if (outputSilent)
+                pData->sleep.status = ProtectedData::Sleep::kStatusQuiet;
+        }
+
         // ------------------------------------------------------------------------------------------------------------
         // Handle parameter outputs
 
@@ -3168,8 +3197,6 @@ public:
             }
         }
 
-        pData->postRtEvents.trySplice();
-
         fEvents.init();
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
@@ -3664,6 +3691,10 @@ protected:
     v3_result v3RestartComponent(const int32_t flags) override
     {
         fRestartFlags |= flags;
+
+        if (flags & V3_RESTART_PARAM_VALUES_CHANGED)
+            setStateChanged();
+
         return V3_OK;
     }
 
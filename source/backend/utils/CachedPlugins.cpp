@@ -6,7 +6,7 @@
 #include "CarlaNative.h"
 #include "CarlaString.hpp"
 #include "CarlaBackendUtils.hpp"
-#include "CarlaLv2Utils.hpp"
+#include "CarlaLv2CacheUtils.hpp"
 
 #ifndef STATIC_PLUGIN_TARGET
 # define HAVE_SFZ
@@ -14,7 +14,10 @@
 #endif
 
 #ifdef HAVE_YSFX
+# include "CarlaCacheFileUtils.hpp"
 # include "CarlaJsfxUtils.hpp"
+# include "CarlaSha1Utils.hpp"
+# include <map>
 #endif
 
 #include "water/files/File.h"
@@ -582,6 +585,143 @@ static const CarlaCachedPluginInfo* get_cached_plugin_lv2(Lv2WorldClass& lv2Worl
     return &info;
 }
 
+// -------------------------------------------------------------------------------------------------------------------
+// LV2 plugin list, loaded from the on-disk cache while it matches the installed bundles
+
+static CarlaMappedFile gLv2CacheFile;
+static CarlaCachedPluginInfo* gLv2CachedPlugins = nullptr;
+static uint32_t gLv2CachedPluginCount = 0;
+static bool gLv2UsingCache = false;
+
+static void clearLv2CachedPlugins()
+{
+    delete[] gLv2CachedPlugins;
+    gLv2CachedPlugins = nullptr;
+    gLv2CachedPluginCount = 0;
+}
+
+static bool loadLv2CachedPlugins(const char* const pluginPath, const char* const signature, const water::File& file)
+{
+    clearLv2CachedPlugins();
+    gLv2CacheFile.unmap();
+
+    if (! gLv2CacheFile.map(file.getFullPathName().toRawUTF8()))
+        return false;
+
+    CarlaCacheReader reader(gLv2CacheFile.getData(), gLv2CacheFile.getSize());
+    uint32_t count;
+
+    if (! (lv2_cache_read_header(reader, signature, pluginPath) && reader.readCount(count, kLv2CacheMinPluginSize)))
+        return false;
+
+    gLv2CachedPlugins = new CarlaCachedPluginInfo[count];
+    gLv2CachedPluginCount = count;
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        CarlaCachedPluginInfo& info(gLv2CachedPlugins[i]);
+        uint32_t valid, category;
+
+        if (! (reader.readUInt(valid)
+            && reader.readUInt(category)
+            && reader.readUInt(info.hints)
+            && reader.readUInt(info.audioIns)
+            && reader.readUInt(info.audioOuts)
+            && reader.readUInt(info.cvIns)
+            && reader.readUInt(info.cvOuts)
+            && reader.readUInt(info.midiIns)
+            && reader.readUInt(info.midiOuts)
+            && reader.readUInt(info.parameterIns)
+            && reader.readUInt(info.parameterOuts)
+            && reader.readString(info.name)
+            && reader.readString(info.label)
+            && reader.readString(info.maker)
+            && reader.readString(info.copyright)))
+        {
+            clearLv2CachedPlugins();
+            return false;
+        }
+
+        info.valid    = valid != 0;
+        info.category = static_cast<CB::PluginCategory>(category);
+    }
+
+    return true;
+}
+
+static void writeLv2CachedPlugins(const char* const pluginPath, const char* const signature, const water::File& file)
+{
+    Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+    lv2World.initIfNeeded(pluginPath);
+
+    const uint count = lv2World.getPluginCount();
+
+    CarlaCacheWriter writer;
+    lv2_cache_write_header(writer, signature, pluginPath);
+    writer.writeUInt(count);
+
+    for (uint i=0; i<count; ++i)
+    {
+        const CarlaCachedPluginInfo* info = nullptr;
+
+        if (const LilvPlugin* const cPlugin = lv2World.getPluginFromIndex(i))
+        {
+            Lilv::Plugin lilvPlugin(cPlugin);
+
+            if (lilvPlugin.get_uri().is_uri())
+                info = get_cached_plugin_lv2(lv2World, lilvPlugin);
+        }
+
+        static const CarlaCachedPluginInfo invalidInfo;
+
+        if (info == nullptr)
+            info = &invalidInfo;
+
+        writer.writeUInt(info->valid ? 1 : 0);
+        writer.writeUInt(static_cast<uint32_t>(info->category));
+        writer.writeUInt(info->hints);
+        writer.writeUInt(info->audioIns);
+        writer.writeUInt(info->audioOuts);
+        writer.writeUInt(info->cvIns);
+        writer.writeUInt(info->cvOuts);
+        writer.writeUInt(info->midiIns);
+        writer.writeUInt(info->midiOuts);
+        writer.writeUInt(info->parameterIns);
+        writer.writeUInt(info->parameterOuts);
+        writer.writeString(info->name);
+        writer.writeString(info->label);
+        writer.writeString(info->maker);
+        writer.writeString(info->copyright);
+    }
+
+    if (! writer.saveTo(file))
+        carla_stderr2("Failed to write LV2 cache file '%s'", file.getFullPathName().toRawUTF8());
+}
+
+static uint getLv2CachedPluginCount(const char* pluginPath)
+{
+    if (pluginPath == nullptr || pluginPath[0] == '\0')
+        pluginPath = LILV_DEFAULT_LV2_PATH;
+
+    const CarlaString signature(Lv2CacheClass::getInstance().getSignature(pluginPath));
+    const water::File file(Lv2CacheClass::getFileForKey("index-", pluginPath));
+
+    gLv2UsingCache = loadLv2CachedPlugins(pluginPath, signature, file);
+
+    if (! gLv2UsingCache)
+    {
+        // cache is missing or stale, rebuild it from lilv and try again
+        writeLv2CachedPlugins(pluginPath, signature, file);
+        gLv2UsingCache = loadLv2CachedPlugins(pluginPath, signature, file);
+    }
+
+    if (gLv2UsingCache)
+        return gLv2CachedPluginCount;
+
+    // could not use the cache at all, keep using lilv directly
+    return Lv2WorldClass::getInstance().getPluginCount();
+}
+
 // -------------------------------------------------------------------------------------------------------------------
 
 #ifdef HAVE_SFZ
@@ -621,10 +761,37 @@ static const CarlaCachedPluginInfo* get_cached_plugin_sfz(const water::File& fil
 // -------------------------------------------------------------------------------------------------------------------
 
 #ifdef HAVE_YSFX
-static const CarlaCachedPluginInfo* get_cached_plugin_jsfx(const CB::CarlaJsfxUnit& unit)
+// -------------------------------------------------------------------------------------------------------------------
+// JSFX plugin info, kept in an on-disk cache so effects are only parsed again when their source files change
+
+static constexpr const uint32_t kJsfxCacheMagic   = 0x5846534a; // "JSFX"
+static constexpr const uint32_t kJsfxCacheVersion = 1;
+
+struct JsfxCachedPlugin {
+    bool valid;
+    uint32_t category;
+    uint32_t audioIns;
+    uint32_t audioOuts;
+    uint32_t parameterIns;
+    CarlaString name;
+    CarlaString maker;
+    CB::CarlaJsfxSourceFiles files;
+
+    JsfxCachedPlugin()
+        : valid(false),
+          category(CB::PLUGIN_CATEGORY_NONE),
+          audioIns(0),
+          audioOuts(0),
+          parameterIns(0),
+          name(),
+          maker(),
+          files() {}
+};
+
+static std::vector<JsfxCachedPlugin> gJSFXInfos;
+
+static void readJsfxPluginInfo(const CB::CarlaJsfxUnit& unit, JsfxCachedPlugin& plugin)
 {
-    static CarlaCachedPluginInfo info;
-
     ysfx_config_u config(ysfx_config_new());
 
     const CarlaString rootPath = unit.getRootPath();
@@ -637,17 +804,179 @@ static const CarlaCachedPluginInfo* get_cached_plugin_jsfx(const CB::CarlaJsfxUn
 
     ysfx_u effect(ysfx_new(config.get()));
 
-    if (! ysfx_load_file(effect.get(), filePath, 0))
-    {
-        info.valid = false;
-        return &info;
-    }
+    plugin = JsfxCachedPlugin();
+
+    const bool loaded = ysfx_load_file(effect.get(), filePath, 0);
+    plugin.files.setFromEffect(effect.get(), filePath);
+
+    if (! loaded)
+        return;
 
     // plugins with neither @block nor @sample are valid, but they are useless
     // also use this as a sanity check against misdetected files
     // since JSFX parsing is so permissive, it might accept lambda text files
     if (! ysfx_has_section(effect.get(), ysfx_section_block) &&
         ! ysfx_has_section(effect.get(), ysfx_section_sample))
+        return;
+
+    plugin.valid = true;
+    plugin.category = static_cast<uint32_t>(CB::CarlaJsfxCategories::getFromEffect(effect.get()));
+    plugin.audioIns = ysfx_get_num_inputs(effect.get());
+    plugin.audioOuts = ysfx_get_num_outputs(effect.get());
+    plugin.name = ysfx_get_name(effect.get());
+    plugin.maker = ysfx_get_author(effect.get());
+
+    for (uint32_t sliderIndex = 0; sliderIndex < ysfx_max_sliders; ++sliderIndex)
+    {
+        if (ysfx_slider_exists(effect.get(), sliderIndex))
+            ++plugin.parameterIns;
+    }
+}
+
+static water::File getJsfxCacheFile(const char* const jsfxPaths)
+{
+    CarlaSha1 sha1;
+    sha1.write(jsfxPaths, std::strlen(jsfxPaths));
+
+    const water::String filename(water::String("index-") + sha1.resultAsString() + ".bin");
+    return carla_cache_directory().getChildFile("jsfx").getChildFile(filename.toRawUTF8());
+}
+
+// entries are keyed by file path, plugins that are no longer found are dropped on the next write
+static void loadJsfxCache(const char* const jsfxPaths, std::map<std::string, JsfxCachedPlugin>& cached)
+{
+    CarlaMappedFile file;
+
+    if (! file.map(getJsfxCacheFile(jsfxPaths).getFullPathName().toRawUTF8()))
+        return;
+
+    CarlaCacheReader reader(file.getData(), file.getSize());
+    uint32_t magic, version, count;
+    const char* fileKey;
+
+    if (! (reader.readUInt(magic) && reader.readUInt(version) && reader.readString(fileKey) && reader.readUInt(count)))
+        return;
+    if (magic != kJsfxCacheMagic || version != kJsfxCacheVersion)
+        return;
+    if (fileKey == nullptr || std::strcmp(fileKey, jsfxPaths) != 0)
+        return;
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        JsfxCachedPlugin plugin;
+        const char *filePath, *name, *maker;
+        uint32_t valid, fileCount;
+
+        if (! (reader.readString(filePath)
+            && reader.readUInt(valid)
+            && reader.readUInt(plugin.category)
+            && reader.readUInt(plugin.audioIns)
+            && reader.readUInt(plugin.audioOuts)
+            && reader.readUInt(plugin.parameterIns)
+            && reader.readString(name)
+            && reader.readString(maker)
+            && reader.readUInt(fileCount)))
+            return;
+
+        if (filePath == nullptr)
+            return;
+
+        plugin.valid = valid != 0;
+        plugin.name = name;
+        plugin.maker = maker;
+
+        for (uint32_t j=0; j<fileCount; ++j)
+        {
+            const char* sourcePath;
+            uint64_t size, mtime;
+
+            if (! (reader.readString(sourcePath) && reader.readULong(size) && reader.readULong(mtime)))
+                return;
+            if (sourcePath == nullptr)
+                return;
+
+            plugin.files.files.push_back(CB::CarlaJsfxSourceFile(sourcePath,
+                                                                 static_cast<int64_t>(size),
+                                                                 static_cast<int64_t>(mtime)));
+        }
+
+        cached[filePath] = plugin;
+    }
+}
+
+static void writeJsfxCache(const char* const jsfxPaths)
+{
+    CarlaCacheWriter writer;
+    writer.writeUInt(kJsfxCacheMagic);
+    writer.writeUInt(kJsfxCacheVersion);
+    writer.writeString(jsfxPaths);
+    writer.writeUInt(static_cast<uint32_t>(gJSFXs.size()));
+
+    for (std::size_t i=0; i<gJSFXs.size(); ++i)
+    {
+        const JsfxCachedPlugin& plugin(gJSFXInfos[i]);
+
+        writer.writeString(gJSFXs[i].getFilePath());
+        writer.writeUInt(plugin.valid ? 1 : 0);
+        writer.writeUInt(plugin.category);
+        writer.writeUInt(plugin.audioIns);
+        writer.writeUInt(plugin.audioOuts);
+        writer.writeUInt(plugin.parameterIns);
+        writer.writeString(plugin.name);
+        writer.writeString(plugin.maker);
+        writer.writeUInt(static_cast<uint32_t>(plugin.files.files.size()));
+
+        for (std::vector<CB::CarlaJsfxSourceFile>::const_iterator it = plugin.files.files.begin(),
+             end = plugin.files.files.end(); it != end; ++it)
+        {
+            writer.writeString(it->path);
+            writer.writeULong(static_cast<uint64_t>(it->size));
+            writer.writeULong(static_cast<uint64_t>(it->mtime));
+        }
+    }
+
+    const water::File file(getJsfxCacheFile(jsfxPaths));
+
+    if (! writer.saveTo(file))
+        carla_stderr2("Failed to write JSFX cache file '%s'", file.getFullPathName().toRawUTF8());
+}
+
+static void updateJsfxInfos(const char* const jsfxPaths)
+{
+    gJSFXInfos.clear();
+    gJSFXInfos.resize(gJSFXs.size());
+
+    if (jsfxPaths == nullptr || jsfxPaths[0] == '\0')
+        return;
+
+    std::map<std::string, JsfxCachedPlugin> cached;
+    loadJsfxCache(jsfxPaths, cached);
+
+    bool needsWrite = cached.size() != gJSFXs.size();
+
+    for (std::size_t i=0; i<gJSFXs.size(); ++i)
+    {
+        const std::map<std::string, JsfxCachedPlugin>::const_iterator it = cached.find(gJSFXs[i].getFilePath().buffer());
+
+        if (it != cached.end() && it->second.files.isUpToDate())
+        {
+            gJSFXInfos[i] = it->second;
+            continue;
+        }
+
+        readJsfxPluginInfo(gJSFXs[i], gJSFXInfos[i]);
+        needsWrite = true;
+    }
+
+    if (needsWrite)
+        writeJsfxCache(jsfxPaths);
+}
+
+static const CarlaCachedPluginInfo* get_cached_plugin_jsfx(const CB::CarlaJsfxUnit& unit, const JsfxCachedPlugin& plugin)
+{
+    static CarlaCachedPluginInfo info;
+
+    if (! plugin.valid)
     {
         info.valid = false;
         return &info;
@@ -655,15 +984,15 @@ static const CarlaCachedPluginInfo* get_cached_plugin_jsfx(const CB::CarlaJsfxUn
 
     static CarlaString name, label, maker;
     label = unit.getFileId();
-    name = ysfx_get_name(effect.get());
-    maker = ysfx_get_author(effect.get());
+    name = plugin.name;
+    maker = plugin.maker;
 
     info.valid = true;
 
-    info.category = CB::CarlaJsfxCategories::getFromEffect(effect.get());
+    info.category = static_cast<CB::PluginCategory>(plugin.category);
 
-    info.audioIns = ysfx_get_num_inputs(effect.get());
-    info.audioOuts = ysfx_get_num_outputs(effect.get());
+    info.audioIns = plugin.audioIns;
+    info.audioOuts = plugin.audioOuts;
 
     info.cvIns = 0;
     info.cvOuts = 0;
@@ -671,21 +1000,12 @@ static const CarlaCachedPluginInfo* get_cached_plugin_jsfx(const CB::CarlaJsfxUn
     info.midiIns = 1;
     info.midiOuts = 1;
 
-    info.parameterIns = 0;
+    info.parameterIns = plugin.parameterIns;
     info.parameterOuts = 0;
-    for (uint32_t sliderIndex = 0; sliderIndex < ysfx_max_sliders; ++sliderIndex)
-    {
-        if (ysfx_slider_exists(effect.get(), sliderIndex))
-            ++info.parameterIns;
-    }
 
+    // TODO(jsfx) cache ysfx_section_gfx as PLUGIN_HAS_CUSTOM_UI when supporting custom graphics
     info.hints    = 0;
 
-#if 0 // TODO(jsfx) when supporting custom graphics
-    if (ysfx_has_section(effect.get(), ysfx_section_gfx))
-        info.hints |= CB::PLUGIN_HAS_CUSTOM_UI;
-#endif
-
     info.name      = name.buffer();
     info.label     = label.buffer();
     info.maker     = maker.buffer();
@@ -710,11 +1030,8 @@ uint carla_get_cached_plugin_count(CB::PluginType ptype, const char* pluginPath)
         return count;
     }
 
-    case CB::PLUGIN_LV2: {
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-        lv2World.initIfNeeded(pluginPath);
-        return lv2World.getPluginCount();
-    }
+    case CB::PLUGIN_LV2:
+        return getLv2CachedPluginCount(pluginPath);
 
    #ifdef HAVE_SFZ
     case CB::PLUGIN_SFZ:
@@ -725,6 +1042,7 @@ uint carla_get_cached_plugin_count(CB::PluginType ptype, const char* pluginPath)
    #ifdef HAVE_YSFX
     case CB::PLUGIN_JSFX:
         findJSFXs(pluginPath);
+        updateJsfxInfos(pluginPath);
         return static_cast<uint>(gJSFXs.size());
    #endif
 
@@ -750,6 +1068,12 @@ const CarlaCachedPluginInfo* carla_get_cached_plugin_info(CB::PluginType ptype,
     }
 
     case CB::PLUGIN_LV2: {
+        if (gLv2UsingCache)
+        {
+            CARLA_SAFE_ASSERT_BREAK(index < gLv2CachedPluginCount);
+            return &gLv2CachedPlugins[index];
+        }
+
         Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
 
         const LilvPlugin* const cPlugin(lv2World.getPluginFromIndex(index));
@@ -770,7 +1094,8 @@ const CarlaCachedPluginInfo* carla_get_cached_plugin_info(CB::PluginType ptype,
    #ifdef HAVE_YSFX
     case CB::PLUGIN_JSFX:
         CARLA_SAFE_ASSERT_BREAK(index < static_cast<uint>(gJSFXs.size()));
-        return get_cached_plugin_jsfx(gJSFXs[index]);
+        CARLA_SAFE_ASSERT_BREAK(index < static_cast<uint>(gJSFXInfos.size()));
+        return get_cached_plugin_jsfx(gJSFXs[index], gJSFXInfos[index]);
    #endif
 
     default:
@@ -5,16 +5,29 @@
 
 #include "CarlaBackendUtils.hpp"
 #include "CarlaBinaryUtils.hpp"
+#include "CarlaCacheFileUtils.hpp"
 #include "CarlaJuceUtils.hpp"
 #include "CarlaPipeUtils.hpp"
 #include "CarlaSha1Utils.hpp"
+#include "CarlaThread.hpp"
 #include "CarlaTimeUtils.hpp"
 
+#include "water/files/DirectoryIterator.h"
 #include "water/files/File.h"
 #include "water/files/FileInputStream.h"
+#include "water/misc/Time.h"
 #include "water/threads/ChildProcess.h"
 #include "water/text/StringArray.h"
 
+#include <deque>
+#include <map>
+#include <set>
+#include <thread>
+
+#ifdef CARLA_OS_LINUX
+# include <sys/inotify.h>
+#endif
+
 namespace CB = CARLA_BACKEND_NAMESPACE;
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -73,6 +86,21 @@ struct CarlaPluginDiscoveryOptions {
     } wine;
    #endif
 
+    // number of concurrent discovery processes, 0 means one per CPU core
+    uint workers;
+
+    // identify binaries by their contents, hashed in the background
+    bool contentHash;
+
+    uint getWorkerCount() const noexcept
+    {
+        if (workers != 0)
+            return workers;
+
+        const uint cores = std::thread::hardware_concurrency();
+        return cores != 0 ? cores : 1;
+    }
+
     static CarlaPluginDiscoveryOptions& getInstance() noexcept
     {
         static CarlaPluginDiscoveryOptions instance;
@@ -81,384 +109,1080 @@ struct CarlaPluginDiscoveryOptions {
 };
 
 // --------------------------------------------------------------------------------------------------------------------
-
-class CarlaPluginDiscovery : private CarlaPipeServer
+// Persistent index of plugin directories, so refreshing an unchanged system does not walk and probe every file.
+//
+// Each directory keeps its listing, plus the binary type and modification time of the binaries found in it.
+// A directory is only listed again after it changes, which is known through inotify on Linux,
+// or by polling its modification time elsewhere and for directories that could not be watched.
+// When content hashing is enabled, binaries are also hashed in a background thread,
+// so that the discovery cache follows binaries that get moved or renamed.
+
+static constexpr const uint32_t kDiscoveryIndexMagic   = 0x58494443; // "CDIX"
+static constexpr const uint32_t kDiscoveryIndexVersion = 1;
+
+class CarlaPluginDiscoveryIndex : private CarlaThread
 {
 public:
-    CarlaPluginDiscovery(const char* const discoveryTool,
-                         const BinaryType btype,
-                         const PluginType ptype,
-                         const std::vector<water::File>&& binaries,
-                         const CarlaPluginDiscoveryCallback discoveryCb,
-                         const CarlaPluginCheckCacheCallback checkCacheCb,
-                         void* const callbackPtr)
-        : fBinaryType(btype),
-          fPluginType(ptype),
-          fDiscoveryCallback(discoveryCb),
-          fCheckCacheCallback(checkCacheCb),
-          fCallbackPtr(callbackPtr),
-          fPluginPath(nullptr),
-          fPluginsFoundInBinary(false),
-          fBinaryIndex(0),
-          fBinaryCount(static_cast<uint>(binaries.size())),
-          fBinaries(binaries),
-          fDiscoveryTool(discoveryTool),
-          fLastMessageTime(0),
-          fNextLabel(nullptr),
-          fNextMaker(nullptr),
-          fNextName(nullptr)
+    enum HashState {
+        kHashUnavailable,
+        kHashPending,
+        kHashReady
+    };
+
+    CarlaPluginDiscoveryIndex()
+        : CarlaThread("CarlaPluginDiscoveryIndex"),
+          fMutex(),
+          fDirectories(),
+          fLoaded(false),
+          fModified(false),
+          fHashQueue(),
+          fHasherActive(false)
+         #ifdef CARLA_OS_LINUX
+        , fInotifyFd(-1),
+          fWatches()
+         #endif
     {
-        start();
     }
 
-    CarlaPluginDiscovery(const char* const discoveryTool,
-                         const BinaryType btype,
-                         const PluginType ptype,
-                         const CarlaPluginDiscoveryCallback discoveryCb,
-                         const CarlaPluginCheckCacheCallback checkCacheCb,
-                         void* const callbackPtr,
-                         const char* const pluginPath = nullptr)
-        : fBinaryType(btype),
-          fPluginType(ptype),
-          fDiscoveryCallback(discoveryCb),
-          fCheckCacheCallback(checkCacheCb),
-          fCallbackPtr(callbackPtr),
-          fPluginPath(pluginPath != nullptr ? carla_strdup_safe(pluginPath) : nullptr),
-          fPluginsFoundInBinary(false),
-          fBinaryIndex(0),
-          fBinaryCount(1),
-          fDiscoveryTool(discoveryTool),
-          fLastMessageTime(0),
-          fNextLabel(nullptr),
-          fNextMaker(nullptr),
-          fNextName(nullptr)
+    ~CarlaPluginDiscoveryIndex() override
     {
-        start();
+        stopThread(5000);
+
+       #ifdef CARLA_OS_LINUX
+        if (fInotifyFd >= 0)
+            ::close(fInotifyFd);
+       #endif
     }
 
-    ~CarlaPluginDiscovery()
+    static CarlaPluginDiscoveryIndex& getInstance()
     {
-        stopPipeServer(5000);
-        std::free(fNextLabel);
-        std::free(fNextMaker);
-        std::free(fNextName);
-        delete[] fPluginPath;
+        static CarlaPluginDiscoveryIndex index;
+        return index;
     }
 
-    bool idle()
+    // recursive search, same as water::File::findChildFiles but only listing directories that changed
+    // if @a btype is not BINARY_NONE, only binaries of that type are returned
+    // with File::ignoreHiddenFiles, entries starting with a dot are skipped, and hidden directories not searched
+    void findChildFiles(std::vector<water::File>& results,
+                        const water::File& dir,
+                        const int whatToLookFor,
+                        const char* const wildcard,
+                        const BinaryType btype)
     {
-        if (isPipeRunning())
+        bool startHasher;
+
         {
-            idlePipe();
+            const CarlaMutexLocker cml(fMutex);
 
-            // automatically skip a plugin if 30s passes without a reply
-            const uint32_t timeNow = carla_gettime_ms();
+            loadIfNeeded();
+           #ifdef CARLA_OS_LINUX
+            processEvents();
+           #endif
 
-            if (timeNow - fLastMessageTime < 30000)
-                return true;
+            findInDirectory(results, dir.getFullPathName(), whatToLookFor, wildcard, btype,
+                            water::Time::currentTimeMillis());
 
-            carla_stdout("Plugin took too long to respond, skipping...");
-            stopPipeServer(1000);
+            startHasher = !fHashQueue.empty() && !fHasherActive;
+
+            if (startHasher)
+                fHasherActive = true;
         }
 
-        // report binary as having no plugins
-        if (fCheckCacheCallback != nullptr && !fPluginsFoundInBinary && !fBinaries.empty())
+        if (startHasher)
         {
-            const water::File file(fBinaries[fBinaryIndex]);
-            const water::String filename(file.getFullPathName());
+            // previous hasher thread has nothing left to do, but might not be fully stopped yet
+            stopThread(-1);
+            startThread();
+        }
+    }
 
-            makeHash(file, filename);
+    // modification time of a binary returned by findChildFiles, without touching the filesystem if possible
+    int64_t getModificationTime(const water::File& file)
+    {
+        {
+            const CarlaMutexLocker cml(fMutex);
 
-            if (! fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), fNextSha1Sum))
-                fDiscoveryCallback(fCallbackPtr, nullptr, fNextSha1Sum);
+            if (const Entry* const entry = findEntry(file.getFullPathName().toRawUTF8()))
+                if (entry->mtime != 0)
+                    return entry->mtime;
         }
 
-        if (++fBinaryIndex == fBinaryCount)
-            return false;
-
-        start();
-        return true;
+        return file.getLastModificationTime();
     }
 
-    void skip()
+    HashState getContentHash(const water::File& file, CarlaString& hash)
     {
-        if (isPipeRunning())
-            stopPipeServer(1000);
+        const CarlaMutexLocker cml(fMutex);
+
+        const Entry* const entry = findEntry(file.getFullPathName().toRawUTF8());
+
+        if (entry == nullptr)
+            return kHashUnavailable;
+
+        if (! entry->contentHash.empty())
+        {
+            hash = entry->contentHash.c_str();
+            return kHashReady;
+        }
+
+        return entry->hashPending ? kHashPending : kHashUnavailable;
     }
 
-protected:
-    bool msgReceived(const char* const msg) noexcept
+    void saveIfNeeded()
     {
-        fLastMessageTime = carla_gettime_ms();
+        const CarlaMutexLocker cml(fMutex);
+
+        if (! fModified)
+            return;
 
-        if (std::strcmp(msg, "warning") == 0 || std::strcmp(msg, "error") == 0)
+        CarlaCacheWriter writer;
+        writer.writeUInt(kDiscoveryIndexMagic);
+        writer.writeUInt(kDiscoveryIndexVersion);
+        writer.writeUInt(CARLA_VERSION_HEX);
+        writer.writeUInt(static_cast<uint32_t>(fDirectories.size()));
+
+        for (DirectoryMap::const_iterator it = fDirectories.begin(); it != fDirectories.end(); ++it)
         {
-            const char* text = nullptr;
-            readNextLineAsString(text, false);
-            carla_stdout("discovery: %s", text);
-            return true;
+            const Directory& directory(it->second);
+
+            // listings we do not trust are saved as unknown, so they get listed again next time
+            writer.writeString(it->first.c_str());
+            writer.writeULong(static_cast<uint64_t>(directory.dirty ? -1 : directory.mtime));
+            writer.writeUInt(directory.btype);
+            writer.writeUInt(static_cast<uint32_t>(directory.entries.size()));
+
+            for (std::vector<Entry>::const_iterator ite = directory.entries.begin(); ite != directory.entries.end(); ++ite)
+            {
+                const Entry& entry(*ite);
+                writer.writeString(entry.name.c_str());
+                writer.writeUInt(entry.isDirectory ? 1 : 0);
+                writer.writeUInt(entry.btype);
+                writer.writeULong(static_cast<uint64_t>(entry.size));
+                writer.writeULong(static_cast<uint64_t>(entry.mtime));
+                writer.writeString(entry.contentHash.c_str());
+            }
         }
 
-        if (std::strcmp(msg, "init") == 0)
+        if (writer.saveTo(getIndexFile()))
+            fModified = false;
+        else
+            carla_stderr2("Failed to save plugin discovery index");
+    }
+
+private:
+    struct Entry {
+        std::string name;
+        bool isDirectory;
+        bool hashPending;
+        // binary type and content hash are only valid for this size and modification time
+        BinaryType btype;
+        int64_t size;
+        int64_t mtime;
+        std::string contentHash;
+
+        Entry() noexcept
+            : name(),
+              isDirectory(false),
+              hashPending(false),
+              btype(CB::BINARY_NONE),
+              size(0),
+              mtime(0),
+              contentHash() {}
+
+        bool operator<(const Entry& other) const noexcept
         {
-            const char* _;
-            readNextLineAsString(_, false);
-            new (&fNextInfo) _CarlaPluginDiscoveryInfo();
-            return true;
+            return name < other.name;
         }
+    };
+
+    struct Directory {
+        // -1 if never listed, 0 if it does not exist
+        int64_t mtime;
+        // binary type of the directory itself, for plugin bundles
+        BinaryType btype;
+        bool dirty;
+        int watch;
+        // sorted by name
+        std::vector<Entry> entries;
+
+        Directory() noexcept
+            : mtime(-1),
+              btype(CB::BINARY_NONE),
+              dirty(false),
+              watch(-1),
+              entries() {}
+    };
+
+    typedef std::map<std::string, Directory> DirectoryMap;
+
+    CarlaMutex fMutex;
+    DirectoryMap fDirectories;
+    bool fLoaded;
+    bool fModified;
+
+    std::deque<std::string> fHashQueue;
+    bool fHasherActive;
+
+   #ifdef CARLA_OS_LINUX
+    // -1 if not initialized yet, -2 if not available
+    int fInotifyFd;
+    // the same directory can be reached through different paths
+    std::multimap<int, std::string> fWatches;
+   #endif
+
+    // listings done within this time of a change cannot be trusted when polling,
+    // as the change might be within the timestamp resolution of the filesystem
+    static constexpr const int64_t kRacyChangeTime = 2000;
+
+    static water::File getIndexFile()
+    {
+        return carla_cache_directory().getChildFile("discovery-index.bin");
+    }
+
+    static water::String getChildPath(const water::String& path, const std::string& name)
+    {
+        return water::File::addTrailingSeparator(path) + name.c_str();
+    }
+
+    Entry* findEntry(const char* const filename)
+    {
+        const char* const sep = std::strrchr(filename, CARLA_OS_SEP);
+        CARLA_SAFE_ASSERT_RETURN(sep != nullptr, nullptr);
+
+        const DirectoryMap::iterator it = fDirectories.find(std::string(filename, static_cast<std::size_t>(sep - filename)));
 
-        if (std::strcmp(msg, "end") == 0)
+        if (it == fDirectories.end())
+            return nullptr;
+
+        std::vector<Entry>& entries(it->second.entries);
+        const std::vector<Entry>::iterator ite = std::lower_bound(entries.begin(), entries.end(), sep + 1, compareName);
+
+        return ite != entries.end() && ite->name == sep + 1 ? &*ite : nullptr;
+    }
+
+    static bool compareName(const Entry& entry, const char* const name) noexcept
+    {
+        return std::strcmp(entry.name.c_str(), name) < 0;
+    }
+
+    void findInDirectory(std::vector<water::File>& results,
+                         const water::String& path,
+                         const int whatToLookFor,
+                         const char* const wildcard,
+                         const BinaryType btype,
+                         const int64_t now)
+    {
+        using water::File;
+        using water::String;
+
+        Directory& directory(fDirectories[path.toRawUTF8()]);
+        const bool checkStamps = refreshDirectory(path, directory, now);
+        const bool contentHash = CarlaPluginDiscoveryOptions::getInstance().contentHash;
+
+        for (std::vector<Entry>::iterator it = directory.entries.begin(); it != directory.entries.end(); ++it)
         {
-            const char* _;
-            readNextLineAsString(_, false);
+            Entry& entry(*it);
+
+            if ((whatToLookFor & File::ignoreHiddenFiles) != 0 && entry.name[0] == '.')
+                continue;
+
+            const String childPath(getChildPath(path, entry.name));
+            const bool matches = (whatToLookFor & (entry.isDirectory ? File::findDirectories : File::findFiles)) != 0
+                               && String(entry.name.c_str()).matchesWildcard(wildcard,
+                                                                             ! File::areFileNamesCaseSensitive());
+
+            if (entry.isDirectory)
+            {
+                // bundle type depends on its contents, so it is checked after them
+                const std::size_t position = results.size();
+
+                findInDirectory(results, childPath, whatToLookFor, wildcard, btype, now);
+
+                if (matches)
+                {
+                    if (btype != CB::BINARY_NONE)
+                    {
+                        Directory& bundle(fDirectories[childPath.toRawUTF8()]);
+
+                        if (bundle.btype == CB::BINARY_NONE)
+                        {
+                            bundle.btype = CB::getBinaryTypeFromFile(childPath.toRawUTF8());
+                            fModified = true;
+                        }
+
+                        if (bundle.btype != btype)
+                            continue;
+                    }
 
-            if (fNextInfo.label == nullptr)
-                fNextInfo.label = gPluginsDiscoveryNullCharPtr;
+                    results.insert(results.begin() + static_cast<std::ptrdiff_t>(position), File(childPath.toRawUTF8()));
+                }
+
+                continue;
+            }
 
-            if (fNextInfo.metadata.maker == nullptr)
-                fNextInfo.metadata.maker = gPluginsDiscoveryNullCharPtr;
+            if (! matches)
+                continue;
 
-            if (fNextInfo.metadata.name == nullptr)
-                fNextInfo.metadata.name = gPluginsDiscoveryNullCharPtr;
+            const File file(childPath.toRawUTF8());
 
-            if (fBinaries.empty())
+            if (checkStamps || entry.mtime == 0)
             {
-                char* filename = nullptr;
+                const int64_t size = file.getSize();
+                const int64_t mtime = file.getLastModificationTime();
 
-                if (fPluginType == CB::PLUGIN_LV2)
+                if (entry.size != size || entry.mtime != mtime)
                 {
-                    do {
-                        const char* const slash = std::strchr(fNextLabel, CARLA_OS_SEP);
-                        CARLA_SAFE_ASSERT_BREAK(slash != nullptr);
-                        filename = strdup(fNextLabel);
-                        filename[slash - fNextLabel] = '\0';
-                        fNextInfo.filename = filename;
-                        fNextInfo.label = slash + 1;
-                    } while (false);
+                    entry.size = size;
+                    entry.mtime = mtime;
+                    entry.btype = CB::BINARY_NONE;
+                    entry.contentHash.clear();
+                    fModified = true;
                 }
+            }
 
-                fNextInfo.ptype = fPluginType;
-                fDiscoveryCallback(fCallbackPtr, &fNextInfo, nullptr);
+            if (btype != CB::BINARY_NONE)
+            {
+                if (entry.btype == CB::BINARY_NONE)
+                {
+                    entry.btype = CB::getBinaryTypeFromFile(childPath.toRawUTF8());
+                    fModified = true;
+                }
 
-                std::free(filename);
+                if (entry.btype != btype)
+                    continue;
             }
-            else
+
+            results.push_back(file);
+
+            if (contentHash && entry.contentHash.empty() && ! entry.hashPending)
             {
-                CARLA_SAFE_ASSERT(fNextSha1Sum.isNotEmpty());
-                const water::String filename(fBinaries[fBinaryIndex].getFullPathName());
-                fNextInfo.filename = filename.toRawUTF8();
-                fNextInfo.ptype = fPluginType;
-                fPluginsFoundInBinary = true;
-                carla_stdout("Found %s from %s", fNextInfo.metadata.name, fNextInfo.filename);
-                fDiscoveryCallback(fCallbackPtr, &fNextInfo, fNextSha1Sum);
+                entry.hashPending = true;
+                fHashQueue.push_back(childPath.toRawUTF8());
             }
+        }
+    }
 
-            std::free(fNextLabel);
-            fNextLabel = nullptr;
+    // returns true if the entries need their size and modification time checked
+    bool refreshDirectory(const water::String& path, Directory& directory, const int64_t now)
+    {
+       #ifdef CARLA_OS_LINUX
+        // nothing happened since last time
+        if (directory.watch >= 0 && ! directory.dirty)
+            return false;
 
-            std::free(fNextMaker);
-            fNextMaker = nullptr;
+        // watch before listing, so changes made while listing are not missed
+        if (directory.watch < 0)
+            addWatch(path, directory);
+       #endif
 
-            std::free(fNextName);
-            fNextName = nullptr;
+        const int64_t mtime = water::File(path.toRawUTF8()).getLastModificationTime();
 
-            return true;
-        }
+        if (directory.dirty || directory.mtime != mtime)
+            listDirectory(path, directory, mtime);
 
-        if (std::strcmp(msg, "build") == 0)
-        {
-            uint8_t btype = 0;
-            readNextLineAsByte(btype);
-            fNextInfo.btype = static_cast<BinaryType>(btype);
-            return true;
-        }
+        directory.dirty = directory.watch < 0 && mtime != 0 && now - mtime < kRacyChangeTime;
+        return true;
+    }
 
-        if (std::strcmp(msg, "hints") == 0)
-        {
-            readNextLineAsUInt(fNextInfo.metadata.hints);
-            return true;
-        }
+    void listDirectory(const water::String& path, Directory& directory, const int64_t mtime)
+    {
+        using water::File;
 
-        if (std::strcmp(msg, "category") == 0)
-        {
-            const char* category = nullptr;
-            readNextLineAsString(category, false);
-            fNextInfo.metadata.category = CB::getPluginCategoryFromString(category);
-            return true;
-        }
+        std::vector<Entry> entries;
+        bool isDirectory;
 
-        if (std::strcmp(msg, "name") == 0)
+        if (mtime != 0)
         {
-            fNextInfo.metadata.name = fNextName = readNextLineAsString();
-            return true;
-        }
+            for (water::DirectoryIterator di(File(path.toRawUTF8()), false, "*", File::findFilesAndDirectories);
+                 di.next(&isDirectory, nullptr, nullptr);)
+            {
+                Entry entry;
+                entry.name = di.getFile().getFileName().toRawUTF8();
+                entry.isDirectory = isDirectory;
+                entries.push_back(entry);
+            }
 
-        if (std::strcmp(msg, "label") == 0)
-        {
-            fNextInfo.label = fNextLabel = readNextLineAsString();
-            return true;
+            std::sort(entries.begin(), entries.end());
         }
 
-        if (std::strcmp(msg, "maker") == 0)
+        // keep what we know about entries that are still here, their stamps get checked again
+        for (std::vector<Entry>::iterator it = directory.entries.begin(); it != directory.entries.end(); ++it)
         {
-            fNextInfo.metadata.maker = fNextMaker = readNextLineAsString();
-            return true;
-        }
+            Entry& old(*it);
+            const std::vector<Entry>::iterator ite = std::lower_bound(entries.begin(), entries.end(), old);
 
-        if (std::strcmp(msg, "uniqueId") == 0)
-        {
-            readNextLineAsULong(fNextInfo.uniqueId);
-            return true;
+            if (ite != entries.end() && ite->name == old.name && ite->isDirectory == old.isDirectory)
+            {
+                if (! old.isDirectory)
+                    std::swap(*ite, old);
+            }
+            else if (old.isDirectory)
+            {
+                removeDirectory(getChildPath(path, old.name));
+            }
         }
 
-        if (std::strcmp(msg, "audio.ins") == 0)
+        directory.entries.swap(entries);
+        directory.mtime = mtime;
+        directory.btype = CB::BINARY_NONE;
+        fModified = true;
+
+        // bundles containing this directory need their binary type checked again
+        for (water::String parent = File(path.toRawUTF8()).getParentDirectory().getFullPathName();;)
         {
-            readNextLineAsUInt(fNextInfo.io.audioIns);
-            return true;
+            const DirectoryMap::iterator it = fDirectories.find(parent.toRawUTF8());
+
+            if (it == fDirectories.end())
+                break;
+
+            it->second.btype = CB::BINARY_NONE;
+
+            const water::String next(File(parent.toRawUTF8()).getParentDirectory().getFullPathName());
+
+            if (next == parent)
+                break;
+
+            parent = next;
         }
+    }
+
+    void removeDirectory(const water::String& path)
+    {
+        const std::string key(path.toRawUTF8());
+        const std::string prefix(water::File::addTrailingSeparator(path).toRawUTF8());
 
-        if (std::strcmp(msg, "audio.outs") == 0)
+        for (DirectoryMap::iterator it = fDirectories.lower_bound(key); it != fDirectories.end();)
         {
-            readNextLineAsUInt(fNextInfo.io.audioOuts);
-            return true;
+            if (it->first != key && it->first.compare(0, prefix.size(), prefix) != 0)
+                break;
+
+           #ifdef CARLA_OS_LINUX
+            removeWatch(it->first, it->second);
+           #endif
+            fDirectories.erase(it++);
         }
+    }
+
+    void loadIfNeeded()
+    {
+        if (fLoaded)
+            return;
+
+        fLoaded = true;
 
-        if (std::strcmp(msg, "cv.ins") == 0)
+        CarlaMappedFile mappedFile;
+
+        if (! mappedFile.map(getIndexFile().getFullPathName().toRawUTF8()))
+            return;
+
+        CarlaCacheReader reader(mappedFile.getData(), mappedFile.getSize());
+        uint32_t magic, version, carlaVersion, count;
+
+        if (! (reader.readUInt(magic) && magic == kDiscoveryIndexMagic &&
+               reader.readUInt(version) && version == kDiscoveryIndexVersion &&
+               reader.readUInt(carlaVersion) && carlaVersion == CARLA_VERSION_HEX &&
+               reader.readUInt(count)))
+            return;
+
+        DirectoryMap directories;
+
+        for (uint32_t i = 0; i < count; ++i)
         {
-            readNextLineAsUInt(fNextInfo.io.cvIns);
-            return true;
+            const char* path;
+            uint64_t mtime;
+            uint32_t btype, numEntries;
+
+            if (! (reader.readString(path) && path != nullptr &&
+                   reader.readULong(mtime) && reader.readUInt(btype) && reader.readUInt(numEntries)))
+                return;
+
+            Directory& directory(directories[path]);
+            directory.mtime = static_cast<int64_t>(mtime);
+            directory.btype = static_cast<BinaryType>(btype);
+            directory.entries.resize(numEntries);
+
+            for (uint32_t j = 0; j < numEntries; ++j)
+            {
+                Entry& entry(directory.entries[j]);
+                const char* name;
+                const char* contentHash;
+                uint32_t isDirectory, entryType;
+                uint64_t size, entryMTime;
+
+                if (! (reader.readString(name) && name != nullptr &&
+                       reader.readUInt(isDirectory) && reader.readUInt(entryType) &&
+                       reader.readULong(size) && reader.readULong(entryMTime) &&
+                       reader.readString(contentHash) && contentHash != nullptr))
+                    return;
+
+                entry.name = name;
+                entry.isDirectory = isDirectory != 0;
+                entry.btype = static_cast<BinaryType>(entryType);
+                entry.size = static_cast<int64_t>(size);
+                entry.mtime = static_cast<int64_t>(entryMTime);
+                entry.contentHash = contentHash;
+            }
         }
 
-        if (std::strcmp(msg, "cv.outs") == 0)
+        fDirectories.swap(directories);
+    }
+
+   #ifdef CARLA_OS_LINUX
+    void addWatch(const water::String& path, Directory& directory)
+    {
+        if (fInotifyFd == -1)
         {
-            readNextLineAsUInt(fNextInfo.io.cvOuts);
-            return true;
+            fInotifyFd = ::inotify_init1(IN_NONBLOCK|IN_CLOEXEC);
+
+            if (fInotifyFd < 0)
+            {
+                carla_stderr2("inotify is not available, plugin directories will be polled instead");
+                fInotifyFd = -2;
+            }
         }
 
-        if (std::strcmp(msg, "midi.ins") == 0)
+        if (fInotifyFd < 0)
+            return;
+
+        // directories that do not exist yet or exceed the watch limit are polled instead
+        directory.watch = ::inotify_add_watch(fInotifyFd, path.toRawUTF8(),
+                                              IN_CREATE|IN_DELETE|IN_MOVED_FROM|IN_MOVED_TO|IN_CLOSE_WRITE|IN_ATTRIB
+                                              |IN_DELETE_SELF|IN_MOVE_SELF|IN_ONLYDIR);
+
+        if (directory.watch >= 0)
+            fWatches.insert(std::make_pair(directory.watch, std::string(path.toRawUTF8())));
+    }
+
+    void removeWatch(const std::string& path, Directory& directory)
+    {
+        if (directory.watch < 0)
+            return;
+
+        bool watchInUse = false;
+
+        for (std::multimap<int, std::string>::iterator it = fWatches.lower_bound(directory.watch);
+             it != fWatches.end() && it->first == directory.watch;)
         {
-            readNextLineAsUInt(fNextInfo.io.midiIns);
-            return true;
+            if (it->second == path)
+                fWatches.erase(it++);
+            else
+                watchInUse = true, ++it;
         }
 
-        if (std::strcmp(msg, "midi.outs") == 0)
+        if (! watchInUse)
+            ::inotify_rm_watch(fInotifyFd, directory.watch);
+
+        directory.watch = -1;
+    }
+
+    void processEvents()
+    {
+        if (fInotifyFd < 0)
+            return;
+
+        alignas(struct inotify_event) char buf[4096];
+
+        for (ssize_t r; (r = ::read(fInotifyFd, buf, sizeof(buf))) > 0;)
         {
-            readNextLineAsUInt(fNextInfo.io.midiOuts);
-            return true;
+            for (const char* ptr = buf; ptr < buf + r;)
+            {
+                const struct inotify_event* const event = reinterpret_cast<const struct inotify_event*>(ptr);
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                // events were lost, check everything
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    for (DirectoryMap::iterator it = fDirectories.begin(); it != fDirectories.end(); ++it)
+                        it->second.dirty = true;
+                    continue;
+                }
+
+                for (std::multimap<int, std::string>::iterator it = fWatches.lower_bound(event->wd);
+                     it != fWatches.end() && it->first == event->wd;)
+                {
+                    const DirectoryMap::iterator itd = fDirectories.find(it->second);
+
+                    if (itd != fDirectories.end())
+                    {
+                        itd->second.dirty = true;
+
+                        if (event->mask & IN_IGNORED)
+                            itd->second.watch = -1;
+                    }
+
+                    if (event->mask & IN_IGNORED)
+                        fWatches.erase(it++);
+                    else
+                        ++it;
+                }
+            }
         }
+    }
+   #endif
 
-        if (std::strcmp(msg, "parameters.ins") == 0)
+    void run() override
+    {
+        for (;;)
         {
-            readNextLineAsUInt(fNextInfo.io.parameterIns);
-            return true;
+            std::string filename;
+
+            {
+                const CarlaMutexLocker cml(fMutex);
+
+                if (fHashQueue.empty() || shouldThreadExit())
+                {
+                    fHasherActive = false;
+                    break;
+                }
+
+                filename = fHashQueue.front();
+                fHashQueue.pop_front();
+            }
+
+            const std::string hash(hashFile(filename.c_str()));
+
+            const CarlaMutexLocker cml(fMutex);
+
+            if (Entry* const entry = findEntry(filename.c_str()))
+            {
+                entry->hashPending = false;
+
+                if (! hash.empty())
+                {
+                    entry->contentHash = hash;
+                    fModified = true;
+                }
+            }
         }
 
-        if (std::strcmp(msg, "parameters.outs") == 0)
+        saveIfNeeded();
+    }
+
+    std::string hashFile(const char* const filename)
+    {
+        const water::File file(filename);
+        water::FileInputStream stream(file);
+
+        if (! stream.openedOk())
+            return std::string();
+
+        CarlaSha1 sha1;
+        uint8_t block[65536];
+
+        for (int r; r = stream.read(block, sizeof(block)), r > 0;)
         {
-            readNextLineAsUInt(fNextInfo.io.parameterOuts);
-            return true;
+            if (shouldThreadExit())
+                return std::string();
+
+            sha1.write(block, r);
         }
 
-        if (std::strcmp(msg, "exiting") == 0)
+        return std::string(sha1.resultAsString());
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaPluginDiscoveryIndex)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Copy of a discovered plugin, kept until all binaries before it have been reported
+
+struct CarlaPluginDiscoveryResult {
+    BinaryType btype;
+    PluginCategory category;
+    uint hints;
+    uint64_t uniqueId;
+    uint32_t audioIns, audioOuts, cvIns, cvOuts, midiIns, midiOuts, parameterIns, parameterOuts;
+    CarlaString label, maker, name;
+
+    CarlaPluginDiscoveryResult(const CarlaPluginDiscoveryInfo& info)
+        : btype(info.btype),
+          category(info.metadata.category),
+          hints(info.metadata.hints),
+          uniqueId(info.uniqueId),
+          audioIns(info.io.audioIns),
+          audioOuts(info.io.audioOuts),
+          cvIns(info.io.cvIns),
+          cvOuts(info.io.cvOuts),
+          midiIns(info.io.midiIns),
+          midiOuts(info.io.midiOuts),
+          parameterIns(info.io.parameterIns),
+          parameterOuts(info.io.parameterOuts),
+          label(info.label),
+          maker(info.metadata.maker),
+          name(info.metadata.name) {}
+
+    void fillInfo(CarlaPluginDiscoveryInfo& info) const noexcept
+    {
+        info.btype = btype;
+        info.label = label.buffer();
+        info.uniqueId = uniqueId;
+        info.metadata.name = name.buffer();
+        info.metadata.maker = maker.buffer();
+        info.metadata.category = category;
+        info.metadata.hints = hints;
+        info.io.audioIns = audioIns;
+        info.io.audioOuts = audioOuts;
+        info.io.cvIns = cvIns;
+        info.io.cvOuts = cvOuts;
+        info.io.midiIns = midiIns;
+        info.io.midiOuts = midiOuts;
+        info.io.parameterIns = parameterIns;
+        info.io.parameterOuts = parameterOuts;
+    }
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class CarlaPluginDiscovery;
+
+// A single carla-discovery process, scanning one binary (or everything, when there are no binaries) at a time.
+// Native binaries are scanned in batch mode, where the same process receives one filename after another.
+// If it crashes or times out, only the binary being scanned is lost and a fresh process is used for the next one.
+class CarlaPluginDiscoveryWorker : private CarlaPipeServer
+{
+public:
+    static constexpr const uint kNoJob = ~0U;
+
+    // restart batch processes after this many binaries, in case plugins leak or do not unload cleanly
+    static constexpr const uint kMaxBatchScans = 100;
+
+    CarlaPluginDiscoveryWorker(CarlaPluginDiscovery& owner,
+                               const BinaryType btype,
+                               const PluginType ptype,
+                               const char* const discoveryTool)
+        : fOwner(owner),
+          fBinaryType(btype),
+          fPluginType(ptype),
+          fDiscoveryTool(discoveryTool),
+          fJobIndex(kNoJob),
+          fJobDone(false),
+          fBatchMode(false),
+          fBatchScans(0),
+          fLastMessageTime(0),
+          fNextLabel(nullptr),
+          fNextMaker(nullptr),
+          fNextName(nullptr) {}
+
+    ~CarlaPluginDiscoveryWorker()
+    {
+        stopPipeServer(5000);
+        std::free(fNextLabel);
+        std::free(fNextMaker);
+        std::free(fNextName);
+    }
+
+    uint getJobIndex() const noexcept
+    {
+        return fJobIndex;
+    }
+
+    bool isBusy() const noexcept
+    {
+        return fJobIndex != kNoJob;
+    }
+
+    // start scanning @a filename, or everything if null
+    // returns false if the discovery process could not be started, the job is then done
+    bool start(const uint jobIndex, const char* const filename);
+
+    // returns false once the current job is done
+    bool idle()
+    {
+        CARLA_SAFE_ASSERT_RETURN(fJobIndex != kNoJob, false);
+
+        if (isPipeRunning())
         {
+            idlePipe();
+
+            // batch process is kept alive for the next binary
+            if (fJobDone)
+            {
+                fJobIndex = kNoJob;
+                return false;
+            }
+
+            // crashed while scanning, a fresh process is started for the next binary
+            if (hasClientExited())
+            {
+                // take anything written before it went away
+                idlePipe();
+
+                carla_stdout("Discovery process terminated unexpectedly, skipping...");
+                stopPipeServer(1000);
+                fJobIndex = kNoJob;
+                return false;
+            }
+
+            // automatically skip a plugin if 30s passes without a reply
+            const uint32_t timeNow = carla_gettime_ms();
+
+            if (timeNow - fLastMessageTime < 30000)
+                return true;
+
+            carla_stdout("Plugin took too long to respond, skipping...");
             stopPipeServer(1000);
-            return true;
         }
 
-        carla_stdout("discovery: unknown message '%s' received", msg);
-        return true;
+        fJobIndex = kNoJob;
+        return false;
     }
 
+    void skip()
+    {
+        if (isPipeRunning())
+            stopPipeServer(1000);
+    }
+
+protected:
+    bool msgReceived(const char* const msg) noexcept override;
+
 private:
+    bool sendBatchFilename(const char* filename);
+
+    CarlaPluginDiscovery& fOwner;
     const BinaryType fBinaryType;
     const PluginType fPluginType;
-    const CarlaPluginDiscoveryCallback fDiscoveryCallback;
-    const CarlaPluginCheckCacheCallback fCheckCacheCallback;
-    void* const fCallbackPtr;
-    const char* fPluginPath;
-
-    bool fPluginsFoundInBinary;
-    uint fBinaryIndex;
-    const uint fBinaryCount;
-    const std::vector<water::File> fBinaries;
     const CarlaString fDiscoveryTool;
 
+    uint fJobIndex;
+    bool fJobDone;
+    bool fBatchMode;
+    uint fBatchScans;
     uint32_t fLastMessageTime;
 
     CarlaPluginDiscoveryInfo fNextInfo;
-    CarlaString fNextSha1Sum;
     char* fNextLabel;
     char* fNextMaker;
     char* fNextName;
 
-    void start()
+    CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginDiscoveryWorker)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+// Runs several discovery workers concurrently.
+// Each binary is scanned in its own process as before, so crashes and timeouts only affect that binary.
+// Results are reported in binary order regardless of which worker finishes first.
+class CarlaPluginDiscovery
+{
+public:
+    CarlaPluginDiscovery(const char* const discoveryTool,
+                         const BinaryType btype,
+                         const PluginType ptype,
+                         const std::vector<water::File>&& binaries,
+                         const CarlaPluginDiscoveryCallback discoveryCb,
+                         const CarlaPluginCheckCacheCallback checkCacheCb,
+                         void* const callbackPtr)
+        : fBinaryType(btype),
+          fPluginType(ptype),
+          fDiscoveryCallback(discoveryCb),
+          fCheckCacheCallback(checkCacheCb),
+          fCallbackPtr(callbackPtr),
+          fPluginPath(nullptr),
+          fBinaryCount(static_cast<uint>(binaries.size())),
+          fBinaries(binaries),
+          fJobs(fBinaryCount),
+          fNextJob(0),
+          fNextReport(0),
+          fWorkers(),
+          fUseContentHash(CarlaPluginDiscoveryOptions::getInstance().contentHash),
+          fContentHashes()
     {
-        using water::File;
-        using water::String;
+        createWorkers(discoveryTool);
+        idle();
+    }
+
+    CarlaPluginDiscovery(const char* const discoveryTool,
+                         const BinaryType btype,
+                         const PluginType ptype,
+                         const CarlaPluginDiscoveryCallback discoveryCb,
+                         const CarlaPluginCheckCacheCallback checkCacheCb,
+                         void* const callbackPtr,
+                         const char* const pluginPath = nullptr)
+        : fBinaryType(btype),
+          fPluginType(ptype),
+          fDiscoveryCallback(discoveryCb),
+          fCheckCacheCallback(checkCacheCb),
+          fCallbackPtr(callbackPtr),
+          fPluginPath(pluginPath != nullptr ? carla_strdup_safe(pluginPath) : nullptr),
+          fBinaryCount(1),
+          fBinaries(),
+          fJobs(1),
+          fNextJob(0),
+          fNextReport(0),
+          fWorkers(),
+          fUseContentHash(CarlaPluginDiscoveryOptions::getInstance().contentHash),
+          fContentHashes()
+    {
+        createWorkers(discoveryTool);
+        idle();
+    }
+
+    ~CarlaPluginDiscovery()
+    {
+        for (std::vector<CarlaPluginDiscoveryWorker*>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+            delete *it;
+
+        delete[] fPluginPath;
+    }
+
+    bool idle()
+    {
+        for (std::vector<CarlaPluginDiscoveryWorker*>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+        {
+            CarlaPluginDiscoveryWorker* const worker = *it;
+
+            if (worker->isBusy())
+            {
+                const uint jobIndex = worker->getJobIndex();
+
+                if (worker->idle())
+                    continue;
 
-        fLastMessageTime = carla_gettime_ms();
-        fPluginsFoundInBinary = false;
-        fNextSha1Sum.clear();
+                fJobs[jobIndex].finished = true;
+            }
+
+            // give this worker the next binary that is not cached
+            while (fNextJob < fBinaryCount)
+            {
+                // content hash of the next binary is still being computed in the background
+                if (isContentHashPending(fNextJob))
+                    break;
+
+                const uint jobIndex = fNextJob++;
+
+                if (! prepareJob(jobIndex))
+                    continue;
+
+                const water::String filename(fBinaries.empty() ? water::String()
+                                                               : fBinaries[jobIndex].getFullPathName());
+
+                if (worker->start(jobIndex, fBinaries.empty() ? nullptr : filename.toRawUTF8()))
+                    break;
+
+                fJobs[jobIndex].finished = true;
+            }
+        }
+
+        reportFinishedJobs();
+
+        return fNextReport < fBinaryCount;
+    }
+
+    // skip the oldest binary still being scanned, which is the one holding back results
+    void skip()
+    {
+        CarlaPluginDiscoveryWorker* oldest = nullptr;
+
+        for (std::vector<CarlaPluginDiscoveryWorker*>::iterator it = fWorkers.begin(); it != fWorkers.end(); ++it)
+        {
+            CarlaPluginDiscoveryWorker* const worker = *it;
+
+            if (worker->isBusy() && (oldest == nullptr || worker->getJobIndex() < oldest->getJobIndex()))
+                oldest = worker;
+        }
+
+        if (oldest != nullptr)
+            oldest->skip();
+    }
+
+    void getProgress(uint* const scanned, uint* const total) const noexcept
+    {
+        if (scanned != nullptr)
+            *scanned = fNextReport;
+        if (total != nullptr)
+            *total = fBinaryCount;
+    }
 
-       #ifndef CARLA_OS_WIN
-        const CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
+    // called by workers for each plugin found
+    void pluginFound(const uint jobIndex, CarlaPluginDiscoveryInfo& info, const char* const label)
+    {
+        CARLA_SAFE_ASSERT_UINT2_RETURN(jobIndex < fBinaryCount, jobIndex, fBinaryCount,);
 
-        String helperTool;
+        Job& job(fJobs[jobIndex]);
 
-        switch (fBinaryType)
+        if (fBinaries.empty())
         {
-        case CB::BINARY_WIN32:
-            if (options.wine.executable.isNotEmpty())
-                helperTool = options.wine.executable.buffer();
-            else
-                helperTool = "wine";
-            break;
+            char* filename = nullptr;
 
-        case CB::BINARY_WIN64:
-            if (options.wine.executable.isNotEmpty())
-            {
-                helperTool = options.wine.executable.buffer();
-
-                if (helperTool.isNotEmpty() && helperTool[0] == CARLA_OS_SEP && File(String(helperTool + "64").toRawUTF8()).existsAsFile())
-                    helperTool += "64";
-            }
-            else
+            if (fPluginType == CB::PLUGIN_LV2)
             {
-                helperTool = "wine";
+                do {
+                    const char* const slash = std::strchr(label, CARLA_OS_SEP);
+                    CARLA_SAFE_ASSERT_BREAK(slash != nullptr);
+                    filename = strdup(label);
+                    filename[slash - label] = '\0';
+                    info.filename = filename;
+                    info.label = slash + 1;
+                } while (false);
             }
-            break;
 
-        default:
-            break;
+            info.ptype = fPluginType;
+            fDiscoveryCallback(fCallbackPtr, &info, nullptr);
+
+            std::free(filename);
+            return;
         }
 
-        String winePrefix;
+        job.pluginsFound = true;
 
-        if (options.wine.autoPrefix && !fBinaries.empty())
+        // not our turn yet, keep a copy until all binaries before this one are reported
+        if (jobIndex != fNextReport)
         {
-            const File file(fBinaries[fBinaryIndex]);
-            const String filename(file.getFullPathName());
-
-            winePrefix = findWinePrefix(filename);
+            job.results.push_back(CarlaPluginDiscoveryResult(info));
+            return;
         }
 
-        if (winePrefix.isEmpty())
-        {
-            const char* const envWinePrefix = std::getenv("WINEPREFIX");
+        reportPlugin(jobIndex, info);
+    }
 
-            if (envWinePrefix != nullptr && envWinePrefix[0] != '\0')
-                winePrefix = envWinePrefix;
-            else if (options.wine.fallbackPrefix.isNotEmpty())
-                winePrefix = options.wine.fallbackPrefix.buffer();
-            else
-                winePrefix = File::getSpecialLocation(File::userHomeDirectory).getFullPathName() + "/.wine";
-        }
+private:
+    struct Job {
+        bool finished;
+        bool pluginsFound;
+        CarlaString sha1sum;
+        std::vector<CarlaPluginDiscoveryResult> results;
+
+        Job() noexcept
+            : finished(false),
+              pluginsFound(false),
+              sha1sum(),
+              results() {}
+    };
 
-        const CarlaScopedEnvVar sev1("WINEDEBUG", "-all");
-        const CarlaScopedEnvVar sev2("WINEPREFIX", winePrefix.toRawUTF8());
-       #endif
+    const BinaryType fBinaryType;
+    const PluginType fPluginType;
+    const CarlaPluginDiscoveryCallback fDiscoveryCallback;
+    const CarlaPluginCheckCacheCallback fCheckCacheCallback;
+    void* const fCallbackPtr;
+    const char* fPluginPath;
+
+    const uint fBinaryCount;
+    const std::vector<water::File> fBinaries;
+    std::vector<Job> fJobs;
+    uint fNextJob;
+    uint fNextReport;
+
+    std::vector<CarlaPluginDiscoveryWorker*> fWorkers;
+
+    const bool fUseContentHash;
+    std::set<std::string> fContentHashes;
+
+    void createWorkers(const char* const discoveryTool)
+    {
+        const uint count = std::max(1U, std::min(fBinaryCount,
+                                                 CarlaPluginDiscoveryOptions::getInstance().getWorkerCount()));
+
+        fWorkers.reserve(count);
+
+        for (uint i=0; i<count; ++i)
+            fWorkers.push_back(new CarlaPluginDiscoveryWorker(*this, fBinaryType, fPluginType, discoveryTool));
+    }
 
-        const CarlaScopedEnvVar sev3("CARLA_DISCOVERY_NO_PROCESSING_CHECKS", "1");
+    // returns false if the job does not need a discovery process, either cached or reported directly
+    bool prepareJob(const uint jobIndex)
+    {
+        Job& job(fJobs[jobIndex]);
 
         if (fBinaries.empty())
         {
@@ -518,69 +1242,112 @@ private:
                             std::free(filename);
                         }
                     }
-                    return;
+                    job.finished = true;
+                    return false;
                 }
             }
 
-           #ifndef CARLA_OS_WIN
-            if (helperTool.isNotEmpty())
-                startPipeServer(helperTool.toRawUTF8(), fDiscoveryTool, getPluginTypeAsString(fPluginType), ":all", -1, 2000);
-            else
-           #endif
-                startPipeServer(fDiscoveryTool, getPluginTypeAsString(fPluginType), ":all", -1, 2000);
+            return true;
         }
-        else
+
+        const water::File file(fBinaries[jobIndex]);
+        const water::String filename(file.getFullPathName());
+
+        if (fCheckCacheCallback != nullptr)
         {
-            const File file(fBinaries[fBinaryIndex]);
-            const String filename(file.getFullPathName());
+            job.sha1sum = makeHash(file, filename);
 
-            if (fCheckCacheCallback != nullptr)
+            if (fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), job.sha1sum))
             {
-                makeHash(file, filename);
+                job.pluginsFound = true;
+                job.finished = true;
+                carla_debug("Skipping \"%s\", using cache", filename.toRawUTF8());
+                return false;
+            }
+        }
+
+        carla_stdout("Scanning \"%s\"...", filename.toRawUTF8());
+        return true;
+    }
+
+    void reportPlugin(const uint jobIndex, CarlaPluginDiscoveryInfo& info)
+    {
+        const Job& job(fJobs[jobIndex]);
+        CARLA_SAFE_ASSERT(fCheckCacheCallback == nullptr || job.sha1sum.isNotEmpty());
+
+        const water::String filename(fBinaries[jobIndex].getFullPathName());
+        info.filename = filename.toRawUTF8();
+        info.ptype = fPluginType;
+        carla_stdout("Found %s from %s", info.metadata.name, info.filename);
+        fDiscoveryCallback(fCallbackPtr, &info, job.sha1sum);
+    }
 
-                if (fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), fNextSha1Sum))
+    // report results of finished binaries in order, stopping at the first one still being scanned
+    void reportFinishedJobs()
+    {
+        for (; fNextReport < fBinaryCount; ++fNextReport)
+        {
+            Job& job(fJobs[fNextReport]);
+
+            if (! fBinaries.empty())
+            {
+                for (std::vector<CarlaPluginDiscoveryResult>::const_iterator it = job.results.begin();
+                     it != job.results.end(); ++it)
                 {
-                    fPluginsFoundInBinary = true;
-                    carla_debug("Skipping \"%s\", using cache", filename.toRawUTF8());
-                    return;
+                    CarlaPluginDiscoveryInfo info;
+                    it->fillInfo(info);
+                    reportPlugin(fNextReport, info);
                 }
+
+                job.results.clear();
             }
 
-            carla_stdout("Scanning \"%s\"...", filename.toRawUTF8());
+            if (! job.finished)
+                break;
 
-           #ifndef CARLA_OS_WIN
-            if (helperTool.isNotEmpty())
-                startPipeServer(helperTool.toRawUTF8(), fDiscoveryTool, getPluginTypeAsString(fPluginType), filename.toRawUTF8(), -1, 2000);
-            else
-           #endif
-                startPipeServer(fDiscoveryTool, getPluginTypeAsString(fPluginType), filename.toRawUTF8(), -1, 2000);
+            // report binary as having no plugins
+            if (fCheckCacheCallback != nullptr && !job.pluginsFound && !fBinaries.empty())
+            {
+                const water::String filename(fBinaries[fNextReport].getFullPathName());
+
+                if (! fCheckCacheCallback(fCallbackPtr, filename.toRawUTF8(), job.sha1sum))
+                    fDiscoveryCallback(fCallbackPtr, nullptr, job.sha1sum);
+            }
         }
     }
 
-    void makeHash(const water::File& file, const water::String& filename)
+    bool isContentHashPending(const uint jobIndex)
+    {
+        if (fBinaries.empty() || fCheckCacheCallback == nullptr || ! fUseContentHash)
+            return false;
+
+        CarlaString contentHash;
+        return CarlaPluginDiscoveryIndex::getInstance().getContentHash(fBinaries[jobIndex], contentHash)
+            == CarlaPluginDiscoveryIndex::kHashPending;
+    }
+
+    CarlaString makeHash(const water::File& file, const water::String& filename)
     {
+        CarlaPluginDiscoveryIndex& index(CarlaPluginDiscoveryIndex::getInstance());
+        CarlaString contentHash;
         CarlaSha1 sha1;
 
-        /* do we want this? it is not exactly needed and makes discovery slow..
-        if (file.existsAsFile() && file.getSize() < 20*1024*1024) // dont bother hashing > 20Mb files
+        // identical copies of a binary cannot share a cache entry, only the first one is identified by contents
+        if (fUseContentHash
+            && index.getContentHash(file, contentHash) == CarlaPluginDiscoveryIndex::kHashReady
+            && fContentHashes.insert(contentHash.buffer()).second)
         {
-            water::FileInputStream stream(file);
-
-            if (stream.openedOk())
-            {
-                uint8_t block[8192];
-                for (int r; r = stream.read(block, sizeof(block)), r > 0;)
-                    sha1.write(block, r);
-            }
+            sha1.write(contentHash.buffer(), contentHash.length());
         }
-        */
-
-        sha1.write(filename.toRawUTF8(), filename.length());
+        else
+        {
+            sha1.write(filename.toRawUTF8(), filename.length());
 
-        const int64_t mtime = file.getLastModificationTime();
-        sha1.write(&mtime, sizeof(mtime));
+            const int64_t mtime = index.getModificationTime(file);
+            sha1.write(&mtime, sizeof(mtime));
+        }
 
-        fNextSha1Sum = sha1.resultAsString();
+        return CarlaString(sha1.resultAsString());
     }
 
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPluginDiscovery)
@@ -588,6 +1355,291 @@ private:
 
 // --------------------------------------------------------------------------------------------------------------------
 
+bool CarlaPluginDiscoveryWorker::start(const uint jobIndex, const char* const filename)
+{
+    using water::File;
+    using water::String;
+
+    CARLA_SAFE_ASSERT_RETURN(fJobIndex == kNoJob, false);
+
+    fJobIndex = jobIndex;
+    fJobDone = false;
+    fLastMessageTime = carla_gettime_ms();
+
+    if (isPipeRunning())
+    {
+        if (fBatchMode && fBatchScans < kMaxBatchScans && filename != nullptr)
+            return sendBatchFilename(filename);
+
+        stopPipeServer(1000);
+    }
+
+   #ifndef CARLA_OS_WIN
+    const CarlaPluginDiscoveryOptions& options(CarlaPluginDiscoveryOptions::getInstance());
+
+    String helperTool;
+
+    switch (fBinaryType)
+    {
+    case CB::BINARY_WIN32:
+        if (options.wine.executable.isNotEmpty())
+            helperTool = options.wine.executable.buffer();
+        else
+            helperTool = "wine";
+        break;
+
+    case CB::BINARY_WIN64:
+        if (options.wine.executable.isNotEmpty())
+        {
+            helperTool = options.wine.executable.buffer();
+
+            if (helperTool.isNotEmpty() && helperTool[0] == CARLA_OS_SEP && File(String(helperTool + "64").toRawUTF8()).existsAsFile())
+                helperTool += "64";
+        }
+        else
+        {
+            helperTool = "wine";
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    String winePrefix;
+
+    if (options.wine.autoPrefix && filename != nullptr)
+        winePrefix = findWinePrefix(filename);
+
+    if (winePrefix.isEmpty())
+    {
+        const char* const envWinePrefix = std::getenv("WINEPREFIX");
+
+        if (envWinePrefix != nullptr && envWinePrefix[0] != '\0')
+            winePrefix = envWinePrefix;
+        else if (options.wine.fallbackPrefix.isNotEmpty())
+            winePrefix = options.wine.fallbackPrefix.buffer();
+        else
+            winePrefix = File::getSpecialLocation(File::userHomeDirectory).getFullPathName() + "/.wine";
+    }
+
+    const CarlaScopedEnvVar sev1("WINEDEBUG", "-all");
+    const CarlaScopedEnvVar sev2("WINEPREFIX", winePrefix.toRawUTF8());
+   #endif
+
+    const CarlaScopedEnvVar sev3("CARLA_DISCOVERY_NO_PROCESSING_CHECKS", "1");
+
+    // discovery tools running under wine cannot receive messages, so they always scan a single binary
+   #ifndef CARLA_OS_WIN
+    fBatchMode = filename != nullptr && helperTool.isEmpty();
+   #else
+    fBatchMode = filename != nullptr;
+   #endif
+    fBatchScans = 0;
+
+    const char* const arg2 = fBatchMode ? ":batch" : filename != nullptr ? filename : ":all";
+    bool started;
+
+   #ifndef CARLA_OS_WIN
+    if (helperTool.isNotEmpty())
+        started = startPipeServer(helperTool.toRawUTF8(), fDiscoveryTool, getPluginTypeAsString(fPluginType), arg2, -1, 2000);
+    else
+   #endif
+        started = startPipeServer(fDiscoveryTool, getPluginTypeAsString(fPluginType), arg2, -1, 2000);
+
+    if (started && fBatchMode)
+        started = sendBatchFilename(filename);
+
+    if (! started)
+        fJobIndex = kNoJob;
+
+    return started;
+}
+
+bool CarlaPluginDiscoveryWorker::sendBatchFilename(const char* const filename)
+{
+    bool sent;
+
+    {
+        const CarlaMutexLocker cml(getPipeLock());
+        sent = writeMessage("scan\n", 5) && writeAndFixMessage(filename) && syncMessages();
+    }
+
+    if (sent)
+    {
+        ++fBatchScans;
+        return true;
+    }
+
+    stopPipeServer(1000);
+    fJobIndex = kNoJob;
+    return false;
+}
+
+bool CarlaPluginDiscoveryWorker::msgReceived(const char* const msg) noexcept
+{
+    fLastMessageTime = carla_gettime_ms();
+
+    if (std::strcmp(msg, "warning") == 0 || std::strcmp(msg, "error") == 0 || std::strcmp(msg, "info") == 0)
+    {
+        const char* text = nullptr;
+        readNextLineAsString(text, false);
+        carla_stdout("discovery: %s", text);
+        return true;
+    }
+
+    if (std::strcmp(msg, "init") == 0)
+    {
+        const char* _;
+        readNextLineAsString(_, false);
+        new (&fNextInfo) _CarlaPluginDiscoveryInfo();
+        return true;
+    }
+
+    if (std::strcmp(msg, "end") == 0)
+    {
+        const char* _;
+        readNextLineAsString(_, false);
+
+        if (fNextInfo.label == nullptr)
+            fNextInfo.label = gPluginsDiscoveryNullCharPtr;
+
+        if (fNextInfo.metadata.maker == nullptr)
+            fNextInfo.metadata.maker = gPluginsDiscoveryNullCharPtr;
+
+        if (fNextInfo.metadata.name == nullptr)
+            fNextInfo.metadata.name = gPluginsDiscoveryNullCharPtr;
+
+        try {
+            fOwner.pluginFound(fJobIndex, fNextInfo, fNextLabel != nullptr ? fNextLabel : gPluginsDiscoveryNullCharPtr);
+        } CARLA_SAFE_EXCEPTION("pluginFound");
+
+        std::free(fNextLabel);
+        fNextLabel = nullptr;
+
+        std::free(fNextMaker);
+        fNextMaker = nullptr;
+
+        std::free(fNextName);
+        fNextName = nullptr;
+
+        return true;
+    }
+
+    if (std::strcmp(msg, "build") == 0)
+    {
+        uint8_t btype = 0;
+        readNextLineAsByte(btype);
+        fNextInfo.btype = static_cast<BinaryType>(btype);
+        return true;
+    }
+
+    if (std::strcmp(msg, "hints") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.metadata.hints);
+        return true;
+    }
+
+    if (std::strcmp(msg, "category") == 0)
+    {
+        const char* category = nullptr;
+        readNextLineAsString(category, false);
+        fNextInfo.metadata.category = CB::getPluginCategoryFromString(category);
+        return true;
+    }
+
+    if (std::strcmp(msg, "name") == 0)
+    {
+        fNextInfo.metadata.name = fNextName = readNextLineAsString();
+        return true;
+    }
+
+    if (std::strcmp(msg, "label") == 0)
+    {
+        fNextInfo.label = fNextLabel = readNextLineAsString();
+        return true;
+    }
+
+    if (std::strcmp(msg, "maker") == 0)
+    {
+        fNextInfo.metadata.maker = fNextMaker = readNextLineAsString();
+        return true;
+    }
+
+    if (std::strcmp(msg, "uniqueId") == 0)
+    {
+        readNextLineAsULong(fNextInfo.uniqueId);
+        return true;
+    }
+
+    if (std::strcmp(msg, "audio.ins") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.audioIns);
+        return true;
+    }
+
+    if (std::strcmp(msg, "audio.outs") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.audioOuts);
+        return true;
+    }
+
+    if (std::strcmp(msg, "cv.ins") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.cvIns);
+        return true;
+    }
+
+    if (std::strcmp(msg, "cv.outs") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.cvOuts);
+        return true;
+    }
+
+    if (std::strcmp(msg, "midi.ins") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.midiIns);
+        return true;
+    }
+
+    if (std::strcmp(msg, "midi.outs") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.midiOuts);
+        return true;
+    }
+
+    if (std::strcmp(msg, "parameters.ins") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.parameterIns);
+        return true;
+    }
+
+    if (std::strcmp(msg, "parameters.outs") == 0)
+    {
+        readNextLineAsUInt(fNextInfo.io.parameterOuts);
+        return true;
+    }
+
+    if (std::strcmp(msg, "done") == 0)
+    {
+        const char* _;
+        readNextLineAsString(_, false);
+        fJobDone = true;
+        return true;
+    }
+
+    if (std::strcmp(msg, "exiting") == 0)
+    {
+        stopPipeServer(1000);
+        return true;
+    }
+
+    carla_stdout("discovery: unknown message '%s' received", msg);
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
 static bool findDirectories(std::vector<water::File>& files, const char* const pluginPath, const char* const wildcard)
 {
     CARLA_SAFE_ASSERT_RETURN(pluginPath != nullptr, true);
@@ -604,18 +1656,16 @@ static bool findDirectories(std::vector<water::File>& files, const char* const p
     if (splitPaths.size() == 0)
         return true;
 
+    CarlaPluginDiscoveryIndex& index(CarlaPluginDiscoveryIndex::getInstance());
+
     for (String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
     {
         const File dir(it->toRawUTF8());
-        std::vector<File> results;
-
-        if (dir.findChildFiles(results, File::findDirectories|File::ignoreHiddenFiles, true, wildcard) > 0)
-        {
-            files.reserve(files.size() + results.size());
-            files.insert(files.end(), results.begin(), results.end());
-        }
+        index.findChildFiles(files, dir, File::findDirectories|File::ignoreHiddenFiles, wildcard, CB::BINARY_NONE);
     }
 
+    index.saveIfNeeded();
+
     return files.empty();
 }
 
@@ -636,25 +1686,16 @@ static bool findFiles(std::vector<water::File>& files,
     if (splitPaths.size() == 0)
         return true;
 
+    CarlaPluginDiscoveryIndex& index(CarlaPluginDiscoveryIndex::getInstance());
+
     for (String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
     {
         const File dir(it->toRawUTF8());
-        std::vector<File> results;
-
-        if (dir.findChildFiles(results, File::findFiles|File::ignoreHiddenFiles, true, wildcard) > 0)
-        {
-            files.reserve(files.size() + results.size());
-
-            for (std::vector<File>::const_iterator cit = results.begin(); cit != results.end(); ++cit)
-            {
-                const File file(*cit);
-
-                if (CB::getBinaryTypeFromFile(file.getFullPathName().toRawUTF8()) == btype)
-                    files.push_back(file);
-            }
-        }
+        index.findChildFiles(files, dir, File::findFiles|File::ignoreHiddenFiles, wildcard, btype);
     }
 
+    index.saveIfNeeded();
+
     return files.empty();
 }
 
@@ -675,6 +1716,8 @@ static bool findVST3s(std::vector<water::File>& files,
     if (splitPaths.size() == 0)
         return true;
 
+    CarlaPluginDiscoveryIndex& index(CarlaPluginDiscoveryIndex::getInstance());
+
     const uint flags = btype == CB::BINARY_WIN32 || btype == CB::BINARY_WIN64
                      ? File::findDirectories|File::findFiles
                      : File::findDirectories;
@@ -682,22 +1725,11 @@ static bool findVST3s(std::vector<water::File>& files,
     for (String *it = splitPaths.begin(), *end = splitPaths.end(); it != end; ++it)
     {
         const File dir(it->toRawUTF8());
-        std::vector<File> results;
-
-        if (dir.findChildFiles(results, flags|File::ignoreHiddenFiles, true, "*.vst3") > 0)
-        {
-            files.reserve(files.size() + results.size());
-
-            for (std::vector<File>::const_iterator cit = results.begin(); cit != results.end(); ++cit)
-            {
-                const File file(*cit);
-
-                if (CB::getBinaryTypeFromFile(file.getFullPathName().toRawUTF8()) == btype)
-                    files.push_back(file);
-            }
-        }
+        index.findChildFiles(files, dir, flags|File::ignoreHiddenFiles, "*.vst3", btype);
     }
 
+    index.saveIfNeeded();
+
     return files.empty();
 }
 
@@ -860,6 +1892,11 @@ void carla_plugin_discovery_stop(const CarlaPluginDiscoveryHandle handle)
     delete static_cast<CarlaPluginDiscovery*>(handle);
 }
 
+void carla_plugin_discovery_get_progress(const CarlaPluginDiscoveryHandle handle, uint* const scanned, uint* const total)
+{
+    static_cast<const CarlaPluginDiscovery*>(handle)->getProgress(scanned, total);
+}
+
 void carla_plugin_discovery_set_option(const EngineOption option, const int value, const char* const valueStr)
 {
     switch (option)
@@ -882,6 +1919,14 @@ void carla_plugin_discovery_set_option(const EngineOption option, const int valu
             CarlaPluginDiscoveryOptions::getInstance().wine.fallbackPrefix.clear();
         break;
    #endif
+    case CB::ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS:
+        CARLA_SAFE_ASSERT_RETURN(value >= 0,);
+        CarlaPluginDiscoveryOptions::getInstance().workers = static_cast<uint>(value);
+        break;
+    case CB::ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH:
+        CARLA_SAFE_ASSERT_RETURN(value == 0 || value == 1,);
+        CarlaPluginDiscoveryOptions::getInstance().contentHash = value != 0;
+        break;
     default:
         break;
     }
@@ -288,12 +288,13 @@ private:
         CARLA_SAFE_ASSERT_RETURN(ptr != nullptr,);
 
 #ifndef BUILD_BRIDGE_ALTERNATIVE_ARCH
-        // pluginId must be 0 (first), except for patchbay things
+        // only handle the first plugin, others are part of its group, except for patchbay things
         if (action < CARLA_BACKEND_NAMESPACE::ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED ||
             action > CARLA_BACKEND_NAMESPACE::ENGINE_CALLBACK_PATCHBAY_CONNECTION_REMOVED)
 #endif
         {
-            CARLA_SAFE_ASSERT_UINT_RETURN(pluginId == 0, pluginId,);
+            if (pluginId != 0)
+                return;
         }
 
         return ((CarlaBridgePlugin*)ptr)->handleCallback(action, value1, value2, value3, valuef, valueStr);
@@ -357,13 +358,7 @@ int main(int argc, char* argv[])
     // ---------------------------------------------------------------------
     // Check plugin type
 
-    CARLA_BACKEND_NAMESPACE::PluginType itype = CARLA_BACKEND_NAMESPACE::getPluginTypeFromString(stype);
-
-    if (itype == CARLA_BACKEND_NAMESPACE::PLUGIN_NONE)
-    {
-        carla_stderr("Invalid plugin type '%s'", stype);
-        return 1;
-    }
+    const CARLA_BACKEND_NAMESPACE::PluginType itype = CARLA_BACKEND_NAMESPACE::getPluginTypeFromString(stype);
 
     // ---------------------------------------------------------------------
     // Set file
@@ -385,6 +380,15 @@ int main(int argc, char* argv[])
 
     const bool useBridge = (shmIds != nullptr);
 
+    // without a plugin type, the bridge is started ahead of time and the host sends the plugin to load later
+    const bool warmStart = useBridge && itype == CARLA_BACKEND_NAMESPACE::PLUGIN_NONE;
+
+    if (itype == CARLA_BACKEND_NAMESPACE::PLUGIN_NONE && ! warmStart)
+    {
+        carla_stderr("Invalid plugin type '%s'", stype);
+        return 1;
+    }
+
     // ---------------------------------------------------------------------
     // Setup bridge ids
 
@@ -593,7 +597,12 @@ int main(int argc, char* argv[])
         // -----------------------------------------------------------------
         // Init plugin
 
-        if (carla_add_plugin(gHostHandle,
+        if (warmStart)
+        {
+            ret = 0;
+            bridge.exec(useBridge);
+        }
+        else if (carla_add_plugin(gHostHandle,
                              btype, itype,
                              file.getFullPathName().toRawUTF8(), name, label, uniqueId, extraStuff,
                              CARLA_BACKEND_NAMESPACE::PLUGIN_OPTIONS_NULL))
@@ -48,6 +48,8 @@ CarlaBridgeFormat::CarlaBridgeFormat() noexcept
 {
     carla_debug("CarlaBridgeFormat::CarlaBridgeFormat()");
 
+    setBinaryFramingAllowed(true);
+
     try {
         fToolkit = CarlaBridgeToolkit::createNew(this);
     } CARLA_SAFE_EXCEPTION_RETURN("CarlaBridgeToolkit::createNew",);
@@ -303,6 +305,49 @@ bool CarlaBridgeFormat::msgReceived(const char* const msg) noexcept
     return false;
 }
 
+bool CarlaBridgeFormat::recordReceived(const uint32_t type, const void* const data, const uint32_t size) noexcept
+{
+    carla_debug("CarlaBridgeFormat::recordReceived(%u, %p, %u)", type, data, size);
+
+    if (! fGotOptions)
+    {
+        carla_stderr2("CarlaBridgeFormat::recordReceived(%u) - invalid record while waiting for options", type);
+        return true;
+    }
+
+    if (fLastMsgTimer > 0)
+        --fLastMsgTimer;
+
+    switch (type)
+    {
+    case kCarlaPipeRecordControls: {
+        const CarlaPipeControlValue* const values = static_cast<const CarlaPipeControlValue*>(data);
+        const uint32_t count = size / sizeof(CarlaPipeControlValue);
+
+        for (uint32_t i=0; i < count; ++i)
+            dspParameterChanged(values[i].index, values[i].value);
+
+        return true;
+    }
+
+    case kCarlaPipeRecordAtom: {
+        CARLA_SAFE_ASSERT_UINT2_RETURN(size >= sizeof(uint32_t)*2 + sizeof(LV2_Atom), size, sizeof(LV2_Atom), true);
+
+        const uint32_t index = *static_cast<const uint32_t*>(data);
+        const LV2_Atom* const atom = reinterpret_cast<const LV2_Atom*>(static_cast<const uint8_t*>(data) + sizeof(uint32_t)*2);
+        const uint32_t atomTotalSize(lv2_atom_total_size(atom));
+
+        CARLA_SAFE_ASSERT_UINT2_RETURN(atomTotalSize == size - sizeof(uint32_t)*2, atomTotalSize, size, true);
+
+        dspAtomReceived(index, atom);
+        return true;
+    }
+    }
+
+    carla_stderr("CarlaBridgeFormat::recordReceived : %u", type);
+    return false;
+}
+
 // ---------------------------------------------------------------------
 
 bool CarlaBridgeFormat::init(const int argc, const char* argv[])
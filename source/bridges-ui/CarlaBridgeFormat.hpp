@@ -183,6 +183,9 @@ protected:
     /*! @internal */
     bool msgReceived(const char* msg) noexcept override;
 
+    /*! @internal */
+    bool recordReceived(uint32_t type, const void* data, uint32_t size) noexcept override;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaBridgeFormat)
 };
 
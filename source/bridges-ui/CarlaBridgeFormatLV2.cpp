@@ -19,7 +19,7 @@
 #include "CarlaBridgeToolkit.hpp"
 
 #include "CarlaLibUtils.hpp"
-#include "CarlaLv2Utils.hpp"
+#include "CarlaLv2CacheUtils.hpp"
 #include "CarlaMIDI.h"
 #include "LinkedList.hpp"
 
@@ -458,10 +458,14 @@ public:
         // ------------------------------------------------------------------------------------------------------------
         // load plugin
 
-        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
-        lv2World.initIfNeeded(std::getenv("LV2_PATH"));
+        const char* LV2_PATH = std::getenv("LV2_PATH");
+
+        if (LV2_PATH == nullptr || LV2_PATH[0] == '\0')
+            LV2_PATH = LILV_DEFAULT_LV2_PATH;
 
 #if 0
+        Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+
         Lilv::Node bundleNode(lv2World.new_file_uri(nullptr, uiBundle));
         CARLA_SAFE_ASSERT_RETURN(bundleNode.is_uri(), false);
 
@@ -474,9 +478,9 @@ public:
 #endif
 
         // ------------------------------------------------------------------------------------------------------------
-        // get plugin from lv2_rdf (lilv)
+        // get plugin from lv2_rdf (cache, or lilv if the cache is stale)
 
-        fRdfDescriptor = lv2_rdf_new(pluginURI, false);
+        fRdfDescriptor = lv2_rdf_new_cached(LV2_PATH, pluginURI, false);
         CARLA_SAFE_ASSERT_RETURN(fRdfDescriptor != nullptr, false);
 
         // ------------------------------------------------------------------------------------------------------------
@@ -89,11 +89,22 @@ static constexpr const float    kSampleRatef = 44100.0f;
 class DiscoveryPipe : public CarlaPipeClient
 {
 public:
-    DiscoveryPipe() {}
+    DiscoveryPipe()
+        : fNextFilename(nullptr) {}
 
     ~DiscoveryPipe()
     {
         writeExitingMessageAndWait();
+        std::free(fNextFilename);
+    }
+
+    // batch mode, returns the next filename received from the host or null if none yet
+    // the caller takes ownership of the returned string
+    char* takeNextFilename() noexcept
+    {
+        char* const filename = fNextFilename;
+        fNextFilename = nullptr;
+        return filename;
     }
 
     bool writeDiscoveryMessage(const char* const key, const char* const value) const noexcept
@@ -115,9 +126,20 @@ public:
 protected:
     bool msgReceived(const char* const msg) noexcept
     {
+        if (std::strcmp(msg, "scan") == 0)
+        {
+            CARLA_SAFE_ASSERT_RETURN(fNextFilename == nullptr, true);
+
+            fNextFilename = readNextLineAsString();
+            return true;
+        }
+
         carla_stdout("discovery msgReceived %s", msg);
         return true;
     }
+
+private:
+    char* fNextFilename;
 };
 #else
 class DiscoveryPipe
@@ -2838,20 +2860,10 @@ static void do_jsfx_check(const char* const filename, bool doInit)
 #endif // HAVE_YSFX
 
 // --------------------------------------------------------------------------------------------------------------------
-// main entry point
+// Check a single binary or bundle, used for both single and batch modes
 
-int main(int argc, const char* argv[])
+static int do_check(const PluginType type, const char* const filename, const char* argv[])
 {
-    if (argc != 3 && argc != 7)
-    {
-        carla_stdout("usage: %s <type> </path/to/plugin>", argv[0]);
-        return 1;
-    }
-
-    const char* const stype    = argv[1];
-    const char* const filename = argv[2];
-    const PluginType  type     = getPluginTypeFromString(stype);
-
     CarlaString filenameCheck(filename);
     filenameCheck.toLower();
 
@@ -2898,42 +2910,6 @@ int main(int argc, const char* argv[])
         return 0;
     }
 
-    // ----------------------------------------------------------------------------------------------------------------
-    // Initialize OS features
-
-    // we want stuff in English so we can parse error messages
-    ::setlocale(LC_ALL, "C");
-   #ifndef CARLA_OS_WIN
-    carla_setenv("LC_ALL", "C");
-   #endif
-
-  #ifdef CARLA_OS_WIN
-    // init win32 stuff that plugins might use
-    OleInitialize(nullptr);
-    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
-
-   #ifndef __WINPTHREADS_VERSION
-    // (non-portable) initialization of statically linked pthread library
-    pthread_win32_process_attach_np();
-    pthread_win32_thread_attach_np();
-   #endif
-
-    // do not show error message box on Windows
-    SetErrorMode(SEM_NOGPFAULTERRORBOX);
-    SetUnhandledExceptionFilter(winExceptionFilter);
-  #endif
-
-    // ----------------------------------------------------------------------------------------------------------------
-    // Initialize pipe
-
-    if (argc == 7)
-    {
-        gPipe = new DiscoveryPipe;
-
-        if (! gPipe->initPipeClient(argv))
-            return 1;
-    }
-
     // ----------------------------------------------------------------------------------------------------------------
 
     if (openLib)
@@ -2943,7 +2919,6 @@ int main(int argc, const char* argv[])
         if (handle == nullptr)
         {
             print_lib_error(filename);
-            gPipe = nullptr;
             return 1;
         }
     }
@@ -2962,7 +2937,6 @@ int main(int argc, const char* argv[])
         if (! lib_close(handle))
         {
             print_lib_error(filename);
-            gPipe = nullptr;
             return 1;
         }
 
@@ -2971,7 +2945,6 @@ int main(int argc, const char* argv[])
         if (handle == nullptr)
         {
             print_lib_error(filename);
-            gPipe = nullptr;
             return 1;
         }
     }
@@ -2980,7 +2953,6 @@ int main(int argc, const char* argv[])
     if (std::strcmp(filename, ":all") == 0)
     {
         do_cached_check(type);
-        gPipe = nullptr;
         return 0;
     }
    #endif
@@ -3077,7 +3049,14 @@ int main(int argc, const char* argv[])
         posix_spawnattr_t attr;
         posix_spawnattr_init(&attr);
         CARLA_SAFE_ASSERT_RETURN(posix_spawnattr_setbinpref_np(&attr, 1, &pref, nullptr) == 0, 1);
-        CARLA_SAFE_ASSERT_RETURN(posix_spawn(&pid, argv[0], nullptr, &attr, (char* const*)argv, nullptr) == 0, 1);
+
+        // argv might be from batch mode, re-run this single filename instead
+        const char* retryArgv[8] = { argv[0], argv[1], filename, nullptr, nullptr, nullptr, nullptr, nullptr };
+
+        if (gPipe != nullptr)
+            std::memcpy(&retryArgv[3], &argv[3], sizeof(const char*) * 4);
+
+        CARLA_SAFE_ASSERT_RETURN(posix_spawn(&pid, argv[0], nullptr, &attr, (char* const*)retryArgv, nullptr) == 0, 1);
         posix_spawnattr_destroy(&attr);
 
         if (pid > 0)
@@ -3085,9 +3064,95 @@ int main(int argc, const char* argv[])
             int status;
             waitpid(pid, &status, 0);
         }
+       #else
+        (void)argv;
        #endif
     }
 
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// main entry point
+
+int main(int argc, const char* argv[])
+{
+    if (argc != 3 && argc != 7)
+    {
+        carla_stdout("usage: %s <type> </path/to/plugin>", argv[0]);
+        return 1;
+    }
+
+    const char* const stype    = argv[1];
+    const char* const filename = argv[2];
+    const PluginType  type     = getPluginTypeFromString(stype);
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Initialize OS features
+
+    // we want stuff in English so we can parse error messages
+    ::setlocale(LC_ALL, "C");
+   #ifndef CARLA_OS_WIN
+    carla_setenv("LC_ALL", "C");
+   #endif
+
+  #ifdef CARLA_OS_WIN
+    // init win32 stuff that plugins might use
+    OleInitialize(nullptr);
+    CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+
+   #ifndef __WINPTHREADS_VERSION
+    // (non-portable) initialization of statically linked pthread library
+    pthread_win32_process_attach_np();
+    pthread_win32_thread_attach_np();
+   #endif
+
+    // do not show error message box on Windows
+    SetErrorMode(SEM_NOGPFAULTERRORBOX);
+    SetUnhandledExceptionFilter(winExceptionFilter);
+  #endif
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // Initialize pipe
+
+    if (argc == 7)
+    {
+        gPipe = new DiscoveryPipe;
+
+        if (! gPipe->initPipeClient(argv))
+            return 1;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    int ret = 0;
+
+   #ifndef BUILDING_CARLA_FOR_WINE
+    // batch mode, scan filenames sent by the host until it closes the pipe
+    // each one is acknowledged with a "done" message so the host knows where to resume if we crash
+    if (gPipe != nullptr && std::strcmp(filename, ":batch") == 0)
+    {
+        while (gPipe->isPipeRunning())
+        {
+            gPipe->idlePipe();
+
+            if (char* const nextFilename = gPipe->takeNextFilename())
+            {
+                do_check(type, nextFilename, argv);
+                gPipe->writeDiscoveryMessage("done", nextFilename);
+                std::free(nextFilename);
+                continue;
+            }
+
+            carla_msleep(1);
+        }
+    }
+    else
+   #endif
+    {
+        ret = do_check(type, filename, argv);
+    }
+
     gPipe = nullptr;
 
     // ----------------------------------------------------------------------------------------------------------------
@@ -3101,7 +3166,7 @@ int main(int argc, const char* argv[])
     OleUninitialize();
   #endif
 
-    return 0;
+    return ret;
 }
 
 // --------------------------------------------------------------------------------------------------------------------
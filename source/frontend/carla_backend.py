@@ -841,6 +841,19 @@ ENGINE_CALLBACK_PARAMETER_MAPPED_RANGE_CHANGED = 46
 # @a valuef   Y position 2
 ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED = 47
 
+# A plugin embed UI has been resized.
+# @a pluginId Plugin Id to resize
+# @a value1   New width
+# @a value2   New height
+ENGINE_CALLBACK_EMBED_UI_RESIZED = 48
+
+# A function that is not realtime-safe was called from the audio thread.
+# Only reported when running with the libcarla_interposer-rtsan preload library.
+# @a pluginId Plugin Id, or MAIN_CARLA_PLUGIN_ID if called by the engine itself
+# @a value1   Number of calls, including similar ones not reported separately
+# @a valueStr Name of the function
+ENGINE_CALLBACK_RT_SAFETY_VIOLATION = 49
+
 # ---------------------------------------------------------------------------------------------------------------------
 # NSM Callback Opcode
 # NSM callback opcodes.
@@ -1026,6 +1039,84 @@ ENGINE_OPTION_CLIENT_NAME_PREFIX = 34
 # Treat loaded plugins as standalone (that is, there is no host UI to manage them)
 ENGINE_OPTION_PLUGINS_ARE_STANDALONE = 35
 
+# Minimum size in bytes for plugin chunks and custom data values to be saved as binary files,
+# stored in a "<project>.data" folder next to the project file instead of being embedded in it.
+# Default is 0, which disables this and keeps all data inside the project file.
+ENGINE_OPTION_PROJECT_BINARY_DATA = 36
+
+# Number of plugin discovery processes to run concurrently.
+# Default is 0, which uses one process per CPU core.
+# @note Only used by plugin discovery, see carla_plugin_discovery_set_option(); engines reject it.
+ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS = 37
+
+# Identify plugin binaries by their contents, so the discovery cache follows binaries that are moved or renamed.
+# Binaries are hashed in a background thread and remembered in the discovery index.
+# Default is 0, which identifies binaries by filename and modification time.
+# @note Only used by plugin discovery, see carla_plugin_discovery_set_option(); engines reject it.
+ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH = 38
+
+# CPUs to run audio threads on, as a list of CPUs and CPU ranges like "2,4-5".
+# Applies to the engine audio thread, bridge audio threads and JACK application threads.
+# Default is empty, which does not set any CPU affinity.
+# @note Only supported on Linux.
+ENGINE_OPTION_AUDIO_CPU_SET = 39
+
+# CPUs to run plugin worker threads on, using the same format as ENGINE_OPTION_AUDIO_CPU_SET.
+# Default is empty, which does not set any CPU affinity.
+# @note Only supported on Linux.
+ENGINE_OPTION_WORKER_CPU_SET = 40
+
+# Realtime priority for audio threads created by Carla, such as bridge audio threads.
+# Positive values are absolute priorities (1-99),
+# negative values are relative to the priority of the engine audio thread (e.g. JACK's).
+# Default is 0, which uses priority 80.
+ENGINE_OPTION_RT_PRIORITY = 41
+
+# Lock the memory of plugin bridge processes, so that audio threads do not page fault.
+# Default is 0, which does not lock memory.
+# @note Not supported on Windows.
+ENGINE_OPTION_BRIDGE_LOCK_MEMORY = 42
+
+# Time in milliseconds an effect must stay silent, while its input is silent and it receives no events,
+# before it is put to sleep and skipped during processing.
+# Plugins that report their tail length use it instead of this value.
+# Sleeping plugins are woken up as soon as they receive non-silent input or events.
+# Default is 0, which disables plugin sleep.
+ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT = 43
+
+# Granularity in frames used to split plugin processing at control event times,
+# for plugins without PLUGIN_OPTION_FIXED_BUFFERS.
+# Event times are rounded down to a multiple of this value before splitting, so parameter changes apply
+# up to granularity-1 frames early, while MIDI events keep their exact time inside the sub-block.
+# A value of -1 picks a granularity per plugin from its measured per-call overhead.
+# Default is 0, which splits at every event time.
+ENGINE_OPTION_SUB_BLOCK_GRANULARITY = 44
+
+# Interval in frames at which CV sources mapped to parameters are read, for sample-accurate plugins.
+# A parameter change is only sent when the value moved enough since the last one, so idle CV costs no events.
+# Default is 32, a value of 0 reads CV once per audio cycle.
+ENGINE_OPTION_CV_EVENT_RESOLUTION = 45
+
+# Number of realtime worker threads shared by all plugins, used for plugins that split their processing
+# into parallel tasks (CLAP thread-pool extension).
+# Worker threads use the realtime priority from ENGINE_OPTION_RT_PRIORITY and run on ENGINE_OPTION_WORKER_CPU_SET.
+# Default is 0, which uses one thread less than the number of CPUs (at most 8), a value of -1 disables them.
+# Threads are only started once a plugin needs them. Plugin bridges only start them if set to a positive value.
+ENGINE_OPTION_WORKER_THREADS = 46
+
+# Number of CPU cores each FluidSynth instance renders its voices on.
+# Extra rendering threads use the realtime priority from ENGINE_OPTION_RT_PRIORITY and run on ENGINE_OPTION_WORKER_CPU_SET.
+# Default is 1, which renders on the audio thread only,
+# a value of 0 uses as many cores as there are engine worker threads, plus the audio thread.
+ENGINE_OPTION_FLUIDSYNTH_CPU_CORES = 47
+
+# Number of plugin bridge processes to keep started ahead of time for each bridge binary in use,
+# so that adding a bridged plugin does not need to wait for a new process to start.
+# A bridge binary is used by the pool after loading a plugin with it,
+# or right away for the native bridge if ENGINE_OPTION_PREFER_PLUGIN_BRIDGES is set.
+# Default is 0, which disables the pool.
+ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE = 48
+
 # ---------------------------------------------------------------------------------------------------------------------
 # Engine Process Mode
 # Engine process mode.
@@ -1408,6 +1499,28 @@ class CarlaRuntimeEngineInfo(Structure):
         ("xruns", c_uint32)
     ]
 
+# Plugin DSP time statistics.
+# Times are in microseconds, measured by the engine around each of the plugin's process calls.
+class CarlaPluginDspStats(Structure):
+    _fields_ = [
+        # Number of process calls accounted for.
+        ("count", c_uint64),
+
+        # Minimum, average and maximum time of a process call.
+        ("minTime", c_float),
+        ("avgTime", c_float),
+        ("maxTime", c_float),
+
+        # Estimated 99th percentile of the process call time.
+        ("p99Time", c_float),
+
+        # Average time as percentage of the engine's buffer period.
+        ("load", c_float),
+
+        # Percentage of cycles skipped while the plugin was asleep, see ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT.
+        ("asleep", c_float)
+    ]
+
 # Runtime engine driver device information.
 class CarlaRuntimeEngineDriverDeviceInfo(Structure):
     _fields_ = [
@@ -1500,6 +1613,17 @@ PyCarlaRuntimeEngineInfo = {
     'xruns': 0
 }
 
+# @see CarlaPluginDspStats
+PyCarlaPluginDspStats = {
+    'count': 0,
+    'minTime': 0.0,
+    'avgTime': 0.0,
+    'maxTime': 0.0,
+    'p99Time': 0.0,
+    'load': 0.0,
+    'asleep': 0.0
+}
+
 # @see CarlaRuntimeEngineDriverDeviceInfo
 PyCarlaRuntimeEngineDriverDeviceInfo = {
     'name': "",
@@ -1641,6 +1765,26 @@ class CarlaHostMeta():
     def clear_engine_xruns(self):
         raise NotImplementedError
 
+    # Start or stop recording a trace of the engine audio cycles.
+    # Enabling again discards the previous recording.
+    @abstractmethod
+    def engine_set_tracing(self, enabled):
+        raise NotImplementedError
+
+    # Save the engine trace recorded so far into @a filename, in Chrome trace JSON format.
+    # The file can be opened with Perfetto or chrome://tracing.
+    @abstractmethod
+    def engine_save_trace(self, filename):
+        raise NotImplementedError
+
+    # Render @a frames of audio from the start of the timeline into @a filename, faster than realtime.
+    # The file is written as FLAC if the filename ends in ".flac", otherwise as 32-bit float WAV.
+    # A non-zero @a blockSize temporarily overrides the engine buffer size.
+    # Blocks until the render is complete, only supported by the Dummy driver.
+    @abstractmethod
+    def engine_render_to_file(self, filename, frames, blockSize):
+        raise NotImplementedError
+
     # Tell the engine to stop the current cancelable action.
     # @see ENGINE_CALLBACK_CANCELABLE_ACTION
     @abstractmethod
@@ -1693,6 +1837,19 @@ class CarlaHostMeta():
     def save_project(self, filename):
         raise NotImplementedError
 
+    # Save current project to a file, only serializing again plugins whose state changed since the last call.
+    # The file is written in the background, meant for frequent autosaves.
+    # Returns false if the previous incremental save is still being written.
+    @abstractmethod
+    def save_project_incremental(self, filename):
+        raise NotImplementedError
+
+    # Get how long the last finished incremental save took, in milliseconds.
+    # Returns 0 if no incremental save has succeeded yet.
+    @abstractmethod
+    def get_last_incremental_save_time(self):
+        raise NotImplementedError
+
     # Clear the currently set project filename.
     @abstractmethod
     def clear_project_filename(self):
@@ -1818,6 +1975,17 @@ class CarlaHostMeta():
     def replace_plugin(self, pluginId):
         raise NotImplementedError
 
+    # Load a new plugin into the bridge process of another, running after the plugins already there.
+    # The group is seen as a single plugin, only available in rack mode.
+    # @param pluginId Bridged plugin to add to
+    # @param ptype    Plugin type
+    # @param filename Filename, if applicable
+    # @param label    Plugin label, if applicable
+    # @param uniqueId Plugin unique Id, if applicable
+    @abstractmethod
+    def add_plugin_to_bridge_group(self, pluginId, ptype, filename, label, uniqueId):
+        raise NotImplementedError
+
     # Switch two plugins positions.
     # @param pluginIdA Plugin A
     # @param pluginIdB Plugin B
@@ -2042,6 +2210,18 @@ class CarlaHostMeta():
     def get_output_peak_value(self, pluginId, isLeft):
         raise NotImplementedError
 
+    # Get a plugin's DSP time statistics, accumulated since the plugin was added or last reset.
+    # @param pluginId Plugin
+    @abstractmethod
+    def get_plugin_dsp_stats(self, pluginId):
+        raise NotImplementedError
+
+    # Reset a plugin's DSP time statistics.
+    # @param pluginId Plugin
+    @abstractmethod
+    def reset_plugin_dsp_stats(self, pluginId):
+        raise NotImplementedError
+
     # Render a plugin's inline display.
     # @param pluginId Plugin
     @abstractmethod
@@ -2318,6 +2498,15 @@ class CarlaHostNull(CarlaHostMeta):
     def clear_engine_xruns(self):
         return
 
+    def engine_set_tracing(self, enabled):
+        return
+
+    def engine_save_trace(self, filename):
+        return False
+
+    def engine_render_to_file(self, filename, frames, blockSize):
+        return False
+
     def cancel_engine_action(self):
         return
 
@@ -2342,6 +2531,12 @@ class CarlaHostNull(CarlaHostMeta):
     def save_project(self, filename):
         return False
 
+    def save_project_incremental(self, filename):
+        return False
+
+    def get_last_incremental_save_time(self):
+        return 0
+
     def clear_project_filename(self):
         return
 
@@ -2399,6 +2594,9 @@ class CarlaHostNull(CarlaHostMeta):
     def replace_plugin(self, pluginId):
         return False
 
+    def add_plugin_to_bridge_group(self, pluginId, ptype, filename, label, uniqueId):
+        return False
+
     def switch_plugins(self, pluginIdA, pluginIdB):
         return False
 
@@ -2492,6 +2690,12 @@ class CarlaHostNull(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return 0.0
 
+    def get_plugin_dsp_stats(self, pluginId):
+        return PyCarlaPluginDspStats
+
+    def reset_plugin_dsp_stats(self, pluginId):
+        return
+
     def render_inline_display(self, pluginId, width, height):
         return None
 
@@ -2639,6 +2843,15 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_clear_engine_xruns.argtypes = (c_void_p,)
         self.lib.carla_clear_engine_xruns.restype = None
 
+        self.lib.carla_engine_set_tracing.argtypes = (c_void_p, c_bool)
+        self.lib.carla_engine_set_tracing.restype = None
+
+        self.lib.carla_engine_save_trace.argtypes = (c_void_p, c_char_p)
+        self.lib.carla_engine_save_trace.restype = c_bool
+
+        self.lib.carla_engine_render_to_file.argtypes = (c_void_p, c_char_p, c_uint64, c_uint)
+        self.lib.carla_engine_render_to_file.restype = c_bool
+
         self.lib.carla_cancel_engine_action.argtypes = (c_void_p,)
         self.lib.carla_cancel_engine_action.restype = None
 
@@ -2663,6 +2876,12 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_save_project.argtypes = (c_void_p, c_char_p)
         self.lib.carla_save_project.restype = c_bool
 
+        self.lib.carla_save_project_incremental.argtypes = (c_void_p, c_char_p)
+        self.lib.carla_save_project_incremental.restype = c_bool
+
+        self.lib.carla_get_last_incremental_save_time.argtypes = (c_void_p,)
+        self.lib.carla_get_last_incremental_save_time.restype = c_uint32
+
         self.lib.carla_clear_project_filename.argtypes = (c_void_p,)
         self.lib.carla_clear_project_filename.restype = None
 
@@ -2721,6 +2940,9 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_replace_plugin.argtypes = (c_void_p, c_uint)
         self.lib.carla_replace_plugin.restype = c_bool
 
+        self.lib.carla_add_plugin_to_bridge_group.argtypes = (c_void_p, c_uint, c_enum, c_char_p, c_char_p, c_int64)
+        self.lib.carla_add_plugin_to_bridge_group.restype = c_bool
+
         self.lib.carla_switch_plugins.argtypes = (c_void_p, c_uint, c_uint)
         self.lib.carla_switch_plugins.restype = c_bool
 
@@ -2814,6 +3036,12 @@ class CarlaHostDLL(CarlaHostMeta):
         self.lib.carla_get_output_peak_value.argtypes = (c_void_p, c_uint, c_bool)
         self.lib.carla_get_output_peak_value.restype = c_float
 
+        self.lib.carla_get_plugin_dsp_stats.argtypes = (c_void_p, c_uint)
+        self.lib.carla_get_plugin_dsp_stats.restype = POINTER(CarlaPluginDspStats)
+
+        self.lib.carla_reset_plugin_dsp_stats.argtypes = (c_void_p, c_uint)
+        self.lib.carla_reset_plugin_dsp_stats.restype = None
+
         self.lib.carla_render_inline_display.argtypes = (c_void_p, c_uint, c_uint, c_uint)
         self.lib.carla_render_inline_display.restype = POINTER(CarlaInlineDisplayImageSurface)
 
@@ -2953,6 +3181,15 @@ class CarlaHostDLL(CarlaHostMeta):
     def clear_engine_xruns(self):
         self.lib.carla_clear_engine_xruns(self.handle)
 
+    def engine_set_tracing(self, enabled):
+        self.lib.carla_engine_set_tracing(self.handle, enabled)
+
+    def engine_save_trace(self, filename):
+        return bool(self.lib.carla_engine_save_trace(self.handle, filename.encode("utf-8")))
+
+    def engine_render_to_file(self, filename, frames, blockSize):
+        return bool(self.lib.carla_engine_render_to_file(self.handle, filename.encode("utf-8"), frames, blockSize))
+
     def cancel_engine_action(self):
         self.lib.carla_cancel_engine_action(self.handle)
 
@@ -2979,6 +3216,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def save_project(self, filename):
         return bool(self.lib.carla_save_project(self.handle, filename.encode("utf-8")))
 
+    def save_project_incremental(self, filename):
+        return bool(self.lib.carla_save_project_incremental(self.handle, filename.encode("utf-8")))
+
+    def get_last_incremental_save_time(self):
+        return int(self.lib.carla_get_last_incremental_save_time(self.handle))
+
     def clear_project_filename(self):
         self.lib.carla_clear_project_filename(self.handle)
 
@@ -3044,6 +3287,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def replace_plugin(self, pluginId):
         return bool(self.lib.carla_replace_plugin(self.handle, pluginId))
 
+    def add_plugin_to_bridge_group(self, pluginId, ptype, filename, label, uniqueId):
+        cfilename = filename.encode("utf-8") if filename else None
+        clabel    = label.encode("utf-8") if label else None
+        return bool(self.lib.carla_add_plugin_to_bridge_group(self.handle, pluginId, ptype,
+                                                              cfilename, clabel, uniqueId))
+
     def switch_plugins(self, pluginIdA, pluginIdB):
         return bool(self.lib.carla_switch_plugins(self.handle, pluginIdA, pluginIdB))
 
@@ -3143,6 +3392,12 @@ class CarlaHostDLL(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return float(self.lib.carla_get_output_peak_value(self.handle, pluginId, isLeft))
 
+    def get_plugin_dsp_stats(self, pluginId):
+        return structToDict(self.lib.carla_get_plugin_dsp_stats(self.handle, pluginId).contents)
+
+    def reset_plugin_dsp_stats(self, pluginId):
+        self.lib.carla_reset_plugin_dsp_stats(self.handle, pluginId)
+
     def render_inline_display(self, pluginId, width, height):
         ptr = self.lib.carla_render_inline_display(self.handle, pluginId, width, height)
         if not ptr or not ptr.contents:
@@ -3277,6 +3532,7 @@ class PluginStoreInfo():
         self.customDataCount = 0
         self.customData      = []
         self.peaks = [0.0, 0.0, 0.0, 0.0]
+        self.dspStats = PyCarlaPluginDspStats.copy()
 
 # ---------------------------------------------------------------------------------------------------------------------
 # Carla Host object for plugins (using pipes)
@@ -3366,6 +3622,16 @@ class CarlaHostPlugin(CarlaHostMeta):
     def clear_engine_xruns(self):
         self.sendMsg(["clear_engine_xruns"])
 
+    def engine_set_tracing(self, enabled):
+        self.sendMsg(["engine_set_tracing", enabled])
+
+    def engine_save_trace(self, filename):
+        return self.sendMsgAndSetError(["engine_save_trace", filename])
+
+    def engine_render_to_file(self, filename, frames, blockSize):
+        self.fLastError = "Operation unavailable in plugin version"
+        return False
+
     def cancel_engine_action(self):
         self.sendMsg(["cancel_engine_action"])
 
@@ -3387,6 +3653,13 @@ class CarlaHostPlugin(CarlaHostMeta):
     def save_project(self, filename):
         return self.sendMsgAndSetError(["save_project", filename])
 
+    def save_project_incremental(self, filename):
+        # not available through the plugin pipe, do a regular save
+        return self.save_project(filename)
+
+    def get_last_incremental_save_time(self):
+        return 0
+
     def clear_project_filename(self):
         return self.sendMsgAndSetError(["clear_project_filename"])
 
@@ -3448,6 +3721,10 @@ class CarlaHostPlugin(CarlaHostMeta):
     def replace_plugin(self, pluginId):
         return self.sendMsgAndSetError(["replace_plugin", pluginId])
 
+    def add_plugin_to_bridge_group(self, pluginId, ptype, filename, label, uniqueId):
+        self.fLastError = "Operation unavailable in plugin version"
+        return False
+
     def switch_plugins(self, pluginIdA, pluginIdB):
         ret = self.sendMsgAndSetError(["switch_plugins", pluginIdA, pluginIdB])
         if ret:
@@ -3556,6 +3833,12 @@ class CarlaHostPlugin(CarlaHostMeta):
     def get_output_peak_value(self, pluginId, isLeft):
         return self.fPluginsInfo[pluginId].peaks[2 if isLeft else 3]
 
+    def get_plugin_dsp_stats(self, pluginId):
+        return self.fPluginsInfo[pluginId].dspStats
+
+    def reset_plugin_dsp_stats(self, pluginId):
+        self.sendMsg(["reset_plugin_dsp_stats", pluginId])
+
     def render_inline_display(self, pluginId, width, height):
         return None
 
@@ -3936,6 +4219,29 @@ class CarlaHostPlugin(CarlaHostMeta):
         if pluginInfo is not None:
             pluginInfo.peaks = [in1, in2, out1, out2]
 
+    def _set_dsp_stats(self, pluginId, count, minTime, avgTime, maxTime, p99Time, sleepCount):
+        pluginInfo = self.fPluginsInfo.get(pluginId, None)
+        if pluginInfo is None:
+            return
+
+        load = 0.0
+        if self.fBufferSize > 0 and self.fSampleRate > 0.0:
+            load = avgTime * self.fSampleRate / self.fBufferSize / 10000.0
+
+        asleep = 0.0
+        if count + sleepCount > 0:
+            asleep = sleepCount * 100.0 / (count + sleepCount)
+
+        pluginInfo.dspStats = {
+            'count': count,
+            'minTime': minTime,
+            'avgTime': avgTime,
+            'maxTime': maxTime,
+            'p99Time': p99Time,
+            'load': load,
+            'asleep': asleep
+        }
+
     def _removePlugin(self, pluginId):
         pluginCountM1 = len(self.fPluginsInfo)-1
 
@@ -145,6 +145,8 @@ class CarlaHostOSC(CarlaHostQtPlugin):
 
         if method in ("clear_engine_xruns",
                       "cancel_engine_action",
+                      "engine_set_tracing",
+                      "engine_save_trace",
                       #"load_file",
                       #"load_project",
                       #"save_project",
@@ -193,6 +195,11 @@ class CarlaHostOSC(CarlaHostQtPlugin):
             needResp = False
             path = "/%s/%i/%s" % (self.lo_target_tcp_name, pluginId, method)
 
+        elif method == "reset_plugin_dsp_stats":
+            pluginId = lines.pop(0)
+            needResp = False
+            path = "/%s/%i/reset_dsp_stats" % (self.lo_target_tcp_name, pluginId)
+
         elif method == "send_midi_note":
             pluginId = lines.pop(0)
             needResp = False
@@ -495,6 +502,12 @@ class CarlaControlServerUDP(Server):
         pluginId, in1, in2, out1, out2 = args
         self.host._set_peaks(pluginId, in1, in2, out1, out2)
 
+    @make_method('/ctrl/dsp', 'ihffffh')
+    def carla_dsp_stats(self, path, args):
+        self.fReceivedMsgs = True
+        pluginId, count, minTime, avgTime, maxTime, p99Time, sleepCount = args
+        self.host._set_dsp_stats(pluginId, count, minTime, avgTime, maxTime, p99Time, sleepCount)
+
     @make_method(None, None)
     def fallback(self, path, args):
         print("ControlServerUDP::fallback(\"%s\") - unknown message, args =" % path, args)
@@ -1082,13 +1082,35 @@ bool PluginListDialog::checkPluginCache(const char* const filename, const char*
     if (plist.isEmpty())
         return p->discovery.ignoreCache || !p->discovery.checkInvalid;
 
-    // if filename does not match, abort (hash collision?)
-    if (filename == nullptr || plist.first().filename != filename)
+    if (filename == nullptr)
     {
         p->plugins.cache.remove(qsha1sum);
         return false;
     }
 
+    if (plist.first().filename != filename)
+    {
+        // binaries identified by their contents keep the same hash when moved or renamed
+        if (QFileInfo::exists(plist.first().filename))
+        {
+            p->plugins.cache.remove(qsha1sum);
+            return false;
+        }
+
+        const QString qfilename(QString::fromUtf8(filename));
+        QList<PluginInfo>& movedList(p->plugins.cache[qsha1sum]);
+        QByteArray qdata;
+
+        for (PluginInfo& info : movedList)
+        {
+            info.filename = qfilename;
+            qdata += asVariant(info).toByteArray();
+        }
+
+        QSafeSettings settings("falkTX", "CarlaDatabase3");
+        settings.setValue(QString("PluginCache/%1").arg(sha1sum), qdata);
+    }
+
     for (const PluginInfo& info : plist)
     {
        #ifdef CARLA_FRONTEND_ONLY_EMBEDDABLE_PLUGINS
@@ -1206,6 +1228,14 @@ void PluginListDialog::timerEvent(QTimerEvent* const event)
                     carla_plugin_discovery_stop(p->discovery.handle);
                     p->discovery.handle = nullptr;
                 }
+                else if (p->discovery.dialog != nullptr)
+                {
+                    uint scanned = 0, total = 0;
+                    carla_plugin_discovery_get_progress(p->discovery.handle, &scanned, &total);
+
+                    if (total != 0)
+                        p->discovery.dialog->progressBar->setValue(static_cast<int>(scanned * 100 / total));
+                }
                 break;
             }
 
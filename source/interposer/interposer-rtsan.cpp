@@ -0,0 +1,476 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaRtSanitizer.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <ctime>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// --------------------------------------------------------------------------------------------------------------------
+// glibc internals, used to reach the real allocator without going through dlsym
+
+extern "C" {
+void* __libc_malloc(size_t);
+void* __libc_calloc(size_t, size_t);
+void* __libc_realloc(void*, size_t);
+void* __libc_memalign(size_t, size_t);
+void __libc_free(void*);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Per-thread state, must not allocate on first access
+
+#define RTSAN_TLS __thread __attribute__((tls_model("initial-exec")))
+
+static RTSAN_TLS int32_t tContext = kCarlaRtSanitizerNoContext;
+static RTSAN_TLS bool tInsideHook = false;
+
+// --------------------------------------------------------------------------------------------------------------------
+// Process-wide state, zero-initialized so that it is valid before any constructor runs
+
+enum RtSanitizerKind {
+    kRtSanitizerKindAlloc = 0,
+    kRtSanitizerKindLock,
+    kRtSanitizerKindSleep,
+    kRtSanitizerKindFile,
+    kRtSanitizerKindSocket,
+    kRtSanitizerKindCount
+};
+
+// at most one violation of each kind gets recorded per interval, the others are only counted
+static constexpr const uint64_t kRtSanitizerRecordInterval = 1000000000ULL;
+
+static constexpr const uint32_t kRtSanitizerNumSlots = 64;
+
+enum RtSanitizerSlotState {
+    kRtSanitizerSlotFree = 0,
+    kRtSanitizerSlotWriting,
+    kRtSanitizerSlotReady
+};
+
+struct RtSanitizerState {
+    std::atomic<uint64_t> lastRecordTime[kRtSanitizerKindCount];
+    std::atomic<uint32_t> suppressed[kRtSanitizerKindCount];
+    std::atomic<uint32_t> writeIndex;
+    std::atomic<uint32_t> slotStates[kRtSanitizerNumSlots];
+    CarlaRtSanitizerViolation slots[kRtSanitizerNumSlots];
+    // only used by the fetching thread
+    uint32_t readIndex;
+};
+
+static RtSanitizerState sState;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static uint64_t getMonotonicTime() noexcept
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static void recordViolation(const RtSanitizerKind kind, const char* const funcName) noexcept
+{
+    // rate-limit recording, as backtraces are expensive
+    const uint64_t now = getMonotonicTime();
+    uint64_t lastTime = sState.lastRecordTime[kind].load(std::memory_order_relaxed);
+
+    if ((lastTime != 0 && now - lastTime < kRtSanitizerRecordInterval)
+        || ! sState.lastRecordTime[kind].compare_exchange_strong(lastTime, now, std::memory_order_relaxed))
+    {
+        sState.suppressed[kind].fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint32_t index = sState.writeIndex.fetch_add(1, std::memory_order_relaxed) % kRtSanitizerNumSlots;
+    uint32_t slotState = kRtSanitizerSlotFree;
+
+    if (! sState.slotStates[index].compare_exchange_strong(slotState, kRtSanitizerSlotWriting,
+                                                           std::memory_order_acquire))
+    {
+        // nobody is fetching violations
+        sState.suppressed[kind].fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    CarlaRtSanitizerViolation& violation(sState.slots[index]);
+    violation.funcName   = funcName;
+    violation.context    = tContext;
+    violation.suppressed = sState.suppressed[kind].exchange(0, std::memory_order_relaxed);
+
+    const int numFrames = backtrace(violation.frames, static_cast<int>(kCarlaRtSanitizerMaxFrames));
+    violation.numFrames = numFrames > 0 ? static_cast<uint32_t>(numFrames) : 0;
+
+    sState.slotStates[index].store(kRtSanitizerSlotReady, std::memory_order_release);
+}
+
+// Checks a call for the current scope.
+// Nested calls (for example malloc called by fopen) are not checked, so only the outermost call is reported.
+class RtSanitizerCheck
+{
+public:
+    RtSanitizerCheck(const RtSanitizerKind kind, const char* const funcName) noexcept
+        : fActive(tContext != kCarlaRtSanitizerNoContext && ! tInsideHook)
+    {
+        if (! fActive)
+            return;
+
+        tInsideHook = true;
+        recordViolation(kind, funcName);
+    }
+
+    ~RtSanitizerCheck() noexcept
+    {
+        if (fActive)
+            tInsideHook = false;
+    }
+
+private:
+    const bool fActive;
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPYABLE(RtSanitizerCheck)
+};
+
+#define RTSAN_CHECK(kind) const RtSanitizerCheck _rtsc(kind, __FUNCTION__)
+
+#define RTSAN_REAL(name, ret, ...)                                                      \
+    typedef ret (*RealFunc)(__VA_ARGS__);                                               \
+    static RealFunc real_ ## name = nullptr;                                            \
+    if (real_ ## name == nullptr)                                                       \
+        real_ ## name = reinterpret_cast<RealFunc>(::dlsym(RTLD_NEXT, #name));
+
+// --------------------------------------------------------------------------------------------------------------------
+// Functions used by the host side, see CarlaRtSanitizer.hpp
+
+CARLA_PLUGIN_EXPORT
+int32_t carla_rtsan_set_context(const int32_t context)
+{
+    const int32_t prevContext = tContext;
+    tContext = context;
+    return prevContext;
+}
+
+CARLA_PLUGIN_EXPORT
+int32_t carla_rtsan_get_context()
+{
+    return tContext;
+}
+
+CARLA_PLUGIN_EXPORT
+bool carla_rtsan_fetch_violation(CarlaRtSanitizerViolation* const violation)
+{
+    CARLA_SAFE_ASSERT_RETURN(violation != nullptr, false);
+
+    for (uint32_t i=0; i < kRtSanitizerNumSlots; ++i)
+    {
+        const uint32_t index = (sState.readIndex + i) % kRtSanitizerNumSlots;
+
+        if (sState.slotStates[index].load(std::memory_order_acquire) != kRtSanitizerSlotReady)
+            continue;
+
+        std::memcpy(violation, &sState.slots[index], sizeof(CarlaRtSanitizerViolation));
+        sState.slotStates[index].store(kRtSanitizerSlotFree, std::memory_order_release);
+        sState.readIndex = index + 1;
+        return true;
+    }
+
+    return false;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Memory allocation
+
+CARLA_PLUGIN_EXPORT
+void* malloc(const size_t size) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+    return __libc_malloc(size);
+}
+
+CARLA_PLUGIN_EXPORT
+void* calloc(const size_t nmemb, const size_t size) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+    return __libc_calloc(nmemb, size);
+}
+
+CARLA_PLUGIN_EXPORT
+void* realloc(void* const ptr, const size_t size) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+    return __libc_realloc(ptr, size);
+}
+
+CARLA_PLUGIN_EXPORT
+void free(void* const ptr) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+    __libc_free(ptr);
+}
+
+CARLA_PLUGIN_EXPORT
+int posix_memalign(void** const memptr, const size_t alignment, const size_t size) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment % sizeof(void*) != 0)
+        return EINVAL;
+
+    void* const ptr = __libc_memalign(alignment, size);
+
+    if (ptr == nullptr)
+        return ENOMEM;
+
+    *memptr = ptr;
+    return 0;
+}
+
+CARLA_PLUGIN_EXPORT
+void* aligned_alloc(const size_t alignment, const size_t size) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+    return __libc_memalign(alignment, size);
+}
+
+CARLA_PLUGIN_EXPORT
+void* memalign(const size_t alignment, const size_t size) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindAlloc);
+    return __libc_memalign(alignment, size);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Blocking locks, the try-lock variants are fine
+
+CARLA_PLUGIN_EXPORT
+int pthread_mutex_lock(pthread_mutex_t* const mutex) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindLock);
+    RTSAN_REAL(pthread_mutex_lock, int, pthread_mutex_t*)
+    return real_pthread_mutex_lock(mutex);
+}
+
+CARLA_PLUGIN_EXPORT
+int pthread_rwlock_rdlock(pthread_rwlock_t* const rwlock) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindLock);
+    RTSAN_REAL(pthread_rwlock_rdlock, int, pthread_rwlock_t*)
+    return real_pthread_rwlock_rdlock(rwlock);
+}
+
+CARLA_PLUGIN_EXPORT
+int pthread_rwlock_wrlock(pthread_rwlock_t* const rwlock) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindLock);
+    RTSAN_REAL(pthread_rwlock_wrlock, int, pthread_rwlock_t*)
+    return real_pthread_rwlock_wrlock(rwlock);
+}
+
+CARLA_PLUGIN_EXPORT
+int pthread_cond_wait(pthread_cond_t* const cond, pthread_mutex_t* const mutex)
+{
+    RTSAN_CHECK(kRtSanitizerKindLock);
+    RTSAN_REAL(pthread_cond_wait, int, pthread_cond_t*, pthread_mutex_t*)
+    return real_pthread_cond_wait(cond, mutex);
+}
+
+CARLA_PLUGIN_EXPORT
+int pthread_cond_timedwait(pthread_cond_t* const cond, pthread_mutex_t* const mutex, const struct timespec* const ts)
+{
+    RTSAN_CHECK(kRtSanitizerKindLock);
+    RTSAN_REAL(pthread_cond_timedwait, int, pthread_cond_t*, pthread_mutex_t*, const struct timespec*)
+    return real_pthread_cond_timedwait(cond, mutex, ts);
+}
+
+CARLA_PLUGIN_EXPORT
+int sem_wait(sem_t* const sem)
+{
+    RTSAN_CHECK(kRtSanitizerKindLock);
+    RTSAN_REAL(sem_wait, int, sem_t*)
+    return real_sem_wait(sem);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Sleeping
+
+CARLA_PLUGIN_EXPORT
+int usleep(const useconds_t usec)
+{
+    RTSAN_CHECK(kRtSanitizerKindSleep);
+    RTSAN_REAL(usleep, int, useconds_t)
+    return real_usleep(usec);
+}
+
+CARLA_PLUGIN_EXPORT
+int nanosleep(const struct timespec* const req, struct timespec* const rem)
+{
+    RTSAN_CHECK(kRtSanitizerKindSleep);
+    RTSAN_REAL(nanosleep, int, const struct timespec*, struct timespec*)
+    return real_nanosleep(req, rem);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Files
+
+CARLA_PLUGIN_EXPORT
+int open(const char* const pathname, const int flags, ...)
+{
+    RTSAN_CHECK(kRtSanitizerKindFile);
+    RTSAN_REAL(open, int, const char*, int, ...)
+
+    mode_t mode = 0;
+
+    if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE)
+    {
+        va_list args;
+        va_start(args, flags);
+        mode = static_cast<mode_t>(va_arg(args, int));
+        va_end(args);
+    }
+
+    return real_open(pathname, flags, mode);
+}
+
+CARLA_PLUGIN_EXPORT
+int openat(const int dirfd, const char* const pathname, const int flags, ...)
+{
+    RTSAN_CHECK(kRtSanitizerKindFile);
+    RTSAN_REAL(openat, int, int, const char*, int, ...)
+
+    mode_t mode = 0;
+
+    if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE)
+    {
+        va_list args;
+        va_start(args, flags);
+        mode = static_cast<mode_t>(va_arg(args, int));
+        va_end(args);
+    }
+
+    return real_openat(dirfd, pathname, flags, mode);
+}
+
+CARLA_PLUGIN_EXPORT
+FILE* fopen(const char* const pathname, const char* const mode)
+{
+    RTSAN_CHECK(kRtSanitizerKindFile);
+    RTSAN_REAL(fopen, FILE*, const char*, const char*)
+    return real_fopen(pathname, mode);
+}
+
+CARLA_PLUGIN_EXPORT
+int fclose(FILE* const stream)
+{
+    RTSAN_CHECK(kRtSanitizerKindFile);
+    RTSAN_REAL(fclose, int, FILE*)
+    return real_fclose(stream);
+}
+
+CARLA_PLUGIN_EXPORT
+int close(const int fd)
+{
+    RTSAN_CHECK(kRtSanitizerKindFile);
+    RTSAN_REAL(close, int, int)
+    return real_close(fd);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Sockets
+
+CARLA_PLUGIN_EXPORT
+int socket(const int domain, const int type, const int protocol) noexcept
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(socket, int, int, int, int)
+    return real_socket(domain, type, protocol);
+}
+
+CARLA_PLUGIN_EXPORT
+int connect(const int sockfd, const struct sockaddr* const addr, const socklen_t addrlen)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(connect, int, int, const struct sockaddr*, socklen_t)
+    return real_connect(sockfd, addr, addrlen);
+}
+
+CARLA_PLUGIN_EXPORT
+int accept(const int sockfd, struct sockaddr* const addr, socklen_t* const addrlen)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(accept, int, int, struct sockaddr*, socklen_t*)
+    return real_accept(sockfd, addr, addrlen);
+}
+
+CARLA_PLUGIN_EXPORT
+ssize_t send(const int sockfd, const void* const buf, const size_t len, const int flags)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(send, ssize_t, int, const void*, size_t, int)
+    return real_send(sockfd, buf, len, flags);
+}
+
+CARLA_PLUGIN_EXPORT
+ssize_t sendto(const int sockfd, const void* const buf, const size_t len, const int flags,
+               const struct sockaddr* const destAddr, const socklen_t addrlen)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(sendto, ssize_t, int, const void*, size_t, int, const struct sockaddr*, socklen_t)
+    return real_sendto(sockfd, buf, len, flags, destAddr, addrlen);
+}
+
+CARLA_PLUGIN_EXPORT
+ssize_t sendmsg(const int sockfd, const struct msghdr* const msg, const int flags)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(sendmsg, ssize_t, int, const struct msghdr*, int)
+    return real_sendmsg(sockfd, msg, flags);
+}
+
+CARLA_PLUGIN_EXPORT
+ssize_t recv(const int sockfd, void* const buf, const size_t len, const int flags)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(recv, ssize_t, int, void*, size_t, int)
+    return real_recv(sockfd, buf, len, flags);
+}
+
+CARLA_PLUGIN_EXPORT
+ssize_t recvfrom(const int sockfd, void* const buf, const size_t len, const int flags,
+                 struct sockaddr* const srcAddr, socklen_t* const addrlen)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(recvfrom, ssize_t, int, void*, size_t, int, struct sockaddr*, socklen_t*)
+    return real_recvfrom(sockfd, buf, len, flags, srcAddr, addrlen);
+}
+
+CARLA_PLUGIN_EXPORT
+ssize_t recvmsg(const int sockfd, struct msghdr* const msg, const int flags)
+{
+    RTSAN_CHECK(kRtSanitizerKindSocket);
+    RTSAN_REAL(recvmsg, ssize_t, int, struct msghdr*, int)
+    return real_recvmsg(sockfd, msg, flags);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+__attribute__((constructor))
+static void carla_rtsan_init()
+{
+    // the first backtrace call loads libgcc and allocates, do it now instead of in a realtime thread
+    void* frames[2];
+    backtrace(frames, 2);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
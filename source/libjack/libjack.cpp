@@ -19,6 +19,7 @@
 
 #include "CarlaThread.hpp"
 #include "CarlaJuceUtils.hpp"
+#include "CarlaProcessUtils.hpp"
 
 #include <signal.h>
 #include <sys/time.h>
@@ -1283,6 +1284,7 @@ bool CarlaJackAppClient::handleNonRtData()
             break;
 
         case kPluginBridgeNonRtClientReload:
+        case kPluginBridgeNonRtClientAddGroupPlugin:
             break;
         }
 
@@ -1305,6 +1307,10 @@ void CarlaJackAppClient::runRealtimeThread()
     _mm_setcsr(_mm_getcsr() | 0x8040);
 #endif
 
+    if (const char* const lockMemory = std::getenv("ENGINE_OPTION_BRIDGE_LOCK_MEMORY"))
+        if (std::strcmp(lockMemory, "true") == 0)
+            carla_prefaultThreadStack();
+
     bool quitReceived = false;
 
     for (; ! fRealtimeThread.shouldThreadExit();)
@@ -1345,6 +1351,13 @@ void CarlaJackAppClient::runNonRealtimeThread()
             fMidiOutBuffers[i].isInput = false;
     }
 
+    if (const char* const lockMemory = std::getenv("ENGINE_OPTION_BRIDGE_LOCK_MEMORY"))
+        if (std::strcmp(lockMemory, "true") == 0)
+            carla_lockProcessMemory();
+
+    const char* const rtPriority = std::getenv("ENGINE_OPTION_RT_PRIORITY");
+    fRealtimeThread.setThreadPolicy(rtPriority != nullptr ? std::atoi(rtPriority) : 0,
+                                    std::getenv("ENGINE_OPTION_AUDIO_CPU_SET"));
     fRealtimeThread.startThread(true);
 
     fLastPingTime = getCurrentTimeMilliseconds();
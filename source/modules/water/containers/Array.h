@@ -876,12 +876,12 @@ public:
 #if 1
             ElementType* const e = data.elements + startIndex;
 
+            for (int i = 0; i < numberToRemove; ++i)
+                e[i].~ElementType();
+
             const int numToShift = numUsed - endIndex;
             if (numToShift > 0)
                 data.moveMemory (e, e + numberToRemove, numToShift);
-
-            for (int i = 0; i < numberToRemove; ++i)
-                e[numToShift + i].~ElementType();
 #else
             ElementType* dst = data.elements + startIndex;
             ElementType* src = dst + numberToRemove;
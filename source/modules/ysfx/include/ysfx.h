@@ -119,6 +119,8 @@ typedef enum ysfx_load_option_e {
 
 // load the source code from file without compiling
 YSFX_API bool ysfx_load_file(ysfx_t *fx, const char *filepath, uint32_t loadopts);
+// load the source code already loaded by another effect, sharing its parsed sections without reading files
+YSFX_API bool ysfx_load_source_from(ysfx_t *fx, ysfx_t *other);
 // unload the source code and any compiled code
 YSFX_API void ysfx_unload(ysfx_t *fx);
 // check whether the effect is loaded
@@ -128,6 +130,8 @@ YSFX_API bool ysfx_is_loaded(ysfx_t *fx);
 YSFX_API const char *ysfx_get_name(ysfx_t *fx);
 // get the path of the file which is loaded
 YSFX_API const char *ysfx_get_file_path(ysfx_t *fx);
+// get the paths of all source files, the main file first and imports next
+YSFX_API uint32_t ysfx_get_source_files(ysfx_t *fx, const char **dest, uint32_t destsize);
 // get the author of the effect
 YSFX_API const char *ysfx_get_author(ysfx_t *fx);
 // get the number of tags of the effect
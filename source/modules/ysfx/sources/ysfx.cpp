@@ -251,6 +251,7 @@ bool ysfx_load_file(ysfx_t *fx, const char *filepath, uint32_t loadopts)
             }
         }
 
+        main->file_path.assign(filepath);
         fx->source.main = std::move(main);
         fx->source.main_file_path.assign(filepath);
 
@@ -306,6 +307,7 @@ bool ysfx_load_file(ysfx_t *fx, const char *filepath, uint32_t loadopts)
 
             // parse it
             ysfx_source_unit_u unit{new ysfx_source_unit_t};
+            unit->file_path = imported_path;
             ysfx::stdio_text_reader reader(stream.get());
 
             ysfx_parse_error error;
@@ -344,6 +346,33 @@ bool ysfx_load_file(ysfx_t *fx, const char *filepath, uint32_t loadopts)
     return true;
 }
 
+bool ysfx_load_source_from(ysfx_t *fx, ysfx_t *other)
+{
+    ysfx_unload(fx);
+
+    if (!other->source.main) {
+        ysfx_logf(*fx->config, ysfx_log_error, "???: no source is loaded, cannot share it");
+        return false;
+    }
+
+    // units are copied, as headers get adjusted per effect, but they keep pointing to the same sections
+    fx->source.main.reset(new ysfx_source_unit_t(*other->source.main));
+    fx->source.imports.reserve(other->source.imports.size());
+    for (const ysfx_source_unit_u &unit : other->source.imports)
+        fx->source.imports.emplace_back(new ysfx_source_unit_t(*unit));
+
+    fx->source.main_file_path = other->source.main_file_path;
+    fx->source.bank_path = other->source.bank_path;
+    fx->source.slider_alias = other->source.slider_alias;
+
+    ysfx_update_slider_visibility_mask(fx);
+
+    for (uint32_t i = 0; i < ysfx_max_sliders; ++i)
+        *fx->var.slider[i] = fx->source.main->header.sliders[i].def;
+
+    return true;
+}
+
 bool ysfx_compile(ysfx_t *fx, uint32_t compileopts)
 {
     ysfx_unload_code(fx);
@@ -566,6 +595,20 @@ const char *ysfx_get_file_path(ysfx_t *fx)
     return fx->source.main_file_path.c_str();
 }
 
+uint32_t ysfx_get_source_files(ysfx_t *fx, const char **dest, uint32_t destsize)
+{
+    if (!fx->source.main)
+        return 0;
+
+    uint32_t count = 1 + (uint32_t)fx->source.imports.size();
+
+    uint32_t copysize = (destsize < count) ? destsize : count;
+    for (uint32_t i = 0; i < copysize; ++i)
+        dest[i] = (i == 0) ? fx->source.main->file_path.c_str() : fx->source.imports[i - 1]->file_path.c_str();
+
+    return count;
+}
+
 const char *ysfx_get_author(ysfx_t *fx)
 {
     ysfx_source_unit_t *main = fx->source.main.get();
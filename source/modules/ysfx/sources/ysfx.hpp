@@ -34,6 +34,7 @@ YSFX_DEFINE_AUTO_PTR(NSEEL_VMCTX_u, void, NSEEL_VM_free); // NOTE: `NSEEL_VMCTX`
 YSFX_DEFINE_AUTO_PTR(NSEEL_CODEHANDLE_u, void, NSEEL_code_free); // NOTE: `NSEEL_CODEHANDLE` is `void *`
 
 struct ysfx_source_unit_t {
+    std::string file_path;
     ysfx_toplevel_t toplevel;
     ysfx_header_t header;
 };
@@ -27,7 +27,8 @@ struct ysfx_section_t;
 struct ysfx_toplevel_t;
 struct ysfx_slider_t;
 struct ysfx_header_t;
-using ysfx_section_u = std::unique_ptr<ysfx_section_t>;
+// sections are shared, so a loaded source can be reused by other effects without copying
+using ysfx_section_u = std::shared_ptr<ysfx_section_t>;
 using ysfx_toplevel_u = std::unique_ptr<ysfx_toplevel_t>;
 using ysfx_slider_u = std::unique_ptr<ysfx_slider_t>;
 using ysfx_header_u = std::unique_ptr<ysfx_header_t>;
@@ -0,0 +1,523 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaHost.h"
+#include "CarlaMutex.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+CARLA_BACKEND_USE_NAMESPACE
+
+// --------------------------------------------------------------------------------------------------------------------
+// Headless engine benchmark, using the Dummy driver in freewheel mode.
+// Synthetic sessions made of internal plugins are built in rack and patchbay modes, then run for a number of cycles.
+// Each run prints one JSON object per line on stdout (and optionally into a file), so results can be tracked.
+
+static constexpr const uint32_t kDefaultCycles     = 20000;
+static constexpr const uint32_t kDefaultEvents     = 64;
+static constexpr const uint32_t kDefaultBufferSize = 256;
+static constexpr const uint32_t kDefaultSampleRate = 48000;
+static constexpr const uint32_t kReadyTimeout      = 10 * 1000;
+
+struct BenchmarkSession {
+    const char* name;
+    const char* labels[6];
+};
+
+static const BenchmarkSession kSessions[] = {
+    { "audio", { "audiogain_s", "bypass", nullptr } },
+    { "midi",  { "midithrough", "lfo", nullptr } },
+    { "mixed", { "audiogain_s", "midithrough", "bypass", "lfo", "audiofile", nullptr } },
+};
+
+static const uint32_t kDefaultPluginCounts[] = { 1, 16, 64 };
+
+// --------------------------------------------------------------------------------------------------------------------
+// patchbay clients and ports, as reported by the engine callback
+
+struct PatchbayGroup {
+    int pluginId;
+    std::vector<uint> audioIns, audioOuts;
+    std::vector<uint> midiIns, midiOuts;
+};
+
+struct PatchbayState {
+    CarlaMutex mutex;
+    std::map<uint, PatchbayGroup> groups;
+};
+
+static void engineCallback(void* const ptr, const EngineCallbackOpcode action, const uint pluginId,
+                           const int value1, const int value2, int, float, const char*)
+{
+    PatchbayState* const state = static_cast<PatchbayState*>(ptr);
+
+    switch (action)
+    {
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_ADDED: {
+        const CarlaMutexLocker cml(state->mutex);
+        PatchbayGroup& group(state->groups[pluginId]);
+        group = PatchbayGroup();
+        group.pluginId = value2;
+        break;
+    }
+
+    case ENGINE_CALLBACK_PATCHBAY_CLIENT_REMOVED: {
+        const CarlaMutexLocker cml(state->mutex);
+        state->groups.erase(pluginId);
+        break;
+    }
+
+    case ENGINE_CALLBACK_PATCHBAY_PORT_ADDED: {
+        const CarlaMutexLocker cml(state->mutex);
+        PatchbayGroup& group(state->groups[pluginId]);
+        const uint hints = static_cast<uint>(value2);
+        const uint portId = static_cast<uint>(value1);
+
+        if (hints & PATCHBAY_PORT_TYPE_AUDIO)
+            (hints & PATCHBAY_PORT_IS_INPUT ? group.audioIns : group.audioOuts).push_back(portId);
+        else if (hints & PATCHBAY_PORT_TYPE_MIDI)
+            (hints & PATCHBAY_PORT_IS_INPUT ? group.midiIns : group.midiOuts).push_back(portId);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+// connect system outputs -> plugin 0 -> plugin 1 -> ... -> system inputs, skipping plugins without such ports
+static uint connectChain(const CarlaHostHandle handle, PatchbayState& state,
+                         std::vector<uint> PatchbayGroup::* const ins,
+                         std::vector<uint> PatchbayGroup::* const outs)
+{
+    std::vector<std::pair<int, uint> > pluginGroups;
+    uint sourceGroup = 0, sinkGroup = 0;
+    std::vector<uint> sourcePorts, sinkPorts;
+
+    {
+        const CarlaMutexLocker cml(state.mutex);
+
+        for (std::map<uint, PatchbayGroup>::const_iterator it = state.groups.begin(); it != state.groups.end(); ++it)
+        {
+            const PatchbayGroup& group(it->second);
+
+            if (group.pluginId >= 0)
+            {
+                pluginGroups.push_back(std::make_pair(group.pluginId, it->first));
+            }
+            else if (sourcePorts.empty() && ! (group.*outs).empty())
+            {
+                sourceGroup = it->first;
+                sourcePorts = group.*outs;
+            }
+            else if (sinkPorts.empty() && ! (group.*ins).empty())
+            {
+                sinkGroup = it->first;
+                sinkPorts = group.*ins;
+            }
+        }
+    }
+
+    std::sort(pluginGroups.begin(), pluginGroups.end());
+
+    uint connections = 0;
+
+    const auto connect = [&](const uint groupId, const std::vector<uint>& targetPorts) {
+        if (sourcePorts.empty())
+            return;
+
+        for (std::size_t i=0; i < targetPorts.size(); ++i)
+            if (carla_patchbay_connect(handle, false,
+                                       sourceGroup, sourcePorts[i % sourcePorts.size()], groupId, targetPorts[i]))
+                ++connections;
+    };
+
+    for (std::size_t i=0; i < pluginGroups.size(); ++i)
+    {
+        const uint groupId = pluginGroups[i].second;
+        std::vector<uint> groupIns, groupOuts;
+
+        {
+            const CarlaMutexLocker cml(state.mutex);
+            const PatchbayGroup& group(state.groups[groupId]);
+            groupIns = group.*ins;
+            groupOuts = group.*outs;
+        }
+
+        connect(groupId, groupIns);
+
+        if (! groupOuts.empty())
+        {
+            sourceGroup = groupId;
+            sourcePorts = groupOuts;
+        }
+    }
+
+    connect(sinkGroup, sinkPorts);
+    return connections;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static uint64_t getResidentMemoryKiB()
+{
+    uint64_t size = 0, resident = 0;
+
+    if (FILE* const file = std::fopen("/proc/self/statm", "r"))
+    {
+        if (std::fscanf(file, P_UINT64 " " P_UINT64, &size, &resident) != 2)
+            resident = 0;
+        std::fclose(file);
+    }
+
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) / 1024;
+}
+
+static double msSince(const uint64_t startTime)
+{
+    return static_cast<double>(carla_gettime_us() - startTime) / 1000.0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkOptions {
+    uint32_t cycles;
+    uint32_t events;
+    uint32_t bufferSize;
+    uint32_t sampleRate;
+    FILE* output;
+    std::string binaryDir;
+};
+
+static bool runSession(const CarlaHostHandle handle, PatchbayState& state, const BenchmarkOptions& options,
+                       const EngineProcessMode processMode, const BenchmarkSession& session, uint32_t numPlugins)
+{
+    const bool isPatchbay = processMode == ENGINE_PROCESS_MODE_PATCHBAY;
+
+    if (! isPatchbay)
+        numPlugins = std::min(numPlugins, MAX_RACK_PLUGINS);
+
+    char tmpBuf[32];
+    std::snprintf(tmpBuf, sizeof(tmpBuf), "%u", options.events);
+    setenv("CARLA_DUMMY_FREEWHEEL", "1", 1);
+    setenv("CARLA_DUMMY_MIDI_EVENTS", tmpBuf, 1);
+
+    carla_set_engine_option(handle, ENGINE_OPTION_PROCESS_MODE, processMode, "");
+    carla_set_engine_option(handle, ENGINE_OPTION_TRANSPORT_MODE, ENGINE_TRANSPORT_MODE_INTERNAL, "");
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_BUFFER_SIZE, static_cast<int>(options.bufferSize), "");
+    carla_set_engine_option(handle, ENGINE_OPTION_AUDIO_SAMPLE_RATE, static_cast<int>(options.sampleRate), "");
+    carla_set_engine_option(handle, ENGINE_OPTION_PATH_BINARIES, 0, options.binaryDir.c_str());
+    carla_set_engine_option(handle, ENGINE_OPTION_PATH_RESOURCES, 0, (options.binaryDir + "/../resources").c_str());
+
+    {
+        const CarlaMutexLocker cml(state.mutex);
+        state.groups.clear();
+    }
+
+    if (! carla_engine_init(handle, "Dummy", "Carla-Benchmark"))
+    {
+        carla_stderr2("failed to start engine: %s", carla_get_last_error(handle));
+        return false;
+    }
+
+    const uint64_t baseMemory = getResidentMemoryKiB();
+    bool ok = true;
+
+    // build session
+    uint64_t startTime = carla_gettime_us();
+    uint connections = 0;
+
+    uint32_t numLabels = 0;
+    while (session.labels[numLabels] != nullptr)
+        ++numLabels;
+
+    for (uint32_t i=0; i < numPlugins && ok; ++i)
+    {
+        const char* const label = session.labels[i % numLabels];
+
+        if (! carla_add_plugin(handle, BINARY_NATIVE, PLUGIN_INTERNAL, "", "", label, 0, nullptr, 0x0))
+        {
+            carla_stderr2("failed to add plugin %s: %s", label, carla_get_last_error(handle));
+            ok = false;
+        }
+    }
+
+    if (ok && isPatchbay)
+    {
+        connections += connectChain(handle, state, &PatchbayGroup::audioIns, &PatchbayGroup::audioOuts);
+        connections += connectChain(handle, state, &PatchbayGroup::midiIns, &PatchbayGroup::midiOuts);
+    }
+
+    const double buildTime = msSince(startTime);
+
+    // wait until the last plugin has been processed, meaning the new graph is live
+    startTime = carla_gettime_us();
+
+    for (const uint32_t timeoutEnd = carla_gettime_ms() + kReadyTimeout;
+         ok && carla_get_plugin_dsp_stats(handle, numPlugins - 1)->count == 0;)
+    {
+        carla_engine_idle(handle);
+
+        if (carla_gettime_ms() >= timeoutEnd)
+        {
+            carla_stderr2("timed out waiting for the session to be processed");
+            ok = false;
+        }
+
+        carla_msleep(1);
+    }
+
+    const double readyTime = msSince(startTime);
+    const uint64_t sessionMemory = getResidentMemoryKiB();
+
+    // measure
+    carla_reset_engine_dsp_stats(handle);
+    carla_clear_engine_xruns(handle);
+
+    for (uint32_t i=0; i < numPlugins; ++i)
+        carla_reset_plugin_dsp_stats(handle, i);
+
+    uint64_t cyclesStart = 0, cyclesEnd = 0;
+    double wallTime = 0.0;
+
+    if (ok)
+    {
+        while ((cyclesStart = carla_get_engine_dsp_stats(handle)->count) == 0)
+            carla_msleep(1);
+
+        startTime = carla_gettime_us();
+
+        while ((cyclesEnd = carla_get_engine_dsp_stats(handle)->count) < cyclesStart + options.cycles)
+        {
+            carla_engine_idle(handle);
+            carla_msleep(1);
+        }
+
+        wallTime = msSince(startTime);
+    }
+
+    const CarlaPluginDspStats cycleStats(*carla_get_engine_dsp_stats(handle));
+    const uint32_t xruns = carla_get_runtime_engine_info(handle)->xruns;
+
+    double pluginAvgSum = 0.0;
+    float pluginMaxP99 = 0.0f;
+
+    for (uint32_t i=0; i < numPlugins; ++i)
+    {
+        const CarlaPluginDspStats* const stats = carla_get_plugin_dsp_stats(handle, i);
+        pluginAvgSum += static_cast<double>(stats->avgTime);
+        pluginMaxP99 = std::max(pluginMaxP99, stats->p99Time);
+    }
+
+    // tear down
+    startTime = carla_gettime_us();
+    carla_remove_all_plugins(handle);
+    const double clearTime = msSince(startTime);
+
+    carla_engine_close(handle);
+
+    if (! ok)
+        return false;
+
+    const uint64_t cycles = cyclesEnd - cyclesStart;
+    const double wallSeconds = std::max(wallTime, 0.001) / 1000.0;
+    const double audioSeconds = static_cast<double>(cycles) * options.bufferSize / options.sampleRate;
+
+    char line[1024];
+    std::snprintf(line, sizeof(line),
+                  "{\"mode\":\"%s\",\"session\":\"%s\",\"plugins\":%u,\"bufferSize\":%u,\"sampleRate\":%u,"
+                  "\"cycles\":" P_UINT64 ",\"wallTime\":%.3f,\"realtimeFactor\":%.2f,"
+                  "\"cycleTime\":{\"min\":%.3f,\"avg\":%.3f,\"p99\":%.3f,\"max\":%.3f},"
+                  "\"pluginTime\":{\"avgSum\":%.3f,\"maxP99\":%.3f},"
+                  "\"events\":{\"perCycle\":%u,\"perSecond\":%.0f},"
+                  "\"graph\":{\"connections\":%u,\"buildTime\":%.3f,\"readyTime\":%.3f,\"clearTime\":%.3f},"
+                  "\"memory\":{\"residentKiB\":" P_UINT64 ",\"sessionKiB\":" P_INT64 "},"
+                  "\"xruns\":%u}\n",
+                  isPatchbay ? "patchbay" : "rack", session.name, numPlugins, options.bufferSize, options.sampleRate,
+                  cycles, wallTime, audioSeconds / wallSeconds,
+                  static_cast<double>(cycleStats.minTime), static_cast<double>(cycleStats.avgTime),
+                  static_cast<double>(cycleStats.p99Time), static_cast<double>(cycleStats.maxTime),
+                  pluginAvgSum, static_cast<double>(pluginMaxP99),
+                  options.events, static_cast<double>(cycles) * options.events / wallSeconds,
+                  connections, buildTime, readyTime, clearTime,
+                  sessionMemory, static_cast<int64_t>(sessionMemory) - static_cast<int64_t>(baseMemory),
+                  xruns);
+
+    std::fputs(line, stdout);
+    std::fflush(stdout);
+
+    if (options.output != nullptr)
+    {
+        std::fputs(line, options.output);
+        std::fflush(options.output);
+    }
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static std::vector<std::string> splitArg(const char* const arg)
+{
+    std::vector<std::string> ret;
+    std::string current;
+
+    for (const char* s = arg; ; ++s)
+    {
+        if (*s == ',' || *s == '\0')
+        {
+            if (! current.empty())
+                ret.push_back(current);
+            current.clear();
+
+            if (*s == '\0')
+                break;
+        }
+        else
+        {
+            current += *s;
+        }
+    }
+
+    return ret;
+}
+
+static void printUsage(const char* const name)
+{
+    std::fprintf(stderr,
+                 "usage: %s [--cycles N] [--plugins N,...] [--modes rack,patchbay] [--sessions audio,midi,mixed]\n"
+                 "          [--events N] [--buffer-size N] [--sample-rate N] [--output FILE]\n", name);
+}
+
+int main(int argc, const char* argv[])
+{
+    BenchmarkOptions options = { kDefaultCycles, kDefaultEvents, kDefaultBufferSize, kDefaultSampleRate, nullptr, "" };
+
+    // internal plugins look for their resources next to the binaries
+    if (char* const realPath = realpath(argv[0], nullptr))
+    {
+        options.binaryDir = realPath;
+        options.binaryDir.erase(options.binaryDir.rfind('/'));
+        std::free(realPath);
+    }
+    std::vector<uint32_t> pluginCounts(kDefaultPluginCounts,
+                                       kDefaultPluginCounts + sizeof(kDefaultPluginCounts)/sizeof(uint32_t));
+    std::vector<std::string> modes, sessions;
+    modes.push_back("rack");
+    modes.push_back("patchbay");
+    sessions.push_back("mixed");
+
+    for (int i=1; i < argc; ++i)
+    {
+        const char* const arg = argv[i];
+        const char* const value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+        if (value == nullptr)
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        ++i;
+
+        if (std::strcmp(arg, "--cycles") == 0)
+        {
+            options.cycles = static_cast<uint32_t>(std::max(1, std::atoi(value)));
+        }
+        else if (std::strcmp(arg, "--events") == 0)
+        {
+            options.events = static_cast<uint32_t>(std::max(0, std::atoi(value)));
+        }
+        else if (std::strcmp(arg, "--buffer-size") == 0)
+        {
+            options.bufferSize = static_cast<uint32_t>(std::max(16, std::atoi(value)));
+        }
+        else if (std::strcmp(arg, "--sample-rate") == 0)
+        {
+            options.sampleRate = static_cast<uint32_t>(std::max(8000, std::atoi(value)));
+        }
+        else if (std::strcmp(arg, "--plugins") == 0)
+        {
+            pluginCounts.clear();
+
+            const std::vector<std::string> counts(splitArg(value));
+            for (std::size_t j=0; j < counts.size(); ++j)
+                pluginCounts.push_back(static_cast<uint32_t>(std::max(1, std::atoi(counts[j].c_str()))));
+        }
+        else if (std::strcmp(arg, "--modes") == 0)
+        {
+            modes = splitArg(value);
+        }
+        else if (std::strcmp(arg, "--sessions") == 0)
+        {
+            sessions = splitArg(value);
+        }
+        else if (std::strcmp(arg, "--output") == 0)
+        {
+            options.output = std::fopen(value, "w");
+
+            if (options.output == nullptr)
+            {
+                carla_stderr2("failed to open \"%s\" for writing", value);
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const CarlaHostHandle handle = carla_standalone_host_init();
+    PatchbayState state;
+    carla_set_engine_callback(handle, engineCallback, &state);
+
+    bool ok = true;
+
+    for (std::size_t m=0; m < modes.size(); ++m)
+    {
+        EngineProcessMode processMode;
+
+        if (modes[m] == "rack")
+            processMode = ENGINE_PROCESS_MODE_CONTINUOUS_RACK;
+        else if (modes[m] == "patchbay")
+            processMode = ENGINE_PROCESS_MODE_PATCHBAY;
+        else
+        {
+            carla_stderr2("unknown mode \"%s\"", modes[m].c_str());
+            ok = false;
+            continue;
+        }
+
+        for (std::size_t s=0; s < sessions.size(); ++s)
+        {
+            const BenchmarkSession* session = nullptr;
+
+            for (std::size_t j=0; j < sizeof(kSessions)/sizeof(kSessions[0]); ++j)
+                if (sessions[s] == kSessions[j].name)
+                    session = &kSessions[j];
+
+            if (session == nullptr)
+            {
+                carla_stderr2("unknown session \"%s\"", sessions[s].c_str());
+                ok = false;
+                continue;
+            }
+
+            for (std::size_t p=0; p < pluginCounts.size(); ++p)
+                ok = runSession(handle, state, options, processMode, *session, pluginCounts[p]) && ok;
+        }
+    }
+
+    if (options.output != nullptr)
+        std::fclose(options.output);
+
+    return ok ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "CarlaPipeUtils.hpp"
+#include "CarlaBase64Utils.hpp"
+#include "CarlaTimeUtils.hpp"
+
+#include <vector>
+
+// --------------------------------------------------------------------------------------------------------------------
+// Throughput benchmark for the CarlaPipe UI protocol, text vs binary framing.
+// The same binary is started as pipe server and then spawned again as pipe client.
+
+static constexpr const uint32_t kNumControls  = 200000;
+static constexpr const uint32_t kNumAtoms     = 20000;
+static constexpr const uint32_t kAtomBodySize = 256;
+static constexpr const int      kPipeSize     = 1024 * 1024;
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class BenchmarkClient : public CarlaPipeClient
+{
+public:
+    BenchmarkClient(const bool binary)
+        : fControls(0),
+          fAtoms(0)
+    {
+        setBinaryFramingAllowed(binary);
+    }
+
+protected:
+    bool msgReceived(const char* const msg) noexcept override
+    {
+        if (std::strcmp(msg, "control") == 0)
+        {
+            uint32_t index;
+            float value;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(index), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsFloat(value), true);
+
+            ++fControls;
+            return true;
+        }
+
+        if (std::strcmp(msg, "atom") == 0)
+        {
+            uint32_t index, atomTotalSize, base64Size;
+            const char* base64atom;
+
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(index), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(atomTotalSize), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(base64Size), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsString(base64atom, false, base64Size), true);
+
+            const std::vector<uint8_t> chunk(carla_getChunkFromBase64String(base64atom));
+            CARLA_SAFE_ASSERT_RETURN(chunk.size() == atomTotalSize, true);
+
+            ++fAtoms;
+            return true;
+        }
+
+        if (std::strcmp(msg, "done") == 0)
+        {
+            char tmpBuf[0xff];
+            std::snprintf(tmpBuf, 0xfe, "done\n%u\n%u\n", fControls, fAtoms);
+            tmpBuf[0xfe] = '\0';
+
+            const CarlaMutexLocker cml(getPipeLock());
+            writeMessage(tmpBuf);
+            syncMessages();
+
+            fControls = fAtoms = 0;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool recordReceived(const uint32_t type, const void* const data, const uint32_t size) noexcept override
+    {
+        switch (type)
+        {
+        case kCarlaPipeRecordControls:
+            fControls += size / sizeof(CarlaPipeControlValue);
+            return true;
+        case kCarlaPipeRecordAtom:
+            CARLA_SAFE_ASSERT_RETURN(size >= sizeof(uint32_t)*2 + sizeof(LV2_Atom), true);
+            CARLA_SAFE_ASSERT_RETURN(sizeof(LV2_Atom) + reinterpret_cast<const LV2_Atom*>(
+                static_cast<const uint8_t*>(data) + sizeof(uint32_t)*2)->size == size - sizeof(uint32_t)*2, true);
+            ++fAtoms;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    uint32_t fControls;
+    uint32_t fAtoms;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+class BenchmarkServer : public CarlaPipeServer
+{
+public:
+    BenchmarkServer(const bool binary)
+        : fDone(false),
+          fControls(0),
+          fAtoms(0)
+    {
+        setBinaryFramingAllowed(binary);
+    }
+
+    // write "done" and wait for the client to report what it received
+    bool waitForClient(uint32_t& controls, uint32_t& atoms)
+    {
+        fDone = false;
+
+        {
+            const CarlaMutexLocker cml(getPipeLock());
+            writeMessage("done\n", 5);
+            syncMessages();
+        }
+
+        for (const uint32_t timeoutEnd = carla_gettime_ms() + 60 * 1000; ! fDone && isPipeRunning();)
+        {
+            idlePipe();
+
+            if (carla_gettime_ms() >= timeoutEnd)
+                return false;
+        }
+
+        controls = fControls;
+        atoms = fAtoms;
+        return fDone;
+    }
+
+protected:
+    bool msgReceived(const char* const msg) noexcept override
+    {
+        if (std::strcmp(msg, "done") == 0)
+        {
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(fControls), true);
+            CARLA_SAFE_ASSERT_RETURN(readNextLineAsUInt(fAtoms), true);
+            fDone = true;
+            return true;
+        }
+
+        return false;
+    }
+
+private:
+    bool fDone;
+    uint32_t fControls;
+    uint32_t fAtoms;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+static bool runBenchmark(const char* const filename, const bool binary)
+{
+    BenchmarkServer server(binary);
+
+    if (! server.startPipeServer(filename, "client", binary ? "binary" : "text", kPipeSize))
+        return false;
+
+    if (binary)
+    {
+        for (const uint32_t timeoutEnd = carla_gettime_ms() + 2000; ! server.isUsingBinaryFraming();)
+        {
+            server.idlePipe();
+
+            if (carla_gettime_ms() >= timeoutEnd)
+            {
+                carla_stderr2("binary framing was not negotiated");
+                return false;
+            }
+
+            carla_msleep(1);
+        }
+    }
+
+    uint32_t controls = 0, atoms = 0;
+
+    // controls
+    uint64_t start = carla_gettime_us();
+
+    for (uint32_t i=0; i < kNumControls; ++i)
+        server.writeControlMessage(i % 64, static_cast<float>(i) / kNumControls);
+
+    server.flushControlMessages();
+
+    const bool controlsOk = server.waitForClient(controls, atoms) && controls == kNumControls;
+    const uint64_t controlsTime = carla_gettime_us() - start;
+
+    // atoms
+    uint8_t atomBuf[sizeof(LV2_Atom) + kAtomBodySize];
+    LV2_Atom* const atom = reinterpret_cast<LV2_Atom*>(atomBuf);
+    atom->size = kAtomBodySize;
+    atom->type = 1;
+
+    for (uint32_t i=0; i < kAtomBodySize; ++i)
+        atomBuf[sizeof(LV2_Atom) + i] = static_cast<uint8_t>(i);
+
+    start = carla_gettime_us();
+
+    for (uint32_t i=0; i < kNumAtoms; ++i)
+        server.writeLv2AtomMessage(0, atom);
+
+    const bool atomsOk = server.waitForClient(controls, atoms) && atoms == kNumAtoms;
+    const uint64_t atomsTime = carla_gettime_us() - start;
+
+    server.stopPipeServer(5000);
+
+    carla_stdout("%s framing: %u controls in %.1f ms (%.0f/s) %s, %u atoms of %u bytes in %.1f ms (%.0f/s) %s",
+                 binary ? "binary" : "text  ",
+                 kNumControls, static_cast<double>(controlsTime) / 1000.0,
+                 kNumControls * 1000000.0 / static_cast<double>(controlsTime), controlsOk ? "ok" : "FAILED",
+                 kNumAtoms, kAtomBodySize, static_cast<double>(atomsTime) / 1000.0,
+                 kNumAtoms * 1000000.0 / static_cast<double>(atomsTime), atomsOk ? "ok" : "FAILED");
+
+    return controlsOk && atomsOk;
+}
+
+static int runClient(const char* argv[])
+{
+    BenchmarkClient client(std::strcmp(argv[2], "binary") == 0);
+
+    if (! client.initPipeClient(argv))
+        return 1;
+
+    while (client.isPipeRunning())
+    {
+        client.idlePipe();
+        carla_msleep(1);
+    }
+
+    client.closePipeClient();
+    return 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, const char* argv[])
+{
+    if (argc == 7 && std::strcmp(argv[1], "client") == 0)
+        return runClient(argv);
+
+    const bool textOk = runBenchmark(argv[0], false);
+    const bool binaryOk = runBenchmark(argv[0], true);
+
+    return textOk && binaryOk ? 0 : 1;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "CarlaPipeUtils.cpp"
+
+// --------------------------------------------------------------------------------------------------------------------
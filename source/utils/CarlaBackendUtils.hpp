@@ -326,6 +326,8 @@ const char* EngineCallbackOpcode2Str(const EngineCallbackOpcode opcode) noexcept
         return "ENGINE_CALLBACK_PATCHBAY_CLIENT_POSITION_CHANGED";
     case ENGINE_CALLBACK_EMBED_UI_RESIZED:
         return "ENGINE_CALLBACK_EMBED_UI_RESIZED";
+    case ENGINE_CALLBACK_RT_SAFETY_VIOLATION:
+        return "ENGINE_CALLBACK_RT_SAFETY_VIOLATION";
     }
 
     carla_stderr("CarlaBackend::EngineCallbackOpcode2Str(%i) - invalid opcode", opcode);
@@ -415,6 +417,32 @@ const char* EngineOption2Str(const EngineOption option) noexcept
         return "ENGINE_OPTION_CLIENT_NAME_PREFIX";
     case ENGINE_OPTION_PLUGINS_ARE_STANDALONE:
         return "ENGINE_OPTION_PLUGINS_ARE_STANDALONE";
+    case ENGINE_OPTION_PROJECT_BINARY_DATA:
+        return "ENGINE_OPTION_PROJECT_BINARY_DATA";
+    case ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS:
+        return "ENGINE_OPTION_PLUGIN_DISCOVERY_WORKERS";
+    case ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH:
+        return "ENGINE_OPTION_PLUGIN_DISCOVERY_CONTENT_HASH";
+    case ENGINE_OPTION_AUDIO_CPU_SET:
+        return "ENGINE_OPTION_AUDIO_CPU_SET";
+    case ENGINE_OPTION_WORKER_CPU_SET:
+        return "ENGINE_OPTION_WORKER_CPU_SET";
+    case ENGINE_OPTION_RT_PRIORITY:
+        return "ENGINE_OPTION_RT_PRIORITY";
+    case ENGINE_OPTION_BRIDGE_LOCK_MEMORY:
+        return "ENGINE_OPTION_BRIDGE_LOCK_MEMORY";
+    case ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT:
+        return "ENGINE_OPTION_PLUGIN_SLEEP_TIMEOUT";
+    case ENGINE_OPTION_SUB_BLOCK_GRANULARITY:
+        return "ENGINE_OPTION_SUB_BLOCK_GRANULARITY";
+    case ENGINE_OPTION_CV_EVENT_RESOLUTION:
+        return "ENGINE_OPTION_CV_EVENT_RESOLUTION";
+    case ENGINE_OPTION_WORKER_THREADS:
+        return "ENGINE_OPTION_WORKER_THREADS";
+    case ENGINE_OPTION_FLUIDSYNTH_CPU_CORES:
+        return "ENGINE_OPTION_FLUIDSYNTH_CPU_CORES";
+    case ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE:
+        return "ENGINE_OPTION_PLUGIN_BRIDGE_POOL_SIZE";
     }
 
     carla_stderr("CarlaBackend::EngineOption2Str(%i) - invalid option", option);
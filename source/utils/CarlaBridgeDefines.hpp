@@ -24,7 +24,7 @@
 #define CARLA_PLUGIN_BRIDGE_API_VERSION_MINIMUM 6
 
 // current API version, bumped when something is added
-#define CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT 10
+#define CARLA_PLUGIN_BRIDGE_API_VERSION_CURRENT 11
 
 // -------------------------------------------------------------------------------------------------------------------
 
@@ -91,6 +91,8 @@ enum PluginBridgeNonRtClientOpcode {
     kPluginBridgeNonRtClientEmbedUI,                        // ulong
     // stuff added in API 10
     kPluginBridgeNonRtClientReload,
+    // stuff added in API 11
+    kPluginBridgeNonRtClientAddGroupPlugin,                 // uint/type, uint/size, str[] (filename), uint/size, str[] (label), long/uniqueId
 };
 
 // Client sends these to server during non-RT
@@ -131,6 +131,8 @@ const char* PluginBridgeNonRtClientOpcode2str(const PluginBridgeNonRtClientOpcod
         return "kPluginBridgeNonRtClientEmbedUI";
     case kPluginBridgeNonRtClientReload:
         return "kPluginBridgeNonRtClientReload";
+    case kPluginBridgeNonRtClientAddGroupPlugin:
+        return "kPluginBridgeNonRtClientAddGroupPlugin";
     }
 
     carla_stderr("CarlaBackend::PluginBridgeNonRtClientOpcode2str(%i) - invalid opcode", opcode);
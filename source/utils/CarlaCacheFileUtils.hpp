@@ -0,0 +1,328 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_CACHE_FILE_UTILS_HPP_INCLUDED
+#define CARLA_CACHE_FILE_UTILS_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include "water/files/File.h"
+#include "water/files/TemporaryFile.h"
+
+#include <vector>
+
+#ifdef CARLA_OS_WIN
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Per-user directory for Carla cache files
+
+static inline
+water::File carla_cache_directory()
+{
+    using water::File;
+
+   #if defined(CARLA_OS_WIN)
+    const char* const localAppData = std::getenv("LOCALAPPDATA");
+    const File base(localAppData != nullptr && localAppData[0] != '\0'
+                    ? File(localAppData)
+                    : File::getSpecialLocation(File::tempDirectory));
+   #elif defined(CARLA_OS_MAC)
+    const File base(File::getSpecialLocation(File::userHomeDirectory).getChildFile("Library").getChildFile("Caches"));
+   #else
+    const char* const xdgCacheHome = std::getenv("XDG_CACHE_HOME");
+    const File base(xdgCacheHome != nullptr && xdgCacheHome[0] == '/'
+                    ? File(xdgCacheHome)
+                    : File::getSpecialLocation(File::userHomeDirectory).getChildFile(".cache"));
+   #endif
+
+    return base.getChildFile("falkTX").getChildFile("Carla");
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Read-only memory mapped file
+
+class CarlaMappedFile
+{
+public:
+    CarlaMappedFile() noexcept
+        : fData(nullptr),
+          fSize(0)
+         #ifdef CARLA_OS_WIN
+        , fFile(INVALID_HANDLE_VALUE),
+          fMapping(nullptr)
+         #endif
+    {
+    }
+
+    ~CarlaMappedFile() noexcept
+    {
+        unmap();
+    }
+
+    bool map(const char* const filename) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(filename != nullptr && filename[0] != '\0', false);
+
+        unmap();
+
+       #ifdef CARLA_OS_WIN
+        fFile = ::CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (fFile == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+
+        if (::GetFileSizeEx(fFile, &size) && size.QuadPart > 0)
+        {
+            fMapping = ::CreateFileMappingA(fFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+            if (fMapping != nullptr)
+            {
+                fData = ::MapViewOfFile(fMapping, FILE_MAP_READ, 0, 0, 0);
+                fSize = static_cast<std::size_t>(size.QuadPart);
+            }
+        }
+       #else
+        const int fd = ::open(filename, O_RDONLY);
+
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+
+        if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* const data = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (data != MAP_FAILED)
+            {
+                fData = data;
+                fSize = static_cast<std::size_t>(st.st_size);
+            }
+        }
+
+        // the mapping keeps its own reference to the file
+        ::close(fd);
+       #endif
+
+        if (fData != nullptr)
+            return true;
+
+        unmap();
+        return false;
+    }
+
+    void unmap() noexcept
+    {
+       #ifdef CARLA_OS_WIN
+        if (fData != nullptr)
+            ::UnmapViewOfFile(fData);
+        if (fMapping != nullptr)
+            ::CloseHandle(fMapping);
+        if (fFile != INVALID_HANDLE_VALUE)
+            ::CloseHandle(fFile);
+
+        fMapping = nullptr;
+        fFile = INVALID_HANDLE_VALUE;
+       #else
+        if (fData != nullptr)
+            ::munmap(fData, fSize);
+       #endif
+
+        fData = nullptr;
+        fSize = 0;
+    }
+
+    const void* getData() const noexcept
+    {
+        return fData;
+    }
+
+    std::size_t getSize() const noexcept
+    {
+        return fSize;
+    }
+
+private:
+    void* fData;
+    std::size_t fSize;
+
+   #ifdef CARLA_OS_WIN
+    HANDLE fFile;
+    HANDLE fMapping;
+   #endif
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaMappedFile)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Binary serialization, native endianness as the cache is never shared between machines
+
+class CarlaCacheWriter
+{
+public:
+    CarlaCacheWriter()
+        : fData()
+    {
+        fData.reserve(4096);
+    }
+
+    void writeUInt(const uint32_t value)
+    {
+        write(&value, sizeof(value));
+    }
+
+    void writeULong(const uint64_t value)
+    {
+        write(&value, sizeof(value));
+    }
+
+    void writeFloat(const float value)
+    {
+        write(&value, sizeof(value));
+    }
+
+    // null is stored as a special length, strings are kept null-terminated so they can be used in place
+    void writeString(const char* const str)
+    {
+        if (str == nullptr)
+        {
+            writeUInt(~0U);
+            return;
+        }
+
+        const uint32_t len = static_cast<uint32_t>(std::strlen(str));
+        writeUInt(len);
+        write(str, len + 1);
+    }
+
+    // write to a temporary file first, so readers never see a partially written cache
+    bool saveTo(const water::File& file) const
+    {
+        const water::File dir(file.getParentDirectory());
+
+        if (! dir.isDirectory() && dir.createDirectory().failed())
+            return false;
+
+        const water::TemporaryFile tmpFile(file);
+
+        if (! tmpFile.getFile().replaceWithData(fData.data(), fData.size()))
+            return false;
+
+        return tmpFile.overwriteTargetFileWithTemporary();
+    }
+
+private:
+    std::vector<uint8_t> fData;
+
+    void write(const void* const data, const std::size_t size)
+    {
+        const uint8_t* const bytes = static_cast<const uint8_t*>(data);
+        fData.insert(fData.end(), bytes, bytes + size);
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaCacheWriter)
+};
+
+class CarlaCacheReader
+{
+public:
+    CarlaCacheReader(const void* const data, const std::size_t size) noexcept
+        : fData(static_cast<const uint8_t*>(data)),
+          fSize(size),
+          fPos(0) {}
+
+    bool readUInt(uint32_t& value) noexcept
+    {
+        return read(&value, sizeof(value));
+    }
+
+    bool readULong(uint64_t& value) noexcept
+    {
+        return read(&value, sizeof(value));
+    }
+
+    bool readFloat(float& value) noexcept
+    {
+        return read(&value, sizeof(value));
+    }
+
+    // reads a number of items, failing if the remaining data is too small to hold that many of them
+    bool readCount(uint32_t& count, const std::size_t minItemSize) noexcept
+    {
+        uint32_t value;
+
+        if (! readUInt(value))
+            return false;
+
+        if (minItemSize != 0 && value > (fSize - fPos) / minItemSize)
+            return false;
+
+        count = value;
+        return true;
+    }
+
+    // returns a pointer into the mapped data, valid for as long as the data is
+    bool readString(const char*& str) noexcept
+    {
+        uint32_t len;
+
+        if (! readUInt(len))
+            return false;
+
+        if (len == ~0U)
+        {
+            str = nullptr;
+            return true;
+        }
+
+        if (len >= fSize - fPos || fData[fPos + len] != '\0')
+            return false;
+
+        str = reinterpret_cast<const char*>(fData + fPos);
+        fPos += len + 1;
+        return true;
+    }
+
+    // returns a new copy, to be deleted with delete[]
+    bool readStringCopy(const char*& str) noexcept
+    {
+        const char* tmp;
+
+        if (! readString(tmp))
+            return false;
+
+        str = tmp != nullptr ? carla_strdup_safe(tmp) : nullptr;
+        return true;
+    }
+
+private:
+    const uint8_t* const fData;
+    const std::size_t fSize;
+    std::size_t fPos;
+
+    bool read(void* const value, const std::size_t size) noexcept
+    {
+        if (size > fSize - fPos)
+            return false;
+
+        std::memcpy(value, fData + fPos, size);
+        fPos += size;
+        return true;
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaCacheReader)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_CACHE_FILE_UTILS_HPP_INCLUDED
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_ENGINE_TRACE_HPP_INCLUDED
+#define CARLA_ENGINE_TRACE_HPP_INCLUDED
+
+#include "CarlaBackend.h"
+#include "CarlaTimeUtils.hpp"
+
+#include <atomic>
+
+CARLA_BACKEND_START_NAMESPACE
+
+class CarlaEngine;
+
+// -----------------------------------------------------------------------
+// Engine trace event, recorded from any thread
+
+struct EngineTraceEvent {
+    // static string, never copied
+    const char* name;
+    // carla_gettime_ns() values, equal for instant events
+    uint64_t startTime;
+    uint64_t endTime;
+    // plugin the event belongs to, or -1
+    int32_t pluginId;
+    // index of the recording thread
+    uint32_t threadIndex;
+};
+
+// -----------------------------------------------------------------------
+// CarlaEngineTrace
+
+/*
+   Process-wide recorder of timestamped spans, exported as Chrome trace JSON (which Perfetto also reads).
+
+   Each recording thread gets its own lock-free ring, claimed on its first event and released when the thread exits.
+   Rings are drained by the engine runner thread into a bounded history that keeps the most recent events.
+
+   When disabled, recording costs a single relaxed atomic load per span, with no time queries.
+  */
+
+class CarlaEngineTrace
+{
+public:
+    static bool isEnabled() noexcept
+    {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * Record a span, or an instant event if @a startTime equals @a endTime.
+     * @note RT-safe
+     */
+    static void addEvent(const char* name, uint64_t startTime, uint64_t endTime, int32_t pluginId = -1) noexcept;
+
+    /*
+     * Record an instant event at the current time, if enabled.
+     * @note RT-safe
+     */
+    static void addInstantEvent(const char* const name) noexcept
+    {
+        if (! isEnabled())
+            return;
+
+        const uint64_t now = carla_gettime_ns();
+        addEvent(name, now, now);
+    }
+
+    /*
+     * Start or stop recording.
+     * Enabling for the first time allocates the per-thread rings, enabling again clears the previous history.
+     */
+    static void setEnabled(bool enabled);
+
+    /*
+     * Move the events recorded so far from the per-thread rings into the history.
+     * Called regularly by the engine runner.
+     */
+    static void collect() noexcept;
+
+    /*
+     * Write the history into @a filename as Chrome trace JSON.
+     * Plugin names are resolved through @a engine at the time of saving.
+     */
+    static bool saveToFile(const CarlaEngine* engine, const char* filename);
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+// -----------------------------------------------------------------------
+// Helper to record a span for the current scope
+
+class ScopedEngineTraceSpan
+{
+public:
+    ScopedEngineTraceSpan(const char* const name, const int32_t pluginId = -1) noexcept
+        : fName(name),
+          fPluginId(pluginId),
+          fEnabled(CarlaEngineTrace::isEnabled()),
+          fStartTime(fEnabled ? carla_gettime_ns() : 0) {}
+
+    ~ScopedEngineTraceSpan() noexcept
+    {
+        if (fEnabled)
+            CarlaEngineTrace::addEvent(fName, fStartTime, carla_gettime_ns(), fPluginId);
+    }
+
+private:
+    const char* const fName;
+    const int32_t fPluginId;
+    const bool fEnabled;
+    const uint64_t fStartTime;
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPYABLE(ScopedEngineTraceSpan)
+};
+
+// -----------------------------------------------------------------------
+
+CARLA_BACKEND_END_NAMESPACE
+
+#endif // CARLA_ENGINE_TRACE_HPP_INCLUDED
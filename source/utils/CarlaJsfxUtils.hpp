@@ -24,6 +24,8 @@
 
 #include "water/files/File.h"
 
+#include <vector>
+
 #ifdef YSFX_API
 # error YSFX_API is not private
 #endif
@@ -173,6 +175,81 @@ private:
     CarlaString fRootPath;
 };
 
+// --------------------------------------------------------------------------------------------------------------------
+// Size and modification time of all source files of an effect, used to find out if cached data is outdated
+
+struct CarlaJsfxSourceFile
+{
+    CarlaString path;
+    int64_t size;
+    int64_t mtime;
+
+    CarlaJsfxSourceFile(const char* const filePath)
+        : path(filePath),
+          size(0),
+          mtime(0)
+    {
+        const water::File file(filePath);
+        size = file.getSize();
+        mtime = file.getLastModificationTime();
+    }
+
+    CarlaJsfxSourceFile(const char* const filePath, const int64_t fileSize, const int64_t fileMTime)
+        : path(filePath),
+          size(fileSize),
+          mtime(fileMTime) {}
+
+    bool isUpToDate() const
+    {
+        const water::File file(path.buffer());
+        return file.existsAsFile() && file.getSize() == size && file.getLastModificationTime() == mtime;
+    }
+};
+
+struct CarlaJsfxSourceFiles
+{
+    std::vector<CarlaJsfxSourceFile> files;
+
+    CarlaJsfxSourceFiles()
+        : files() {}
+
+    // store the main file and imports of a loaded effect, or only @a filePath if loading failed
+    void setFromEffect(ysfx_t* const effect, const char* const filePath)
+    {
+        files.clear();
+
+        if (const uint32_t fileCount = ysfx_get_source_files(effect, nullptr, 0))
+        {
+            std::vector<const char*> paths;
+            paths.resize(fileCount);
+            ysfx_get_source_files(effect, paths.data(), fileCount);
+
+            files.reserve(fileCount);
+
+            for (uint32_t i=0; i<fileCount; ++i)
+                files.push_back(CarlaJsfxSourceFile(paths[i]));
+        }
+        else
+        {
+            files.push_back(CarlaJsfxSourceFile(filePath));
+        }
+    }
+
+    bool isUpToDate() const
+    {
+        if (files.empty())
+            return false;
+
+        for (std::vector<CarlaJsfxSourceFile>::const_iterator it = files.begin(), end = files.end(); it != end; ++it)
+        {
+            if (! it->isUpToDate())
+                return false;
+        }
+
+        return true;
+    }
+};
+
 // --------------------------------------------------------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
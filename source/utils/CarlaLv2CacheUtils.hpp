@@ -0,0 +1,668 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_LV2_CACHE_UTILS_HPP_INCLUDED
+#define CARLA_LV2_CACHE_UTILS_HPP_INCLUDED
+
+#include "CarlaCacheFileUtils.hpp"
+#include "CarlaLv2Utils.hpp"
+#include "CarlaMutex.hpp"
+#include "CarlaSha1Utils.hpp"
+
+#include <algorithm>
+#include <string>
+
+// --------------------------------------------------------------------------------------------------------------------
+// On-disk cache of LV2 data, so that processes do not need to parse all Turtle files on every start.
+//
+// Everything in the cache is tied to a signature of the LV2 bundles found in LV2_PATH,
+// made from bundle paths plus the size and modification time of their top-level Turtle files.
+// Any installed, removed or modified bundle invalidates the cache, which is then rebuilt using lilv.
+
+static constexpr const uint32_t kLv2CacheMagic   = 0x32564c43; // "CLV2"
+static constexpr const uint32_t kLv2CacheVersion = 1;
+
+// --------------------------------------------------------------------------------------------------------------------
+// Expand variables in a LV2_PATH entry, matching what lilv does
+
+static inline
+water::String lv2_cache_expand_path(const water::String& path)
+{
+   #ifdef CARLA_OS_WIN
+    char expanded[MAX_PATH];
+
+    if (::ExpandEnvironmentStringsA(path.toRawUTF8(), expanded, MAX_PATH) == 0)
+        return path;
+
+    return water::String(expanded);
+   #else
+    const char* const home = std::getenv("HOME");
+    std::string expanded;
+
+    for (const char* s = path.toRawUTF8(); *s != '\0';)
+    {
+        if (*s == '$')
+        {
+            const char* t = s + 1;
+            while (std::isupper(*t) || std::isdigit(*t) || *t == '_')
+                ++t;
+
+            const std::string var(s + 1, static_cast<std::size_t>(t - s - 1));
+
+            if (const char* const value = std::getenv(var.c_str()))
+                expanded += value;
+            else
+                expanded += "$" + var;
+
+            s = t;
+        }
+        else if (*s == '~' && (s[1] == '/' || s[1] == '\0'))
+        {
+            expanded += home != nullptr ? home : "~";
+            ++s;
+        }
+        else
+        {
+            expanded += *s++;
+        }
+    }
+
+    return water::String(expanded.c_str());
+   #endif
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Our LV2 Cache class
+
+class Lv2CacheClass
+{
+public:
+    Lv2CacheClass()
+        : fMutex(),
+          fPath(),
+          fSignature() {}
+
+    static Lv2CacheClass& getInstance()
+    {
+        static Lv2CacheClass lv2Cache;
+        return lv2Cache;
+    }
+
+    static water::File getDirectory()
+    {
+        return carla_cache_directory().getChildFile("lv2");
+    }
+
+    static water::File getFileForKey(const char* const prefix, const char* const key)
+    {
+        CarlaSha1 sha1;
+        sha1.write(key, std::strlen(key));
+
+        const water::String filename(water::String(prefix) + sha1.resultAsString() + ".bin");
+        return getDirectory().getChildFile(filename.toRawUTF8());
+    }
+
+    // signature of all LV2 bundles in @a LV2_PATH, computed once per process for each path
+    CarlaString getSignature(const char* const LV2_PATH)
+    {
+        CARLA_SAFE_ASSERT_RETURN(LV2_PATH != nullptr, CarlaString());
+
+        const CarlaMutexLocker cml(fMutex);
+
+        if (fSignature.isEmpty() || fPath != LV2_PATH)
+        {
+            fPath = LV2_PATH;
+            fSignature = computeSignature(LV2_PATH);
+        }
+
+        return fSignature;
+    }
+
+private:
+    CarlaMutex fMutex;
+    CarlaString fPath;
+    CarlaString fSignature;
+
+    static CarlaString computeSignature(const char* const LV2_PATH)
+    {
+        using water::File;
+        using water::String;
+        using water::StringArray;
+
+        CarlaSha1 sha1;
+
+        const uint32_t header[2] = { kLv2CacheVersion, CARLA_VERSION_HEX };
+        sha1.write(header, sizeof(header));
+        sha1.write(LV2_PATH, std::strlen(LV2_PATH));
+
+        const StringArray paths(StringArray::fromTokens(LV2_PATH, CARLA_OS_SPLIT_STR, ""));
+
+        for (const String *it = paths.begin(), *end = paths.end(); it != end; ++it)
+        {
+            const File dir(lv2_cache_expand_path(*it).toRawUTF8());
+
+            if (! dir.isDirectory())
+                continue;
+
+            std::vector<File> bundles;
+            dir.findChildFiles(bundles, File::findDirectories, false);
+            std::sort(bundles.begin(), bundles.end());
+
+            for (std::vector<File>::const_iterator itb = bundles.begin(); itb != bundles.end(); ++itb)
+            {
+                const File& bundle(*itb);
+
+                if (! bundle.getChildFile("manifest.ttl").existsAsFile())
+                    continue;
+
+                const String bundlePath(bundle.getFullPathName());
+                sha1.write(bundlePath.toRawUTF8(), bundlePath.length());
+
+                std::vector<File> ttls;
+                bundle.findChildFiles(ttls, File::findFiles, false, "*.ttl");
+                std::sort(ttls.begin(), ttls.end());
+
+                for (std::vector<File>::const_iterator itt = ttls.begin(); itt != ttls.end(); ++itt)
+                {
+                    const File& ttl(*itt);
+                    const String filename(ttl.getFileName());
+                    const int64_t stamp[2] = { ttl.getSize(), ttl.getLastModificationTime() };
+
+                    sha1.write(filename.toRawUTF8(), filename.length());
+                    sha1.write(stamp, sizeof(stamp));
+                }
+            }
+        }
+
+        return CarlaString(sha1.resultAsString());
+    }
+
+    CARLA_DECLARE_NON_COPYABLE(Lv2CacheClass)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Cache file header, shared by all cache files
+
+static inline
+void lv2_cache_write_header(CarlaCacheWriter& writer, const char* const signature, const char* const key)
+{
+    writer.writeUInt(kLv2CacheMagic);
+    writer.writeUInt(kLv2CacheVersion);
+    writer.writeString(signature);
+    writer.writeString(key);
+}
+
+static inline
+bool lv2_cache_read_header(CarlaCacheReader& reader, const char* const signature, const char* const key)
+{
+    uint32_t magic, version;
+    const char* fileSignature;
+    const char* fileKey;
+
+    if (! (reader.readUInt(magic) && reader.readUInt(version)))
+        return false;
+    if (magic != kLv2CacheMagic || version != kLv2CacheVersion)
+        return false;
+    if (! (reader.readString(fileSignature) && reader.readString(fileKey)))
+        return false;
+    if (fileSignature == nullptr || fileKey == nullptr)
+        return false;
+
+    return std::strcmp(fileSignature, signature) == 0 && std::strcmp(fileKey, key) == 0;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// RDF descriptor serialization
+
+// smallest serialized size of each item, used to validate the counts read from a cache file
+static constexpr const std::size_t kLv2CacheMinStringSize  = sizeof(uint32_t); // null string, only its length
+static constexpr const std::size_t kLv2CacheMinUnitSize    = 7 * sizeof(uint32_t) + 3 * kLv2CacheMinStringSize;
+static constexpr const std::size_t kLv2CacheMinPortSize    = 5 * sizeof(uint32_t) + 4 * kLv2CacheMinStringSize
+                                                           + kLv2CacheMinUnitSize;
+static constexpr const std::size_t kLv2CacheMinParamSize   = 2 * sizeof(uint32_t) + 4 * kLv2CacheMinStringSize
+                                                           + kLv2CacheMinUnitSize;
+static constexpr const std::size_t kLv2CacheMinUISize      = 4 * sizeof(uint32_t) + 3 * kLv2CacheMinStringSize;
+static constexpr const std::size_t kLv2CacheMinPluginSize  = 11 * sizeof(uint32_t) + 4 * kLv2CacheMinStringSize;
+
+static inline
+void lv2_cache_write_unit(CarlaCacheWriter& writer, const LV2_RDF_PortMidiMap& midiMap,
+                          const LV2_RDF_PortPoints& points, const LV2_RDF_PortUnit& unit)
+{
+    writer.writeUInt(midiMap.Type);
+    writer.writeUInt(midiMap.Number);
+    writer.writeUInt(points.Hints);
+    writer.writeFloat(points.Default);
+    writer.writeFloat(points.Minimum);
+    writer.writeFloat(points.Maximum);
+    writer.writeUInt(unit.Hints);
+    writer.writeString(unit.Name);
+    writer.writeString(unit.Render);
+    writer.writeString(unit.Symbol);
+    writer.writeUInt(unit.Unit);
+}
+
+static inline
+bool lv2_cache_read_unit(CarlaCacheReader& reader, LV2_RDF_PortMidiMap& midiMap,
+                         LV2_RDF_PortPoints& points, LV2_RDF_PortUnit& unit)
+{
+    return reader.readUInt(midiMap.Type)
+        && reader.readUInt(midiMap.Number)
+        && reader.readUInt(points.Hints)
+        && reader.readFloat(points.Default)
+        && reader.readFloat(points.Minimum)
+        && reader.readFloat(points.Maximum)
+        && reader.readUInt(unit.Hints)
+        && reader.readStringCopy(unit.Name)
+        && reader.readStringCopy(unit.Render)
+        && reader.readStringCopy(unit.Symbol)
+        && reader.readUInt(unit.Unit);
+}
+
+static inline
+void lv2_cache_write_features(CarlaCacheWriter& writer, const uint32_t count, const LV2_RDF_Feature* const features)
+{
+    writer.writeUInt(count);
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        writer.writeUInt(features[i].Required ? 1 : 0);
+        writer.writeString(features[i].URI);
+    }
+}
+
+static inline
+bool lv2_cache_read_features(CarlaCacheReader& reader, uint32_t& count, LV2_RDF_Feature*& features)
+{
+    if (! reader.readCount(count, sizeof(uint32_t) + kLv2CacheMinStringSize))
+        return false;
+    if (count == 0)
+        return true;
+
+    features = new LV2_RDF_Feature[count];
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        uint32_t required;
+
+        if (! (reader.readUInt(required) && reader.readStringCopy(features[i].URI)))
+            return false;
+
+        features[i].Required = required != 0;
+    }
+
+    return true;
+}
+
+static inline
+void lv2_cache_write_extensions(CarlaCacheWriter& writer, const uint32_t count, const LV2_URI* const extensions)
+{
+    writer.writeUInt(count);
+
+    for (uint32_t i=0; i<count; ++i)
+        writer.writeString(extensions[i]);
+}
+
+static inline
+bool lv2_cache_read_extensions(CarlaCacheReader& reader, uint32_t& count, LV2_URI*& extensions)
+{
+    if (! reader.readCount(count, kLv2CacheMinStringSize))
+        return false;
+    if (count == 0)
+        return true;
+
+    extensions = new LV2_URI[count];
+    carla_zeroPointers(extensions, count);
+
+    for (uint32_t i=0; i<count; ++i)
+    {
+        if (! reader.readStringCopy(extensions[i]))
+            return false;
+    }
+
+    return true;
+}
+
+static inline
+void lv2_cache_write_rdf(CarlaCacheWriter& writer, const LV2_RDF_Descriptor* const desc)
+{
+    writer.writeUInt(desc->Type[0]);
+    writer.writeUInt(desc->Type[1]);
+    writer.writeString(desc->URI);
+    writer.writeString(desc->Name);
+    writer.writeString(desc->Author);
+    writer.writeString(desc->License);
+    writer.writeString(desc->Binary);
+    writer.writeString(desc->Bundle);
+    writer.writeULong(desc->UniqueID);
+
+    writer.writeUInt(desc->PortCount);
+
+    for (uint32_t i=0; i<desc->PortCount; ++i)
+    {
+        const LV2_RDF_Port& port(desc->Ports[i]);
+
+        writer.writeUInt(port.Types);
+        writer.writeUInt(port.Properties);
+        writer.writeUInt(port.Designation);
+        writer.writeString(port.Name);
+        writer.writeString(port.Symbol);
+        writer.writeString(port.Comment);
+        writer.writeString(port.GroupURI);
+        lv2_cache_write_unit(writer, port.MidiMap, port.Points, port.Unit);
+        writer.writeUInt(port.MinimumSize);
+
+        writer.writeUInt(port.ScalePointCount);
+
+        for (uint32_t j=0; j<port.ScalePointCount; ++j)
+        {
+            writer.writeString(port.ScalePoints[j].Label);
+            writer.writeFloat(port.ScalePoints[j].Value);
+        }
+    }
+
+    writer.writeUInt(desc->ParameterCount);
+
+    for (uint32_t i=0; i<desc->ParameterCount; ++i)
+    {
+        const LV2_RDF_Parameter& param(desc->Parameters[i]);
+
+        writer.writeString(param.URI);
+        writer.writeUInt(param.Type);
+        writer.writeUInt(param.Flags);
+        writer.writeString(param.Label);
+        writer.writeString(param.Comment);
+        writer.writeString(param.GroupURI);
+        lv2_cache_write_unit(writer, param.MidiMap, param.Points, param.Unit);
+    }
+
+    // port group URIs point to a port or parameter group string, store which one
+    writer.writeUInt(desc->PortGroupCount);
+
+    for (uint32_t i=0; i<desc->PortGroupCount; ++i)
+    {
+        const LV2_RDF_PortGroup& portGroup(desc->PortGroups[i]);
+        uint32_t owner = ~0U;
+
+        for (uint32_t j=0; j<desc->PortCount && owner == ~0U; ++j)
+        {
+            if (desc->Ports[j].GroupURI == portGroup.URI)
+                owner = j;
+        }
+
+        for (uint32_t j=0; j<desc->ParameterCount && owner == ~0U; ++j)
+        {
+            if (desc->Parameters[j].GroupURI == portGroup.URI)
+                owner = desc->PortCount + j;
+        }
+
+        writer.writeUInt(owner);
+        writer.writeString(portGroup.Name);
+        writer.writeString(portGroup.Symbol);
+    }
+
+    writer.writeUInt(desc->PresetCount);
+
+    for (uint32_t i=0; i<desc->PresetCount; ++i)
+    {
+        writer.writeString(desc->Presets[i].URI);
+        writer.writeString(desc->Presets[i].Label);
+    }
+
+    lv2_cache_write_features(writer, desc->FeatureCount, desc->Features);
+    lv2_cache_write_extensions(writer, desc->ExtensionCount, desc->Extensions);
+
+    writer.writeUInt(desc->UICount);
+
+    for (uint32_t i=0; i<desc->UICount; ++i)
+    {
+        const LV2_RDF_UI& ui(desc->UIs[i]);
+
+        writer.writeUInt(ui.Type);
+        writer.writeString(ui.URI);
+        writer.writeString(ui.Binary);
+        writer.writeString(ui.Bundle);
+        lv2_cache_write_features(writer, ui.FeatureCount, ui.Features);
+        lv2_cache_write_extensions(writer, ui.ExtensionCount, ui.Extensions);
+
+        writer.writeUInt(ui.PortNotificationCount);
+
+        for (uint32_t j=0; j<ui.PortNotificationCount; ++j)
+        {
+            writer.writeString(ui.PortNotifications[j].Symbol);
+            writer.writeUInt(ui.PortNotifications[j].Index);
+            writer.writeUInt(ui.PortNotifications[j].Protocol);
+        }
+    }
+}
+
+static inline
+bool lv2_cache_read_rdf(CarlaCacheReader& reader, LV2_RDF_Descriptor* const desc)
+{
+    uint64_t uniqueId;
+
+    if (! (reader.readUInt(desc->Type[0])
+        && reader.readUInt(desc->Type[1])
+        && reader.readStringCopy(desc->URI)
+        && reader.readStringCopy(desc->Name)
+        && reader.readStringCopy(desc->Author)
+        && reader.readStringCopy(desc->License)
+        && reader.readStringCopy(desc->Binary)
+        && reader.readStringCopy(desc->Bundle)
+        && reader.readULong(uniqueId)))
+        return false;
+
+    desc->UniqueID = static_cast<ulong>(uniqueId);
+
+    if (! reader.readCount(desc->PortCount, kLv2CacheMinPortSize))
+        return false;
+
+    if (desc->PortCount > 0)
+    {
+        desc->Ports = new LV2_RDF_Port[desc->PortCount];
+
+        for (uint32_t i=0; i<desc->PortCount; ++i)
+        {
+            LV2_RDF_Port& port(desc->Ports[i]);
+
+            if (! (reader.readUInt(port.Types)
+                && reader.readUInt(port.Properties)
+                && reader.readUInt(port.Designation)
+                && reader.readStringCopy(port.Name)
+                && reader.readStringCopy(port.Symbol)
+                && reader.readStringCopy(port.Comment)
+                && reader.readStringCopy(port.GroupURI)
+                && lv2_cache_read_unit(reader, port.MidiMap, port.Points, port.Unit)
+                && reader.readUInt(port.MinimumSize)
+                && reader.readCount(port.ScalePointCount, kLv2CacheMinStringSize + sizeof(float))))
+                return false;
+
+            if (port.ScalePointCount == 0)
+                continue;
+
+            port.ScalePoints = new LV2_RDF_PortScalePoint[port.ScalePointCount];
+
+            for (uint32_t j=0; j<port.ScalePointCount; ++j)
+            {
+                if (! (reader.readStringCopy(port.ScalePoints[j].Label)
+                    && reader.readFloat(port.ScalePoints[j].Value)))
+                    return false;
+            }
+        }
+    }
+
+    if (! reader.readCount(desc->ParameterCount, kLv2CacheMinParamSize))
+        return false;
+
+    if (desc->ParameterCount > 0)
+    {
+        desc->Parameters = new LV2_RDF_Parameter[desc->ParameterCount];
+
+        for (uint32_t i=0; i<desc->ParameterCount; ++i)
+        {
+            LV2_RDF_Parameter& param(desc->Parameters[i]);
+
+            if (! (reader.readStringCopy(param.URI)
+                && reader.readUInt(param.Type)
+                && reader.readUInt(param.Flags)
+                && reader.readStringCopy(param.Label)
+                && reader.readStringCopy(param.Comment)
+                && reader.readStringCopy(param.GroupURI)
+                && lv2_cache_read_unit(reader, param.MidiMap, param.Points, param.Unit)))
+                return false;
+        }
+    }
+
+    if (! reader.readCount(desc->PortGroupCount, sizeof(uint32_t) + 2 * kLv2CacheMinStringSize))
+        return false;
+
+    if (desc->PortGroupCount > 0)
+    {
+        desc->PortGroups = new LV2_RDF_PortGroup[desc->PortGroupCount];
+
+        for (uint32_t i=0; i<desc->PortGroupCount; ++i)
+        {
+            LV2_RDF_PortGroup& portGroup(desc->PortGroups[i]);
+            uint32_t owner;
+
+            if (! (reader.readUInt(owner)
+                && reader.readStringCopy(portGroup.Name)
+                && reader.readStringCopy(portGroup.Symbol)))
+                return false;
+
+            if (owner < desc->PortCount)
+                portGroup.URI = desc->Ports[owner].GroupURI;
+            else if (owner - desc->PortCount < desc->ParameterCount)
+                portGroup.URI = desc->Parameters[owner - desc->PortCount].GroupURI;
+            else
+                return false;
+        }
+    }
+
+    if (! reader.readCount(desc->PresetCount, 2 * kLv2CacheMinStringSize))
+        return false;
+
+    if (desc->PresetCount > 0)
+    {
+        desc->Presets = new LV2_RDF_Preset[desc->PresetCount];
+
+        for (uint32_t i=0; i<desc->PresetCount; ++i)
+        {
+            if (! (reader.readStringCopy(desc->Presets[i].URI)
+                && reader.readStringCopy(desc->Presets[i].Label)))
+                return false;
+        }
+    }
+
+    if (! lv2_cache_read_features(reader, desc->FeatureCount, desc->Features))
+        return false;
+    if (! lv2_cache_read_extensions(reader, desc->ExtensionCount, desc->Extensions))
+        return false;
+
+    if (! reader.readCount(desc->UICount, kLv2CacheMinUISize))
+        return false;
+
+    if (desc->UICount > 0)
+    {
+        desc->UIs = new LV2_RDF_UI[desc->UICount];
+
+        for (uint32_t i=0; i<desc->UICount; ++i)
+        {
+            LV2_RDF_UI& ui(desc->UIs[i]);
+
+            if (! (reader.readUInt(ui.Type)
+                && reader.readStringCopy(ui.URI)
+                && reader.readStringCopy(ui.Binary)
+                && reader.readStringCopy(ui.Bundle)
+                && lv2_cache_read_features(reader, ui.FeatureCount, ui.Features)
+                && lv2_cache_read_extensions(reader, ui.ExtensionCount, ui.Extensions)
+                && reader.readCount(ui.PortNotificationCount, kLv2CacheMinStringSize + 2 * sizeof(uint32_t))))
+                return false;
+
+            if (ui.PortNotificationCount == 0)
+                continue;
+
+            ui.PortNotifications = new LV2_RDF_UI_PortNotification[ui.PortNotificationCount];
+
+            for (uint32_t j=0; j<ui.PortNotificationCount; ++j)
+            {
+                if (! (reader.readStringCopy(ui.PortNotifications[j].Symbol)
+                    && reader.readUInt(ui.PortNotifications[j].Index)
+                    && reader.readUInt(ui.PortNotifications[j].Protocol)))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// Create new RDF object, from the cache if possible (otherwise using lilv)
+
+static inline
+const LV2_RDF_Descriptor* lv2_rdf_new_cached(const char* const LV2_PATH, const LV2_URI uri, const bool loadPresets)
+{
+    CARLA_SAFE_ASSERT_RETURN(LV2_PATH != nullptr, nullptr);
+    CARLA_SAFE_ASSERT_RETURN(uri != nullptr && uri[0] != '\0', nullptr);
+
+    const CarlaString signature(Lv2CacheClass::getInstance().getSignature(LV2_PATH));
+    const water::File cacheFile(Lv2CacheClass::getFileForKey("rdf-", uri));
+    bool cacheFileInvalid = false;
+
+    {
+        CarlaMappedFile mappedFile;
+
+        if (mappedFile.map(cacheFile.getFullPathName().toRawUTF8()))
+        {
+            CarlaCacheReader reader(mappedFile.getData(), mappedFile.getSize());
+
+            if (lv2_cache_read_header(reader, signature, uri))
+            {
+                LV2_RDF_Descriptor* const desc = new LV2_RDF_Descriptor();
+
+                if (lv2_cache_read_rdf(reader, desc))
+                {
+                    // cached data always includes presets
+                    if (! loadPresets && desc->Presets != nullptr)
+                    {
+                        delete[] desc->Presets;
+                        desc->Presets = nullptr;
+                        desc->PresetCount = 0;
+                    }
+
+                    return desc;
+                }
+
+                carla_stderr2("lv2_rdf_new_cached(\"%s\") - invalid cache file, discarding it", uri);
+                cacheFileInvalid = true;
+                delete desc;
+            }
+        }
+    }
+
+    // removed after unmapping, in case it cannot be written again below
+    if (cacheFileInvalid)
+        cacheFile.deleteFile();
+
+    Lv2WorldClass& lv2World(Lv2WorldClass::getInstance());
+    lv2World.initIfNeeded(LV2_PATH);
+
+    const LV2_RDF_Descriptor* const desc = lv2_rdf_new(uri, loadPresets);
+
+    // only complete data is cached
+    if (desc != nullptr && loadPresets)
+    {
+        CarlaCacheWriter writer;
+        lv2_cache_write_header(writer, signature, uri);
+        lv2_cache_write_rdf(writer, desc);
+
+        if (! writer.saveTo(cacheFile))
+            carla_stderr2("lv2_rdf_new_cached(\"%s\") - failed to write cache file", uri);
+    }
+
+    return desc;
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_LV2_CACHE_UTILS_HPP_INCLUDED
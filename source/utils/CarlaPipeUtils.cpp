@@ -571,6 +571,22 @@ void waitForChildToStopOrKillIt(pid_t& pid, const uint32_t timeOutMilliseconds)
 }
 #endif
 
+// -----------------------------------------------------------------------
+// binary records
+
+// marker byte, followed by type and payload size
+static constexpr const uint8_t  kRecordMarker     = 0x1e;
+static constexpr const uint32_t kRecordHeaderSize = 1 + sizeof(uint32_t) * 2;
+
+// payloads up to this size are sent in a single write together with their header
+static constexpr const uint32_t kRecordInlineSize = 2048;
+
+// sanity limit for incoming records
+static constexpr const uint32_t kRecordMaxSize = 16 * 1024 * 1024;
+
+// how many control changes are queued before writing a batch
+static constexpr const uint32_t kMaxPendingControls = kRecordInlineSize / sizeof(CarlaPipeControlValue);
+
 // -----------------------------------------------------------------------
 
 struct CarlaPipeCommon::PrivateData {
@@ -602,6 +618,10 @@ struct CarlaPipeCommon::PrivateData {
     // for debugging
     bool isServer;
 
+    // binary framing, allowed by subclass and in use after negotiation
+    bool binaryFramingAllowed;
+    bool binaryFraming;
+
     // common write lock
     CarlaMutex writeLock;
 
@@ -609,6 +629,14 @@ struct CarlaPipeCommon::PrivateData {
     mutable char        tmpBuf[0xffff];
     mutable CarlaString tmpStr;
 
+    // control changes waiting to be written as a single record, protected by writeLock
+    CarlaPipeControlValue pendingControls[kMaxPendingControls];
+    uint32_t pendingControlCount;
+
+    // incoming record payload, grown as needed
+    uint8_t* recordData;
+    uint32_t recordDataSize;
+
     PrivateData() noexcept
 #ifdef CARLA_OS_WIN
         : processInfo(),
@@ -622,9 +650,15 @@ struct CarlaPipeCommon::PrivateData {
           pipeClosed(true),
           lastMessageFailed(false),
           isServer(false),
+          binaryFramingAllowed(false),
+          binaryFraming(false),
           writeLock(),
           tmpBuf(),
-          tmpStr()
+          tmpStr(),
+          pendingControls(),
+          pendingControlCount(0),
+          recordData(nullptr),
+          recordDataSize(0)
     {
 #ifdef CARLA_OS_WIN
         carla_zeroStruct(processInfo);
@@ -638,6 +672,227 @@ struct CarlaPipeCommon::PrivateData {
         carla_zeroChars(tmpBuf, 0xffff);
     }
 
+    ~PrivateData() noexcept
+    {
+        std::free(recordData);
+    }
+
+    // raw write of a text message, must be locked before calling
+    bool writeBuffer(const void* const data, const std::size_t size) noexcept
+    {
+        if (pipeClosed)
+            return false;
+
+        if (pipeSend == INVALID_PIPE_VALUE)
+        {
+            carla_stderr2("CarlaPipe write error, isServer:%s, message was:\n%s", bool2str(isServer), static_cast<const char*>(data));
+            return false;
+        }
+
+        ssize_t ret;
+
+        try {
+           #ifdef CARLA_OS_WIN
+            ret = WriteFileWin32(pipeSend, ovSend, data, static_cast<DWORD>(size));
+           #else
+            ret = ::write(pipeSend, data, size);
+           #endif
+        } CARLA_SAFE_EXCEPTION_RETURN("CarlaPipeCommon::writeMsgBuffer", false);
+
+       #ifdef CARLA_OS_WIN
+        if (ret == -2)
+        {
+            pipeClosed = true;
+            return false;
+        }
+       #endif
+
+        if (ret == static_cast<ssize_t>(size))
+        {
+            if (lastMessageFailed)
+                lastMessageFailed = false;
+            return true;
+        }
+
+        if (! lastMessageFailed)
+        {
+            lastMessageFailed = true;
+            fprintf(stderr,
+                    "CarlaPipeCommon::_writeMsgBuffer(..., " P_SIZE ") - failed with " P_SSIZE " (%s), message was:\n%s",
+                    size, ret, bool2str(isServer), static_cast<const char*>(data));
+        }
+
+        return false;
+    }
+
+    // write all of a binary record part, retrying until done or timed out, must be locked before calling.
+    // @a started is set once any data of the record got written.
+    bool writeRecordBuffer(const void* const data, const std::size_t size,
+                           const uint32_t timeoutEnd, bool& started) noexcept
+    {
+        const uint8_t* ptr = static_cast<const uint8_t*>(data);
+        std::size_t remaining = size;
+        ssize_t ret;
+
+        while (remaining != 0)
+        {
+            if (pipeClosed || pipeSend == INVALID_PIPE_VALUE)
+                return false;
+
+            try {
+               #ifdef CARLA_OS_WIN
+                ret = WriteFileWin32(pipeSend, ovSend, ptr, static_cast<DWORD>(remaining));
+               #else
+                ret = ::write(pipeSend, ptr, remaining);
+               #endif
+            } CARLA_SAFE_EXCEPTION_RETURN("CarlaPipeCommon::writeRecordBuffer", false);
+
+           #ifdef CARLA_OS_WIN
+            if (ret == -2)
+            {
+                pipeClosed = true;
+                return false;
+            }
+           #endif
+
+            if (ret > 0)
+            {
+                CARLA_SAFE_ASSERT_RETURN(ret <= static_cast<ssize_t>(remaining), false);
+                started = true;
+                ptr += ret;
+                remaining -= static_cast<std::size_t>(ret);
+                continue;
+            }
+
+           #ifndef CARLA_OS_WIN
+            if (ret == 0 || errno != EAGAIN)
+                return false;
+           #endif
+
+            if (carla_gettime_ms() >= timeoutEnd)
+            {
+                carla_stderr2("CarlaPipeCommon::writeRecordBuffer timed out, " P_SIZE " of " P_SIZE " bytes missing",
+                              remaining, size);
+                return false;
+            }
+
+            carla_msleep(1);
+        }
+
+        return true;
+    }
+
+    // write a binary record, must be locked before calling
+    bool writeRecord(const uint32_t type,
+                     const void* const data, const uint32_t size,
+                     const void* const extraData = nullptr, const uint32_t extraSize = 0) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(binaryFraming, false);
+
+        uint8_t buf[kRecordHeaderSize + kRecordInlineSize];
+        const uint32_t totalSize = size + extraSize;
+
+        buf[0] = kRecordMarker;
+        std::memcpy(buf + 1, &type, sizeof(uint32_t));
+        std::memcpy(buf + 1 + sizeof(uint32_t), &totalSize, sizeof(uint32_t));
+
+        const uint32_t timeoutEnd = carla_gettime_ms() + 1000;
+        bool started = false;
+        bool ok;
+
+        if (size <= kRecordInlineSize)
+        {
+            std::memcpy(buf + kRecordHeaderSize, data, size);
+
+            ok = writeRecordBuffer(buf, kRecordHeaderSize + size, timeoutEnd, started);
+        }
+        else
+        {
+            ok = writeRecordBuffer(buf, kRecordHeaderSize, timeoutEnd, started)
+              && writeRecordBuffer(data, size, timeoutEnd, started);
+        }
+
+        if (ok && extraSize != 0)
+            ok = writeRecordBuffer(extraData, extraSize, timeoutEnd, started);
+
+        if (ok)
+        {
+            if (lastMessageFailed)
+                lastMessageFailed = false;
+            return true;
+        }
+
+        // the other side reads records by their size, anything written after a partial record would be misread
+        if (started)
+        {
+            carla_stderr2("CarlaPipe write error, isServer:%s, binary record of size %u was only partially written, "
+                          "closing the pipe", bool2str(isServer), totalSize);
+            pipeClosed = true;
+        }
+        else if (! lastMessageFailed)
+        {
+            lastMessageFailed = true;
+            carla_stderr2("CarlaPipe write error, isServer:%s, binary record of size %u", bool2str(isServer), totalSize);
+        }
+
+        return false;
+    }
+
+    // write queued control changes, must be locked before calling
+    bool writePendingControls() noexcept
+    {
+        if (pendingControlCount == 0)
+            return true;
+
+        CARLA_SAFE_ASSERT_RETURN(binaryFraming, false);
+
+        const uint32_t size = static_cast<uint32_t>(pendingControlCount * sizeof(CarlaPipeControlValue));
+        pendingControlCount = 0;
+
+        return writeRecord(kCarlaPipeRecordControls, pendingControls, size);
+    }
+
+    // raw read of exactly size bytes, used for binary records
+    bool readBuffer(void* const data, const uint32_t size, const uint32_t timeOutMilliseconds) noexcept
+    {
+        uint8_t* ptr = static_cast<uint8_t*>(data);
+        uint32_t remaining = size;
+        const uint32_t timeoutEnd = carla_gettime_ms() + timeOutMilliseconds;
+        ssize_t ret;
+
+        while (remaining != 0)
+        {
+            try {
+               #ifdef CARLA_OS_WIN
+                ret = ReadFileWin32(pipeRecv, ovRecv, ptr, remaining);
+               #else
+                ret = ::read(pipeRecv, ptr, remaining);
+               #endif
+            } CARLA_SAFE_EXCEPTION_RETURN("CarlaPipeCommon::readBuffer", false);
+
+            if (ret > 0)
+            {
+                CARLA_SAFE_ASSERT_INT2_RETURN(ret <= static_cast<ssize_t>(remaining), ret, remaining, false);
+                ptr += ret;
+                remaining -= static_cast<uint32_t>(ret);
+                continue;
+            }
+
+           #ifndef CARLA_OS_WIN
+            if (ret == 0 || errno != EAGAIN)
+                return false;
+           #endif
+
+            if (carla_gettime_ms() >= timeoutEnd)
+            {
+                carla_stderr2("CarlaPipeCommon::readBuffer timed out, %u of %u bytes missing", remaining, size);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     CARLA_DECLARE_NON_COPYABLE(PrivateData)
 };
 
@@ -679,10 +934,47 @@ void CarlaPipeCommon::idlePipe(const bool onlyOnce) noexcept
 
         pData->isReading = true;
 
-        if (std::strcmp(msg, "__carla-quit__") == 0)
+        if (pData->binaryFraming && static_cast<uint8_t>(msg[0]) == kRecordMarker && msg[1] == '\0')
+        {
+            // payload must always be consumed, even if not handled
+            if (! _readRecord())
+                carla_stderr2("CarlaPipeCommon::idlePipe() - failed to read binary record");
+        }
+        else if (std::strcmp(msg, "__carla-quit__") == 0)
         {
             pData->pipeClosed = true;
         }
+        else if (std::strcmp(msg, "binaryframing") == 0)
+        {
+            uint32_t version = 0;
+            CARLA_SAFE_ASSERT(readNextLineAsUInt(version));
+
+            if (pData->binaryFramingAllowed && version == kCarlaPipeBinaryFramingVersion && ! pData->binaryFraming)
+            {
+                const CarlaMutexLocker cml(pData->writeLock);
+
+                // the server replies with the same message, the client only enables binary framing after the reply
+                if (pData->isServer)
+                {
+                    char tmpBuf[0xff];
+                    std::snprintf(tmpBuf, 0xfe, "binaryframing\n%u\n", kCarlaPipeBinaryFramingVersion);
+                    tmpBuf[0xfe] = '\0';
+
+                    if (_writeMsgBuffer(tmpBuf, std::strlen(tmpBuf)))
+                    {
+                        syncMessages();
+                        pData->binaryFraming = true;
+                    }
+                }
+                else
+                {
+                    pData->binaryFraming = true;
+                }
+
+                carla_debug("CarlaPipeCommon::idlePipe() - binary framing enabled, isServer:%s",
+                            bool2str(pData->isServer));
+            }
+        }
         else if (! pData->clientClosingDown)
         {
             try {
@@ -697,6 +989,27 @@ void CarlaPipeCommon::idlePipe(const bool onlyOnce) noexcept
         if (onlyOnce || pData->pipeRecv == INVALID_PIPE_VALUE)
             break;
     }
+
+    if (pData->pendingControlCount != 0)
+        flushControlMessages();
+}
+
+bool CarlaPipeCommon::isUsingBinaryFraming() const noexcept
+{
+    return pData->binaryFraming;
+}
+
+bool CarlaPipeCommon::recordReceived(const uint32_t type, const void*, const uint32_t size) noexcept
+{
+    carla_stderr2("CarlaPipeCommon::recordReceived(%u, ..., %u) - unhandled record", type, size);
+    return false;
+}
+
+void CarlaPipeCommon::setBinaryFramingAllowed(const bool allowed) noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(! isPipeRunning(),);
+
+    pData->binaryFramingAllowed = allowed;
 }
 
 // -------------------------------------------------------------------
@@ -1002,6 +1315,17 @@ bool CarlaPipeCommon::writeControlMessage(const uint32_t index, const float valu
         return writeControlMessage(index, value, false);
     }
 
+    if (pData->binaryFraming)
+    {
+        if (pData->pendingControlCount == kMaxPendingControls && ! pData->writePendingControls())
+            return false;
+
+        CarlaPipeControlValue& pending(pData->pendingControls[pData->pendingControlCount++]);
+        pending.index = index;
+        pending.value = value;
+        return true;
+    }
+
     char tmpBuf[0xff];
     tmpBuf[0xfe] = '\0';
 
@@ -1024,6 +1348,61 @@ bool CarlaPipeCommon::writeControlMessage(const uint32_t index, const float valu
     return true;
 }
 
+bool CarlaPipeCommon::writeControlMessages(const CarlaPipeControlValue* const values, const uint32_t count) const noexcept
+{
+    CARLA_SAFE_ASSERT_RETURN(values != nullptr, false);
+
+    const CarlaMutexLocker cml(pData->writeLock);
+
+    if (pData->binaryFraming)
+    {
+        if (! pData->writePendingControls())
+            return false;
+
+        for (uint32_t i = 0, batch; i < count; i += batch)
+        {
+            batch = std::min(count - i, kMaxPendingControls);
+
+            if (! pData->writeRecord(kCarlaPipeRecordControls,
+                                     values + i, static_cast<uint32_t>(batch * sizeof(CarlaPipeControlValue))))
+                return false;
+        }
+
+        syncMessages();
+        return true;
+    }
+
+    char tmpBuf[0xff];
+    tmpBuf[0xfe] = '\0';
+
+    const CarlaScopedLocale csl;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        std::snprintf(tmpBuf, 0xfe, "control\n%i\n%.12g\n", values[i].index, static_cast<double>(values[i].value));
+
+        if (! _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf)))
+            return false;
+    }
+
+    syncMessages();
+    return true;
+}
+
+bool CarlaPipeCommon::flushControlMessages() const noexcept
+{
+    const CarlaMutexLocker cml(pData->writeLock);
+
+    if (pData->pendingControlCount == 0)
+        return true;
+
+    if (! pData->writePendingControls())
+        return false;
+
+    syncMessages();
+    return true;
+}
+
 bool CarlaPipeCommon::writeConfigureMessage(const char* const key, const char* const value) const noexcept
 {
     CARLA_SAFE_ASSERT_RETURN(key != nullptr && key[0] != '\0', false);
@@ -1168,6 +1547,23 @@ bool CarlaPipeCommon::writeLv2AtomMessage(const uint32_t index, const LV2_Atom*
     tmpBuf[0xfe] = '\0';
 
     const uint32_t atomTotalSize(lv2_atom_total_size(atom));
+
+    if (pData->binaryFraming)
+    {
+        // padding keeps the atom 64-bit aligned on the receiving side
+        const uint32_t indexAndPadding[2] = { index, 0 };
+
+        const CarlaMutexLocker cml(pData->writeLock);
+
+        if (! pData->writePendingControls())
+            return false;
+        if (! pData->writeRecord(kCarlaPipeRecordAtom, indexAndPadding, sizeof(indexAndPadding), atom, atomTotalSize))
+            return false;
+
+        syncMessages();
+        return true;
+    }
+
     CarlaString base64atom(CarlaString::asBase64(atom, atomTotalSize));
 
     const CarlaMutexLocker cml(pData->writeLock);
@@ -1286,6 +1682,13 @@ const char* CarlaPipeCommon::_readline(const bool allocReturn, const uint16_t si
                 break;
             }
 
+            // binary records start with a single marker byte instead of a text line
+            if (i == 0 && pData->binaryFraming && ! pData->isReading && static_cast<uint8_t>(c) == kRecordMarker)
+            {
+                *ptr++ = c;
+                break;
+            }
+
             if (c == '\r')
                 c = '\n';
 
@@ -1421,49 +1824,47 @@ const char* CarlaPipeCommon::_readlineblock(const bool allocReturn,
 
 bool CarlaPipeCommon::_writeMsgBuffer(const char* const msg, const std::size_t size) const noexcept
 {
-    if (pData->pipeClosed)
+    // queued control changes go first, so that message order is kept
+    if (pData->pendingControlCount != 0 && ! pData->writePendingControls())
         return false;
 
-    if (pData->pipeSend == INVALID_PIPE_VALUE)
-    {
-        carla_stderr2("CarlaPipe write error, isServer:%s, message was:\n%s", bool2str(pData->isServer), msg);
+    return pData->writeBuffer(msg, size);
+}
+
+// internal
+bool CarlaPipeCommon::_readRecord() noexcept
+{
+    uint8_t header[kRecordHeaderSize - 1];
+
+    if (! pData->readBuffer(header, sizeof(header), 1000))
         return false;
-    }
 
-    ssize_t ret;
+    uint32_t type, size;
+    std::memcpy(&type, header, sizeof(uint32_t));
+    std::memcpy(&size, header + sizeof(uint32_t), sizeof(uint32_t));
 
-    try {
-       #ifdef CARLA_OS_WIN
-        ret = WriteFileWin32(pData->pipeSend, pData->ovSend, msg, static_cast<DWORD>(size));
-       #else
-        ret = ::write(pData->pipeSend, msg, size);
-       #endif
-    } CARLA_SAFE_EXCEPTION_RETURN("CarlaPipeCommon::writeMsgBuffer", false);
+    CARLA_SAFE_ASSERT_UINT2_RETURN(size <= kRecordMaxSize, size, kRecordMaxSize, false);
 
-   #ifdef CARLA_OS_WIN
-    if (ret == -2)
+    if (size > pData->recordDataSize)
     {
-        pData->pipeClosed = true;
-        return false;
-    }
-   #endif
+        uint8_t* const recordData = static_cast<uint8_t*>(std::realloc(pData->recordData, size));
+        CARLA_SAFE_ASSERT_RETURN(recordData != nullptr, false);
 
-    if (ret == static_cast<ssize_t>(size))
-    {
-        if (pData->lastMessageFailed)
-            pData->lastMessageFailed = false;
-        return true;
+        pData->recordData = recordData;
+        pData->recordDataSize = size;
     }
 
-    if (! pData->lastMessageFailed)
+    if (size != 0 && ! pData->readBuffer(pData->recordData, size, 1000))
+        return false;
+
+    if (! pData->clientClosingDown)
     {
-        pData->lastMessageFailed = true;
-        fprintf(stderr,
-                "CarlaPipeCommon::_writeMsgBuffer(..., " P_SIZE ") - failed with " P_SSIZE " (%s), message was:\n%s",
-                size, ret, bool2str(pData->isServer), msg);
+        try {
+            recordReceived(type, pData->recordData, size);
+        } CARLA_SAFE_EXCEPTION("recordReceived");
     }
 
-    return false;
+    return true;
 }
 
 // -----------------------------------------------------------------------
@@ -1491,6 +1892,30 @@ uintptr_t CarlaPipeServer::getPID() const noexcept
 #endif
 }
 
+bool CarlaPipeServer::hasClientExited() const noexcept
+{
+#ifdef CARLA_OS_WIN
+    CARLA_SAFE_ASSERT_RETURN(pData->processInfo.hProcess != INVALID_HANDLE_VALUE, false);
+
+    try {
+        return ::WaitForSingleObject(pData->processInfo.hProcess, 0) == WAIT_OBJECT_0;
+    } CARLA_SAFE_EXCEPTION_RETURN("WaitForSingleObject", false);
+#else
+    CARLA_SAFE_ASSERT_RETURN(pData->pid > 0, false);
+
+    siginfo_t info;
+    carla_zeroStruct(info);
+
+    // WNOWAIT keeps the child as zombie, so stopPipeServer() can still wait for it
+    try {
+        if (::waitid(P_PID, static_cast<id_t>(pData->pid), &info, WEXITED|WNOHANG|WNOWAIT) != 0)
+            return false;
+    } CARLA_SAFE_EXCEPTION_RETURN("waitid", false);
+
+    return info.si_pid != 0;
+#endif
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 
 bool CarlaPipeServer::startPipeServer(const char* const helperTool,
@@ -1827,6 +2252,10 @@ void CarlaPipeServer::closePipeServer() noexcept
 
     const CarlaMutexLocker cml(pData->writeLock);
 
+    // binary framing is negotiated again on the next start
+    pData->binaryFraming = false;
+    pData->pendingControlCount = 0;
+
     if (pData->pipeRecv != INVALID_PIPE_VALUE)
     {
 #ifdef CARLA_OS_WIN
@@ -1949,7 +2378,18 @@ bool CarlaPipeClient::initPipeClient(const char* argv[]) noexcept
     pData->clientClosingDown = false;
 
     if (writeMessage("\n", 1))
+    {
+        // offer binary framing, the server replies with the same message if it accepts
+        if (pData->binaryFramingAllowed)
+        {
+            char tmpBuf[0xff];
+            std::snprintf(tmpBuf, 0xfe, "binaryframing\n%u\n", kCarlaPipeBinaryFramingVersion);
+            tmpBuf[0xfe] = '\0';
+            _writeMsgBuffer(tmpBuf, std::strlen(tmpBuf));
+        }
+
         syncMessages();
+    }
 
     return true;
 }
@@ -1962,6 +2402,10 @@ void CarlaPipeClient::closePipeClient() noexcept
 
     const CarlaMutexLocker cml(pData->writeLock);
 
+    // binary framing is negotiated again on the next start
+    pData->binaryFraming = false;
+    pData->pendingControlCount = 0;
+
     if (pData->pipeRecv != INVALID_PIPE_VALUE)
     {
 #ifdef CARLA_OS_WIN
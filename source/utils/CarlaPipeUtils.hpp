@@ -27,6 +27,39 @@
 # include "lv2/atom/atom.h"
 #endif
 
+// -----------------------------------------------------------------------
+// CarlaPipe binary records
+
+/*!
+ * Binary framing version, sent by the client and echoed by the server when both pipe ends agree on using it.
+ */
+static constexpr const uint32_t kCarlaPipeBinaryFramingVersion = 1;
+
+/*!
+ * Binary record types.
+ * Records are only exchanged after binary framing has been negotiated, text messages keep working alongside them.
+ * On the wire a record is a single marker byte, its type and payload size (both uint32_t), followed by the payload.
+ */
+enum CarlaPipeRecordType {
+    kCarlaPipeRecordNull = 0,
+    /*!
+     * Batched control changes, payload is an array of CarlaPipeControlValue.
+     */
+    kCarlaPipeRecordControls = 1,
+    /*!
+     * LV2 atom, payload is the port index and padding (2x uint32_t) followed by the raw atom.
+     */
+    kCarlaPipeRecordAtom = 2
+};
+
+/*!
+ * A single control change, as sent in kCarlaPipeRecordControls records.
+ */
+struct CarlaPipeControlValue {
+    uint32_t index;
+    float value;
+};
+
 // -----------------------------------------------------------------------
 // CarlaPipeCommon class
 
@@ -50,6 +83,13 @@ protected:
      */
     virtual bool msgReceived(const char* msg) noexcept = 0;
 
+    /*!
+     * A binary record has been received (in the context of idlePipe()).
+     * Only called after binary framing has been negotiated, see setBinaryFramingAllowed().
+     * @a data is only valid during this call.
+     */
+    virtual bool recordReceived(uint32_t type, const void* data, uint32_t size) noexcept;
+
     /*!
      * An error has occurred during the current requested operation.
      * Reimplementing this method allows to catch these errors as strings.
@@ -68,9 +108,15 @@ public:
 
     /*!
      * Check the pipe for new messages and send them to msgReceived().
+     * Any queued control changes are written at the end.
      */
     void idlePipe(bool onlyOnce = false) noexcept;
 
+    /*!
+     * Check if binary framing has been negotiated with the other side of the pipe.
+     */
+    bool isUsingBinaryFraming() const noexcept;
+
     // -------------------------------------------------------------------
     // write lock
 
@@ -190,9 +236,22 @@ public:
 
     /*!
      * Write a "control" message used for parameter/control changes.
+     * When using binary framing the change is queued and sent in a batch, see flushControlMessages().
      */
     bool writeControlMessage(uint32_t index, float value, bool withWriteLock = true) const noexcept;
 
+    /*!
+     * Write several control changes at once.
+     * Sent as a single record when using binary framing, or as regular "control" messages otherwise.
+     */
+    bool writeControlMessages(const CarlaPipeControlValue* values, uint32_t count) const noexcept;
+
+    /*!
+     * Write any control changes queued by writeControlMessage().
+     * Does nothing when not using binary framing.
+     */
+    bool flushControlMessages() const noexcept;
+
     /*!
      * Write a "configure" message used for state changes.
      */
@@ -225,6 +284,7 @@ public:
 
     /*!
      * Write an lv2 "atom" message.
+     * Sent as raw bytes instead of base64 when using binary framing.
      */
     bool writeLv2AtomMessage(uint32_t index, const LV2_Atom* atom) const noexcept;
 
@@ -246,6 +306,14 @@ protected:
 
     // -------------------------------------------------------------------
 
+    /*!
+     * Allow binary framing to be negotiated.
+     * Must be called before the pipe is started, and only by subclasses that reimplement recordReceived().
+     */
+    void setBinaryFramingAllowed(bool allowed) noexcept;
+
+    // -------------------------------------------------------------------
+
     /*! @internal */
     const char* _readline(bool allocReturn, uint16_t size, bool& readSucess) const noexcept;
 
@@ -255,6 +323,9 @@ protected:
     /*! @internal */
     bool _writeMsgBuffer(const char* msg, std::size_t size) const noexcept;
 
+    /*! @internal */
+    bool _readRecord() noexcept;
+
     CARLA_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CarlaPipeCommon)
 };
 
@@ -281,6 +352,12 @@ public:
      */
     uintptr_t getPID() const noexcept;
 
+    /*!
+     * Check if this pipe's matching client process has terminated, usually because it crashed.
+     * The process is not reaped, stopPipeServer() must still be called afterwards.
+     */
+    bool hasClientExited() const noexcept;
+
     /*!
      * Start the pipe server using @a filename with 2 arguments.
      * @see fail()
@@ -0,0 +1,200 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_PROCESS_TIME_HISTOGRAM_HPP_INCLUDED
+#define CARLA_PROCESS_TIME_HISTOGRAM_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+// --------------------------------------------------------------------------------------------------------------------
+// CarlaProcessTimeHistogram class
+
+/*
+   Lock-free accumulator of process cycle durations, in nanoseconds.
+
+   There is a single writer (the audio thread calling add()), everything else can be called from any thread.
+   Readers get min/avg/max values and a percentile estimate taken from a log-scale histogram, which
+   has 8 bins per octave starting at 512ns, so that percentiles have a resolution of about 9%.
+
+   Cycles where processing was skipped are counted separately through addSkipped().
+
+   A reset is only requested by the readers and then done by the writer on its next add() or addSkipped() call,
+   so that the writer never races against a concurrent clear.
+  */
+
+class CarlaProcessTimeHistogram
+{
+public:
+    static constexpr const uint32_t kTimeShift     = 6; // 64ns units
+    static constexpr const uint32_t kBinsPerOctave = 8;
+    static constexpr const uint32_t kNumOctaves    = 24;
+    static constexpr const uint32_t kNumBins       = 1 + kNumOctaves * kBinsPerOctave;
+
+    struct Stats {
+        uint64_t count;
+        uint64_t skipped;
+        float minTime; // in microseconds
+        float avgTime;
+        float maxTime;
+        float p99Time;
+    };
+
+    CarlaProcessTimeHistogram() noexcept
+        : fCount(0),
+          fSum(0),
+          fMin(UINT64_MAX),
+          fMax(0),
+          fSkipped(0),
+          fResetRequested(false)
+    {
+        for (uint32_t i=0; i < kNumBins; ++i)
+            fBins[i].store(0, std::memory_order_relaxed);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // writer side
+
+    void add(const uint64_t nanoseconds) noexcept
+    {
+        handleResetRequest();
+
+        const uint32_t bin = getBinIndex(nanoseconds);
+        fBins[bin].store(fBins[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+        if (nanoseconds < fMin.load(std::memory_order_relaxed))
+            fMin.store(nanoseconds, std::memory_order_relaxed);
+        if (nanoseconds > fMax.load(std::memory_order_relaxed))
+            fMax.store(nanoseconds, std::memory_order_relaxed);
+
+        fSum.store(fSum.load(std::memory_order_relaxed) + nanoseconds, std::memory_order_relaxed);
+        fCount.store(fCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void addSkipped() noexcept
+    {
+        handleResetRequest();
+
+        fSkipped.store(fSkipped.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // reader side
+
+    void requestReset() noexcept
+    {
+        fResetRequested.store(true, std::memory_order_release);
+    }
+
+    /*
+     * Get the current statistics.
+     * Values may be from slightly different cycles if the writer is active, which is fine for reporting.
+     */
+    Stats getStats() const noexcept
+    {
+        Stats stats = { 0, 0, 0.f, 0.f, 0.f, 0.f };
+
+        if (fResetRequested.load(std::memory_order_acquire))
+            return stats;
+
+        stats.skipped = fSkipped.load(std::memory_order_acquire);
+
+        const uint64_t count = fCount.load(std::memory_order_acquire);
+
+        if (count == 0)
+            return stats;
+
+        stats.count   = count;
+        stats.minTime = static_cast<float>(fMin.load(std::memory_order_relaxed)) / 1000.f;
+        stats.maxTime = static_cast<float>(fMax.load(std::memory_order_relaxed)) / 1000.f;
+        stats.avgTime = static_cast<float>(static_cast<double>(fSum.load(std::memory_order_relaxed))
+                                           / static_cast<double>(count) / 1000.0);
+
+        uint64_t binsTotal = 0;
+        for (uint32_t i=0; i < kNumBins; ++i)
+            binsTotal += fBins[i].load(std::memory_order_relaxed);
+
+        const uint64_t target = binsTotal - binsTotal / 100;
+        uint64_t accum = 0;
+
+        for (uint32_t i=0; i < kNumBins; ++i)
+        {
+            accum += fBins[i].load(std::memory_order_relaxed);
+
+            if (accum >= target)
+            {
+                // upper edge of the bin, but never above the real maximum
+                stats.p99Time = std::min(static_cast<float>(getBinUpperEdge(i)) / 1000.f, stats.maxTime);
+                break;
+            }
+        }
+
+        return stats;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+    static uint32_t getBinIndex(const uint64_t nanoseconds) noexcept
+    {
+        uint64_t value = nanoseconds >> kTimeShift;
+
+        if (value < kBinsPerOctave)
+            return 0;
+
+        uint32_t octave = 0;
+        for (; value >= kBinsPerOctave * 2; value >>= 1)
+            ++octave;
+
+        if (octave >= kNumOctaves)
+            return kNumBins - 1;
+
+        return 1 + octave * kBinsPerOctave + static_cast<uint32_t>(value - kBinsPerOctave);
+    }
+
+    static uint64_t getBinUpperEdge(const uint32_t bin) noexcept
+    {
+        if (bin == 0)
+            return static_cast<uint64_t>(kBinsPerOctave) << kTimeShift;
+
+        const uint32_t octave = (bin - 1) / kBinsPerOctave;
+        const uint32_t step   = (bin - 1) % kBinsPerOctave;
+
+        return static_cast<uint64_t>(kBinsPerOctave + step + 1) << (octave + kTimeShift);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+private:
+    void handleResetRequest() noexcept
+    {
+        if (! fResetRequested.load(std::memory_order_acquire))
+            return;
+
+        fCount.store(0, std::memory_order_relaxed);
+        fSum.store(0, std::memory_order_relaxed);
+        fMin.store(UINT64_MAX, std::memory_order_relaxed);
+        fMax.store(0, std::memory_order_relaxed);
+        fSkipped.store(0, std::memory_order_relaxed);
+
+        for (uint32_t i=0; i < kNumBins; ++i)
+            fBins[i].store(0, std::memory_order_relaxed);
+
+        fResetRequested.store(false, std::memory_order_release);
+    }
+
+    std::atomic<uint64_t> fCount;
+    std::atomic<uint64_t> fSum;
+    std::atomic<uint64_t> fMin;
+    std::atomic<uint64_t> fMax;
+    std::atomic<uint64_t> fSkipped;
+    std::atomic<bool> fResetRequested;
+    std::atomic<uint32_t> fBins[kNumBins];
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaProcessTimeHistogram)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_PROCESS_TIME_HISTOGRAM_HPP_INCLUDED
@@ -35,6 +35,7 @@ typedef __sighandler_t sig_t;
 #ifndef CARLA_OS_WIN
 # include <csignal>
 # include <csetjmp>
+# include <sys/mman.h>
 #endif
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -92,6 +93,34 @@ void carla_terminateProcessOnParentExit(const bool kill) noexcept
     return; (void)kill;
 }
 
+/*
+ * Lock all current and future memory of the process, so that it never gets paged out.
+ */
+static inline
+bool carla_lockProcessMemory() noexcept
+{
+#if !(defined(CARLA_OS_WASM) || defined(CARLA_OS_WIN))
+    if (::mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+        return true;
+
+    carla_stderr2("Failed to lock process memory, check the memlock limit of the current user");
+#endif
+    return false;
+}
+
+/*
+ * Touch the stack of the calling thread, so it does not page fault later on.
+ * Only useful after carla_lockProcessMemory().
+ */
+static inline
+void carla_prefaultThreadStack() noexcept
+{
+    volatile uint8_t stack[256 * 1024];
+
+    for (std::size_t i = 0; i < sizeof(stack); i += 1024)
+        stack[i] = 0;
+}
+
 // --------------------------------------------------------------------------------------------------------------------
 // process utility classes
 
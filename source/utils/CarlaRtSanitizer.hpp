@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_RT_SANITIZER_HPP_INCLUDED
+#define CARLA_RT_SANITIZER_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#if defined(CARLA_OS_LINUX) && defined(__GLIBC__)
+# define CARLA_RT_SANITIZER_SUPPORTED
+# include <dlfcn.h>
+#endif
+
+// --------------------------------------------------------------------------------------------------------------------
+// Realtime-safety sanitizer
+//
+// libcarla_interposer-rtsan.so, when preloaded into a Carla process, interposes memory allocation, blocking locks,
+// sleeps, file and socket functions and records any call made by a thread currently marked as realtime.
+// Engine and plugin code marks its threads through ScopedRtSanitizerContext, which is a no-op without the interposer.
+
+// thread is not running realtime code
+static constexpr const int32_t kCarlaRtSanitizerNoContext = -2;
+
+// thread is running engine realtime code, values >= 0 are plugin ids
+static constexpr const int32_t kCarlaRtSanitizerEngineContext = -1;
+
+static constexpr const uint32_t kCarlaRtSanitizerMaxFrames = 32;
+
+struct CarlaRtSanitizerViolation {
+    // name of the function called, static string
+    const char* funcName;
+    // context of the calling thread, engine or plugin id
+    int32_t context;
+    // similar violations that were only counted since the previous recorded one
+    uint32_t suppressed;
+    // backtrace of the call
+    uint32_t numFrames;
+    void* frames[kCarlaRtSanitizerMaxFrames];
+};
+
+extern "C" {
+typedef int32_t (*CarlaRtSanitizerSetContextFunc)(int32_t context);
+typedef int32_t (*CarlaRtSanitizerGetContextFunc)();
+typedef bool (*CarlaRtSanitizerFetchViolationFunc)(CarlaRtSanitizerViolation* violation);
+}
+
+// --------------------------------------------------------------------------------------------------------------------
+// CarlaRtSanitizer class, to be used by the host side
+
+class CarlaRtSanitizer
+{
+public:
+    /*
+     * Whether the interposer is loaded into the current process.
+     */
+    static bool isActive() noexcept
+    {
+        return getFuncs().setContext != nullptr;
+    }
+
+    /*
+     * Take the oldest violation recorded so far, returns false if there are none.
+     * Must not be called from realtime threads.
+     */
+    static bool fetchViolation(CarlaRtSanitizerViolation& violation) noexcept
+    {
+        const Funcs& funcs(getFuncs());
+        return funcs.fetchViolation != nullptr && funcs.fetchViolation(&violation);
+    }
+
+private:
+    struct Funcs {
+        CarlaRtSanitizerSetContextFunc setContext;
+        CarlaRtSanitizerGetContextFunc getContext;
+        CarlaRtSanitizerFetchViolationFunc fetchViolation;
+
+        Funcs() noexcept
+            : setContext(nullptr),
+              getContext(nullptr),
+              fetchViolation(nullptr)
+        {
+           #ifdef CARLA_RT_SANITIZER_SUPPORTED
+            // only accept a complete set of functions
+            CarlaRtSanitizerSetContextFunc     set   = (CarlaRtSanitizerSetContextFunc)
+                                                       ::dlsym(RTLD_DEFAULT, "carla_rtsan_set_context");
+            CarlaRtSanitizerGetContextFunc     get   = (CarlaRtSanitizerGetContextFunc)
+                                                       ::dlsym(RTLD_DEFAULT, "carla_rtsan_get_context");
+            CarlaRtSanitizerFetchViolationFunc fetch = (CarlaRtSanitizerFetchViolationFunc)
+                                                       ::dlsym(RTLD_DEFAULT, "carla_rtsan_fetch_violation");
+
+            if (set != nullptr && get != nullptr && fetch != nullptr)
+            {
+                setContext = set;
+                getContext = get;
+                fetchViolation = fetch;
+            }
+           #endif
+        }
+    };
+
+    static const Funcs& getFuncs() noexcept
+    {
+        static const Funcs funcs;
+        return funcs;
+    }
+
+    friend class ScopedRtSanitizerContext;
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+// Helper to mark the current thread as running realtime code for the current scope
+
+class ScopedRtSanitizerContext
+{
+public:
+    /*
+     * Enter @a context, and restore the previous one on scope exit.
+     * Plugin contexts are only entered on threads already marked as realtime by the engine.
+     * @note RT-safe
+     */
+    ScopedRtSanitizerContext(const int32_t context) noexcept
+        : fSetContext(CarlaRtSanitizer::getFuncs().setContext),
+          fPrevContext(kCarlaRtSanitizerNoContext),
+          fChanged(false)
+    {
+        if (fSetContext == nullptr)
+            return;
+
+        if (context >= 0 && CarlaRtSanitizer::getFuncs().getContext() == kCarlaRtSanitizerNoContext)
+            return;
+
+        fPrevContext = fSetContext(context);
+        fChanged = true;
+    }
+
+    ~ScopedRtSanitizerContext() noexcept
+    {
+        if (fChanged)
+            fSetContext(fPrevContext);
+    }
+
+private:
+    const CarlaRtSanitizerSetContextFunc fSetContext;
+    int32_t fPrevContext;
+    bool fChanged;
+
+    CARLA_PREVENT_HEAP_ALLOCATION
+    CARLA_DECLARE_NON_COPYABLE(ScopedRtSanitizerContext)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_RT_SANITIZER_HPP_INCLUDED
@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: 2011-2024 Filipe Coelho <falktx@falktx.com>
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#ifndef CARLA_SPSC_RING_BUFFER_HPP_INCLUDED
+#define CARLA_SPSC_RING_BUFFER_HPP_INCLUDED
+
+#include "CarlaUtils.hpp"
+
+#include <atomic>
+
+// --------------------------------------------------------------------------------------------------------------------
+// CarlaSpscRingBuffer templated class
+
+/*
+   Fixed-capacity, single-producer/single-consumer ring of trivially copyable elements.
+
+   Storage is part of the object, so there is no allocation after construction.
+   Producer and consumer never block each other: a full ring makes tryPush() fail and increments the
+   overflow counter, an empty ring makes tryPop() fail.
+
+   head:
+    next writing position, only modified by the producer.
+
+   tail:
+    next reading position, only modified by the consumer.
+
+   Both positions are free-running counters masked on access, and live on separate cache lines so
+   that the producer and consumer threads do not keep invalidating each other's cache.
+  */
+
+template <typename ElementType, uint32_t kCapacity>
+class CarlaSpscRingBuffer
+{
+    static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0, "capacity must be a power of 2");
+
+public:
+    static constexpr const uint32_t kCacheLineSize = 64;
+
+    CarlaSpscRingBuffer() noexcept
+        : fHead(0),
+          fTail(0),
+          fOverflows(0) {}
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // producer side
+
+    bool tryPush(const ElementType& element) noexcept
+    {
+        const uint32_t head = fHead.load(std::memory_order_relaxed);
+
+        if (head - fTail.load(std::memory_order_acquire) >= kCapacity)
+        {
+            fOverflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        fElements[head & (kCapacity - 1)] = element;
+        fHead.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // consumer side
+
+    bool tryPop(ElementType& element) noexcept
+    {
+        const uint32_t tail = fTail.load(std::memory_order_relaxed);
+
+        if (tail == fHead.load(std::memory_order_acquire))
+            return false;
+
+        element = fElements[tail & (kCapacity - 1)];
+        fTail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t getReadableCount() const noexcept
+    {
+        return fHead.load(std::memory_order_acquire) - fTail.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return getReadableCount() == 0;
+    }
+
+    /*
+     * Discard everything currently readable.
+     * Must be called from the consumer side.
+     */
+    void flush() noexcept
+    {
+        fTail.store(fHead.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+    // overflow counter, safe to call from any thread
+
+    uint32_t getOverflowCount() const noexcept
+    {
+        return fOverflows.load(std::memory_order_relaxed);
+    }
+
+    uint32_t takeOverflowCount() noexcept
+    {
+        return fOverflows.exchange(0, std::memory_order_relaxed);
+    }
+
+    static constexpr uint32_t getCapacity() noexcept
+    {
+        return kCapacity;
+    }
+
+    // ----------------------------------------------------------------------------------------------------------------
+
+private:
+    std::atomic<uint32_t> fHead;
+    char fPad1[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+
+    std::atomic<uint32_t> fTail;
+    char fPad2[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+
+    std::atomic<uint32_t> fOverflows;
+    char fPad3[kCacheLineSize - sizeof(std::atomic<uint32_t>)];
+
+    ElementType fElements[kCapacity];
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaSpscRingBuffer)
+};
+
+// --------------------------------------------------------------------------------------------------------------------
+
+#endif // CARLA_SPSC_RING_BUFFER_HPP_INCLUDED
@@ -18,16 +18,20 @@
 #include "CarlaStateUtils.hpp"
 
 #include "CarlaBackendUtils.hpp"
+#include "CarlaBase64Utils.hpp"
 #include "CarlaMathUtils.hpp"
 #include "CarlaMIDI.h"
+#include "CarlaString.hpp"
 
 #include "water/streams/MemoryOutputStream.h"
 #include "water/xml/XmlElement.h"
 
 #include <string>
 
+using water::File;
 using water::MemoryOutputStream;
 using water::String;
+using water::StringArray;
 using water::XmlElement;
 
 CARLA_BACKEND_START_NAMESPACE
@@ -54,6 +58,21 @@ static void getNewLineSplittedString(MemoryOutputStream& stream, const String& s
     stream << (raw+i);
 }
 
+// -----------------------------------------------------------------------
+// writeChunkXml
+
+static void writeChunkXml(MemoryOutputStream& content, const char* const base64Chunk)
+{
+    MemoryOutputStream chunkXml, chunkSplt;
+    getNewLineSplittedString(chunkSplt, base64Chunk);
+
+    chunkXml << "\n   <Chunk>\n";
+    chunkXml << chunkSplt;
+    chunkXml << "\n   </Chunk>\n";
+
+    content << chunkXml;
+}
+
 // -----------------------------------------------------------------------
 // xmlSafeStringFast
 
@@ -153,7 +172,8 @@ CarlaStateSave::Parameter::~Parameter() noexcept
 CarlaStateSave::CustomData::CustomData() noexcept
     : type(nullptr),
       key(nullptr),
-      value(nullptr) {}
+      value(nullptr),
+      valueFile(nullptr) {}
 
 CarlaStateSave::CustomData::~CustomData() noexcept
 {
@@ -172,13 +192,18 @@ CarlaStateSave::CustomData::~CustomData() noexcept
         delete[] value;
         value = nullptr;
     }
+    if (valueFile != nullptr)
+    {
+        delete[] valueFile;
+        valueFile = nullptr;
+    }
 }
 
 bool CarlaStateSave::CustomData::isValid() const noexcept
 {
     if (type  == nullptr || type[0] == '\0') return false;
     if (key   == nullptr || key [0] == '\0') return false;
-    if (value == nullptr)                    return false;
+    if (value == nullptr && valueFile == nullptr) return false;
     return true;
 }
 
@@ -207,6 +232,8 @@ CarlaStateSave::CarlaStateSave() noexcept
       currentMidiBank(-1),
       currentMidiProgram(-1),
       chunk(nullptr),
+      chunkFile(nullptr),
+      chunkData(),
       parameters(),
       customData() {}
 
@@ -247,6 +274,13 @@ void CarlaStateSave::clear() noexcept
         delete[] chunk;
         chunk = nullptr;
     }
+    if (chunkFile != nullptr)
+    {
+        delete[] chunkFile;
+        chunkFile = nullptr;
+    }
+
+    chunkData.clear();
 
     uniqueId = 0;
     options  = PLUGIN_OPTIONS_NULL;
@@ -284,7 +318,7 @@ void CarlaStateSave::clear() noexcept
 // -----------------------------------------------------------------------
 // fillFromXmlElement
 
-bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
+bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement, const CarlaStateExternalData* const externalData)
 {
     CARLA_SAFE_ASSERT_RETURN(xmlElement != nullptr, false);
 
@@ -513,6 +547,19 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
                         {
                             stateCustomData->key = xmlSafeStringCharDup(cText.trim(), false);
                         }
+                        else if (cTag == "Value" && xmlSubData->hasAttribute("File"))
+                        {
+                            if (externalData == nullptr)
+                            {
+                                carla_stderr("CustomData value is stored externally, but no project file is known");
+                                continue;
+                            }
+
+                            const File valueFile(externalData->resolve(xmlSubData->getStringAttribute("File")));
+
+                            if (valueFile.getFullPathName().isNotEmpty())
+                                stateCustomData->valueFile = carla_strdup(valueFile.getFullPathName().toRawUTF8());
+                        }
                         else if (cTag == "Value")
                         {
                             // save operation adds a newline and newline+space around the string in some cases
@@ -543,7 +590,21 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
 
                 else if (tag == "Chunk")
                 {
-                    chunk = carla_strdup(text.toRawUTF8());
+                    if (! xmlData->hasAttribute("File"))
+                    {
+                        chunk = carla_strdup(text.toRawUTF8());
+                    }
+                    else if (externalData != nullptr)
+                    {
+                        const File file(externalData->resolve(xmlData->getStringAttribute("File")));
+
+                        if (file.getFullPathName().isNotEmpty())
+                            chunkFile = carla_strdup(file.getFullPathName().toRawUTF8());
+                    }
+                    else
+                    {
+                        carla_stderr("Chunk is stored externally, but no project file is known");
+                    }
                 }
             }
         }
@@ -555,7 +616,7 @@ bool CarlaStateSave::fillFromXmlElement(const XmlElement* const xmlElement)
 // -----------------------------------------------------------------------
 // fillXmlStringFromStateSave
 
-void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
+void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content, CarlaStateExternalData* const externalData) const
 {
     const PluginType pluginType = getPluginTypeFromString(type);
 
@@ -731,6 +792,7 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         CustomData* const stateCustomData(it.getValue(nullptr));
         CARLA_SAFE_ASSERT_CONTINUE(stateCustomData != nullptr);
         CARLA_SAFE_ASSERT_CONTINUE(stateCustomData->isValid());
+        CARLA_SAFE_ASSERT_CONTINUE(stateCustomData->value != nullptr);
 
         MemoryOutputStream customDataXml;
 
@@ -739,7 +801,30 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         customDataXml << "    <Type>" << xmlSafeString(stateCustomData->type, true) << "</Type>\n";
         customDataXml << "    <Key>"  << xmlSafeString(stateCustomData->key, true)  << "</Key>\n";
 
-        if (std::strcmp(stateCustomData->type, CUSTOM_DATA_TYPE_CHUNK) == 0 || std::strlen(stateCustomData->value) >= 128)
+        const std::size_t valueSize = std::strlen(stateCustomData->value);
+        String valueFilename;
+
+        if (externalData != nullptr && externalData->shouldStore(valueSize))
+        {
+            // chunks are stored decoded, the file is read back as base64 on restore
+            if (std::strcmp(stateCustomData->type, CUSTOM_DATA_TYPE_CHUNK) == 0)
+            {
+                const std::vector<uint8_t> chunk(carla_getChunkFromBase64String(stateCustomData->value));
+
+                if (! chunk.empty())
+                    valueFilename = externalData->store(&chunk.front(), chunk.size());
+            }
+            else
+            {
+                valueFilename = externalData->store(stateCustomData->value, valueSize);
+            }
+        }
+
+        if (valueFilename.isNotEmpty())
+        {
+            customDataXml << "    <Value File=\"" << xmlSafeString(valueFilename, true) << "\"/>\n";
+        }
+        else if (std::strcmp(stateCustomData->type, CUSTOM_DATA_TYPE_CHUNK) == 0 || std::strlen(stateCustomData->value) >= 128)
         {
             customDataXml << "    <Value>\n";
             customDataXml << xmlSafeStringFast(stateCustomData->value, true);
@@ -757,21 +842,124 @@ void CarlaStateSave::dumpToMemoryStream(MemoryOutputStream& content) const
         content << customDataXml;
     }
 
-    if (chunk != nullptr && chunk[0] != '\0')
+    if (! chunkData.empty())
     {
-        MemoryOutputStream chunkXml, chunkSplt;
-        getNewLineSplittedString(chunkSplt, chunk);
+        String chunkFilename;
 
-        chunkXml << "\n   <Chunk>\n";
-        chunkXml << chunkSplt;
-        chunkXml << "\n   </Chunk>\n";
+        if (externalData != nullptr && externalData->shouldStore(chunkData.size()))
+            chunkFilename = externalData->store(&chunkData.front(), chunkData.size());
 
-        content << chunkXml;
+        if (chunkFilename.isNotEmpty())
+            content << "\n   <Chunk File=\"" << xmlSafeString(chunkFilename, true) << "\"/>\n";
+        else
+            writeChunkXml(content, CarlaString::asBase64(&chunkData.front(), chunkData.size()).buffer());
+    }
+    else if (chunk != nullptr && chunk[0] != '\0')
+    {
+        writeChunkXml(content, chunk);
     }
 
     content << "  </Data>\n";
 }
 
+// -----------------------------------------------------------------------
+// CarlaStateExternalData
+
+CarlaStateExternalData::CarlaStateExternalData(const File& projectFile, const uint minimumSize)
+    : fProjectDir(projectFile.getParentDirectory()),
+      fDataDir(projectFile.getSiblingFile((projectFile.getFileName() + ".data").toRawUTF8())),
+      fMinimumSize(minimumSize),
+      fStoredFiles(),
+      fNextIndex(0) {}
+
+bool CarlaStateExternalData::shouldStore(const std::size_t size) const noexcept
+{
+    return fMinimumSize != 0 && size >= fMinimumSize;
+}
+
+String CarlaStateExternalData::store(const void* const data, const std::size_t size)
+{
+    CARLA_SAFE_ASSERT_RETURN(data != nullptr, String());
+
+    if (! fDataDir.isDirectory() && fDataDir.createDirectory().failed())
+    {
+        carla_stderr2("Failed to create project data folder '%s'", fDataDir.getFullPathName().toRawUTF8());
+        return String();
+    }
+
+    // skip names already on disk, the current project file may still point to them
+    String filename;
+    File file;
+
+    do {
+        filename = String(++fNextIndex).paddedLeft('0', 4) + ".bin";
+        file = fDataDir.getChildFile(filename.toRawUTF8());
+    } while (file.exists());
+
+    if (! file.replaceWithData(data, size))
+    {
+        carla_stderr2("Failed to write project data file '%s'", file.getFullPathName().toRawUTF8());
+        return String();
+    }
+
+    fStoredFiles.add(filename);
+    return file.getRelativePathFrom(fProjectDir);
+}
+
+File CarlaStateExternalData::resolve(const String& relativePath) const
+{
+    // projects can only refer to files inside their data folder
+    if (relativePath.isEmpty()
+        || relativePath.startsWithChar('/')
+        || relativePath.startsWithChar('\\')
+        || File::isAbsolutePath(relativePath.toRawUTF8()))
+    {
+        carla_stderr2("Project data file '%s' is not a relative path, ignored", relativePath.toRawUTF8());
+        return File();
+    }
+
+    StringArray components;
+    components.addTokens(relativePath, "/\\", "");
+
+    if (components.contains(".."))
+    {
+        carla_stderr2("Project data file '%s' points outside of the project, ignored", relativePath.toRawUTF8());
+        return File();
+    }
+
+    const File file(fProjectDir.getChildFile(relativePath.toRawUTF8()));
+
+    if (! file.isAChildOf(fDataDir))
+    {
+        carla_stderr2("Project data file '%s' is not inside '%s', ignored",
+                      relativePath.toRawUTF8(), fDataDir.getFullPathName().toRawUTF8());
+        return File();
+    }
+
+    return file;
+}
+
+void CarlaStateExternalData::removeStored() const
+{
+    for (int i=0, size=fStoredFiles.size(); i < size; ++i)
+        fDataDir.getChildFile(fStoredFiles[i].toRawUTF8()).deleteFile();
+}
+
+void CarlaStateExternalData::removeUnused() const
+{
+    if (! fDataDir.isDirectory())
+        return;
+
+    std::vector<File> files;
+    fDataDir.findChildFiles(files, File::findFiles, false, "*.bin");
+
+    for (std::vector<File>::iterator it = files.begin(); it != files.end(); ++it)
+    {
+        if (! fStoredFiles.contains((*it).getFileName()))
+            (*it).deleteFile();
+    }
+}
+
 // -----------------------------------------------------------------------
 
 CARLA_BACKEND_END_NAMESPACE
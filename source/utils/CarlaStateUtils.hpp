@@ -21,12 +21,17 @@
 #include "CarlaBackend.h"
 #include "LinkedList.hpp"
 
-#include "water/text/String.h"
+#include "water/files/File.h"
+#include "water/text/StringArray.h"
+
+#include <vector>
 
 CARLA_BACKEND_START_NAMESPACE
 
 // -----------------------------------------------------------------------
 
+class CarlaStateExternalData;
+
 struct CarlaStateSave {
     struct Parameter {
         bool        dummy; // if true only midiChannel/CC are used
@@ -55,6 +60,7 @@ struct CarlaStateSave {
         const char* type;
         const char* key;
         const char* value;
+        const char* valueFile; // absolute path of externally stored value, read on restore
 
         CustomData() noexcept;
         ~CustomData() noexcept;
@@ -91,6 +97,8 @@ struct CarlaStateSave {
     int32_t     currentMidiBank;
     int32_t     currentMidiProgram;
     const char* chunk;
+    const char* chunkFile;          // absolute path of externally stored chunk, read on restore
+    std::vector<uint8_t> chunkData; // raw chunk, used instead of base64 when external storage is enabled
 
     ParameterList parameters;
     CustomDataList customData;
@@ -99,12 +107,54 @@ struct CarlaStateSave {
     ~CarlaStateSave() noexcept;
     void clear() noexcept;
 
-    bool fillFromXmlElement(const water::XmlElement* const xmlElement);
-    void dumpToMemoryStream(water::MemoryOutputStream& stream) const;
+    bool fillFromXmlElement(const water::XmlElement* const xmlElement,
+                            const CarlaStateExternalData* const externalData = nullptr);
+    void dumpToMemoryStream(water::MemoryOutputStream& stream,
+                            CarlaStateExternalData* const externalData = nullptr) const;
 
     CARLA_DECLARE_NON_COPYABLE(CarlaStateSave)
 };
 
+// -----------------------------------------------------------------------
+
+/*
+ * External storage for large plugin state, used by projects.
+ *
+ * Chunks and custom data values bigger than a minimum size are written as raw files inside a
+ * "<project>.data" folder next to the project file, and referenced from the XML via a "File" attribute.
+ * This avoids base64 encoding and XML string handling for big sampler/synth states.
+ * Data is only read back from disk when the plugin state is restored.
+ * Files referenced by the previous save are never overwritten, so that it stays valid until the new XML is written.
+ */
+class CarlaStateExternalData
+{
+public:
+    CarlaStateExternalData(const water::File& projectFile, uint minimumSize);
+
+    bool shouldStore(std::size_t size) const noexcept;
+
+    // write data into a new file, returns its path relative to the project (empty on failure)
+    water::String store(const void* data, std::size_t size);
+
+    // delete files written by store(), used when the project file could not be written
+    void removeStored() const;
+
+    // get absolute file from a path relative to the project
+    water::File resolve(const water::String& relativePath) const;
+
+    // delete files from previous saves that were not written again
+    void removeUnused() const;
+
+private:
+    const water::File fProjectDir;
+    const water::File fDataDir;
+    const uint fMinimumSize;
+    water::StringArray fStoredFiles;
+    uint fNextIndex;
+
+    CARLA_DECLARE_NON_COPYABLE(CarlaStateExternalData)
+};
+
 static inline
 water::String xmlSafeString(const char* const cstring, const bool toXml)
 {
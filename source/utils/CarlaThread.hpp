@@ -27,6 +27,10 @@
 # error Threads do not work under wasm!
 #endif
 
+#ifdef CARLA_OS_LINUX
+# include <sched.h>
+#endif
+
 // -----------------------------------------------------------------------
 // CarlaThread class
 
@@ -40,6 +44,8 @@ protected:
         : fLock(),
           fSignal(),
           fName(threadName),
+          fCpuSet(),
+          fRealtimePriority(kDefaultRealtimePriority),
          #ifdef PTW32_DLLPORT
           fHandle({nullptr, 0}),
          #else
@@ -85,6 +91,20 @@ public:
         return fShouldExit;
     }
 
+    /*
+     * Set the scheduling policy to use when the thread starts.
+     * @a realtimePriority is only used when starting with realtime priority, 0 means the default.
+     * @a cpuSet is a list of CPUs and CPU ranges, like "2,4-5", null or empty means no affinity.
+     */
+    void setThreadPolicy(const int realtimePriority, const char* const cpuSet) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(! isThreadRunning(),);
+        CARLA_SAFE_ASSERT_RETURN(realtimePriority >= 0 && realtimePriority < 100,);
+
+        fRealtimePriority = realtimePriority != 0 ? realtimePriority : kDefaultRealtimePriority;
+        fCpuSet = cpuSet != nullptr ? cpuSet : "";
+    }
+
     /*
      * Start the thread.
      */
@@ -106,7 +126,7 @@ public:
 
         if (withRealtimePriority)
         {
-            sched_param.sched_priority = 80;
+            sched_param.sched_priority = fRealtimePriority;
 
            #ifndef CARLA_OS_HAIKU
             if (pthread_attr_setscope(&attr, PTHREAD_SCOPE_SYSTEM)          == 0  &&
@@ -243,6 +263,31 @@ public:
        #endif
     }
 
+    /*
+     * Restrict the caller thread to the CPUs in @a cpuSet, see setThreadPolicy().
+     * Only supported on Linux.
+     */
+    static bool setCurrentThreadAffinity(const char* const cpuSet) noexcept
+    {
+        CARLA_SAFE_ASSERT_RETURN(cpuSet != nullptr && cpuSet[0] != '\0', false);
+
+       #ifdef CARLA_OS_LINUX
+        cpu_set_t cpus;
+
+        if (! parseCpuSet(cpuSet, cpus))
+        {
+            carla_stderr2("CarlaThread: invalid CPU set \"%s\"", cpuSet);
+            return false;
+        }
+
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0)
+            return true;
+
+        carla_stderr2("CarlaThread: failed to set CPU affinity to \"%s\"", cpuSet);
+       #endif
+        return false;
+    }
+
     /*
      * Changes the name of the caller thread.
      */
@@ -259,9 +304,13 @@ public:
     // -------------------------------------------------------------------
 
 private:
+    static constexpr const int kDefaultRealtimePriority = 80;
+
     CarlaMutex         fLock;       // Thread lock
     CarlaSignal        fSignal;     // Thread start wait signal
     const CarlaString  fName;       // Thread name
+    CarlaString        fCpuSet;     // CPUs to run on, empty for any
+    int                fRealtimePriority;
     volatile pthread_t fHandle;     // Handle for this thread
     volatile bool      fShouldExit; // true if thread should exit
 
@@ -304,6 +353,47 @@ private:
        #endif
     }
 
+   #ifdef CARLA_OS_LINUX
+    /*
+     * Parse a list of CPUs and CPU ranges, like "2,4-5".
+     */
+    static bool parseCpuSet(const char* str, cpu_set_t& cpus) noexcept
+    {
+        CPU_ZERO(&cpus);
+
+        for (;;)
+        {
+            char* end;
+            const long first = std::strtol(str, &end, 10);
+            long last = first;
+
+            if (end == str || first < 0)
+                return false;
+
+            if (*end == '-')
+            {
+                str = end + 1;
+                last = std::strtol(str, &end, 10);
+
+                if (end == str || last < first)
+                    return false;
+            }
+
+            CARLA_SAFE_ASSERT_RETURN(last < CPU_SETSIZE, false);
+
+            for (long i = first; i <= last; ++i)
+                CPU_SET(static_cast<int>(i), &cpus);
+
+            if (*end == '\0')
+                return true;
+            if (*end != ',')
+                return false;
+
+            str = end + 1;
+        }
+    }
+   #endif
+
     /*
      * Thread entry point.
      */
@@ -312,6 +402,9 @@ private:
         if (fName.isNotEmpty())
             setCurrentThreadName(fName);
 
+        if (fCpuSet.isNotEmpty())
+            setCurrentThreadAffinity(fCpuSet);
+
         // report ready
         fSignal.signal();
 